@@ -106,6 +106,7 @@ AudioOutputBase::AudioOutputBase(const AudioSettings &settings) :
     memory_corruption_test0(0xdeadbeef),
     memory_corruption_test1(0xdeadbeef),
     src_out(NULL),              kAudioSRCOutputSize(0),
+    stretch_stage(NULL),        stretch_stage_size(0),
     memory_corruption_test2(0xdeadbeef),
     memory_corruption_test3(0xdeadbeef),
     m_configure_succeeded(false),m_length_last_data(0),
@@ -151,6 +152,7 @@ AudioOutputBase::~AudioOutputBase()
 
     if (kAudioSRCOutputSize > 0)
         delete[] src_out;
+    delete[] stretch_stage;
 
     assert(memory_corruption_test0 == 0xdeadbeef);
     assert(memory_corruption_test1 == 0xdeadbeef);
@@ -1313,6 +1315,95 @@ int AudioOutputBase::CopyWithUpmix(char *buffer, int frames, uint &org_waud)
     return len;
 }
 
+/**
+ * Returns a scratch buffer of at least 'samples' floats for upmixed
+ * samples on their way to the timestretcher
+ */
+float *AudioOutputBase::GetStretchStage(int samples)
+{
+    if (samples > stretch_stage_size)
+    {
+        delete[] stretch_stage;
+        stretch_stage_size = (samples + 15) & ~0xf;
+        stretch_stage = new float[stretch_stage_size];
+    }
+    return stretch_stage;
+}
+
+/**
+ * Feed frames through the upmixer (if necessary) and the timestretcher
+ * straight into the audiobuffer
+ *
+ * Samples are only written to the audiobuffer once they have been
+ * stretched, instead of being copied in, read back out by the stretcher
+ * and written over again.
+ *
+ * Returns the number of bytes the frames took up before stretching, which
+ * is what the audio timecode is based on. 'stretched_len' is set to the
+ * number of bytes actually written to the audiobuffer.
+ */
+int AudioOutputBase::StretchWithUpmix(char *buffer, int frames,
+                                      uint &org_waud, int &stretched_len)
+{
+    int bpf = bytes_per_frame;
+    int len = 0;
+
+    if (!needs_upmix)
+    {
+        pSoundStretch->putSamples((STST *)buffer, frames);
+        len = frames * bpf;
+    }
+    else if (!upmixer)
+    {
+        // mono to stereo, see CopyWithUpmix()
+        float *stage = GetStretchStage(frames * 2);
+        AudioOutputUtil::MonoToStereo(stage, buffer, frames);
+        pSoundStretch->putSamples((STST *)stage, frames);
+        len = frames * bpf;
+    }
+    else
+    {
+        int off = sizeof(float) * source_channels;
+        int i = 0;
+        while (i < frames)
+        {
+            i += upmixer->putFrames(buffer + i * off, frames - i,
+                                    source_channels);
+            int nFrames = upmixer->numFrames();
+            if (!nFrames)
+                continue;
+
+            float *stage = GetStretchStage(nFrames * configured_channels);
+            nFrames = upmixer->receiveFrames(stage, nFrames);
+            pSoundStretch->putSamples((STST *)stage, nFrames);
+            len += nFrames * bpf;
+        }
+    }
+
+    int nFrames = pSoundStretch->numSamples();
+    stretched_len = CheckFreeSpace(nFrames);
+    if (nFrames <= 0)
+        return len;
+
+    int bdFrames = (kAudioRingBufferSize - org_waud) / bpf;
+    int received = 0;
+    if (nFrames > bdFrames)
+    {
+        received = pSoundStretch->receiveSamples((STST *)(WPOS), bdFrames);
+        nFrames -= received;
+        org_waud = 0;
+    }
+    if (nFrames > 0)
+    {
+        nFrames = pSoundStretch->receiveSamples((STST *)(WPOS), nFrames);
+        received += nFrames;
+    }
+    org_waud = (org_waud + nFrames * bpf) % kAudioRingBufferSize;
+    stretched_len = received * bpf;
+
+    return len;
+}
+
 /**
  * Add frames to the audiobuffer and perform any required processing
  *
@@ -1504,8 +1595,15 @@ bool AudioOutputBase::AddData(void *in_buffer, int in_len,
            timecode of the first - add the time in ms that the frames added
            represent */
 
-        // Copy samples into audiobuffer, with upmix if necessary
-        if ((len = CopyWithUpmix((char *)buffer, frames, org_waud)) <= 0)
+        // Copy samples into audiobuffer, with upmix and timestretch
+        // if necessary
+        int stretched_len = 0;
+        if (pSoundStretch)
+            len = StretchWithUpmix((char *)buffer, frames, org_waud,
+                                   stretched_len);
+        else
+            len = CopyWithUpmix((char *)buffer, frames, org_waud);
+        if (len <= 0)
         {
             continue;
         }
@@ -1527,38 +1625,10 @@ bool AudioOutputBase::AddData(void *in_buffer, int in_len,
                     .arg(bpf));
         }
 
+        // timestretch does not change the timecode, only the number
+        // of samples that ended up in the audiobuffer
         if (pSoundStretch)
-        {
-            // does not change the timecode, only the number of samples
-            org_waud     = waud;
-            int bdFrames = bdiff / bpf;
-
-            if (bdiff < len)
-            {
-                pSoundStretch->putSamples((STST *)(WPOS), bdFrames);
-                pSoundStretch->putSamples((STST *)ABUF, (len - bdiff) / bpf);
-            }
-            else
-                pSoundStretch->putSamples((STST *)(WPOS), frames);
-
-            int nFrames = pSoundStretch->numSamples();
-            if (nFrames > frames)
-                CheckFreeSpace(nFrames);
-
-            len = nFrames * bpf;
-
-            if (nFrames > bdFrames)
-            {
-                nFrames -= pSoundStretch->receiveSamples((STST *)(WPOS),
-                                                         bdFrames);
-                org_waud = 0;
-            }
-            if (nFrames > 0)
-                nFrames = pSoundStretch->receiveSamples((STST *)(WPOS),
-                                                        nFrames);
-
-            org_waud = (org_waud + nFrames * bpf) % kAudioRingBufferSize;
-        }
+            len = stretched_len;
 
         if (internal_vol && SWVolume())
         {
@@ -47,7 +47,7 @@ private:
 // Forward declaration of SPDIF encoder
 class SPDIFEncoder;
 
-class AudioOutputBase : public AudioOutput, public MThread
+class MPUBLIC AudioOutputBase : public AudioOutput, public MThread
 {
  public:
     const char *quality_string(int q);
@@ -207,6 +207,9 @@ class AudioOutputBase : public AudioOutput, public MThread
                           int &samplerate_tmp, int &channels_tmp);
     AudioOutputSettings* OutputSettings(bool digital = true);
     int CopyWithUpmix(char *buffer, int frames, uint &org_waud);
+    int StretchWithUpmix(char *buffer, int frames, uint &org_waud,
+                         int &stretched_len);
+    float *GetStretchStage(int samples);
     void SetAudiotime(int frames, int64_t timecode);
     AudioOutputSettings *output_settingsraw;
     AudioOutputSettings *output_settings;
@@ -276,6 +279,8 @@ class AudioOutputBase : public AudioOutput, public MThread
     uint memory_corruption_test1;
     float *src_out;
     int kAudioSRCOutputSize;
+    float *stretch_stage;         // upmixed samples waiting for timestretch
+    int stretch_stage_size;
     uint memory_corruption_test2;
     /**
      * main audio buffer
@@ -18,7 +18,7 @@
 
 */
 
-class AudioOutputNULL : public AudioOutputBase
+class MPUBLIC AudioOutputNULL : public AudioOutputBase
 {
   public:
     AudioOutputNULL(const AudioSettings &settings);
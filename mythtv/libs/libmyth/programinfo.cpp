@@ -5740,6 +5740,7 @@ bool LoadFromOldRecorded(
  *  \param recMap          recording map
  *  \param sort            sort order, negative for descending, 0 for
  *                         unsorted, positive for ascending
+ *  \param recordedids     only load these recordings, all if empty
  *  \return true if it succeeds, false if it fails.
  *  \sa QueryInUseMap(void)
  *      QueryJobsRunning(int)
@@ -5751,7 +5752,8 @@ bool LoadFromRecorded(
     const QMap<QString,uint32_t> &inUseMap,
     const QMap<QString,bool> &isJobRunning,
     const QMap<QString, ProgramInfo*> &recMap,
-    int sort)
+    int sort,
+    const QList<uint> &recordedids)
 {
     destination.clear();
 
@@ -5765,6 +5767,17 @@ bool LoadFromRecorded(
     if (possiblyInProgressRecordingsOnly)
         thequery += "WHERE r.endtime >= NOW() AND r.starttime <= NOW() ";
 
+    if (!recordedids.empty())
+    {
+        QStringList ids;
+        QList<uint>::const_iterator it = recordedids.begin();
+        for (; it != recordedids.end(); ++it)
+            ids << QString::number(*it);
+
+        thequery += (possiblyInProgressRecordingsOnly) ? "AND " : "WHERE ";
+        thequery += QString("r.recordedid IN (%1) ").arg(ids.join(","));
+    }
+
     if (sort)
         thequery += "ORDER BY r.starttime ";
     if (sort < 0)
@@ -818,7 +818,8 @@ MPUBLIC bool LoadFromRecorded(
     const QMap<QString,uint32_t> &inUseMap,
     const QMap<QString,bool> &isJobRunning,
     const QMap<QString, ProgramInfo*> &recMap,
-    int                 sort = 0);
+    int                 sort = 0,
+    const QList<uint>  &recordedids = QList<uint>());
 
 template<typename TYPE>
 bool LoadFromScheduler(
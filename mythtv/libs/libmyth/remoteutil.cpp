@@ -36,6 +36,79 @@ vector<ProgramInfo *> *RemoteGetRecordedList(int sort)
     return info;
 }
 
+/** \brief Fetches the recordings changed since the given position in the
+ *         master backend's recording journal.
+ *
+ *  \param epoch      in: as returned by the last call, 0 for none,
+ *                    out: the backend's epoch
+ *  \param generation in: as returned by the last call,
+ *                    out: the generation the result brings us up to
+ *  \param full       set if the result is the complete list of recordings
+ *                    rather than only the added and changed ones
+ *  \param removed    filled with the recordedid of removed recordings
+ *  \return NULL if the backend doesn't understand QUERY_RECORDINGS_SINCE
+ *          or the request failed
+ */
+vector<ProgramInfo *> *RemoteGetRecordedListSince(
+    uint &epoch, uint &generation, bool &full, vector<uint> &removed)
+{
+    QStringList strlist(QString("QUERY_RECORDINGS_SINCE %1 %2")
+                        .arg(epoch).arg(generation));
+
+    if (!gCoreContext->SendReceiveStringList(strlist) || strlist.isEmpty())
+        return NULL;
+
+    // Backends from before QUERY_RECORDINGS_SINCE speak the same protocol
+    // version and answer UNKNOWN_COMMAND, the caller then loads the full
+    // list with QUERY_RECORDINGS.
+    if (strlist[0] == "UNKNOWN_COMMAND")
+    {
+        LOG(VB_GENERAL, LOG_INFO, "RemoteGetRecordedListSince() backend "
+            "doesn't support QUERY_RECORDINGS_SINCE, loading the full list");
+        return NULL;
+    }
+
+    if (strlist.size() < 5 || (strlist[0] != "FULL" && strlist[0] != "DELTA"))
+    {
+        LOG(VB_GENERAL, LOG_ERR,
+            "RemoteGetRecordedListSince() unexpected reply from the backend.");
+        return NULL;
+    }
+
+    full       = (strlist[0] == "FULL");
+    epoch      = strlist[1].toUInt();
+    generation = strlist[2].toUInt();
+
+    int numremoved = strlist[3].toInt();
+    if (numremoved < 0 || numremoved + 5 > strlist.size())
+    {
+        LOG(VB_GENERAL, LOG_ERR,
+            "RemoteGetRecordedListSince() list size appears to be incorrect.");
+        return NULL;
+    }
+
+    for (int i = 0; i < numremoved; i++)
+        removed.push_back(strlist[4 + i].toUInt());
+
+    QStringList::const_iterator it = strlist.begin() + 4 + numremoved;
+    int numrecordings = (*it).toInt();
+    ++it;
+
+    if (numrecordings < 0 ||
+        numrecordings * NUMPROGRAMLINES + numremoved + 5 > strlist.size())
+    {
+        LOG(VB_GENERAL, LOG_ERR,
+            "RemoteGetRecordedListSince() list size appears to be incorrect.");
+        return NULL;
+    }
+
+    vector<ProgramInfo *> *info = new vector<ProgramInfo *>;
+    for (int i = 0; i < numrecordings; i++)
+        info->push_back(new ProgramInfo(it, strlist.end()));
+
+    return info;
+}
+
 bool RemoteGetLoad(float load[3])
 {
     QStringList strlist(QString("QUERY_LOAD"));
@@ -15,6 +15,8 @@ class ProgramInfo;
 class MythEvent;
 
 MPUBLIC vector<ProgramInfo *> *RemoteGetRecordedList(int sort);
+MPUBLIC vector<ProgramInfo *> *RemoteGetRecordedListSince(
+    uint &epoch, uint &generation, bool &full, vector<uint> &removed);
 MPUBLIC bool RemoteGetLoad(float load[3]);
 MPUBLIC bool RemoteGetUptime(time_t &uptime);
 MPUBLIC
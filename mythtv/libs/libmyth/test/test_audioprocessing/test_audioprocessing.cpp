@@ -0,0 +1,3 @@
+#include "test_audioprocessing.h"
+
+QTEST_APPLESS_MAIN(TestAudioProcessing)
@@ -0,0 +1,147 @@
+/*
+ *  Class TestAudioProcessing
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <cmath>
+
+#include <unistd.h>
+
+#include <QtTest/QtTest>
+
+#include "mythcorecontext.h"
+#include "mythdb.h"
+#include "audiooutputnull.h"
+#include "audiosettings.h"
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+}
+
+#define BENCHMARK_FRAMES  1536  // about one AC-3 frame worth of samples
+
+/**
+ *  AudioOutputNULL refuses to open, which makes it useless for driving the
+ *  processing chain. This one opens fine and throws the audio away as fast
+ *  as the output thread can hand it over.
+ */
+class BenchmarkAudioOutput : public AudioOutputNULL
+{
+  public:
+    BenchmarkAudioOutput(const AudioSettings &settings) :
+        AudioOutputNULL(settings)
+    {
+        Reconfigure(settings);
+    }
+
+  protected:
+    virtual bool OpenDevice(void)
+    {
+        AudioOutputNULL::OpenDevice(); // sets the fragment sizes
+        return true;
+    }
+};
+
+class TestAudioProcessing: public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        gCoreContext = new MythCoreContext("bin_version", NULL);
+        // use the built in defaults for every audio setting
+        gCoreContext->GetDB()->IgnoreDatabase(true);
+    }
+
+    void CPUPerSecond_data(void)
+    {
+        QTest::addColumn<int>("SAMPLERATE");
+        QTest::addColumn<bool>("UPMIX");
+        QTest::addColumn<float>("STRETCH");
+
+        QTest::newRow("Float conversion") << 48000 << false << 1.0f;
+        QTest::newRow("Resample")         << 44100 << false << 1.0f;
+        QTest::newRow("Upmix 5.1")        << 48000 << true  << 1.0f;
+        QTest::newRow("Timestretch")      << 48000 << false << 1.5f;
+        QTest::newRow("Upmix+Stretch")    << 48000 << true  << 1.5f;
+        QTest::newRow("All")              << 44100 << true  << 1.5f;
+    }
+
+    // Feeds stereo audio through each processing configuration, one
+    // second of it per iteration, so the result is the time it takes to
+    // process a second of audio. Run with -tickcounter for CPU ticks.
+    void CPUPerSecond(void)
+    {
+        QFETCH(int, SAMPLERATE);
+        QFETCH(bool, UPMIX);
+        QFETCH(float, STRETCH);
+
+        AudioOutputSettings custom;
+        custom.AddSupportedRate(48000);
+        custom.AddSupportedFormat(FORMAT_S16);
+        custom.AddSupportedFormat(FORMAT_FLT);
+        custom.AddSupportedChannels(2);
+        custom.AddSupportedChannels(6);
+        custom.setPassthrough(-1);
+
+        AudioSettings settings(QString("NULL"), QString(), FORMAT_S16, 2,
+                               AV_CODEC_ID_NONE, SAMPLERATE,
+                               AUDIOOUTPUT_VIDEO, false, false, 0, &custom);
+        settings.init = false;
+
+        BenchmarkAudioOutput *output = new BenchmarkAudioOutput(settings);
+        QVERIFY(output->GetError().isEmpty());
+        if (UPMIX)
+            QVERIFY(output->ToggleUpmix());
+        output->SetStretchFactor(STRETCH);
+
+        short *samples = new short[BENCHMARK_FRAMES * 2];
+        for (int i = 0; i < BENCHMARK_FRAMES; i++)
+        {
+            short val = (short)(sin(i * 2.0 * M_PI * 440.0 / SAMPLERATE) *
+                                16384.0);
+            samples[i * 2]     = val;
+            samples[i * 2 + 1] = -val;
+        }
+
+        int64_t fed = 0;
+
+        QBENCHMARK
+        {
+            int64_t end = fed + SAMPLERATE;
+            while (fed < end)
+            {
+                int64_t timecode = fed * 1000 / SAMPLERATE;
+                if (!output->AddFrames(samples, BENCHMARK_FRAMES, timecode))
+                {
+                    usleep(1000); // audiobuffer is full
+                    continue;
+                }
+                fed += BENCHMARK_FRAMES;
+            }
+        }
+        output->Drain();
+
+        delete output;
+        delete[] samples;
+    }
+
+    void cleanupTestCase(void)
+    {
+    }
+};
@@ -70,6 +70,23 @@
  *  right away even though the thread will eventually not be counted amoung
  *  those forcing other threads to go to the queue rather than running right
  *  away.
+ *
+ *  An MThreadPool can also be created in work stealing mode. Instead of one
+ *  shared run queue it then keeps a fixed set of at most maxThreadCount()
+ *  worker threads, each with its own queue split into priority lanes. Work
+ *  started from one of the pool's own threads goes onto that worker's queue,
+ *  other work is spread round robin, and a worker that runs dry takes the
+ *  oldest runnable of the best priority waiting in another worker's queue.
+ *  Workers do not expire. startReserved() is unaffected by the mode and
+ *  always gets a thread of its own, so long running work belongs there.
+ *  As in the default mode lower priority values run first, but in this mode
+ *  that is only strictly true within one worker's queue.
+ *
+ *  Both modes support cooperative cancellation: cancel() removes a runnable
+ *  that is still queued, or flags it if it is already running, in which
+ *  case its run() should poll MThreadPool::isCancelled() and return early.
+ *  Stopping the pool flags every running runnable. Each pool also keeps
+ *  queue wait and run time statistics, see GetStats() and GetAllStats().
  */
 
 // C++ headers
@@ -78,12 +95,14 @@ using namespace std;
 
 // Qt headers
 #include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThreadStorage>
 #include <QWaitCondition>
 #include <QMutexLocker>
+#include <QAtomicInt>
 #include <QRunnable>
 #include <QMutex>
 #include <QList>
-#include <QPair>
 #include <QMap>
 #include <QSet>
 
@@ -95,16 +114,104 @@ using namespace std;
 #include "mthread.h"
 #include "mythdb.h"
 
-typedef QPair<QRunnable*,QString> MPoolEntry;
-typedef QList<MPoolEntry> MPoolQueue;
+class MPoolTask
+{
+  public:
+    MPoolTask() : runnable(NULL), queued(0) {}
+    MPoolTask(QRunnable *r, const QString &n, qint64 q) :
+        runnable(r), name(n), queued(q) {}
+
+    QRunnable *runnable;
+    QString    name;
+    qint64     queued; ///< MThreadPool::Now() when the runnable was queued
+};
+typedef QList<MPoolTask> MPoolQueue;
 typedef QMap<int, MPoolQueue> MPoolQueues;
 
+static bool remove_runnable(MPoolQueues &queues, QRunnable *runnable)
+{
+    MPoolQueues::iterator it = queues.begin();
+    for (; it != queues.end(); ++it)
+    {
+        MPoolQueue::iterator qit = (*it).begin();
+        for (; qit != (*it).end(); ++qit)
+        {
+            if ((*qit).runnable == runnable)
+            {
+                (*it).erase(qit);
+                if ((*it).empty())
+                    queues.erase(it);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/// The runnable a pool thread is running and its cancellation flag
+class MPoolCurrent
+{
+  public:
+    MPoolCurrent() : m_runnable(NULL) {}
+
+    void Set(QRunnable *runnable)
+    {
+        QMutexLocker locker(&m_lock);
+        m_runnable = runnable;
+        m_cancel.store(0);
+    }
+
+    bool IsBusy(void)
+    {
+        QMutexLocker locker(&m_lock);
+        return m_runnable != NULL;
+    }
+
+    /// Flags the running runnable, any runnable if NULL is passed in
+    bool Cancel(QRunnable *runnable)
+    {
+        QMutexLocker locker(&m_lock);
+        if (!m_runnable || (runnable && runnable != m_runnable))
+            return false;
+        m_cancel.store(1);
+        return true;
+    }
+
+    QMutex     m_lock;
+    QRunnable *m_runnable;
+    QAtomicInt m_cancel;
+};
+
+/// Lets MThreadPool::isCancelled() find the calling pool thread's flag
+class MPoolThreadContext
+{
+  public:
+    MPoolThreadContext(QAtomicInt *c, MThreadPool *p, MPoolWorker *w) :
+        cancel(c), pool(p), worker(w) {}
+
+    QAtomicInt  *cancel;
+    MThreadPool *pool;
+    MPoolWorker *worker; ///< NULL unless this is a work stealing worker
+};
+static QThreadStorage<MPoolThreadContext*> s_pool_context;
+
+/// Tidies up after each runnable, for both kinds of pool thread
+static void pool_thread_cleanup(const QString &threadName)
+{
+    loggingDeregisterThread();
+    loggingRegisterThread(threadName);
+
+    GetMythDB()->GetDBManager()->PurgeIdleConnections(false);
+    qApp->processEvents();
+    qApp->sendPostedEvents(NULL, QEvent::DeferredDelete);
+}
+
 class MPoolThread : public MThread
 {
   public:
     MPoolThread(MThreadPool &pool, int timeout) :
         MThread("PT"), m_pool(pool), m_expiry_timeout(timeout),
-        m_do_run(true), m_reserved(false)
+        m_do_run(true), m_reserved(false), m_queued(0)
     {
         QMutexLocker locker(&s_lock);
         setObjectName(QString("PT%1").arg(s_thread_num));
@@ -115,6 +222,9 @@ class MPoolThread : public MThread
     {
         RunProlog();
 
+        s_pool_context.setLocalData(
+            new MPoolThreadContext(&m_current.m_cancel, &m_pool, NULL));
+
         MythTimer t;
         t.start();
         QMutexLocker locker(&m_lock);
@@ -136,8 +246,14 @@ class MPoolThread : public MThread
             if (!m_runnable_name.isEmpty())
                 loggingRegisterThread(m_runnable_name);
 
+            qint64 waitMS = m_pool.Now() - m_queued;
+            MythTimer runTimer;
+            runTimer.start();
+            m_current.Set(m_runnable);
+
             bool autodelete = m_runnable->autoDelete();
             m_runnable->run();
+            m_current.Set(NULL);
             if (autodelete)
                 delete m_runnable;
             if (m_reserved)
@@ -145,12 +261,11 @@ class MPoolThread : public MThread
             m_reserved = false;
             m_runnable = NULL;
 
-            loggingDeregisterThread();
-            loggingRegisterThread(objectName());
+            qint64 runMS = runTimer.elapsed();
+
+            pool_thread_cleanup(objectName());
 
-            GetMythDB()->GetDBManager()->PurgeIdleConnections(false);
-            qApp->processEvents();
-            qApp->sendPostedEvents(NULL, QEvent::DeferredDelete);
+            m_pool.RecordTask(waitMS, runMS);
 
             t.start();
 
@@ -173,7 +288,7 @@ class MPoolThread : public MThread
     }
 
     bool SetRunnable(QRunnable *runnable, QString runnableName,
-                     bool reserved)
+                     bool reserved, qint64 queued)
     {
         QMutexLocker locker(&m_lock);
         if (m_do_run && (m_runnable == NULL))
@@ -181,6 +296,7 @@ class MPoolThread : public MThread
             m_runnable = runnable;
             m_runnable_name = runnableName;
             m_reserved = reserved;
+            m_queued = queued;
             m_wait.wakeAll();
             return true;
         }
@@ -201,6 +317,8 @@ class MPoolThread : public MThread
     bool m_do_run;
     QString m_runnable_name;
     bool m_reserved;
+    qint64 m_queued;
+    MPoolCurrent m_current;
 
     static QMutex s_lock;
     static uint s_thread_num;
@@ -210,16 +328,88 @@ uint MPoolThread::s_thread_num = 0;
 
 //////////////////////////////////////////////////////////////////////
 
+/** \brief Thread of an MThreadPool in work stealing mode.
+ *
+ *  Each worker owns a queue split into priority lanes. Other workers
+ *  only touch it to steal from it, so its lock is rarely contended.
+ */
+class MPoolWorker : public MThread
+{
+  public:
+    MPoolWorker(MThreadPool &pool) :
+        MThread("PW"), m_pool(pool)
+    {
+        QMutexLocker locker(&s_lock);
+        setObjectName(QString("PW%1").arg(s_worker_num));
+        s_worker_num++;
+    }
+
+    void run(void);
+
+    void Push(const MPoolTask &task, int priority)
+    {
+        QMutexLocker locker(&m_lock);
+        m_lanes[priority].push_back(task);
+    }
+
+    /// Takes the oldest runnable from the best priority lane
+    bool Take(MPoolTask &task)
+    {
+        QMutexLocker locker(&m_lock);
+        MPoolQueues::iterator it = m_lanes.begin();
+        if (it == m_lanes.end())
+            return false;
+        task = (*it).takeFirst();
+        if ((*it).empty())
+            m_lanes.erase(it);
+        return true;
+    }
+
+    /// Returns the best priority waiting in this worker's queue
+    bool Peek(int &priority)
+    {
+        QMutexLocker locker(&m_lock);
+        if (m_lanes.empty())
+            return false;
+        priority = m_lanes.begin().key();
+        return true;
+    }
+
+    bool Remove(QRunnable *runnable)
+    {
+        QMutexLocker locker(&m_lock);
+        return remove_runnable(m_lanes, runnable);
+    }
+
+    MThreadPool &m_pool;
+    QMutex m_lock;
+    MPoolQueues m_lanes;
+    MPoolCurrent m_current;
+
+    static QMutex s_lock;
+    static uint s_worker_num;
+};
+QMutex MPoolWorker::s_lock;
+uint MPoolWorker::s_worker_num = 0;
+
+//////////////////////////////////////////////////////////////////////
+
 class MThreadPoolPrivate
 {
   public:
-    MThreadPoolPrivate(const QString &name) :
+    MThreadPoolPrivate(const QString &name, bool workStealing) :
         m_name(name),
         m_running(true),
         m_expiry_timeout(120 * 1000),
         m_max_thread_count(QThread::idealThreadCount()),
-        m_reserve_thread(0)
+        m_reserve_thread(0),
+        m_work_stealing(workStealing),
+        m_idle_workers(0),
+        m_next_worker(0)
     {
+        m_clock.start();
+        m_stats.name = name;
+        m_stats.workStealing = workStealing;
     }
 
     int GetRealMaxThread(void)
@@ -240,6 +430,19 @@ class MThreadPoolPrivate
     QSet<MPoolThread*> m_running_threads;
     QList<MPoolThread*> m_delete_threads;
 
+    // work stealing mode
+    bool m_work_stealing;
+    QList<MPoolWorker*> m_workers;
+    int m_idle_workers;
+    uint m_next_worker;
+    QAtomicInt m_queued;     ///< runnables sitting in the workers' queues
+    QAtomicInt m_stopped;    ///< Stop() called, readable without m_lock
+    QWaitCondition m_work_wait;
+
+    QElapsedTimer m_clock;
+    QMutex m_stats_lock;
+    MThreadPoolStats m_stats; ///< only the counters are kept up to date
+
     static QMutex s_pool_lock;
     static MThreadPool *s_pool;
     static QList<MThreadPool*> s_all_pools;
@@ -251,8 +454,49 @@ QList<MThreadPool*> MThreadPoolPrivate::s_all_pools;
 
 //////////////////////////////////////////////////////////////////////
 
-MThreadPool::MThreadPool(const QString &name) :
-    m_priv(new MThreadPoolPrivate(name))
+void MPoolWorker::run(void)
+{
+    RunProlog();
+
+    s_pool_context.setLocalData(
+        new MPoolThreadContext(&m_current.m_cancel, &m_pool, this));
+
+    MPoolTask task;
+    while (m_pool.NextTask(this, task))
+    {
+        if (!task.name.isEmpty())
+            loggingRegisterThread(task.name);
+
+        qint64 waitMS = m_pool.Now() - task.queued;
+        MythTimer runTimer;
+        runTimer.start();
+
+        // Only stop counting it as queued once it is visibly running,
+        // otherwise waitForDone() could slip through in between.
+        m_current.Set(task.runnable);
+        m_pool.m_priv->m_queued.deref();
+
+        bool autodelete = task.runnable->autoDelete();
+        task.runnable->run();
+        m_current.Set(NULL);
+        if (autodelete)
+            delete task.runnable;
+        task = MPoolTask();
+
+        qint64 runMS = runTimer.elapsed();
+
+        pool_thread_cleanup(objectName());
+
+        m_pool.RecordTask(waitMS, runMS);
+    }
+
+    RunEpilog();
+}
+
+//////////////////////////////////////////////////////////////////////
+
+MThreadPool::MThreadPool(const QString &name, bool workStealing) :
+    m_priv(new MThreadPoolPrivate(name, workStealing))
 {
     QMutexLocker locker(&MThreadPoolPrivate::s_pool_lock);
     MThreadPoolPrivate::s_all_pools.push_back(this);
@@ -274,12 +518,20 @@ void MThreadPool::Stop(void)
 {
     QMutexLocker locker(&m_priv->m_lock);
     m_priv->m_running = false;
+    m_priv->m_stopped.store(1);
     QSet<MPoolThread*>::iterator it = m_priv->m_avail_threads.begin();
     for (; it != m_priv->m_avail_threads.end(); ++it)
         (*it)->Shutdown();
     it = m_priv->m_running_threads.begin();
     for (; it != m_priv->m_running_threads.end(); ++it)
+    {
         (*it)->Shutdown();
+        (*it)->m_current.Cancel(NULL);
+    }
+    QList<MPoolWorker*>::iterator wit = m_priv->m_workers.begin();
+    for (; wit != m_priv->m_workers.end(); ++wit)
+        (*wit)->m_current.Cancel(NULL);
+    m_priv->m_work_wait.wakeAll();
     m_priv->m_wait.wakeAll();
 }
 
@@ -309,6 +561,31 @@ void MThreadPool::DeletePoolThreads(void)
         else
             m_priv->m_delete_threads.removeAll(thread);
     }
+
+    // Workers only exit once the pool is stopped
+    if (m_priv->m_running || m_priv->m_workers.empty())
+        return;
+
+    QList<MPoolWorker*> workers = m_priv->m_workers;
+    m_priv->m_workers.clear();
+    m_priv->m_work_wait.wakeAll();
+    locker.unlock();
+
+    QList<MPoolWorker*>::iterator wit = workers.begin();
+    for (; wit != workers.end(); ++wit)
+    {
+        (*wit)->wait();
+
+        // Anything still queued will never run
+        MPoolTask task;
+        while ((*wit)->Take(task))
+        {
+            m_priv->m_queued.deref();
+            if (task.runnable->autoDelete())
+                delete task.runnable;
+        }
+        delete *wit;
+    }
 }
 
 MThreadPool *MThreadPool::globalInstance(void)
@@ -349,18 +626,30 @@ void MThreadPool::ShutdownAllPools(void)
 void MThreadPool::start(QRunnable *runnable, QString debugName, int priority)
 {
     QMutexLocker locker(&m_priv->m_lock);
+    if (m_priv->m_work_stealing)
+    {
+        if (StartStealing(runnable, debugName, priority, false))
+            return;
+        if (m_priv->m_running)
+        {
+            LOG(VB_GENERAL, LOG_ERR, QString("MThreadPool(%1): No worker "
+                "threads, falling back to the shared queue for %2")
+                .arg(m_priv->m_name).arg(debugName));
+        }
+    }
+
     if (TryStartInternal(runnable, debugName, false))
         return;
 
     MPoolQueues::iterator it = m_priv->m_run_queues.find(priority);
     if (it != m_priv->m_run_queues.end())
     {
-        (*it).push_back(MPoolEntry(runnable,debugName));
+        (*it).push_back(MPoolTask(runnable, debugName, Now()));
     }
     else
     {
         MPoolQueue list;
-        list.push_back(MPoolEntry(runnable,debugName));
+        list.push_back(MPoolTask(runnable, debugName, Now()));
         m_priv->m_run_queues[priority] = list;
     }
 }
@@ -389,15 +678,20 @@ void MThreadPool::startReserved(
 bool MThreadPool::tryStart(QRunnable *runnable, QString debugName)
 {
     QMutexLocker locker(&m_priv->m_lock);
+    if (m_priv->m_work_stealing)
+        return StartStealing(runnable, debugName, 0, true);
     return TryStartInternal(runnable, debugName, false);
 }
 
 bool MThreadPool::TryStartInternal(
-    QRunnable *runnable, QString debugName, bool reserved)
+    QRunnable *runnable, QString debugName, bool reserved, qint64 queued)
 {
     if (!m_priv->m_running)
         return false;
 
+    if (queued < 0)
+        queued = Now();
+
     while (!m_priv->m_delete_threads.empty())
     {
         m_priv->m_delete_threads.back()->wait();
@@ -412,7 +706,7 @@ bool MThreadPool::TryStartInternal(
         m_priv->m_running_threads.insert(thread);
         if (reserved)
             m_priv->m_reserve_thread++;
-        if (thread->SetRunnable(runnable, debugName, reserved))
+        if (thread->SetRunnable(runnable, debugName, reserved, queued))
         {
             return true;
         }
@@ -433,7 +727,7 @@ bool MThreadPool::TryStartInternal(
             m_priv->m_reserve_thread++;
         MPoolThread *thread = new MPoolThread(*this, m_priv->m_expiry_timeout);
         m_priv->m_running_threads.insert(thread);
-        thread->SetRunnable(runnable, debugName, reserved);
+        thread->SetRunnable(runnable, debugName, reserved, queued);
         thread->start();
         if (thread->isRunning())
         {
@@ -454,6 +748,128 @@ bool MThreadPool::TryStartInternal(
     return false;
 }
 
+/** \brief Queues a runnable on one of the workers, m_lock must be held.
+ *
+ *  A new worker is started if none are idle and there is room for one.
+ *  With tryOnly the runnable is only queued if a worker is free to pick
+ *  it up straight away.
+ */
+bool MThreadPool::StartStealing(QRunnable *runnable, QString debugName,
+                                int priority, bool tryOnly)
+{
+    if (!m_priv->m_running)
+        return false;
+
+    // Work queued from one of our own workers stays with it, the data it
+    // works on is likely still in that CPU's cache.
+    MPoolWorker *worker = NULL;
+    if (s_pool_context.hasLocalData() &&
+        s_pool_context.localData()->pool == this)
+    {
+        worker = s_pool_context.localData()->worker;
+    }
+
+    bool idle = m_priv->m_idle_workers > 0;
+    if (!idle && m_priv->m_workers.size() < max(m_priv->m_max_thread_count,1))
+    {
+        MPoolWorker *newWorker = new MPoolWorker(*this);
+        newWorker->start();
+        if (newWorker->isRunning())
+        {
+            m_priv->m_workers.push_back(newWorker);
+            if (!worker)
+                worker = newWorker;
+            idle = true;
+        }
+        else
+        {
+            // Thread failed to run, OOM?
+            delete newWorker;
+        }
+    }
+
+    if ((tryOnly && !idle) || m_priv->m_workers.empty())
+        return false;
+
+    if (!worker)
+    {
+        worker = m_priv->m_workers[
+            m_priv->m_next_worker++ % m_priv->m_workers.size()];
+    }
+
+    worker->Push(MPoolTask(runnable, debugName, Now()), priority);
+    m_priv->m_queued.ref();
+    m_priv->m_work_wait.wakeOne();
+
+    return true;
+}
+
+/** \brief Waits for the next runnable for a worker to run.
+ *  \return false once the worker should exit.
+ */
+bool MThreadPool::NextTask(MPoolWorker *worker, MPoolTask &task)
+{
+    while (true)
+    {
+        if (m_priv->m_stopped.load())
+            break;
+
+        if (worker->Take(task) || StealTask(worker, task))
+            return true;
+
+        QMutexLocker locker(&m_priv->m_lock);
+        if (!m_priv->m_running)
+            break;
+
+        // Something was queued since we looked
+        if (m_priv->m_queued.load() > 0)
+            continue;
+
+        m_priv->m_idle_workers++;
+        m_priv->m_wait.wakeAll(); // for waitForDone()
+        m_priv->m_work_wait.wait(locker.mutex());
+        m_priv->m_idle_workers--;
+    }
+
+    QMutexLocker locker(&m_priv->m_lock);
+    m_priv->m_wait.wakeAll();
+    return false;
+}
+
+/// Takes the oldest runnable from the best lane of any other worker
+bool MThreadPool::StealTask(MPoolWorker *thief, MPoolTask &task)
+{
+    QList<MPoolWorker*> workers;
+    {
+        QMutexLocker locker(&m_priv->m_lock);
+        workers = m_priv->m_workers;
+    }
+
+    // Start with our neighbour so ties don't all go to the first worker
+    int count = workers.size();
+    int self  = workers.indexOf(thief);
+    MPoolWorker *victim = NULL;
+    int best = 0;
+    for (int i = 1; i <= count; ++i)
+    {
+        MPoolWorker *worker = workers[(self + i + count) % count];
+        int priority;
+        if (worker != thief && worker->Peek(priority) &&
+            (!victim || priority < best))
+        {
+            victim = worker;
+            best = priority;
+        }
+    }
+
+    if (!victim || !victim->Take(task))
+        return false;
+
+    QMutexLocker locker(&m_priv->m_stats_lock);
+    m_priv->m_stats.steals++;
+    return true;
+}
+
 void MThreadPool::NotifyAvailable(MPoolThread *thread)
 {
     QMutexLocker locker(&m_priv->m_lock);
@@ -476,12 +892,12 @@ void MThreadPool::NotifyAvailable(MPoolThread *thread)
         return;
     }
 
-    MPoolEntry e = (*it).front();
-    if (!thread->SetRunnable(e.first, e.second, false))
+    MPoolTask e = (*it).front();
+    if (!thread->SetRunnable(e.runnable, e.name, false, e.queued))
     {
         m_priv->m_running_threads.remove(thread);
         m_priv->m_wait.wakeAll();
-        if (!TryStartInternal(e.first, e.second, false))
+        if (!TryStartInternal(e.runnable, e.name, false, e.queued))
         {
             thread->Shutdown();
             m_priv->m_delete_threads.push_front(thread);
@@ -533,7 +949,135 @@ void MThreadPool::setMaxThreadCount(int maxThreadCount)
 int MThreadPool::activeThreadCount(void) const
 {
     QMutexLocker locker(&m_priv->m_lock);
-    return m_priv->m_avail_threads.size() + m_priv->m_running_threads.size();
+    return m_priv->m_avail_threads.size() + m_priv->m_running_threads.size() +
+        m_priv->m_workers.size();
+}
+
+bool MThreadPool::isWorkStealing(void) const
+{
+    return m_priv->m_work_stealing;
+}
+
+/** \brief Cancels a runnable started on this pool.
+ *
+ *  If the runnable is still queued it is removed, and deleted if it is
+ *  set to auto delete, and true is returned. If it is already running
+ *  it is flagged so that isCancelled() returns true in its thread and
+ *  false is returned, it is up to the runnable to notice and stop early.
+ */
+bool MThreadPool::cancel(QRunnable *runnable)
+{
+    QMutexLocker locker(&m_priv->m_lock);
+
+    bool removed = remove_runnable(m_priv->m_run_queues, runnable);
+
+    QList<MPoolWorker*>::iterator wit = m_priv->m_workers.begin();
+    for (; !removed && wit != m_priv->m_workers.end(); ++wit)
+    {
+        if ((*wit)->Remove(runnable))
+        {
+            m_priv->m_queued.deref();
+            removed = true;
+        }
+    }
+
+    if (!removed)
+    {
+        QSet<MPoolThread*>::iterator it = m_priv->m_running_threads.begin();
+        for (; it != m_priv->m_running_threads.end(); ++it)
+            (*it)->m_current.Cancel(runnable);
+        for (wit = m_priv->m_workers.begin();
+             wit != m_priv->m_workers.end(); ++wit)
+        {
+            (*wit)->m_current.Cancel(runnable);
+        }
+        return false;
+    }
+
+    m_priv->m_wait.wakeAll();
+    locker.unlock();
+
+    {
+        QMutexLocker statsLocker(&m_priv->m_stats_lock);
+        m_priv->m_stats.cancelled++;
+    }
+
+    if (runnable->autoDelete())
+        delete runnable;
+
+    return true;
+}
+
+/** \brief Returns true if the runnable running in the calling thread has
+ *         been cancelled, or its pool is being stopped.
+ *
+ *  Always false outside of MThreadPool threads.
+ */
+bool MThreadPool::isCancelled(void)
+{
+    if (!s_pool_context.hasLocalData())
+        return false;
+    return s_pool_context.localData()->cancel->load() != 0;
+}
+
+qint64 MThreadPool::Now(void) const
+{
+    return m_priv->m_clock.elapsed();
+}
+
+void MThreadPool::RecordTask(qint64 waitMS, qint64 runMS)
+{
+    QMutexLocker locker(&m_priv->m_stats_lock);
+    MThreadPoolStats &stats = m_priv->m_stats;
+    stats.completed++;
+    stats.totalWaitMS += waitMS;
+    stats.maxWaitMS    = max(stats.maxWaitMS, waitMS);
+    stats.totalRunMS  += runMS;
+    stats.maxRunMS     = max(stats.maxRunMS, runMS);
+}
+
+MThreadPoolStats MThreadPool::GetStats(void) const
+{
+    MThreadPoolStats stats;
+    {
+        QMutexLocker locker(&m_priv->m_stats_lock);
+        stats = m_priv->m_stats;
+    }
+
+    QMutexLocker locker(&m_priv->m_lock);
+
+    stats.threads = m_priv->m_avail_threads.size() +
+        m_priv->m_running_threads.size() + m_priv->m_workers.size();
+
+    stats.active = 0;
+    QSet<MPoolThread*>::const_iterator it = m_priv->m_running_threads.begin();
+    for (; it != m_priv->m_running_threads.end(); ++it)
+        stats.active += (*it)->m_current.IsBusy() ? 1 : 0;
+    QList<MPoolWorker*>::const_iterator wit = m_priv->m_workers.begin();
+    for (; wit != m_priv->m_workers.end(); ++wit)
+        stats.active += (*wit)->m_current.IsBusy() ? 1 : 0;
+
+    stats.queued = max(m_priv->m_queued.load(), 0);
+    MPoolQueues::const_iterator qit = m_priv->m_run_queues.begin();
+    for (; qit != m_priv->m_run_queues.end(); ++qit)
+        stats.queued += (*qit).size();
+
+    return stats;
+}
+
+QList<MThreadPoolStats> MThreadPool::GetAllStats(void)
+{
+    QList<MThreadPoolStats> list;
+
+    QMutexLocker locker(&MThreadPoolPrivate::s_pool_lock);
+    QList<MThreadPool*>::iterator it;
+    for (it = MThreadPoolPrivate::s_all_pools.begin();
+         it != MThreadPoolPrivate::s_all_pools.end(); ++it)
+    {
+        list.push_back((*it)->GetStats());
+    }
+
+    return list;
 }
 
 /*
@@ -584,7 +1128,18 @@ void MThreadPool::waitForDone(void)
             m_priv->m_delete_threads.pop_back();
         }
 
-        if (m_priv->m_running && !m_priv->m_run_queues.empty())
+        if (m_priv->m_running &&
+            (!m_priv->m_run_queues.empty() || m_priv->m_queued.load() > 0))
+        {
+            m_priv->m_wait.wait(locker.mutex());
+            continue;
+        }
+
+        bool busy = false;
+        QList<MPoolWorker*>::iterator wit = m_priv->m_workers.begin();
+        for (; !busy && wit != m_priv->m_workers.end(); ++wit)
+            busy = (*wit)->m_current.IsBusy();
+        if (busy)
         {
             m_priv->m_wait.wait(locker.mutex());
             continue;
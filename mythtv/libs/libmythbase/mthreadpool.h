@@ -4,21 +4,59 @@
 #define _MYTH_THREAD_POOL_H_
 
 #include <QString>
+#include <QList>
 
 #include "mythbaseexp.h"
 
 class MThreadPoolPrivate;
 class MPoolThread;
+class MPoolWorker;
+class MPoolTask;
 class QRunnable;
 
+/**
+  * \ingroup mthreadpool
+  * \brief Snapshot of the counters kept by an MThreadPool.
+  *
+  * Times are in milliseconds, the wait time is how long a runnable sat in
+  * the queue before a thread picked it up.
+  */
+class MBASE_PUBLIC MThreadPoolStats
+{
+  public:
+    MThreadPoolStats() :
+        workStealing(false), threads(0), active(0), queued(0),
+        completed(0), cancelled(0), steals(0),
+        totalWaitMS(0), maxWaitMS(0), totalRunMS(0), maxRunMS(0) {}
+
+    double AverageWaitMS(void) const
+        { return completed ? (double)totalWaitMS / completed : 0.0; }
+    double AverageRunMS(void) const
+        { return completed ? (double)totalRunMS / completed : 0.0; }
+
+    QString name;
+    bool    workStealing;
+    int     threads;    ///< threads currently owned by the pool
+    int     active;     ///< threads currently running a runnable
+    int     queued;     ///< runnables waiting for a thread
+    quint64 completed;
+    quint64 cancelled;  ///< runnables removed from the queue by cancel()
+    quint64 steals;     ///< runnables taken from another worker's queue
+    qint64  totalWaitMS;
+    qint64  maxWaitMS;
+    qint64  totalRunMS;
+    qint64  maxRunMS;
+};
+
 /**
   * \ingroup mthreadpool
   */
 class MBASE_PUBLIC MThreadPool
 {
     friend class MPoolThread;
+    friend class MPoolWorker;
   public:
-    MThreadPool(const QString &name);
+    MThreadPool(const QString &name, bool workStealing = false);
     ~MThreadPool();
 
     void Stop(void);
@@ -42,13 +80,26 @@ class MBASE_PUBLIC MThreadPool
 
     int activeThreadCount(void) const;
 
+    bool isWorkStealing(void) const;
+
+    bool cancel(QRunnable *runnable);
+    static bool isCancelled(void);
+
+    MThreadPoolStats GetStats(void) const;
+    static QList<MThreadPoolStats> GetAllStats(void);
+
     void waitForDone(void);
 
   private:
-    bool TryStartInternal(QRunnable*, QString, bool);
+    bool TryStartInternal(QRunnable*, QString, bool, qint64 queued = -1);
+    bool StartStealing(QRunnable*, QString, int priority, bool tryOnly);
+    bool NextTask(MPoolWorker*, MPoolTask&);
+    bool StealTask(MPoolWorker*, MPoolTask&);
     void NotifyAvailable(MPoolThread*);
     void NotifyDone(MPoolThread*);
     void ReleaseThread(void);
+    void RecordTask(qint64 waitMS, qint64 runMS);
+    qint64 Now(void) const;
 
 
     MThreadPoolPrivate *m_priv;
@@ -11,6 +11,7 @@
 #include <QTextStream>
 #include <QNetworkProxy>
 #include <QMutexLocker>
+#include <QAbstractEventDispatcher>
 #include <QUrl>
 
 #include "stdlib.h"
@@ -36,6 +37,17 @@ using namespace std;
 #define LOC      QString("DownloadManager: ")
 #define CACHE_REDIRECTION_LIMIT     10
 
+/// Downloads in progress at once
+static const int kMaxActive     = 16;
+/// Downloads in progress from one host, QNetworkAccessManager itself
+/// opens at most six connections to a host and queues the rest
+static const int kMaxPerHost    = 4;
+/// Background downloads in progress, leaves room for interactive ones
+static const int kMaxBackground = 12;
+/// Background downloads in progress from one host, so that an interactive
+/// one never waits for a host to finish its background downloads
+static const int kMaxBackgroundPerHost = kMaxPerHost - 1;
+
 MythDownloadManager *downloadManager = NULL;
 QMutex               dmCreateLock;
 
@@ -52,7 +64,8 @@ class MythDownloadInfo
         m_processReply(true),    m_done(false),        m_bytesReceived(0),
         m_bytesTotal(0),         m_lastStat(MythDate::current()),
         m_authCallback(NULL),    m_authArg(NULL),
-        m_headers(NULL),         m_errorCode(QNetworkReply::NoError)
+        m_headers(NULL),         m_priority(kDownloadInteractive),
+        m_shareable(false),      m_errorCode(QNetworkReply::NoError)
     {
         qRegisterMetaType<QNetworkReply::NetworkError>("QNetworkReply::NetworkError");
     }
@@ -83,6 +96,29 @@ class MythDownloadInfo
         m_done = done;
     }
 
+    /// Whether the download is a plain GET whose result can be handed
+    /// to everyone asking for the same URL
+    bool IsShareable(void) const
+    {
+        return m_requestType == kRequestGet && !m_request &&
+               m_processReply && !m_authCallback && !m_headers;
+    }
+
+    /// Whether other can wait for this download instead of its own.
+    /// Once an asynchronous download has handed out data piecemeal the
+    /// start of it is gone, so it can not be joined any more.
+    bool CanShare(const MythDownloadInfo *other) const
+    {
+        bool streamed = !m_syncMode && m_caller && m_bytesReceived > 0;
+        return m_shareable && other->m_shareable && m_url == other->m_url &&
+               (m_reload || !other->m_reload) && !streamed;
+    }
+
+    QString Host(void) const
+    {
+        return QUrl(m_url).host();
+    }
+
     QString          m_url;
     QUrl             m_redirectedTo;
     QNetworkRequest *m_request;
@@ -103,6 +139,10 @@ class MythDownloadInfo
     AuthCallback     m_authCallback;
     void            *m_authArg;
     const QHash<QByteArray, QByteArray> *m_headers;
+    MDownloadPriority m_priority;
+    bool             m_shareable;
+    /// Requests for the same URL served by this download
+    QList<MythDownloadInfo*> m_followers;
 
     QNetworkReply::NetworkError m_errorCode;
     QMutex           m_lock;
@@ -223,7 +263,7 @@ MythDownloadManager::MythDownloadManager() :
 MythDownloadManager::~MythDownloadManager()
 {
     m_runThread = false;
-    m_queueWaitCond.wakeAll();
+    wakeQueue();
 
     wait();
 
@@ -243,7 +283,6 @@ void MythDownloadManager::run(void)
     bool downloading = false;
     bool itemsInQueue = false;
     bool itemsInCancellationQueue = false;
-    bool waitAnyway = false;
 
     m_queueThread = QThread::currentThread();
 
@@ -256,6 +295,10 @@ void MythDownloadManager::run(void)
     m_diskCache->setCacheDirectory(GetConfDir() + "/cache/" +
                                    QCoreApplication::applicationName() + "-" +
                                    gCoreContext->GetHostName());
+    // QNetworkDiskCache drops the least recently used entries past this
+    m_diskCache->setMaximumCacheSize(
+        (qint64)gCoreContext->GetNumSetting("DownloadCacheSize", 100) *
+        1024 * 1024);
     m_manager->setCache(m_diskCache);
 
     // Set the proxy for the manager to be the application default proxy,
@@ -269,6 +312,10 @@ void MythDownloadManager::run(void)
     QObject::connect(m_manager, SIGNAL(finished(QNetworkReply*)), this,
                        SLOT(downloadFinished(QNetworkReply*)));
 
+    // Bounds the wait for network events, see below
+    QTimer pollTimer;
+    pollTimer.start(200);
+
     m_isRunning = true;
     while (m_runThread)
     {
@@ -278,9 +325,6 @@ void MythDownloadManager::run(void)
             updateCookieJar();
         }
         m_infoLock->lock();
-        LOG(VB_FILE, LOG_DEBUG, LOC + QString("items downloading %1").arg(m_downloadInfos.count()));
-        LOG(VB_FILE, LOG_DEBUG, LOC + QString("items queued %1").arg(m_downloadQueue.count()));
-        downloading = !m_downloadInfos.isEmpty();
         itemsInCancellationQueue = !m_cancellationQueue.isEmpty();
         m_infoLock->unlock();
 
@@ -288,72 +332,197 @@ void MythDownloadManager::run(void)
         {
             downloadCanceled();
         }
-        if (downloading)
-            QCoreApplication::processEvents();
 
         m_infoLock->lock();
+        MythDownloadInfo *dlInfo;
+        while ((dlInfo = takeNextItem()))
+            startItem(dlInfo);
+
+        LOG(VB_FILE, LOG_DEBUG, LOC + QString("items downloading %1").arg(m_downloadInfos.count()));
+        LOG(VB_FILE, LOG_DEBUG, LOC + QString("items queued %1").arg(m_downloadQueue.count()));
+        downloading = !m_downloadInfos.isEmpty();
         itemsInQueue = !m_downloadQueue.isEmpty();
         m_infoLock->unlock();
 
-        if (!itemsInQueue || waitAnyway)
+        if (downloading)
         {
-            waitAnyway = false;
-            m_queueWaitLock.lock();
+            // Handle the replies as their data arrives. New items and
+            // cancellations interrupt the wait through wakeQueue().
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+            continue;
+        }
 
-            if (downloading)
-            {
-                LOG(VB_FILE, LOG_DEBUG, LOC + QString("waiting 200ms"));
-                m_queueWaitCond.wait(&m_queueWaitLock, 200);
-            }
-            else
-            {
-                LOG(VB_FILE, LOG_DEBUG, LOC + QString("waiting for more items to download"));
-                m_queueWaitCond.wait(&m_queueWaitLock);
-            }
+        m_queueWaitLock.lock();
+        if (itemsInQueue)
+        {
+            LOG(VB_FILE, LOG_DEBUG, LOC + QString("waiting 200ms"));
+            m_queueWaitCond.wait(&m_queueWaitLock, 200);
+        }
+        else
+        {
+            LOG(VB_FILE, LOG_DEBUG, LOC + QString("waiting for more items to download"));
+            m_queueWaitCond.wait(&m_queueWaitLock);
+        }
+        m_queueWaitLock.unlock();
+    }
+    m_isRunning = false;
+
+    RunEpilog();
+}
+
+/** \brief Wakes the queue thread, and anyone waiting on a download.
+ */
+void MythDownloadManager::wakeQueue(void)
+{
+    m_queueWaitCond.wakeAll();
+
+    if (m_queueThread)
+    {
+        QAbstractEventDispatcher *dispatcher =
+            QAbstractEventDispatcher::instance(m_queueThread);
+        if (dispatcher)
+            dispatcher->wakeUp();
+    }
+}
+
+/** \brief Adds a download to the queue, must hold m_infoLock.
+ *
+ *   A plain GET of a URL which is already queued or in progress waits for
+ *   that download rather than fetching it again. The queue is kept in
+ *   priority order, first come first served within a priority.
+ */
+void MythDownloadManager::enqueueItem(MythDownloadInfo *dlInfo)
+{
+    dlInfo->m_shareable = dlInfo->IsShareable();
 
-            m_queueWaitLock.unlock();
+    if (dlInfo->m_shareable)
+    {
+        MythDownloadInfo *leader = m_downloadInfos.value(dlInfo->m_url);
+        if (leader && leader->CanShare(dlInfo))
+        {
+            LOG(VB_FILE, LOG_DEBUG, LOC +
+                QString("Joining download in progress of %1")
+                    .arg(dlInfo->m_url));
+            leader->m_followers.push_back(dlInfo);
+            return;
         }
 
-        m_infoLock->lock();
-        if (!m_downloadQueue.isEmpty())
+        QList<MythDownloadInfo*>::iterator it = m_downloadQueue.begin();
+        for (; it != m_downloadQueue.end(); ++it)
         {
-            MythDownloadInfo *dlInfo = m_downloadQueue.front();
+            leader = *it;
+            if (!leader || !leader->CanShare(dlInfo))
+                continue;
 
-            m_downloadQueue.pop_front();
+            LOG(VB_FILE, LOG_DEBUG, LOC +
+                QString("Joining queued download of %1").arg(dlInfo->m_url));
+            leader->m_followers.push_back(dlInfo);
 
-            if (!dlInfo)
+            // Someone more urgent is now waiting for it, move it up
+            // without joining it to anything else
+            if (dlInfo->m_priority < leader->m_priority)
             {
-                m_infoLock->unlock();
-                continue;
+                m_downloadQueue.erase(it);
+                leader->m_priority = dlInfo->m_priority;
+                insertItem(leader);
             }
+            return;
+        }
+    }
 
-            if (m_downloadInfos.contains(dlInfo->m_url))
-            {
-                // Push request to the end of the queue to let others process.
-                // If this is the only item in the queue, force the loop to
-                // wait a little.
-                if (m_downloadQueue.isEmpty())
-                    waitAnyway = true;
-                m_downloadQueue.push_back(dlInfo);
-                m_infoLock->unlock();
-                continue;
-            }
+    insertItem(dlInfo);
+}
 
-            if (dlInfo->m_url.startsWith("myth://"))
-                downloadRemoteFile(dlInfo);
-            else
-            {
-                QMutexLocker cLock(&m_cookieLock);
-                downloadQNetworkRequest(dlInfo);
-            }
+/** \brief Inserts a download into the queue in priority order, after
+ *         those of the same priority, must hold m_infoLock.
+ */
+void MythDownloadManager::insertItem(MythDownloadInfo *dlInfo)
+{
+    QList<MythDownloadInfo*>::iterator it = m_downloadQueue.begin();
+    while (it != m_downloadQueue.end() &&
+           (!*it || (*it)->m_priority <= dlInfo->m_priority))
+    {
+        ++it;
+    }
+    m_downloadQueue.insert(it, dlInfo);
+}
 
-            m_downloadInfos[dlInfo->m_url] = dlInfo;
+/** \brief Takes the first queued download which may start now, must hold
+ *         m_infoLock.
+ *  \return NULL if the limits on downloads in progress leave no room
+ */
+MythDownloadInfo *MythDownloadManager::takeNextItem(void)
+{
+    if (m_downloadInfos.size() >= kMaxActive)
+        return NULL;
+
+    QHash<QString, int> hosts;
+    QHash<QString, int> backgroundHosts;
+    int background = 0;
+    QMap<QString, MythDownloadInfo*>::const_iterator ait =
+        m_downloadInfos.begin();
+    for (; ait != m_downloadInfos.end(); ++ait)
+    {
+        hosts[(*ait)->Host()]++;
+        if ((*ait)->m_priority == kDownloadBackground)
+        {
+            backgroundHosts[(*ait)->Host()]++;
+            background++;
         }
-        m_infoLock->unlock();
     }
-    m_isRunning = false;
 
-    RunEpilog();
+    QMutableListIterator<MythDownloadInfo*> lit(m_downloadQueue);
+    while (lit.hasNext())
+    {
+        MythDownloadInfo *dlInfo = lit.next();
+
+        if (!dlInfo)
+        {
+            lit.remove();
+            continue;
+        }
+
+        // One download of a URL at a time, the next one may want
+        // something else from it, e.g. a reload.
+        if (m_downloadInfos.contains(dlInfo->m_url))
+            continue;
+
+        if (hosts.value(dlInfo->Host()) >= kMaxPerHost)
+            continue;
+
+        if (dlInfo->m_priority == kDownloadBackground)
+        {
+            if (background >= kMaxBackground)
+                break; // the rest of the queue is background as well
+
+            if (backgroundHosts.value(dlInfo->Host()) >= kMaxBackgroundPerHost)
+                continue;
+        }
+
+        lit.remove();
+        return dlInfo;
+    }
+
+    return NULL;
+}
+
+/** \brief Starts a download taken from the queue, must hold m_infoLock.
+ */
+void MythDownloadManager::startItem(MythDownloadInfo *dlInfo)
+{
+    // The stall timeout of a blocking download runs from here,
+    // not from when it was queued.
+    dlInfo->m_lastStat = MythDate::current();
+
+    if (dlInfo->m_url.startsWith("myth://"))
+        downloadRemoteFile(dlInfo);
+    else
+    {
+        QMutexLocker cLock(&m_cookieLock);
+        downloadQNetworkRequest(dlInfo);
+    }
+
+    m_downloadInfos[dlInfo->m_url] = dlInfo;
 }
 
 /**
@@ -369,7 +538,8 @@ void MythDownloadManager::run(void)
 void MythDownloadManager::queueItem(const QString &url, QNetworkRequest *req,
                                     const QString &dest, QByteArray *data,
                                     QObject *caller, const MRequestType reqType,
-                                    const bool reload)
+                                    const bool reload,
+                                    MDownloadPriority priority)
 {
     MythDownloadInfo *dlInfo = new MythDownloadInfo;
 
@@ -380,12 +550,13 @@ void MythDownloadManager::queueItem(const QString &url, QNetworkRequest *req,
     dlInfo->m_caller  = caller;
     dlInfo->m_requestType = reqType;
     dlInfo->m_reload  = reload;
+    dlInfo->m_priority = priority;
 
     dlInfo->detach();
 
     QMutexLocker locker(m_infoLock);
-    m_downloadQueue.push_back(dlInfo);
-    m_queueWaitCond.wakeAll();
+    enqueueItem(dlInfo);
+    wakeQueue();
 }
 
 /**
@@ -399,13 +570,15 @@ void MythDownloadManager::queueItem(const QString &url, QNetworkRequest *req,
  *  \param authCallback AuthCallback function for authentication
  *  \param authArg  Opaque argument for callback function
  *  \param headers  Hash of optional HTTP header to add to the request
+ *  \param priority Whether to go ahead of background downloads
  */
 bool MythDownloadManager::processItem(const QString &url, QNetworkRequest *req,
                                       const QString &dest, QByteArray *data,
                                       const MRequestType reqType,
                                       const bool reload,
                                       AuthCallback authCallback, void *authArg,
-                                   const QHash<QByteArray, QByteArray> *headers)
+                                   const QHash<QByteArray, QByteArray> *headers,
+                                      MDownloadPriority priority)
 {
     MythDownloadInfo *dlInfo = new MythDownloadInfo;
 
@@ -419,6 +592,7 @@ bool MythDownloadManager::processItem(const QString &url, QNetworkRequest *req,
     dlInfo->m_authCallback = authCallback;
     dlInfo->m_authArg  = authArg;
     dlInfo->m_headers  = headers;
+    dlInfo->m_priority = priority;
 
     return downloadNow(dlInfo, true);
 }
@@ -429,7 +603,8 @@ bool MythDownloadManager::processItem(const QString &url, QNetworkRequest *req,
 void MythDownloadManager::preCache(const QString &url)
 {
     LOG(VB_FILE, LOG_DEBUG, LOC + QString("preCache('%1')").arg(url));
-    queueItem(url, NULL, QString(), NULL, NULL);
+    queueItem(url, NULL, QString(), NULL, NULL, kRequestGet, false,
+              kDownloadBackground);
 }
 
 /** \brief Adds a url to the download queue.
@@ -437,16 +612,18 @@ void MythDownloadManager::preCache(const QString &url)
  *  \param dest     Destination filename.
  *  \param caller   QObject to receive event notifications.
  *  \param reload   Whether to force reloading of the URL or not
+ *  \param priority Whether to go ahead of background downloads
  */
 void MythDownloadManager::queueDownload(const QString &url,
                                         const QString &dest,
                                         QObject *caller,
-                                        const bool reload)
+                                        const bool reload,
+                                        MDownloadPriority priority)
 {
     LOG(VB_FILE, LOG_DEBUG, LOC + QString("queueDownload('%1', '%2', %3)")
             .arg(url).arg(dest).arg((long long)caller));
 
-    queueItem(url, NULL, dest, NULL, caller, kRequestGet, reload);
+    queueItem(url, NULL, dest, NULL, caller, kRequestGet, reload, priority);
 }
 
 /** \brief Downloads a QNetworkRequest via the QNetworkAccessManager
@@ -473,24 +650,30 @@ void MythDownloadManager::queueDownload(QNetworkRequest *req,
  *  \param url     URI to download.
  *  \param dest    Destination filename.
  *  \param reload  Whether to force reloading of the URL or not
+ *  \param priority Whether to go ahead of background downloads
  *  \return true if download was successful, false otherwise.
  */
 bool MythDownloadManager::download(const QString &url, const QString &dest,
-                                   const bool reload)
+                                   const bool reload,
+                                   MDownloadPriority priority)
 {
-    return processItem(url, NULL, dest, NULL, kRequestGet, reload);
+    return processItem(url, NULL, dest, NULL, kRequestGet, reload,
+                       NULL, NULL, NULL, priority);
 }
 
 /** \brief Downloads a URI to a QByteArray in blocking mode.
  *  \param url     URI to download.
  *  \param data    Pointer to destination QByteArray.
  *  \param reload  Whether to force reloading of the URL or not
+ *  \param priority Whether to go ahead of background downloads
  *  \return true if download was successful, false otherwise.
  */
 bool MythDownloadManager::download(const QString &url, QByteArray *data,
-                                   const bool reload)
+                                   const bool reload,
+                                   MDownloadPriority priority)
 {
-    return processItem(url, NULL, QString(), data, kRequestGet, reload);
+    return processItem(url, NULL, QString(), data, kRequestGet, reload,
+                       NULL, NULL, NULL, priority);
 }
 
 /** \brief Downloads a URI to a QByteArray in blocking mode.
@@ -848,9 +1031,9 @@ bool MythDownloadManager::downloadNow(MythDownloadInfo *dlInfo, bool deleteInfo)
     dlInfo->m_syncMode = true;
 
     m_infoLock->lock();
-    m_downloadQueue.push_back(dlInfo);
+    enqueueItem(dlInfo);
     m_infoLock->unlock();
-    m_queueWaitCond.wakeAll();
+    wakeQueue();
 
     // timeout myth:// RemoteFile transfers 20 seconds from now
     // timeout non-myth:// QNetworkAccessManager transfers 60 seconds after
@@ -947,7 +1130,7 @@ void MythDownloadManager::cancelDownload(const QStringList &urls, bool block)
     }
 
     // wake-up running thread
-    m_queueWaitCond.wakeAll();
+    wakeQueue();
 
     if (!block)
         return;
@@ -977,6 +1160,16 @@ void MythDownloadManager::downloadCanceled()
             dlInfo->m_reply->abort();
         }
         lit.remove();
+
+        // Those waiting for the same URL are canceled along with it
+        QList<MythDownloadInfo*>::iterator fit = dlInfo->m_followers.begin();
+        for (; fit != dlInfo->m_followers.end(); ++fit)
+        {
+            (*fit)->m_errorCode = QNetworkReply::OperationCanceledError;
+            (*fit)->SetDone(true);
+        }
+        dlInfo->m_followers.clear();
+
         if (dlInfo->m_done)
         {
             dlInfo->m_lock.unlock();
@@ -992,34 +1185,34 @@ void MythDownloadManager::downloadCanceled()
  *         MythDownloadInfo instances.
  *  \param caller  QObject listener to remove
  */
+static void removeCaller(MythDownloadInfo *dlInfo, QObject *caller)
+{
+    if (!dlInfo)
+        return;
+
+    if (dlInfo->m_caller == caller)
+    {
+        dlInfo->m_caller  = NULL;
+        dlInfo->m_outFile = QString();
+        dlInfo->m_data    = NULL;
+    }
+
+    QList<MythDownloadInfo*>::iterator fit = dlInfo->m_followers.begin();
+    for (; fit != dlInfo->m_followers.end(); ++fit)
+        removeCaller(*fit, caller);
+}
+
 void MythDownloadManager::removeListener(QObject *caller)
 {
     QMutexLocker locker(m_infoLock);
-    MythDownloadInfo *dlInfo;
 
     QList <MythDownloadInfo*>::iterator lit = m_downloadQueue.begin();
     for (; lit != m_downloadQueue.end(); ++lit)
-    {
-        dlInfo = *lit;
-        if (dlInfo->m_caller == caller)
-        {
-            dlInfo->m_caller  = NULL;
-            dlInfo->m_outFile = QString();
-            dlInfo->m_data    = NULL;
-        }
-    }
+        removeCaller(*lit, caller);
 
     QMap <QString, MythDownloadInfo*>::iterator mit = m_downloadInfos.begin();
     for (; mit != m_downloadInfos.end(); ++mit)
-    {
-        dlInfo = mit.value();
-        if (dlInfo->m_caller == caller)
-        {
-            dlInfo->m_caller  = NULL;
-            dlInfo->m_outFile = QString();
-            dlInfo->m_data    = NULL;
-        }
-    }
+        removeCaller(mit.value(), caller);
 }
 
 /** \brief Slot to process download error events.
@@ -1131,6 +1324,7 @@ void MythDownloadManager::downloadFinished(MythDownloadInfo *dlInfo)
 
         if (dlInfo->m_data)
             dlInfo->m_data->clear();
+        dlInfo->m_privData.clear();
 
         dlInfo->m_bytesReceived = 0;
         dlInfo->m_bytesTotal    = 0;
@@ -1215,50 +1409,19 @@ void MythDownloadManager::downloadFinished(MythDownloadInfo *dlInfo)
 
         dlInfo->m_redirectedTo.clear();
 
-        int dataSize = -1;
+        QByteArray data;
+        bool haveData = true;
 
         // If we downloaded via the QNetworkAccessManager
         // AND the caller isn't handling the reply directly
         if (reply && dlInfo->m_processReply)
-        {
-            bool append = (!dlInfo->m_syncMode && dlInfo->m_caller);
-            QByteArray data = reply->readAll();
-            dataSize = data.size();
-
-            if (append)
-                dlInfo->m_bytesReceived += dataSize;
-            else
-                dlInfo->m_bytesReceived = dataSize;
-
-            dlInfo->m_bytesTotal = dlInfo->m_bytesReceived;
-
-            if (dlInfo->m_data)
-            {
-                if (append)
-                    dlInfo->m_data->append(data);
-                else
-                    *dlInfo->m_data = data;
-            }
-            else if (!dlInfo->m_outFile.isEmpty())
-            {
-                saveFile(dlInfo->m_outFile, data, append);
-            }
-        }
+            data = reply->readAll();
         else if (!reply)  // If we downloaded via RemoteFile
-        {
-            if (dlInfo->m_data)
-            {
-                (*dlInfo->m_data) = dlInfo->m_privData;
-            }
-            else if (!dlInfo->m_outFile.isEmpty())
-            {
-                saveFile(dlInfo->m_outFile, dlInfo->m_privData);
-            }
-            dlInfo->m_bytesReceived += dataSize;
-            dlInfo->m_bytesTotal = dlInfo->m_bytesReceived;
-        }
+            data = dlInfo->m_privData;
         // else we downloaded via QNetworkAccessManager
         // AND the caller is handling the reply
+        else
+            haveData = false;
 
         m_infoLock->lock();
         if (!m_downloadInfos.remove(dlInfo->m_url))
@@ -1268,35 +1431,100 @@ void MythDownloadManager::downloadFinished(MythDownloadInfo *dlInfo)
 
         if (reply)
             m_downloadReplies.remove(reply);
+
+        QList<MythDownloadInfo*> followers = dlInfo->m_followers;
+        dlInfo->m_followers.clear();
+
+        QNetworkReply::NetworkError errorCode =
+            reply ? reply->error() : dlInfo->m_errorCode;
+        QList<MythDownloadInfo*>::iterator fit = followers.begin();
+        for (; fit != followers.end(); ++fit)
+            (*fit)->m_errorCode = errorCode;
         m_infoLock->unlock();
 
-        dlInfo->SetDone(true);
+        if (!followers.isEmpty())
+        {
+            LOG(VB_FILE, LOG_DEBUG, QString("downloadFinished(%1): "
+                    "COMPLETE: %2, shared with %3 more requests")
+                    .arg((long long)dlInfo).arg(dlInfo->m_url)
+                    .arg(followers.size()));
+
+            // The leader may have been handed its data piecemeal,
+            // m_privData keeps what was already read.
+            QByteArray whole = (reply ? dlInfo->m_privData + data : data);
+            for (fit = followers.begin(); fit != followers.end(); ++fit)
+                completeItem(*fit, reply, whole, true, true);
+        }
+
+        completeItem(dlInfo, reply, data, haveData, false);
+
+        wakeQueue();
+    }
+}
+
+/** \brief Hands the data of a finished download to whoever asked for it.
+ *  \param dlInfo   The download, deleted here unless someone waits on it
+ *  \param reply    Reply which carried the data, NULL for RemoteFile
+ *  \param data     The data not yet handed over
+ *  \param haveData Whether there is any data to hand over at all
+ *  \param whole    Whether data is the whole body, as it is for a request
+ *                  which waited on another one
+ */
+void MythDownloadManager::completeItem(MythDownloadInfo *dlInfo,
+                                       QNetworkReply *reply,
+                                       const QByteArray &data, bool haveData,
+                                       bool whole)
+{
+    if (haveData)
+    {
+        bool append = (!whole && reply && !dlInfo->m_syncMode &&
+                       dlInfo->m_caller);
+        int dataSize = data.size();
+
+        if (append)
+            dlInfo->m_bytesReceived += dataSize;
+        else
+            dlInfo->m_bytesReceived = dataSize;
+
+        dlInfo->m_bytesTotal = dlInfo->m_bytesReceived;
 
-        if (!dlInfo->m_syncMode)
+        if (dlInfo->m_data)
         {
-            if (dlInfo->m_caller)
-            {
-                LOG(VB_FILE, LOG_DEBUG, QString("downloadFinished(%1): "
-                        "COMPLETE: %2, sending event to caller")
-                        .arg((long long)dlInfo).arg(dlInfo->m_url));
-
-                QStringList args;
-                args << dlInfo->m_url;
-                args << dlInfo->m_outFile;
-                args << QString::number(dlInfo->m_bytesTotal);
-                // placeholder for error string
-                args << (reply ? reply->errorString() : QString());
-                args << QString::number((int)(reply ? reply->error() :
-                                        dlInfo->m_errorCode));
-
-                QCoreApplication::postEvent(dlInfo->m_caller,
-                    new MythEvent("DOWNLOAD_FILE FINISHED", args));
-            }
+            if (append)
+                dlInfo->m_data->append(data);
+            else
+                *dlInfo->m_data = data;
+        }
+        else if (!dlInfo->m_outFile.isEmpty())
+        {
+            saveFile(dlInfo->m_outFile, data, append);
+        }
+    }
 
-            delete dlInfo;
+    dlInfo->SetDone(true);
+
+    if (!dlInfo->m_syncMode)
+    {
+        if (dlInfo->m_caller)
+        {
+            LOG(VB_FILE, LOG_DEBUG, QString("downloadFinished(%1): "
+                    "COMPLETE: %2, sending event to caller")
+                    .arg((long long)dlInfo).arg(dlInfo->m_url));
+
+            QStringList args;
+            args << dlInfo->m_url;
+            args << dlInfo->m_outFile;
+            args << QString::number(dlInfo->m_bytesTotal);
+            // placeholder for error string
+            args << (reply ? reply->errorString() : QString());
+            args << QString::number((int)(reply ? reply->error() :
+                                    dlInfo->m_errorCode));
+
+            QCoreApplication::postEvent(dlInfo->m_caller,
+                new MythEvent("DOWNLOAD_FILE FINISHED", args));
         }
 
-        m_queueWaitCond.wakeAll();
+        delete dlInfo;
     }
 }
 
@@ -1325,6 +1553,10 @@ void MythDownloadManager::downloadProgress(qint64 bytesReceived,
 
     dlInfo->m_lastStat = MythDate::current();
 
+    QList<MythDownloadInfo*>::iterator fit = dlInfo->m_followers.begin();
+    for (; fit != dlInfo->m_followers.end(); ++fit)
+        (*fit)->m_lastStat = dlInfo->m_lastStat;
+
     LOG(VB_FILE, LOG_DEBUG, LOC +
         QString("downloadProgress: %1 to %2 is at %3 of %4 bytes downloaded")
             .arg(dlInfo->m_url).arg(dlInfo->m_outFile)
@@ -1344,6 +1576,11 @@ void MythDownloadManager::downloadProgress(qint64 bytesReceived,
         if (dlInfo->m_data)
             dlInfo->m_data->append(data);
 
+        // Keep a copy for the requests waiting on this one, no more
+        // can join now that the data is handed out.
+        if (!dlInfo->m_followers.isEmpty())
+            dlInfo->m_privData.append(data);
+
         dlInfo->m_bytesReceived = bytesReceived;
         dlInfo->m_bytesTotal = bytesTotal;
 
@@ -1574,7 +1811,7 @@ void MythDownloadManager::refreshCookieJar(QNetworkCookieJar *jar)
     m_inCookieJar = static_cast<QNetworkCookieJar *>(outJar);
 
     QMutexLocker locker2(&m_queueWaitLock);
-    m_queueWaitCond.wakeAll();
+    wakeQueue();
 }
 
 /** \brief Update the cookie jar from the temporary cookie jar
@@ -27,6 +27,11 @@ typedef enum MRequestType {
     kRequestPost
 } MRequestType;
 
+typedef enum MDownloadPriority {
+    kDownloadInteractive, ///< Someone is waiting for the result
+    kDownloadBackground   ///< Prefetching and bulk refreshes
+} MDownloadPriority;
+
 typedef void (*AuthCallback)(QNetworkReply*, QAuthenticator*, void*);
 
 class MBASE_PUBLIC MythDownloadManager : public QObject, public MThread
@@ -46,13 +51,16 @@ class MBASE_PUBLIC MythDownloadManager : public QObject, public MThread
     // Methods to GET a URL
     void preCache(const QString &url);
     void queueDownload(const QString &url, const QString &dest,
-                       QObject *caller, const bool reload = false);
+                       QObject *caller, const bool reload = false,
+                       MDownloadPriority priority = kDownloadInteractive);
     void queueDownload(QNetworkRequest *req, QByteArray *data,
                        QObject *caller);
     bool download(const QString &url, const QString &dest,
-                  const bool reload = false);
+                  const bool reload = false,
+                  MDownloadPriority priority = kDownloadInteractive);
     bool download(const QString &url, QByteArray *data,
-                  const bool reload = false);
+                  const bool reload = false,
+                  MDownloadPriority priority = kDownloadInteractive);
     QNetworkReply *download(const QString &url, const bool reload = false);
     bool download(QNetworkRequest *req, QByteArray *data);
     bool downloadAuth(const QString &url, const QString &dest,
@@ -106,7 +114,8 @@ class MBASE_PUBLIC MythDownloadManager : public QObject, public MThread
     void queueItem(const QString &url, QNetworkRequest *req,
                    const QString &dest, QByteArray *data, QObject *caller,
                    const MRequestType reqType = kRequestGet,
-                   const bool reload = false);
+                   const bool reload = false,
+                   MDownloadPriority priority = kDownloadInteractive);
 
     bool processItem(const QString &url, QNetworkRequest *req,
                      const QString &dest, QByteArray *data,
@@ -114,7 +123,18 @@ class MBASE_PUBLIC MythDownloadManager : public QObject, public MThread
                      const bool reload = false,
                      AuthCallback authCallback = NULL,
                      void *authArg = NULL,
-                     const QHash<QByteArray, QByteArray> *headers = NULL);
+                     const QHash<QByteArray, QByteArray> *headers = NULL,
+                     MDownloadPriority priority = kDownloadInteractive);
+
+    // Queue handling, these must be called with m_infoLock held
+    void enqueueItem(MythDownloadInfo *dlInfo);
+    void insertItem(MythDownloadInfo *dlInfo);
+    MythDownloadInfo *takeNextItem(void);
+    void startItem(MythDownloadInfo *dlInfo);
+
+    void completeItem(MythDownloadInfo *dlInfo, QNetworkReply *reply,
+                      const QByteArray &data, bool haveData, bool whole);
+    void wakeQueue(void);
 
     void downloadRemoteFile(MythDownloadInfo *dlInfo);
     void downloadQNetworkRequest(MythDownloadInfo *dlInfo);
@@ -730,6 +730,10 @@ void myth_yield(void)
  *  if -1 or 8 do not work. It will not report an error on these conditions
  *  as they will be the common case.
  *
+ *  If thread_only is set only the calling thread is affected, which
+ *  lets a helper thread such as a read ahead thread run at a lower
+ *  priority than the rest of the process.
+ *
  *  Only Linux on i386, ppc, x86_64 and ia64 are currently supported.
  *  This is a no-op on all other architectures and platforms.
  */
@@ -768,14 +772,14 @@ void myth_yield(void)
 enum { IOPRIO_CLASS_NONE,IOPRIO_CLASS_RT,IOPRIO_CLASS_BE,IOPRIO_CLASS_IDLE, };
 enum { IOPRIO_WHO_PROCESS = 1, IOPRIO_WHO_PGRP, IOPRIO_WHO_USER, };
 
-bool myth_ioprio(int val)
+bool myth_ioprio(int val, bool thread_only)
 {
     int new_ioclass = (val < 0) ? IOPRIO_CLASS_RT :
         (val > 7) ? IOPRIO_CLASS_IDLE : IOPRIO_CLASS_BE;
     int new_iodata = (new_ioclass == IOPRIO_CLASS_BE) ? val : 0;
     int new_ioprio = IOPRIO_PRIO_VALUE(new_ioclass, new_iodata);
 
-    int pid = getpid();
+    int pid = thread_only ? syscall(__NR_gettid) : getpid();
     int old_ioprio = syscall(__NR_ioprio_get, IOPRIO_WHO_PROCESS, pid);
     if (old_ioprio == new_ioprio)
         return true;
@@ -794,7 +798,7 @@ bool myth_ioprio(int val)
 
 #else
 
-bool myth_ioprio(int) { return true; }
+bool myth_ioprio(int, bool) { return true; }
 
 #endif
 
@@ -74,7 +74,7 @@ MBASE_PUBLIC bool IsPulseAudioRunning(void);
 MBASE_PUBLIC bool myth_nice(int val);
 MBASE_PUBLIC void myth_yield(void);
 /// range -1..8, smaller is higher priority
-MBASE_PUBLIC bool myth_ioprio(int val);
+MBASE_PUBLIC bool myth_ioprio(int val, bool thread_only = false);
 
 MBASE_PUBLIC bool MythRemoveDirectory(QDir &aDir);
 
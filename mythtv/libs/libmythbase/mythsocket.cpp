@@ -41,6 +41,8 @@ const uint MythSocket::kShortTimeout = kMythSocketShortTimeout;
 const uint MythSocket::kLongTimeout  = kMythSocketLongTimeout;
 
 const int MythSocket::kSocketReceiveBufferSize = 128 * 1024;
+const int MythSocket::kMaxQueuedStringLists = 4096;
+const qint64 MythSocket::kMaxBytesToWrite = 256 * 1024;
 
 QMutex MythSocket::s_loopbackCacheLock;
 QHash<QString, QHostAddress::SpecialAddress> MythSocket::s_loopbackCache;
@@ -91,7 +93,10 @@ MythSocket::MythSocket(
     m_connected(false),
     m_dataAvailable(0),
     m_isValidated(false),
-    m_isAnnounced(false)
+    m_isAnnounced(false),
+    m_writeQueueScheduled(false),
+    m_droppedCount(0),
+    m_writingQueue(false)
 {
     LOG(VB_SOCKET, LOG_INFO, LOC + QString("MythSocket(%1, 0x%2) ctor")
         .arg(socket).arg((intptr_t)(cb),0,16));
@@ -115,6 +120,10 @@ MythSocket::MythSocket(
             this, SLOT(ReadyReadHandler()),
             Qt::DirectConnection);
 
+    connect(m_tcpSocket,  SIGNAL(bytesWritten(qint64)),
+            this, SLOT(WriteQueueHandler()),
+            Qt::DirectConnection);
+
     connect(this, SIGNAL(CallReadyRead()),
             this, SLOT(CallReadyReadHandler()),
             Qt::QueuedConnection);
@@ -319,6 +328,79 @@ bool MythSocket::WriteStringList(const QStringList &list)
     return ret;
 }
 
+/** \brief Returns list as it is sent over the wire.
+ *
+ *  The result can be handed to QueueStringList() of any number of
+ *  sockets, they all share the same data.
+ */
+QByteArray MythSocket::EncodeStringList(const QStringList &list)
+{
+    QByteArray utf8 = list.join("[]:[]").toUtf8();
+
+    QByteArray payload;
+    payload = payload.setNum(utf8.length());
+    payload += "        ";
+    payload.truncate(8);
+    payload += utf8;
+
+    return payload;
+}
+
+/** \brief Queues a string list encoded by EncodeStringList() for
+ *         sending without waiting for the socket thread.
+ *
+ *  Lists with the same non-empty coalesce_key supersede each other,
+ *  a list still waiting to be sent is replaced in place when a newer
+ *  one with the same key is queued. This lets a client which is slow to read
+ *  fall behind without the queue growing with stale updates.
+ *
+ *  \return false if the socket is not connected
+ */
+bool MythSocket::QueueStringList(const QByteArray &payload,
+                                 const QString &coalesce_key)
+{
+    if (!IsConnected() || payload.isEmpty())
+        return false;
+
+    QMutexLocker locker(&m_queueLock);
+
+    // Take the place of the superseded list, so that the order of
+    // events relative to other lists is kept. It is already scheduled.
+    if (!coalesce_key.isEmpty())
+    {
+        for (int i = 0; i < m_writeQueue.size(); i++)
+        {
+            if (m_writeQueue[i].first == coalesce_key)
+            {
+                m_writeQueue[i].second = payload;
+                return true;
+            }
+        }
+    }
+
+    if (m_writeQueue.size() >= kMaxQueuedStringLists)
+    {
+        m_writeQueue.removeFirst();
+        if (!(m_droppedCount++ % kMaxQueuedStringLists))
+        {
+            LOG(VB_GENERAL, LOG_WARNING, LOC +
+                QString("Client is not reading, dropped %1 queued messages")
+                    .arg(m_droppedCount));
+        }
+    }
+
+    m_writeQueue.push_back(QPair<QString,QByteArray>(coalesce_key, payload));
+
+    if (!m_writeQueueScheduled)
+    {
+        m_writeQueueScheduled = true;
+        QMetaObject::invokeMethod(this, "WriteQueueHandler",
+                                  Qt::QueuedConnection);
+    }
+
+    return true;
+}
+
 bool MythSocket::ReadStringList(QStringList &list, uint timeoutMS)
 {
     bool ret = false;
@@ -761,18 +843,11 @@ void MythSocket::WriteStringListReal(const QStringList *list, bool *ret)
         return;
     }
 
-    QByteArray utf8 = str.toUtf8();
-    int size = utf8.length();
+    QByteArray payload = EncodeStringList(*list);
+    int size = payload.length();
     int written = 0;
     int written_since_timer_restart = 0;
 
-    QByteArray payload;
-    payload = payload.setNum(size);
-    payload += "        ";
-    payload.truncate(8);
-    payload += utf8;
-    size = payload.length();
-
     if (VERBOSE_LEVEL_CHECK(VB_NETWORK, LOG_INFO))
     {
         QString msg = QString("write -> %1 %2")
@@ -836,6 +911,69 @@ void MythSocket::WriteStringListReal(const QStringList *list, bool *ret)
     return;
 }
 
+/** \brief Writes the lists queued by QueueStringList().
+ *
+ *  Runs in the socket thread. Stops while more than
+ *  kMaxBytesToWrite are waiting in the QTcpSocket, the bytesWritten()
+ *  signal resumes writing once the client has read some of them.
+ */
+void MythSocket::WriteQueueHandler(void)
+{
+    if (m_writingQueue)
+        return;
+    m_writingQueue = true;
+
+    {
+        QMutexLocker locker(&m_queueLock);
+        m_writeQueueScheduled = false;
+    }
+
+    bool wrote = true;
+    while (wrote)
+    {
+        wrote = false;
+        while (m_tcpSocket->bytesToWrite() < kMaxBytesToWrite)
+        {
+            QByteArray payload;
+            {
+                QMutexLocker locker(&m_queueLock);
+                if (m_writeQueue.empty())
+                    break;
+                if (m_tcpSocket->state() != QAbstractSocket::ConnectedState)
+                {
+                    m_writeQueue.clear();
+                    break;
+                }
+                payload = m_writeQueue.takeFirst().second;
+            }
+
+            if (VERBOSE_LEVEL_CHECK(VB_NETWORK, LOG_INFO))
+            {
+                LOG(VB_NETWORK, LOG_INFO, LOC +
+                    QString("queued write -> %1 %2")
+                        .arg(m_tcpSocket->socketDescriptor(), 2)
+                        .arg(to_sample(payload)));
+            }
+
+            if (m_tcpSocket->write(payload) != payload.length())
+            {
+                LOG(VB_GENERAL, LOG_ERR, LOC +
+                    "WriteQueueHandler: Error, short write." +
+                    QString("\n\t\t\tstarts with: %1")
+                        .arg(to_sample(payload)));
+            }
+            wrote = true;
+        }
+
+        // flush() emits bytesWritten() before returning, the nested call
+        // returns right away, so go round again for what it made room for.
+        if (wrote)
+            m_tcpSocket->flush();
+    }
+
+    m_writingQueue = false;
+}
+
 void MythSocket::ReadStringListReal(
     QStringList *list, uint timeoutMS, bool *ret)
 {
@@ -4,6 +4,9 @@
 
 #include <QHostAddress>
 #include <QStringList>
+#include <QByteArray>
+#include <QPair>
+#include <QList>
 #include <QAtomicInt>
 #include <QMutex>
 #include <QHash>
@@ -56,6 +59,10 @@ class MBASE_PUBLIC MythSocket : public QObject, public ReferenceCounter
     bool ReadStringList(QStringList &list, uint timeoutMS = kShortTimeout);
     bool WriteStringList(const QStringList &list);
 
+    static QByteArray EncodeStringList(const QStringList &list);
+    bool QueueStringList(const QByteArray &payload,
+                         const QString &coalesce_key = QString());
+
     bool IsConnected(void) const;
     bool IsDataAvailable(void) const;
 
@@ -81,6 +88,7 @@ class MBASE_PUBLIC MythSocket : public QObject, public ReferenceCounter
     void DisconnectHandler(void);
     void ReadyReadHandler(void);
     void CallReadyReadHandler(void);
+    void WriteQueueHandler(void);
 
     void ReadStringListReal(QStringList *list, uint timeoutMS, bool *ret);
     void WriteStringListReal(const QStringList *list, bool *ret);
@@ -113,7 +121,16 @@ class MBASE_PUBLIC MythSocket : public QObject, public ReferenceCounter
     bool            m_isAnnounced; // only set in thread using MythSocket
     QStringList     m_announce; // only set in thread using MythSocket
 
+    QMutex          m_queueLock;
+    /// coalesce key and encoded string list, protected by m_queueLock
+    QList<QPair<QString,QByteArray> > m_writeQueue;
+    bool            m_writeQueueScheduled; // protected by m_queueLock
+    uint            m_droppedCount; // protected by m_queueLock
+    bool            m_writingQueue; // only used in socket thread
+
     static const int kSocketReceiveBufferSize;
+    static const int kMaxQueuedStringLists;
+    static const qint64 kMaxBytesToWrite;
 
     static QMutex s_loopbackCacheLock;
     static QHash<QString, QHostAddress::SpecialAddress> s_loopbackCache;
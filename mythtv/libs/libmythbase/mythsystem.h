@@ -49,6 +49,8 @@ typedef enum MythSystemMask {
                                         ///  for the duration of application.
     kMSPropagateLogs      = 0x00020000, ///< add arguments for MythTV log
                                         ///  propagation
+    kMSProcessGroup       = 0x00040000, ///< run child in its own process
+                                        ///  group and signal the group
 } MythSystemMask;
 
 typedef enum MythSignal {
@@ -308,13 +308,17 @@ void MythSystemLegacy::Term(bool force)
     d->Term(force);
 }
 
-void MythSystemLegacy::Signal(MythSignal sig)
+/** \brief Sends a signal to the child, or to its process group when
+ *         it was started with kMSProcessGroup.
+ *  \return true if the signal was delivered
+ */
+bool MythSystemLegacy::Signal(MythSignal sig)
 {
     if (!d)
         m_status = GENERIC_EXIT_NO_HANDLER;
 
     if (m_status != GENERIC_EXIT_RUNNING)
-        return;
+        return false;
 
     int posix_signal = SIGTRAP;
     switch (sig)
@@ -337,10 +341,10 @@ void MythSystemLegacy::Signal(MythSignal sig)
     if (SIGTRAP == posix_signal)
     {
         LOG(VB_SYSTEM, LOG_ERR, "Programmer error: Unknown signal");
-        return;
+        return false;
     }
 
-    d->Signal(posix_signal);
+    return d->Signal(posix_signal);
 }
 
 
@@ -395,6 +399,8 @@ void MythSystemLegacy::ProcessFlags(uint flags)
         m_settings["OnlyLowExitVal"] = true;
     if (flags & kMSPropagateLogs)
         m_settings["PropagateLogs"] = true;
+    if (flags & kMSProcessGroup)
+        m_settings["ProcessGroup"] = true;
 }
 
 QByteArray  MythSystemLegacy::Read(int size)
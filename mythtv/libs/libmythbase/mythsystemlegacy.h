@@ -106,7 +106,7 @@ class MBASE_PUBLIC MythSystemLegacy : public QObject
 
     // FIXME: Can Term be wrapped into Signal?
     void Term(bool force = false);
-    void Signal(MythSignal);
+    bool Signal(MythSignal);
 
     // FIXME: Should be IsBackground() + documented
     bool isBackground(void)   { return GetSetting("RunInBackground"); }
@@ -33,7 +33,7 @@ class MythSystemLegacyPrivate : public QObject, public ReferenceCounter
     virtual void Manage(void) = 0;
 
     virtual void Term(bool force=false) = 0;
-    virtual void Signal(int sig) = 0;
+    virtual bool Signal(int sig) = 0;
     virtual void JumpAbort(void) = 0;
 
     virtual bool ParseShell(const QString &cmd, QString &abscmd,
@@ -762,7 +762,7 @@ void MythSystemLegacyUnix::Term(bool force)
     }
 }
 
-void MythSystemLegacyUnix::Signal( int sig )
+bool MythSystemLegacyUnix::Signal( int sig )
 {
     int status = GetStatus();
     if( (status != GENERIC_EXIT_RUNNING && status != GENERIC_EXIT_TIMEOUT) ||
@@ -770,12 +770,21 @@ void MythSystemLegacyUnix::Signal( int sig )
     {
         LOG(VB_GENERAL, LOG_DEBUG, QString("Signal skipped. Status: %1")
             .arg(status));
-        return;
+        return false;
     }
 
-    LOG(VB_GENERAL, LOG_INFO, QString("Child PID %1 killed with %2")
-                    .arg(m_pid).arg(strsignal(sig)));
-    kill(m_pid, sig);
+    // A negative pid signals every process in the child's group
+    bool group = GetSetting("ProcessGroup");
+    LOG(VB_GENERAL, LOG_INFO, QString("Child %1 %2 killed with %3")
+                    .arg(group ? "process group" : "PID").arg(m_pid)
+                    .arg(strsignal(sig)));
+    if (kill(group ? -m_pid : m_pid, sig) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, QString("Signal to child %1 failed: ")
+            .arg(m_pid) + ENO);
+        return false;
+    }
+    return true;
 }
 
 #define MAX_BUFLEN 1024
@@ -920,6 +929,7 @@ void MythSystemLegacyUnix::Fork(time_t timeout)
 
     int niceval = m_parent->GetNice();
     int ioprioval = m_parent->GetIOPrio();
+    bool procgroup = GetSetting("ProcessGroup");
 
     /* Do this before forking in case the child miserably fails */
     m_timeout = timeout;
@@ -940,6 +950,10 @@ void MythSystemLegacyUnix::Fork(time_t timeout)
         m_pid = child;
         SetStatus( GENERIC_EXIT_RUNNING );
 
+        /* the child does this too, whichever runs first wins the race */
+        if (procgroup)
+            setpgid(child, child);
+
         LOG(VB_SYSTEM, LOG_INFO,
                     QString("Managed child (PID: %1) has started! "
                             "%2%3 command=%4, timeout=%5")
@@ -1107,6 +1121,15 @@ void MythSystemLegacyUnix::Fork(time_t timeout)
                  << strerror(errno) << endl;
         }
 
+        /* lead a process group of our own, so the shell and anything
+         * it starts can be signalled together */
+        if (procgroup && setpgid(0, 0) < 0)
+        {
+            cerr << locerr
+                 << "setpgid() failed: "
+                 << strerror(errno) << endl;
+        }
+
         /* Set nice and ioprio values if non-default */
         if (niceval)
             myth_nice(niceval);
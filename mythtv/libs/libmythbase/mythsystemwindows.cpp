@@ -589,13 +589,16 @@ void MythSystemLegacyWindows::Term(bool force)
     }
 }
 
-void MythSystemLegacyWindows::Signal( int sig )
+bool MythSystemLegacyWindows::Signal( int sig )
 {
     if( (GetStatus() != GENERIC_EXIT_RUNNING) || (!m_child) )
-        return;
+        return false;
+    // There is no way to stop a process for a while here
+    if (sig == SIGSTOP || sig == SIGCONT)
+        return false;
     LOG(VB_SYSTEM, LOG_INFO, QString("Child Handle %1 killed with %2")
                     .arg((long long)m_child).arg(sig));
-    TerminateProcess( m_child, sig * 256 );
+    return TerminateProcess( m_child, sig * 256 );
 }
 
 
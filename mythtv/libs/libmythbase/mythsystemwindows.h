@@ -92,7 +92,7 @@ class MBASE_PUBLIC MythSystemLegacyWindows : public MythSystemLegacyPrivate
         virtual void Manage(void) MOVERRIDE;
 
         virtual void Term(bool force=false) MOVERRIDE;
-        virtual void Signal(int sig) MOVERRIDE;
+        virtual bool Signal(int sig) MOVERRIDE;
         virtual void JumpAbort(void) MOVERRIDE;
 
         virtual bool ParseShell(const QString &cmd, QString &abscmd,
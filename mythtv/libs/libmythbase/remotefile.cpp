@@ -1,3 +1,4 @@
+#include <cstring>
 #include <iostream>
 using namespace std;
 
@@ -47,6 +48,8 @@ RemoteFile::RemoteFile(const QString &_path, bool write, bool useRA,
     lock(QMutex::NonRecursive),
     controlSock(NULL),    sock(NULL),
     query("QUERY_FILETRANSFER %1"),
+    canstream(true),      streaming(false),
+    streamReceived(0LL),  streamLimit(0LL),
     writemode(write),     completed(false),
     localFile(-1),        fileWriter(NULL)
 {
@@ -353,6 +356,10 @@ void RemoteFile::Close(bool haslock)
     {
         lock.lock();
     }
+    if (streaming && IsConnected())
+        StopStream();
+    streaming = false;
+
     if (controlSock->IsConnected() && !controlSock->SendReceiveStringList(
             strlist, 0, MythSocket::kShortTimeout))
     {
@@ -620,6 +627,13 @@ void RemoteFile::Reset(void)
         LOG(VB_NETWORK, LOG_ERR, "RemoteFile::Reset(): Called with no socket");
         return;
     }
+    if (streaming)
+    {
+        // The backend read ahead of us, so put it back where we are
+        StopStream();
+        SeekInternal(lastposition, SEEK_SET);
+        return;
+    }
     sock->Reset();
 }
 
@@ -683,9 +697,33 @@ long long RemoteFile::SeekInternal(long long pos, int whence, long long curpos)
     strlist << QString::number(whence);
     if (curpos > 0)
         strlist << QString::number(curpos);
+    else if (streaming)
+        strlist << QString::number(lastposition);
     else
         strlist << QString::number(readposition);
 
+    if (streaming)
+    {
+        // The stream keeps running, the backend tells us how much of it
+        // was sent before the seek so we can skip it.
+        bool ok = controlSock->WriteStringList(strlist) &&
+                  WaitForStreamReply(strlist);
+        if (!ok || strlist.size() < 2)
+        {
+            LOG(VB_NETWORK, LOG_ERR,
+                "RemoteFile::Seek(): Streamed seek failed");
+            streaming = false;
+            lastposition = 0LL;
+            Resume(false);
+            return -1;
+        }
+
+        DiscardStream(strlist[1].toLongLong());
+        lastposition = readposition = strlist[0].toLongLong();
+        UpdateStreamCredit();
+        return strlist[0].toLongLong();
+    }
+
     bool ok = controlSock->SendReceiveStringList(strlist);
 
     if (ok && !strlist.isEmpty())
@@ -834,6 +872,12 @@ int RemoteFile::Read(void *data, int size)
         return -1;
     }
 
+    if (usereadahead && canstream && !streaming)
+        StartStream();
+
+    if (streaming)
+        return ReadStream(data, size);
+
     if (sock->IsDataAvailable())
     {
         LOG(VB_NETWORK, LOG_ERR,
@@ -943,6 +987,236 @@ int RemoteFile::Read(void *data, int size)
     return recv;
 }
 
+/** \fn RemoteFile::StartStream(void)
+ *  \brief Asks the backend to stream the file instead of answering a
+ *         REQUEST_BLOCK per Read(). Must have lock.
+ *
+ *   With REQUEST_BLOCK every read costs a round trip to the backend, during
+ *   which the link is idle. A streaming backend instead keeps sending until
+ *   kStreamWindow bytes are in flight, and ReadStream() raises that limit
+ *   as it consumes the data. The limit is the total since the stream
+ *   started rather than an increment, so repeated or reordered credits are
+ *   harmless. Backends which don't know REQUEST_STREAM, and
+ *   mythmediaserver, answer with an error and we stay with REQUEST_BLOCK.
+ */
+bool RemoteFile::StartStream(void)
+{
+    if (sock->IsDataAvailable())
+    {
+        LOG(VB_NETWORK, LOG_ERR,
+                "RemoteFile::Read(): Read socket not empty to start!");
+        sock->Reset();
+    }
+
+    QStringList strlist( QString(query).arg(recordernum) );
+    strlist << "REQUEST_STREAM";
+    strlist << QString::number(kStreamWindow);
+
+    if (!controlSock->SendReceiveStringList(strlist))
+        return false;
+
+    if (strlist.isEmpty() || strlist[0] != "1")
+    {
+        LOG(VB_NETWORK, LOG_INFO,
+            "RemoteFile: Backend can't stream, using block requests");
+        canstream = false;
+        return false;
+    }
+
+    streaming      = true;
+    streamReceived = 0;
+    streamLimit    = kStreamWindow;
+    streamPending.clear();
+
+    return true;
+}
+
+/** \fn RemoteFile::StopStream(void)
+ *  \brief Stops the stream and drops what is left of it. Must have lock.
+ *
+ *   The backend will have read past lastposition, the caller has to seek
+ *   before using block requests again.
+ */
+void RemoteFile::StopStream(void)
+{
+    streaming = false;
+
+    QStringList strlist( QString(query).arg(recordernum) );
+    strlist << "STOP_STREAM";
+
+    if (controlSock->WriteStringList(strlist) &&
+        WaitForStreamReply(strlist) && !strlist.isEmpty())
+    {
+        DiscardStream(strlist[0].toLongLong());
+    }
+    else
+    {
+        LOG(VB_NETWORK, LOG_ERR, "RemoteFile: Stopping the stream failed");
+    }
+
+    streamPending.clear();
+    sock->Reset();
+}
+
+/// Reads from the stream, must have lock
+int RemoteFile::ReadStream(void *data, int size)
+{
+    int recv = min(size, streamPending.size());
+    if (recv > 0)
+    {
+        memcpy(data, streamPending.constData(), recv);
+        streamPending.remove(0, recv);
+    }
+
+    int waitms = 30;
+    MythTimer mtimer;
+    mtimer.start();
+
+    while (recv < size && mtimer.elapsed() < 10000)
+    {
+        int ret = sock->Read(((char *)data) + recv, size - recv, waitms);
+
+        if (ret < 0)
+        {
+            LOG(VB_NETWORK, LOG_ERR, "RemoteFile::Read(): Stream read failed");
+            streaming = false;
+            Resume();
+            return -1;
+        }
+
+        if (ret > 0)
+        {
+            recv += ret;
+            streamReceived += ret;
+            continue;
+        }
+
+        // Hand over what we have rather than wait for the rest
+        if (recv > 0)
+            break;
+
+        QStringList strlist( QString(query).arg(recordernum) );
+        strlist << "STREAM_STATUS";
+        if (controlSock->SendReceiveStringList(strlist) &&
+            strlist.size() >= 2 && strlist[1].toInt() &&
+            strlist[0].toLongLong() <= streamReceived)
+        {
+            return 0; // everything up to the end of the file is here
+        }
+
+        waitms += (waitms < 200) ? 20 : 0;
+    }
+
+    if (recv == 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, "RemoteFile::Read(): Stream timed out.");
+        streaming = false;
+        Resume();
+        return -1;
+    }
+
+    LOG(VB_NETWORK, LOG_DEBUG,
+        QString("ReadStream(): reqd=%1, rcvd=%2, total=%3, limit=%4")
+            .arg(size).arg(recv).arg(streamReceived).arg(streamLimit));
+
+    lastposition += recv;
+    UpdateStreamCredit();
+
+    return recv;
+}
+
+/// Gives the backend more credit once half the window is used, must have lock
+void RemoteFile::UpdateStreamCredit(void)
+{
+    if (streamLimit - streamReceived >= kStreamWindow / 2)
+        return;
+
+    streamLimit = streamReceived + kStreamWindow;
+
+    // The backend reads one request at a time, so the reply has to be
+    // read before the next request is sent.
+    QStringList strlist( QString(query).arg(recordernum) );
+    strlist << "STREAM_CREDIT";
+    strlist << QString::number(streamLimit);
+    if (!controlSock->WriteStringList(strlist) ||
+        !WaitForStreamReply(strlist) || strlist.isEmpty() ||
+        strlist[0] != "OK")
+    {
+        LOG(VB_NETWORK, LOG_ERR,
+            "RemoteFile: Raising the stream credit failed");
+    }
+}
+
+/** \fn RemoteFile::WaitForStreamReply(QStringList&)
+ *  \brief Reads the reply to a request made while streaming. Must have lock.
+ *
+ *   The backend may be blocked writing the stream before it can answer,
+ *   so the data socket is emptied into streamPending in the meantime.
+ */
+bool RemoteFile::WaitForStreamReply(QStringList &strlist)
+{
+    char buf[16 * 1024];
+    MythTimer mtimer;
+    mtimer.start();
+
+    while (!controlSock->IsDataAvailable())
+    {
+        if (mtimer.elapsed() > (int)MythSocket::kLongTimeout ||
+            !controlSock->IsConnected())
+        {
+            return false;
+        }
+
+        int ret = sock->Read(buf, sizeof(buf), 10);
+        if (ret < 0)
+            return false;
+        if (ret > 0)
+        {
+            streamPending.append(buf, ret);
+            streamReceived += ret;
+        }
+    }
+
+    return controlSock->ReadStringList(strlist);
+}
+
+/// Drops the stream up to byte upto since it started, must have lock
+void RemoteFile::DiscardStream(long long upto)
+{
+    long long consumed = streamReceived - streamPending.size();
+    if (upto <= consumed)
+        return;
+
+    long long skip = upto - consumed;
+    if (skip <= streamPending.size())
+    {
+        streamPending.remove(0, skip);
+        return;
+    }
+
+    skip -= streamPending.size();
+    streamPending.clear();
+
+    char buf[16 * 1024];
+    MythTimer mtimer;
+    mtimer.start();
+
+    while (skip > 0 && mtimer.elapsed() < 10000)
+    {
+        int ret = sock->Read(buf, min(skip, (long long)sizeof(buf)), 30);
+        if (ret < 0)
+            break;
+        skip -= ret;
+        streamReceived += ret;
+    }
+
+    if (skip > 0)
+    {
+        LOG(VB_NETWORK, LOG_ERR,
+            QString("RemoteFile: Lost %1 bytes of the stream").arg(skip));
+    }
+}
+
 /**
  * GetFileSize: returns the remote file's size at the time it was first opened
  * Will query the server in order to get the size. If file isn't being modified
@@ -70,6 +70,13 @@ class MBASE_PUBLIC RemoteFile
     bool Resume(bool repos = true);
     long long SeekInternal(long long pos, int whence, long long curpos = -1);
 
+    bool StartStream(void);
+    void StopStream(void);
+    int  ReadStream(void *data, int size);
+    void UpdateStreamCredit(void);
+    bool WaitForStreamReply(QStringList &strlist);
+    void DiscardStream(long long upto);
+
     MythSocket     *openSocket(bool control);
 
     QString         path;
@@ -87,6 +94,14 @@ class MBASE_PUBLIC RemoteFile
     MythSocket     *sock;
     QString         query;
 
+    // Streamed reads, see StartStream()
+    bool            canstream;
+    bool            streaming;
+    long long       streamReceived;
+    long long       streamLimit;
+    QByteArray      streamPending;
+    static const int kStreamWindow = 2 * 1024 * 1024;
+
     bool            writemode;
     bool            completed;
     MythTimer       lastSizeCheck;
@@ -9,6 +9,7 @@
 #include "mythlogging.h"
 #include "mythcoreutil.h"
 #include "mythdirs.h"
+#include "mythdate.h"
 
 #define LOC QString("SG(%1): ").arg(m_groupname)
 
@@ -19,6 +20,13 @@ bool                   StorageGroup::m_staticInitDone = false;
 QMap<QString, QString> StorageGroup::m_builtinGroups;
 QMutex                 StorageGroup::s_groupToUseLock;
 QHash<QString,QString> StorageGroup::s_groupToUseCache;
+QMutex                 StorageGroup::s_fileIndexLock;
+QHash<QString,StorageGroup::FileIndexEntry> StorageGroup::s_fileIndex;
+
+/// Seconds a file index entry is trusted before it is re-checked on disk
+const int StorageGroup::kFileIndexValidateSecs = 60;
+/// Upper bound on the number of cached file locations
+const int StorageGroup::kFileIndexMaxEntries = 50000;
 
 const QStringList StorageGroup::kSpecialGroups = QStringList()
     << QT_TRANSLATE_NOOP("(StorageGroups)", "LiveTV")
@@ -630,6 +638,17 @@ QString StorageGroup::FindFileDir(const QString &filename)
     QString result = "";
     QFileInfo checkFile("");
 
+    // Only our own directories may answer before they have been searched,
+    // another group may hold a different file of the same name.
+    QString cached = LookupFileIndex(filename, m_dirlist, false);
+    if (!cached.isEmpty())
+    {
+        LOG(VB_FILE, LOG_DEBUG, LOC +
+            QString("FindFileDir: Using cached '%1' for '%2'")
+                .arg(cached).arg(filename));
+        return cached;
+    }
+
     int curDir = 0;
     while (curDir < m_dirlist.size())
     {
@@ -642,12 +661,27 @@ QString StorageGroup::FindFileDir(const QString &filename)
         {
             QString tmp = m_dirlist[curDir];
             tmp.detach();
+            AddFileToIndex(tmp, filename);
             return tmp;
         }
 
         curDir++;
     }
 
+    // When falling back is allowed the search below ends up looking in
+    // every local directory anyway, so any cached location is acceptable.
+    if (!m_groupname.isEmpty() && m_allowFallback)
+    {
+        cached = LookupFileIndex(filename, m_dirlist, true);
+        if (!cached.isEmpty())
+        {
+            LOG(VB_FILE, LOG_DEBUG, LOC +
+                QString("FindFileDir: Using cached fallback '%1' for '%2'")
+                    .arg(cached).arg(filename));
+            return cached;
+        }
+    }
+
     if (m_groupname.isEmpty() || (m_allowFallback == false))
     {
         // Not found in any dir, so try RecordFilePrefix if it exists
@@ -908,4 +942,161 @@ QString StorageGroup::GetGroupToUse(
     return tmpGroup;
 }
 
+/**
+ *  \brief Looks up the directory holding a file in the file location index
+ *
+ *   The index maps a filename relative to a Storage Group directory to the
+ *   directory it was last found in.  It is filled lazily by FindFileDir() and
+ *   kept up to date by the backend as it deletes and renames files.  Entries
+ *   older than kFileIndexValidateSecs are re-checked on disk before they are
+ *   used, so that changes made behind our back are eventually noticed.
+ *   The index is shared by every group and host, so a directory which is
+ *   not in dirlist is always checked on disk.
+ *
+ *  \param filename The filename relative to a Storage Group directory
+ *  \param dirlist  The directories the caller is searching
+ *  \param anyDir   Accept a cached directory even if it is not in dirlist
+ *  \return         The cached directory, or an empty string on a miss
+ */
+QString StorageGroup::LookupFileIndex(const QString &filename,
+                                      const QStringList &dirlist,
+                                      bool anyDir)
+{
+    QString dir;
+    QDateTime now = MythDate::current();
+
+    {
+        QMutexLocker locker(&s_fileIndexLock);
+
+        QHash<QString,FileIndexEntry>::const_iterator it =
+            s_fileIndex.find(filename);
+        if (it == s_fileIndex.end())
+            return QString();
+
+        bool ours = dirlist.contains((*it).dir);
+        if (!anyDir && !ours)
+            return QString();
+
+        dir = (*it).dir;
+        dir.detach();
+
+        if (ours && (*it).validated.secsTo(now) <= kFileIndexValidateSecs)
+            return dir;
+    }
+
+    // Stale entry, or one found for another group or host, check it
+    // without holding the lock since the stat() may block for a while
+    // on network filesystems.
+    QFileInfo checkFile(dir + "/" + filename);
+    bool exists = checkFile.exists() || checkFile.isSymLink();
+
+    QMutexLocker locker(&s_fileIndexLock);
+
+    QHash<QString,FileIndexEntry>::iterator it = s_fileIndex.find(filename);
+    if (it != s_fileIndex.end() && (*it).dir == dir)
+    {
+        if (exists)
+            (*it).validated = now;
+        else
+            s_fileIndex.erase(it);
+    }
+
+    return exists ? dir : QString();
+}
+
+/**
+ *  \brief Records that filename lives in the Storage Group directory dir
+ *
+ *  \param dir      The Storage Group directory, without a trailing slash
+ *  \param filename The filename relative to dir
+ */
+void StorageGroup::AddFileToIndex(const QString &dir, const QString &filename)
+{
+    if (dir.isEmpty() || filename.isEmpty())
+        return;
+
+    QMutexLocker locker(&s_fileIndexLock);
+
+    if (s_fileIndex.size() >= kFileIndexMaxEntries &&
+        !s_fileIndex.contains(filename))
+    {
+        LOG(VB_FILE, LOG_INFO,
+            "StorageGroup: File location index is full, clearing it");
+        s_fileIndex.clear();
+    }
+
+    QString tmpDir = dir;
+    QString tmpFile = filename;
+    tmpDir.detach();
+    tmpFile.detach();
+    s_fileIndex[tmpFile] = FileIndexEntry(tmpDir, MythDate::current());
+}
+
+/**
+ *  \brief Forgets the cached location of a file that has been deleted
+ *
+ *  \param fullpath The full pathname of the file
+ */
+void StorageGroup::RemoveFileFromIndex(const QString &fullpath)
+{
+    QMutexLocker locker(&s_fileIndexLock);
+
+    if (s_fileIndex.isEmpty())
+        return;
+
+    // The index is keyed by the name relative to the Storage Group dir,
+    // so try every possible split of the path into dir and filename.
+    int pos = fullpath.indexOf('/', 1);
+    while (pos > 0)
+    {
+        QString filename = fullpath.mid(pos + 1);
+        QHash<QString,FileIndexEntry>::iterator it =
+            s_fileIndex.find(filename);
+        if (it != s_fileIndex.end() && (*it).dir == fullpath.left(pos))
+        {
+            s_fileIndex.erase(it);
+            return;
+        }
+        pos = fullpath.indexOf('/', pos + 1);
+    }
+}
+
+/**
+ *  \brief Moves the cached location of a renamed file
+ *
+ *   Only renames within the same Storage Group directory are recorded,
+ *   anything else is simply dropped and will be found again on demand.
+ */
+void StorageGroup::RenameFileInIndex(const QString &oldpath,
+                                     const QString &newpath)
+{
+    QString dir;
+
+    {
+        QMutexLocker locker(&s_fileIndexLock);
+
+        int pos = oldpath.indexOf('/', 1);
+        while (pos > 0 && dir.isEmpty())
+        {
+            QHash<QString,FileIndexEntry>::iterator it =
+                s_fileIndex.find(oldpath.mid(pos + 1));
+            if (it != s_fileIndex.end() && (*it).dir == oldpath.left(pos))
+            {
+                dir = (*it).dir;
+                s_fileIndex.erase(it);
+            }
+            pos = oldpath.indexOf('/', pos + 1);
+        }
+    }
+
+    if (!dir.isEmpty() && newpath.startsWith(dir + "/"))
+        AddFileToIndex(dir, newpath.mid(dir.length() + 1));
+}
+
+void StorageGroup::ClearFileIndex(void)
+{
+    QMutexLocker locker(&s_fileIndexLock);
+    s_fileIndex.clear();
+}
+
 /* vim: set expandtab tabstop=4 shiftwidth=4: */
@@ -2,6 +2,7 @@
 #define _STORAGEGROUP_H
 
 #include <QStringList>
+#include <QDateTime>
 #include <QMutex>
 #include <QHash>
 #include <QMap>
@@ -55,7 +56,16 @@ class MBASE_PUBLIC StorageGroup
     static QString GetGroupToUse(
         const QString &host, const QString &sgroup);
 
+    static void AddFileToIndex(const QString &dir, const QString &filename);
+    static void RemoveFileFromIndex(const QString &fullpath);
+    static void RenameFileInIndex(const QString &oldpath,
+                                  const QString &newpath);
+    static void ClearFileIndex(void);
+
   private:
+    static QString LookupFileIndex(const QString &filename,
+                                   const QStringList &dirlist,
+                                   bool anyDir);
     static void    StaticInit(void);
     static bool    m_staticInitDone;
     static QMutex  m_staticInitLock;
@@ -69,6 +79,22 @@ class MBASE_PUBLIC StorageGroup
 
     static QMutex                 s_groupToUseLock;
     static QHash<QString,QString> s_groupToUseCache;
+
+    /// Cached location of a file, see LookupFileIndex()
+    class FileIndexEntry
+    {
+      public:
+        FileIndexEntry() {}
+        FileIndexEntry(const QString &d, const QDateTime &v) :
+            dir(d), validated(v) {}
+        QString   dir;
+        QDateTime validated;
+    };
+
+    static QMutex                        s_fileIndexLock;
+    static QHash<QString,FileIndexEntry> s_fileIndex;
+    static const int                     kFileIndexValidateSecs;
+    static const int                     kFileIndexMaxEntries;
 };
 
 #endif
@@ -0,0 +1,3 @@
+#include "test_mthreadpool.h"
+
+QTEST_GUILESS_MAIN(TestMThreadPool)
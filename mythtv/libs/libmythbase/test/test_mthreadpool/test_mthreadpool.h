@@ -0,0 +1,244 @@
+/*
+ *  Class TestMThreadPool
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <unistd.h> // for usleep()
+
+#include <QtTest/QtTest>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QMutex>
+#include <QList>
+
+#include "mythcorecontext.h"
+#include "mthreadpool.h"
+
+/// Blocks its pool thread until Release() is called
+class BlockingRunnable : public QRunnable
+{
+  public:
+    BlockingRunnable() : m_started(false), m_released(false),
+        m_sawCancel(false) { setAutoDelete(false); }
+
+    void run(void)
+    {
+        QMutexLocker locker(&m_lock);
+        m_started = true;
+        m_wait.wakeAll();
+        while (!m_released)
+            m_wait.wait(locker.mutex(), 10);
+        m_sawCancel = MThreadPool::isCancelled();
+    }
+
+    void WaitForStart(void)
+    {
+        QMutexLocker locker(&m_lock);
+        while (!m_started)
+            m_wait.wait(locker.mutex());
+    }
+
+    void Release(void)
+    {
+        QMutexLocker locker(&m_lock);
+        m_released = true;
+        m_wait.wakeAll();
+    }
+
+    QMutex m_lock;
+    QWaitCondition m_wait;
+    bool m_started;
+    bool m_released;
+    bool m_sawCancel;
+};
+
+/// Records the order in which runnables ran
+class OrderRunnable : public QRunnable
+{
+  public:
+    OrderRunnable(int id, QList<int> &order, QMutex &lock) :
+        m_id(id), m_order(order), m_lock(lock) {}
+
+    void run(void)
+    {
+        QMutexLocker locker(&m_lock);
+        m_order.push_back(m_id);
+    }
+
+    int m_id;
+    QList<int> &m_order;
+    QMutex &m_lock;
+};
+
+/// Queues more work on its own pool from inside a pool thread
+class SpawningRunnable : public QRunnable
+{
+  public:
+    SpawningRunnable(MThreadPool &pool, int count, QAtomicInt &done) :
+        m_pool(pool), m_count(count), m_done(done) {}
+
+    void run(void)
+    {
+        for (int i = 0; i < m_count; i++)
+            m_pool.start(new SpawningRunnable(m_pool, 0, m_done), "spawned");
+        usleep(1000);
+        m_done.ref();
+    }
+
+    MThreadPool &m_pool;
+    int m_count;
+    QAtomicInt &m_done;
+};
+
+class TestMThreadPool: public QObject
+{
+    Q_OBJECT
+
+    void Priorities(bool workStealing)
+    {
+        MThreadPool pool("TestPriorities", workStealing);
+        pool.setMaxThreadCount(1);
+
+        BlockingRunnable block;
+        pool.start(&block, "block");
+        block.WaitForStart();
+
+        QList<int> order;
+        QMutex lock;
+        pool.start(new OrderRunnable(2, order, lock), "two", 10);
+        pool.start(new OrderRunnable(0, order, lock), "zero", -10);
+        pool.start(new OrderRunnable(1, order, lock), "one", 0);
+
+        block.Release();
+        pool.waitForDone();
+
+        QCOMPARE(order.size(), 3);
+        QCOMPARE(order[0], 0);
+        QCOMPARE(order[1], 1);
+        QCOMPARE(order[2], 2);
+    }
+
+    void CancelQueued(bool workStealing)
+    {
+        MThreadPool pool("TestCancel", workStealing);
+        pool.setMaxThreadCount(1);
+
+        BlockingRunnable block;
+        pool.start(&block, "block");
+        block.WaitForStart();
+
+        QList<int> order;
+        QMutex lock;
+        OrderRunnable *queued = new OrderRunnable(1, order, lock);
+        queued->setAutoDelete(false);
+        pool.start(queued, "queued");
+
+        QVERIFY(pool.cancel(queued));
+        QVERIFY(!pool.cancel(queued));
+
+        block.Release();
+        pool.waitForDone();
+        delete queued;
+
+        QVERIFY(order.empty());
+        QCOMPARE((int)pool.GetStats().cancelled, 1);
+    }
+
+    void CancelRunning(bool workStealing)
+    {
+        MThreadPool pool("TestCancelRunning", workStealing);
+
+        BlockingRunnable block;
+        pool.start(&block, "block");
+        block.WaitForStart();
+
+        QVERIFY(!pool.cancel(&block));
+        block.Release();
+        pool.waitForDone();
+
+        QVERIFY(block.m_sawCancel);
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        gCoreContext = new MythCoreContext("bin_version", NULL);
+    }
+
+    // called at the end of these sets of tests
+    void cleanupTestCase(void)
+    {
+        MThreadPool::ShutdownAllPools();
+    }
+
+    void PrioritiesAreHonoured(void)        { Priorities(false); }
+    void StealingPrioritiesAreHonoured(void) { Priorities(true); }
+    void CancelRemovesQueued(void)          { CancelQueued(false); }
+    void StealingCancelRemovesQueued(void)  { CancelQueued(true); }
+    void CancelFlagsRunning(void)           { CancelRunning(false); }
+    void StealingCancelFlagsRunning(void)   { CancelRunning(true); }
+
+    void NotCancelledOutsidePool(void)
+    {
+        QVERIFY(!MThreadPool::isCancelled());
+    }
+
+    void IdleWorkersSteal(void)
+    {
+        MThreadPool pool("TestStealing", true);
+        pool.setMaxThreadCount(4);
+
+        // Everything spawned goes on the first worker's queue,
+        // the others can only get at it by stealing.
+        QAtomicInt done;
+        pool.start(new SpawningRunnable(pool, 200, done), "spawner");
+        pool.waitForDone();
+
+        QCOMPARE(done.load(), 201);
+
+        MThreadPoolStats stats = pool.GetStats();
+        QVERIFY(stats.workStealing);
+        QCOMPARE((int)stats.completed, 201);
+        QCOMPARE(stats.queued, 0);
+        QCOMPARE(stats.active, 0);
+        QVERIFY(stats.threads <= 4);
+        QVERIFY(stats.steals > 0);
+    }
+
+    void StatsArePublished(void)
+    {
+        MThreadPool pool("TestStats");
+        QAtomicInt done;
+        for (int i = 0; i < 10; i++)
+            pool.start(new SpawningRunnable(pool, 0, done), "stats");
+        pool.waitForDone();
+
+        bool found = false;
+        QList<MThreadPoolStats> all = MThreadPool::GetAllStats();
+        for (int i = 0; i < all.size(); i++)
+        {
+            if (all[i].name != "TestStats")
+                continue;
+            found = true;
+            QCOMPARE((int)all[i].completed, 10);
+            QVERIFY(!all[i].workStealing);
+            QVERIFY(all[i].AverageRunMS() >= 0.0);
+        }
+        QVERIFY(found);
+    }
+};
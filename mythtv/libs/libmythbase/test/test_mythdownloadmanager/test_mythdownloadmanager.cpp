@@ -0,0 +1,3 @@
+#include "test_mythdownloadmanager.h"
+
+QTEST_GUILESS_MAIN(TestMythDownloadManager)
@@ -0,0 +1,474 @@
+/*
+ *  Class TestMythDownloadManager
+ *
+ *  Copyright (C) MythTV Developers
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QList>
+
+#include "mythcorecontext.h"
+#include "mythdownloadmanager.h"
+#include "mythqtcompat.h"
+
+/** \class StandInHttpServer
+ *  \brief A local web server standing in for the metadata and artwork
+ *         sites, it answers every GET after a fixed delay.
+ *
+ *   Between Hold() and Release() requests are not answered at all, so a
+ *   test can look at what was requested while they are in progress.
+ *
+ *   It runs in its own thread, since the test thread blocks in
+ *   MythDownloadManager::download(), and keeps count of the requests
+ *   for each path and of how many were in progress at once.
+ */
+class StandInHttpServer : public QTcpServer
+{
+    Q_OBJECT
+
+  public:
+    StandInHttpServer(int latency_ms, int size) :
+        m_latency(latency_ms), m_size(size), m_hold(false),
+        m_active(0), m_maxActive(0)
+    {
+    }
+
+    int Requests(const QString &path)
+    {
+        QMutexLocker locker(&m_lock);
+        return m_requests.value(path);
+    }
+
+    int Active(void)
+    {
+        QMutexLocker locker(&m_lock);
+        return m_active;
+    }
+
+    int MaxActive(void)
+    {
+        QMutexLocker locker(&m_lock);
+        return m_maxActive;
+    }
+
+    void ResetCounts(void)
+    {
+        QMutexLocker locker(&m_lock);
+        m_requests.clear();
+        m_maxActive = 0;
+    }
+
+    QByteArray Body(const QString &path) const
+    {
+        return QByteArray(m_size, 'a' + (qHash(path) % 26));
+    }
+
+  public slots:
+    quint16 Start(void)
+    {
+        if (!listen(QHostAddress::LocalHost))
+            return 0;
+        return serverPort();
+    }
+
+    void Stop(void)
+    {
+        close();
+        QList<QTcpSocket*> sockets = findChildren<QTcpSocket*>();
+        for (int i = 0; i < sockets.size(); ++i)
+            sockets[i]->close();
+    }
+
+    void Hold(void)
+    {
+        m_hold = true;
+    }
+
+    void Release(void)
+    {
+        m_hold = false;
+        while (!m_held.isEmpty())
+            Respond(m_held.takeFirst());
+    }
+
+  protected:
+    void incomingConnection(qt_socket_fd_t handle)
+    {
+        QTcpSocket *socket = new QTcpSocket(this);
+        socket->setSocketDescriptor(handle);
+        connect(socket, SIGNAL(readyRead()), this, SLOT(ReadRequest()));
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+    }
+
+  private slots:
+    void ReadRequest(void)
+    {
+        QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+        if (!socket)
+            return;
+
+        // Only GETs, so a request ends with the headers
+        QByteArray &buffer = m_buffers[socket];
+        buffer.append(socket->readAll());
+        int end;
+        while ((end = buffer.indexOf("\r\n\r\n")) >= 0)
+        {
+            QList<QByteArray> line = buffer.left(buffer.indexOf("\r\n"))
+                .split(' ');
+            buffer.remove(0, end + 4);
+            if (line.size() < 2)
+                continue;
+
+            QString path = QString::fromLatin1(line[1]);
+            {
+                QMutexLocker locker(&m_lock);
+                m_requests[path]++;
+                m_active++;
+                m_maxActive = qMax(m_maxActive, m_active);
+            }
+
+            if (m_hold)
+            {
+                m_held.append(qMakePair(socket, path));
+                continue;
+            }
+
+            m_pending.append(qMakePair(socket, path));
+            QTimer::singleShot(m_latency, this, SLOT(SendResponse()));
+        }
+    }
+
+    void SendResponse(void)
+    {
+        if (!m_pending.isEmpty())
+            Respond(m_pending.takeFirst());
+    }
+
+  private:
+    void Respond(const QPair<QTcpSocket*, QString> &request)
+    {
+        {
+            QMutexLocker locker(&m_lock);
+            m_active--;
+        }
+
+        QTcpSocket *socket = request.first;
+        if (!findChildren<QTcpSocket*>().contains(socket) ||
+            socket->state() != QAbstractSocket::ConnectedState)
+        {
+            return;
+        }
+
+        QByteArray body = Body(request.second);
+        QByteArray response =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: application/octet-stream\r\n"
+            "Cache-Control: no-store\r\n"
+            "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+            "\r\n";
+        socket->write(response + body);
+    }
+
+    int  m_latency;
+    int  m_size;
+    bool m_hold;
+
+    QHash<QTcpSocket*, QByteArray>       m_buffers;
+    QList<QPair<QTcpSocket*, QString> >  m_pending;
+    QList<QPair<QTcpSocket*, QString> >  m_held;
+
+    QMutex              m_lock;
+    QHash<QString, int> m_requests;
+    int                 m_active;
+    int                 m_maxActive;
+};
+
+/// Background downloads from one host, one slot is left interactive
+static const int kBackgroundPerHost = 3;
+
+/// Does a blocking download, the way MetadataImageDownload does
+class DownloadThread : public QThread
+{
+  public:
+    DownloadThread(const QStringList &urls,
+                   MDownloadPriority priority = kDownloadInteractive) :
+        m_urls(urls), m_priority(priority), m_ok(0)
+    {
+    }
+
+    void run(void)
+    {
+        for (int i = 0; i < m_urls.size(); ++i)
+        {
+            QByteArray data;
+            if (GetMythDownloadManager()->download(m_urls[i], &data, false,
+                                                   m_priority))
+            {
+                m_data.append(data);
+                m_ok++;
+            }
+        }
+    }
+
+    QStringList        m_urls;
+    MDownloadPriority  m_priority;
+    QList<QByteArray>  m_data;
+    int                m_ok;
+};
+
+class TestMythDownloadManager: public QObject
+{
+    Q_OBJECT
+
+    static const int kLatency = 50;       // ms per request
+    static const int kSize    = 64 * 1024;
+
+    QTemporaryDir      m_confDir;
+    QThread           *m_serverThread;
+    StandInHttpServer *m_server;
+    quint16            m_port;
+
+    QString Url(const QString &path)
+    {
+        return QString("http://127.0.0.1:%1%2").arg(m_port).arg(path);
+    }
+
+    /// Starts the threads, one list of URLs each
+    void StartThreads(const QList<QStringList> &lists,
+                      QList<DownloadThread*> &threads,
+                      MDownloadPriority priority = kDownloadInteractive)
+    {
+        int first = threads.size();
+        for (int i = 0; i < lists.size(); ++i)
+            threads.append(new DownloadThread(lists[i], priority));
+        for (int i = first; i < threads.size(); ++i)
+            threads[i]->start();
+    }
+
+    void WaitThreads(QList<DownloadThread*> &threads)
+    {
+        for (int i = 0; i < threads.size(); ++i)
+            threads[i]->wait();
+    }
+
+    /// Runs the threads, one list of URLs each, and waits for them
+    void RunThreads(const QList<QStringList> &lists,
+                    QList<DownloadThread*> &threads)
+    {
+        StartThreads(lists, threads);
+        WaitThreads(threads);
+    }
+
+    void HoldResponses(bool hold)
+    {
+        QMetaObject::invokeMethod(m_server, hold ? "Hold" : "Release",
+                                  Qt::BlockingQueuedConnection);
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        // Keep the download cache out of the real configuration
+        QVERIFY(m_confDir.isValid());
+        qputenv("MYTHCONFDIR", m_confDir.path().toLocal8Bit());
+
+        gCoreContext = new MythCoreContext("bin_version", NULL);
+
+        m_serverThread = new QThread();
+        m_server = new StandInHttpServer(kLatency, kSize);
+        m_server->moveToThread(m_serverThread);
+        m_serverThread->start();
+        QMetaObject::invokeMethod(m_server, "Start",
+                                  Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(quint16, m_port));
+        QVERIFY(m_port != 0);
+
+        QVERIFY(GetMythDownloadManager() != NULL);
+    }
+
+    // called at the end of these sets of tests
+    void cleanupTestCase(void)
+    {
+        ShutdownMythDownloadManager();
+
+        QMetaObject::invokeMethod(m_server, "Stop",
+                                  Qt::BlockingQueuedConnection);
+        m_serverThread->quit();
+        m_serverThread->wait();
+        delete m_server;
+        delete m_serverThread;
+
+        delete gCoreContext;
+        gCoreContext = NULL;
+    }
+
+    // called before each test case
+    void init(void)
+    {
+        m_server->ResetCounts();
+    }
+
+    // called after each test case
+    void cleanup(void)
+    {
+        // Never leave a failed test's downloads hanging
+        HoldResponses(false);
+    }
+
+    void download_returns_data(void)
+    {
+        QByteArray data;
+        QVERIFY(GetMythDownloadManager()->download(Url("/single"), &data));
+        QCOMPARE(data, m_server->Body("/single"));
+    }
+
+    void identical_urls_share_one_request(void)
+    {
+        HoldResponses(true);
+
+        QList<QStringList> lists;
+        for (int i = 0; i < 8; ++i)
+            lists.append(QStringList(Url("/shared")));
+
+        QList<DownloadThread*> threads;
+        StartThreads(lists, threads);
+
+        // Give every thread ample time to ask while the first request
+        // is still unanswered
+        QTRY_COMPARE(m_server->Requests("/shared"), 1);
+        QTest::qWait(1000);
+        HoldResponses(false);
+
+        WaitThreads(threads);
+        for (int i = 0; i < threads.size(); ++i)
+        {
+            QCOMPARE(threads[i]->m_ok, 1);
+            QCOMPARE(threads[i]->m_data[0], m_server->Body("/shared"));
+        }
+        qDeleteAll(threads);
+
+        QCOMPARE(m_server->Requests("/shared"), 1);
+    }
+
+    void downloads_per_host_are_limited(void)
+    {
+        QList<QStringList> lists;
+        for (int i = 0; i < 12; ++i)
+            lists.append(QStringList(Url(QString("/limit%1").arg(i))));
+
+        QList<DownloadThread*> threads;
+        RunThreads(lists, threads);
+
+        for (int i = 0; i < threads.size(); ++i)
+            QCOMPARE(threads[i]->m_ok, 1);
+        qDeleteAll(threads);
+
+        QVERIFY(m_server->MaxActive() > 1);
+        QVERIFY(m_server->MaxActive() <= 4);
+    }
+
+    void interactive_downloads_go_first(void)
+    {
+        HoldResponses(true);
+
+        QList<QStringList> lists;
+        for (int i = 0; i < 24; ++i)
+            lists << QStringList(Url(QString("/background%1").arg(i)));
+
+        QList<DownloadThread*> threads;
+        StartThreads(lists, threads, kDownloadBackground);
+
+        // The background downloads take what they may of the host, the
+        // rest of them wait in the queue
+        QTRY_COMPARE(m_server->Active(), kBackgroundPerHost);
+
+        // and the interactive one is sent while none of them is answered
+        StartThreads(QList<QStringList>() << QStringList(Url("/interactive")),
+                     threads);
+        QTRY_COMPARE(m_server->Requests("/interactive"), 1);
+        QCOMPARE(m_server->Active(), kBackgroundPerHost + 1);
+
+        HoldResponses(false);
+
+        WaitThreads(threads);
+        for (int i = 0; i < threads.size(); ++i)
+            QCOMPARE(threads[i]->m_ok, 1);
+        qDeleteAll(threads);
+    }
+
+    void sequential_download_benchmark_data(void)
+    {
+        QTest::addColumn<int>("count");
+        QTest::newRow("8 files")  << 8;
+        QTest::newRow("32 files") << 32;
+    }
+
+    /// One file after another, like the artwork of a library refresh
+    void sequential_download_benchmark(void)
+    {
+        QFETCH(int, count);
+
+        static int run = 0;
+        QBENCHMARK
+        {
+            QStringList urls;
+            for (int i = 0; i < count; ++i)
+                urls << Url(QString("/seq%1-%2").arg(run).arg(i));
+            run++;
+
+            QList<DownloadThread*> threads;
+            RunThreads(QList<QStringList>() << urls, threads);
+            QCOMPARE(threads[0]->m_ok, count);
+            qDeleteAll(threads);
+        }
+    }
+
+    void parallel_download_benchmark_data(void)
+    {
+        QTest::addColumn<int>("count");
+        QTest::newRow("8 files")  << 8;
+        QTest::newRow("32 files") << 32;
+    }
+
+    /// Many callers at once, like several lookups in flight
+    void parallel_download_benchmark(void)
+    {
+        QFETCH(int, count);
+
+        static int run = 0;
+        QBENCHMARK
+        {
+            QList<QStringList> lists;
+            for (int i = 0; i < count; ++i)
+                lists << QStringList(Url(QString("/par%1-%2").arg(run).arg(i)));
+            run++;
+
+            QList<DownloadThread*> threads;
+            RunThreads(lists, threads);
+            for (int i = 0; i < threads.size(); ++i)
+                QCOMPARE(threads[i]->m_ok, 1);
+            qDeleteAll(threads);
+        }
+    }
+};
@@ -0,0 +1,174 @@
+/*
+ *  Class TestMythSocket
+ *
+ *  Copyright (C) MythTV Developers
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "mythcorecontext.h"
+#include "mythsocket.h"
+
+/** \class Queuer
+ *  \brief Queues string lists from the socket thread.
+ *
+ *   The queue is only written once control returns to the socket
+ *   thread's event loop, so everything queued in one Queue() call is
+ *   waiting together, as when a client falls behind.
+ */
+class Queuer : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit Queuer(MythSocket *socket) : m_socket(socket) {}
+
+    void Add(const QStringList &list, const QString &key = QString())
+    {
+        m_lists.append(QPair<QString,QByteArray>(
+                           key, MythSocket::EncodeStringList(list)));
+    }
+
+  public slots:
+    void Queue(void)
+    {
+        for (int i = 0; i < m_lists.size(); i++)
+            m_socket->QueueStringList(m_lists[i].second, m_lists[i].first);
+        m_lists.clear();
+    }
+
+  private:
+    MythSocket *m_socket;
+    QList<QPair<QString,QByteArray> > m_lists;
+};
+
+class TestMythSocket: public QObject
+{
+    Q_OBJECT
+
+    QTcpServer  *m_server;
+    MythSocket  *m_socket;
+    QTcpSocket  *m_client;
+
+    static QByteArray Read(QTcpSocket *sock, int len)
+    {
+        QByteArray data;
+        while (data.size() < len)
+        {
+            if (!sock->bytesAvailable() && !sock->waitForReadyRead(10000))
+                return QByteArray();
+            data += sock->read(len - data.size());
+        }
+        return data;
+    }
+
+    /// Reads a string list the way MythSocket::ReadStringList() does
+    QStringList ReadStringList(void)
+    {
+        QByteArray size = Read(m_client, 8);
+        if (size.isEmpty())
+            return QStringList();
+        QByteArray payload = Read(m_client, size.trimmed().toInt());
+        return QString::fromUtf8(payload).split("[]:[]");
+    }
+
+    void Queue(Queuer *queuer)
+    {
+        queuer->moveToThread(m_socket->thread());
+        QMetaObject::invokeMethod(queuer, "Queue",
+                                  Qt::BlockingQueuedConnection);
+        queuer->deleteLater();
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        gCoreContext = new MythCoreContext("bin_version", NULL);
+    }
+
+    // called at the end of these sets of tests
+    void cleanupTestCase(void)
+    {
+        delete gCoreContext;
+        gCoreContext = NULL;
+    }
+
+    // called before each test case
+    void init(void)
+    {
+        m_server = new QTcpServer();
+        QVERIFY(m_server->listen(QHostAddress::LocalHost));
+
+        m_socket = new MythSocket();
+        QVERIFY(m_socket->ConnectToHost(QHostAddress(QHostAddress::LocalHost),
+                                        m_server->serverPort()));
+        QVERIFY(m_server->waitForNewConnection(5000));
+        m_client = m_server->nextPendingConnection();
+        QVERIFY(m_client);
+    }
+
+    // called after each test case
+    void cleanup(void)
+    {
+        m_socket->DecrRef();
+        m_socket = NULL;
+        delete m_server; // also deletes m_client
+        m_server = NULL;
+        m_client = NULL;
+    }
+
+    /// A newer event with the same key takes the place of the old one
+    /// instead of going behind the events queued in between.
+    void superseded_list_keeps_its_place(void)
+    {
+        Queuer *queuer = new Queuer(m_socket);
+        queuer->Add(QStringList("BACKEND_MESSAGE") << "UPDATE 1", "update");
+        queuer->Add(QStringList("BACKEND_MESSAGE") << "OTHER");
+        queuer->Add(QStringList("BACKEND_MESSAGE") << "UPDATE 2", "update");
+        queuer->Add(QStringList("BACKEND_MESSAGE") << "LAST");
+        Queue(queuer);
+
+        QCOMPARE(ReadStringList(), QStringList("BACKEND_MESSAGE") << "UPDATE 2");
+        QCOMPARE(ReadStringList(), QStringList("BACKEND_MESSAGE") << "OTHER");
+        QCOMPARE(ReadStringList(), QStringList("BACKEND_MESSAGE") << "LAST");
+    }
+
+    /// A queue many times larger than what is written at once has to be
+    /// resumed each time the client has read some of it.
+    void large_queue_is_drained(void)
+    {
+        const int kLists = 64;
+        const QString padding(64 * 1024, 'x');
+
+        Queuer *queuer = new Queuer(m_socket);
+        for (int i = 0; i < kLists; i++)
+            queuer->Add(QStringList("BACKEND_MESSAGE") << QString::number(i)
+                                                      << padding);
+        Queue(queuer);
+
+        for (int i = 0; i < kLists; i++)
+        {
+            QStringList list = ReadStringList();
+            QCOMPARE(list.size(), 3);
+            QCOMPARE(list[1], QString::number(i));
+            QCOMPARE(list[2].size(), padding.size());
+        }
+    }
+};
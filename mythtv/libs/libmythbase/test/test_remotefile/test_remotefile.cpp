@@ -0,0 +1,3 @@
+#include "test_remotefile.h"
+
+QTEST_GUILESS_MAIN(TestRemoteFile)
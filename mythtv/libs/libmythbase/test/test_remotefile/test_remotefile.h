@@ -0,0 +1,310 @@
+/*
+ *  Class TestRemoteFile
+ *
+ *  Copyright (C) MythTV Developers
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+#include <QTcpServer>
+#include <QThread>
+#include <QMutex>
+
+#include "mythcorecontext.h"
+#include "mythversion.h"
+#include "mythsocket.h"
+#include "mythqtcompat.h"
+#include "remotefile.h"
+
+/** \class StandInBackend
+ *  \brief Serves one file the way mythbackend streams it to RemoteFile.
+ *
+ *   Like MainServer it reads a single request for each readyRead, so a
+ *   request sent before the previous one was answered is left unread.
+ *   Those are counted, a client must never send them.
+ */
+class StandInBackend : public QTcpServer, public MythSocketCBs
+{
+    Q_OBJECT
+
+  public:
+    explicit StandInBackend(const QByteArray &file) :
+        m_file(file), m_control(NULL), m_data(NULL), m_streaming(false),
+        m_pos(0), m_sent(0), m_limit(0), m_pipelined(0), m_credits(0)
+    {
+    }
+
+    int Pipelined(void)
+    {
+        QMutexLocker locker(&m_lock);
+        return m_pipelined;
+    }
+
+    int Credits(void)
+    {
+        QMutexLocker locker(&m_lock);
+        return m_credits;
+    }
+
+    void ResetCounts(void)
+    {
+        QMutexLocker locker(&m_lock);
+        m_pipelined = 0;
+        m_credits = 0;
+    }
+
+    // MythSocketCBs
+    void connected(MythSocket*) {}
+    void connectionFailed(MythSocket*) {}
+    void connectionClosed(MythSocket*) {}
+
+    void readyRead(MythSocket *sock)
+    {
+        QMutexLocker locker(&m_lock);
+
+        QStringList request;
+        if (!sock->ReadStringList(request) || request.empty())
+            return;
+        if (sock->IsDataAvailable())
+            m_pipelined++;
+
+        QStringList reply = Handle(sock, request);
+        if (!reply.empty())
+            sock->WriteStringList(reply);
+        Send();
+    }
+
+  public slots:
+    quint16 Start(void)
+    {
+        if (!listen(QHostAddress::LocalHost))
+            return 0;
+        return serverPort();
+    }
+
+    void Stop(void)
+    {
+        close();
+        QMutexLocker locker(&m_lock);
+        while (!m_sockets.empty())
+            m_sockets.takeFirst()->DecrRef();
+        m_control = m_data = NULL;
+    }
+
+  protected:
+    void incomingConnection(qt_socket_fd_t handle)
+    {
+        QMutexLocker locker(&m_lock);
+        m_sockets.append(new MythSocket(handle, this));
+    }
+
+  private:
+    QStringList Handle(MythSocket *sock, const QStringList &request)
+    {
+        QStringList tokens = request[0].split(' ', QString::SkipEmptyParts);
+
+        if (tokens[0] == "MYTH_PROTO_VERSION")
+            return QStringList("ACCEPT") << MYTH_PROTO_VERSION;
+
+        if (tokens[0] == "ANN" && tokens.size() > 1)
+        {
+            if (tokens[1] == "FileTransfer")
+            {
+                m_data = sock;
+                m_streaming = false;
+                m_pos = 0;
+                return QStringList("OK") << "1"
+                                         << QString::number(m_file.size());
+            }
+            m_control = sock;
+            return QStringList("OK");
+        }
+
+        if (tokens[0] != "QUERY_FILETRANSFER" || request.size() < 2)
+            return QStringList("ERROR");
+
+        QString command = request[1];
+        if (command == "REQUEST_STREAM")
+        {
+            m_streaming = true;
+            m_sent = 0;
+            m_limit = request[2].toLongLong();
+            return QStringList("1");
+        }
+        if (command == "STREAM_CREDIT")
+        {
+            m_credits++;
+            m_limit = qMax(m_limit, request[2].toLongLong());
+            return QStringList("OK");
+        }
+        if (command == "STREAM_STATUS")
+        {
+            return QStringList(QString::number(m_sent))
+                << QString::number(m_pos >= m_file.size());
+        }
+        if (command == "STOP_STREAM")
+        {
+            m_streaming = false;
+            return QStringList(QString::number(m_sent));
+        }
+        if (command == "SEEK")
+        {
+            // Only SEEK_SET, which is all these tests use
+            m_pos = qMin(request[2].toLongLong(), (long long)m_file.size());
+            QStringList reply(QString::number(m_pos));
+            if (m_streaming)
+                reply << QString::number(m_sent);
+            return reply;
+        }
+        if (command == "DONE")
+        {
+            m_streaming = false;
+            return QStringList("OK");
+        }
+        return QStringList("ERROR");
+    }
+
+    /// Writes the stream up to the credit the client gave
+    void Send(void)
+    {
+        while (m_streaming && m_data && m_sent < m_limit &&
+               m_pos < m_file.size())
+        {
+            int size = qMin(qMin(m_limit - m_sent,
+                                 (long long)m_file.size() - m_pos),
+                            64LL * 1024);
+            int ret = m_data->Write(m_file.constData() + m_pos, size);
+            if (ret <= 0)
+                return;
+            m_pos  += ret;
+            m_sent += ret;
+        }
+    }
+
+    QByteArray          m_file;
+
+    QMutex              m_lock;
+    QList<MythSocket*>  m_sockets;
+    MythSocket         *m_control;
+    MythSocket         *m_data;
+    bool                m_streaming;
+    long long           m_pos;
+    long long           m_sent;
+    long long           m_limit;
+    int                 m_pipelined;
+    int                 m_credits;
+};
+
+class TestRemoteFile: public QObject
+{
+    Q_OBJECT
+
+    static const int kFileSize = 8 * 1024 * 1024;
+    static const int kReadSize = 64 * 1024;
+
+    QByteArray      m_file;
+    QThread        *m_backendThread;
+    StandInBackend *m_backend;
+    quint16         m_port;
+
+    QString Url(void)
+    {
+        return QString("myth://127.0.0.1:%1/stream.mpg").arg(m_port);
+    }
+
+    /// Reads size bytes, which are compared with the file from pos
+    bool ReadAndCompare(RemoteFile &rf, long long pos, int size)
+    {
+        QByteArray data(kReadSize, 0);
+        while (size > 0)
+        {
+            int ret = rf.Read(data.data(), qMin(size, kReadSize));
+            if (ret <= 0 || data.left(ret) != m_file.mid(pos, ret))
+                return false;
+            pos  += ret;
+            size -= ret;
+        }
+        return true;
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        gCoreContext = new MythCoreContext("bin_version", NULL);
+
+        m_file.resize(kFileSize);
+        for (int i = 0; i < kFileSize; ++i)
+            m_file[i] = (char)(i % 251);
+
+        m_backendThread = new QThread();
+        m_backend = new StandInBackend(m_file);
+        m_backend->moveToThread(m_backendThread);
+        m_backendThread->start();
+        QMetaObject::invokeMethod(m_backend, "Start",
+                                  Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(quint16, m_port));
+        QVERIFY(m_port != 0);
+    }
+
+    // called at the end of these sets of tests
+    void cleanupTestCase(void)
+    {
+        QMetaObject::invokeMethod(m_backend, "Stop",
+                                  Qt::BlockingQueuedConnection);
+        m_backendThread->quit();
+        m_backendThread->wait();
+        delete m_backend;
+        delete m_backendThread;
+
+        delete gCoreContext;
+        gCoreContext = NULL;
+    }
+
+    // called before each test case
+    void init(void)
+    {
+        m_backend->ResetCounts();
+    }
+
+    /// Reading the whole file gives credit several times, each has to be
+    /// answered before the next request goes out.
+    void stream_credit_is_not_pipelined(void)
+    {
+        RemoteFile rf(Url(), false, true, 2000);
+        QVERIFY(rf.isOpen());
+
+        QVERIFY(ReadAndCompare(rf, 0, kFileSize));
+        QVERIFY(m_backend->Credits() > 1);
+        QCOMPARE(m_backend->Pipelined(), 0);
+    }
+
+    /// A seek right after credit was given, then credit again for the
+    /// stream after the seek.
+    void seek_after_stream_credit(void)
+    {
+        RemoteFile rf(Url(), false, true, 2000);
+        QVERIFY(rf.isOpen());
+
+        QVERIFY(ReadAndCompare(rf, 0, 3 * 1024 * 1024));
+        QVERIFY(m_backend->Credits() > 0);
+
+        QCOMPARE(rf.Seek(1000, SEEK_SET), 1000LL);
+        QVERIFY(ReadAndCompare(rf, 1000, 4 * 1024 * 1024));
+
+        QCOMPARE(m_backend->Pipelined(), 0);
+    }
+};
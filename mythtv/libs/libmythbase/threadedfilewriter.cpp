@@ -68,6 +68,7 @@ ThreadedFileWriter::ThreadedFileWriter(const QString &fname,
     flush(false),                        in_dtor(false),
     ignore_writes(false),                tfw_min_write_size(kMinWriteSize),
     totalBufferUse(0),
+    m_bufferUse(0),                      m_writeLatency(0),
     // threads
     writeThread(NULL),                   syncThread(NULL),
     m_warned(false),                     m_blocking(false),
@@ -283,6 +284,7 @@ uint ThreadedFileWriter::Write(const void *data, uint count)
         }
 
         totalBufferUse += towrite;
+        m_bufferUse.store(totalBufferUse);
 
         const char *cdata = (const char*) data + written;
         buf->data.insert(buf->data.end(), cdata, cdata+towrite);
@@ -491,6 +493,7 @@ void ThreadedFileWriter::DiskLoop(void)
         TFWBuffer *buf = writeBuffers.front();
         writeBuffers.pop_front();
         totalBufferUse -= buf->data.size();
+        m_bufferUse.store(totalBufferUse);
         bufferWasFreed.wakeAll();
         minWriteTimer.start();
 
@@ -563,6 +566,8 @@ void ThreadedFileWriter::DiskLoop(void)
         buf->lastUsed = MythDate::current();
         emptyBuffers.push_back(buf);
 
+        m_writeLatency.store(writeTimer.elapsed());
+
         if (writeTimer.elapsed() > 1000)
         {
             LOG(VB_GENERAL, LOG_WARNING, LOC +
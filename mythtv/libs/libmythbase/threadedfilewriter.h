@@ -6,6 +6,7 @@
 using namespace std;
 
 #include <QWaitCondition>
+#include <QAtomicInt>
 #include <QDateTime>
 #include <QString>
 #include <QMutex>
@@ -58,6 +59,13 @@ class MBASE_PUBLIC ThreadedFileWriter
     void Flush(void);
     bool SetBlocking(bool block = true);
 
+    /// Bytes waiting to be written, readable without locking
+    uint GetBufferUse(void) const { return m_bufferUse.load(); }
+    /// Largest amount that may be buffered before writes are dropped
+    uint GetBufferSize(void) const { return kMaxBufferSize; }
+    /// Duration of the last write to the file in ms, readable without locking
+    uint GetWriteLatency(void) const { return m_writeLatency.load(); }
+
   protected:
     void DiskLoop(void);
     void SyncLoop(void);
@@ -76,6 +84,8 @@ class MBASE_PUBLIC ThreadedFileWriter
     bool            ignore_writes;      // protected by buflock
     uint            tfw_min_write_size; // protected by buflock
     uint            totalBufferUse;     // protected by buflock
+    QAtomicInt      m_bufferUse;        // copy of totalBufferUse
+    QAtomicInt      m_writeLatency;
 
     // buffers
     class TFWBuffer
@@ -170,7 +170,9 @@ void MetadataImageDownload::run()
                         QString("Metadata Image Download: %1 ->%2")
                          .arg(oldurl).arg(finalfile));
                     QByteArray download;
-                    GetMythDownloadManager()->download(oldurl, &download);
+                    // Leave the network to interactive downloads first
+                    GetMythDownloadManager()->download(oldurl, &download, false,
+                                                       kDownloadBackground);
 
                     QImage testImage;
                     bool didLoad = testImage.loadFromData(download);
@@ -242,7 +244,8 @@ void MetadataImageDownload::run()
                         QString("Metadata Image Download: %1 -> %2")
                             .arg(oldurl).arg(finalfile));
                     QByteArray download;
-                    GetMythDownloadManager()->download(oldurl, &download);
+                    GetMythDownloadManager()->download(oldurl, &download, false,
+                                                       kDownloadBackground);
 
                     QImage testImage;
                     bool didLoad = testImage.loadFromData(download);
@@ -0,0 +1,68 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: pidCount.h
+// Created     : Oct. 19, 2026
+//
+// Copyright (c) 2026 team MythTV
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef PIDCOUNT_H_
+#define PIDCOUNT_H_
+
+#include "serviceexp.h"
+#include "datacontracthelper.h"
+
+namespace DTC
+{
+
+class SERVICE_PUBLIC PIDCount : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO( "version"    , "1.0" );
+
+    Q_PROPERTY( uint      PID     READ PID     WRITE setPID     )
+    Q_PROPERTY( qlonglong Packets READ Packets WRITE setPackets )
+
+    PROPERTYIMP    ( uint       , PID     )
+    PROPERTYIMP    ( qlonglong  , Packets )
+
+    public:
+
+        static inline void InitializeCustomTypes();
+
+    public:
+
+        PIDCount(QObject *parent = 0)
+            : QObject( parent ), m_PID(0), m_Packets(0)
+        {
+        }
+
+        PIDCount( const PIDCount &src )
+        {
+            Copy( src );
+        }
+
+        void Copy( const PIDCount &src )
+        {
+            m_PID           = src.m_PID     ;
+            m_Packets       = src.m_Packets ;
+        }
+};
+
+} // namespace DTC
+
+Q_DECLARE_METATYPE( DTC::PIDCount  )
+Q_DECLARE_METATYPE( DTC::PIDCount* )
+
+namespace DTC
+{
+inline void PIDCount::InitializeCustomTypes()
+{
+    qRegisterMetaType< PIDCount  >();
+    qRegisterMetaType< PIDCount* >();
+}
+}
+
+#endif
@@ -0,0 +1,159 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: recorderMetrics.h
+// Created     : Oct. 19, 2026
+//
+// Copyright (c) 2026 team MythTV
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef RECORDERMETRICS_H_
+#define RECORDERMETRICS_H_
+
+#include <QDateTime>
+#include <QString>
+#include <QVariantList>
+
+#include "serviceexp.h"
+#include "datacontracthelper.h"
+
+#include "pidCount.h"
+
+namespace DTC
+{
+
+/////////////////////////////////////////////////////////////////////////////
+
+class SERVICE_PUBLIC RecorderMetrics : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO( "version"    , "1.0" );
+
+    // Q_CLASSINFO Used to augment Metadata for properties.
+    // See datacontracthelper.h for details
+
+    Q_CLASSINFO( "PIDCounts", "type=DTC::PIDCount");
+
+    Q_PROPERTY( uint         InputId          READ InputId          WRITE setInputId          )
+    Q_PROPERTY( QString      Device           READ Device           WRITE setDevice           )
+    Q_PROPERTY( uint         ChanId           READ ChanId           WRITE setChanId           )
+    Q_PROPERTY( QDateTime    StartTs          READ StartTs          WRITE setStartTs          )
+    Q_PROPERTY( QDateTime    Updated          READ Updated          WRITE setUpdated          )
+    Q_PROPERTY( qlonglong    BytesIn          READ BytesIn          WRITE setBytesIn          )
+    Q_PROPERTY( qlonglong    BytesOut         READ BytesOut         WRITE setBytesOut         )
+    Q_PROPERTY( qlonglong    Packets          READ Packets          WRITE setPackets          )
+    Q_PROPERTY( qlonglong    ContinuityErrors READ ContinuityErrors WRITE setContinuityErrors )
+    Q_PROPERTY( qlonglong    Keyframes        READ Keyframes        WRITE setKeyframes        )
+    Q_PROPERTY( qlonglong    FramesWritten    READ FramesWritten    WRITE setFramesWritten    )
+    Q_PROPERTY( uint         WriteBufferUse   READ WriteBufferUse   WRITE setWriteBufferUse   )
+    Q_PROPERTY( uint         WriteBufferSize  READ WriteBufferSize  WRITE setWriteBufferSize  )
+    Q_PROPERTY( uint         WriteLatency     READ WriteLatency     WRITE setWriteLatency     )
+    Q_PROPERTY( uint         MaxWriteLatency  READ MaxWriteLatency  WRITE setMaxWriteLatency  )
+    Q_PROPERTY( uint         ReadBufferUse    READ ReadBufferUse    WRITE setReadBufferUse    )
+    Q_PROPERTY( uint         ReadBufferSize   READ ReadBufferSize   WRITE setReadBufferSize   )
+
+    Q_PROPERTY( QVariantList PIDCounts READ PIDCounts DESIGNABLE true )
+
+    PROPERTYIMP    ( uint       , InputId          )
+    PROPERTYIMP    ( QString    , Device           )
+    PROPERTYIMP    ( uint       , ChanId           )
+    PROPERTYIMP    ( QDateTime  , StartTs          )
+    PROPERTYIMP    ( QDateTime  , Updated          )
+    PROPERTYIMP    ( qlonglong  , BytesIn          )
+    PROPERTYIMP    ( qlonglong  , BytesOut         )
+    PROPERTYIMP    ( qlonglong  , Packets          )
+    PROPERTYIMP    ( qlonglong  , ContinuityErrors )
+    PROPERTYIMP    ( qlonglong  , Keyframes        )
+    PROPERTYIMP    ( qlonglong  , FramesWritten    )
+    PROPERTYIMP    ( uint       , WriteBufferUse   )
+    PROPERTYIMP    ( uint       , WriteBufferSize  )
+    PROPERTYIMP    ( uint       , WriteLatency     )
+    PROPERTYIMP    ( uint       , MaxWriteLatency  )
+    PROPERTYIMP    ( uint       , ReadBufferUse    )
+    PROPERTYIMP    ( uint       , ReadBufferSize   )
+
+    PROPERTYIMP_RO_REF( QVariantList, PIDCounts )
+
+    public:
+
+        static inline void InitializeCustomTypes();
+
+    public:
+
+        RecorderMetrics(QObject *parent = 0)
+            : QObject            ( parent ),
+              m_InputId          ( 0      ),
+              m_ChanId           ( 0      ),
+              m_BytesIn          ( 0      ),
+              m_BytesOut         ( 0      ),
+              m_Packets          ( 0      ),
+              m_ContinuityErrors ( 0      ),
+              m_Keyframes        ( 0      ),
+              m_FramesWritten    ( 0      ),
+              m_WriteBufferUse   ( 0      ),
+              m_WriteBufferSize  ( 0      ),
+              m_WriteLatency     ( 0      ),
+              m_MaxWriteLatency  ( 0      ),
+              m_ReadBufferUse    ( 0      ),
+              m_ReadBufferSize   ( 0      )
+        {
+        }
+
+        RecorderMetrics( const RecorderMetrics &src )
+        {
+            Copy( src );
+        }
+
+        void Copy( const RecorderMetrics &src )
+        {
+            m_InputId          = src.m_InputId          ;
+            m_Device           = src.m_Device           ;
+            m_ChanId           = src.m_ChanId           ;
+            m_StartTs          = src.m_StartTs          ;
+            m_Updated          = src.m_Updated          ;
+            m_BytesIn          = src.m_BytesIn          ;
+            m_BytesOut         = src.m_BytesOut         ;
+            m_Packets          = src.m_Packets          ;
+            m_ContinuityErrors = src.m_ContinuityErrors ;
+            m_Keyframes        = src.m_Keyframes        ;
+            m_FramesWritten    = src.m_FramesWritten    ;
+            m_WriteBufferUse   = src.m_WriteBufferUse   ;
+            m_WriteBufferSize  = src.m_WriteBufferSize  ;
+            m_WriteLatency     = src.m_WriteLatency     ;
+            m_MaxWriteLatency  = src.m_MaxWriteLatency  ;
+            m_ReadBufferUse    = src.m_ReadBufferUse    ;
+            m_ReadBufferSize   = src.m_ReadBufferSize   ;
+
+            CopyListContents< PIDCount >( this, m_PIDCounts, src.m_PIDCounts );
+        }
+
+        PIDCount *AddNewPIDCount()
+        {
+            // We must make sure the object added to the QVariantList has
+            // a parent of 'this'
+
+            PIDCount *pObject = new PIDCount( this );
+            m_PIDCounts.append( QVariant::fromValue<QObject *>( pObject ));
+
+            return pObject;
+        }
+};
+
+} // namespace DTC
+
+Q_DECLARE_METATYPE( DTC::RecorderMetrics  )
+Q_DECLARE_METATYPE( DTC::RecorderMetrics* )
+
+namespace DTC
+{
+inline void RecorderMetrics::InitializeCustomTypes()
+{
+    qRegisterMetaType< RecorderMetrics  >();
+    qRegisterMetaType< RecorderMetrics* >();
+
+    PIDCount::InitializeCustomTypes();
+}
+}
+
+#endif
@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: recorderMetricsList.h
+// Created     : Oct. 19, 2026
+//
+// Copyright (c) 2026 team MythTV
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef RECORDERMETRICSLIST_H_
+#define RECORDERMETRICSLIST_H_
+
+#include <QVariantList>
+
+#include "serviceexp.h"
+#include "datacontracthelper.h"
+
+#include "recorderMetrics.h"
+
+namespace DTC
+{
+
+class SERVICE_PUBLIC RecorderMetricsList : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO( "version", "1.0" );
+
+    // Q_CLASSINFO Used to augment Metadata for properties.
+    // See datacontracthelper.h for details
+
+    Q_CLASSINFO( "Recorders", "type=DTC::RecorderMetrics");
+
+    Q_PROPERTY( QVariantList Recorders READ Recorders DESIGNABLE true )
+
+    PROPERTYIMP_RO_REF( QVariantList, Recorders )
+
+    public:
+
+        static inline void InitializeCustomTypes();
+
+    public:
+
+        RecorderMetricsList(QObject *parent = 0)
+            : QObject( parent )
+        {
+        }
+
+        RecorderMetricsList( const RecorderMetricsList &src )
+        {
+            Copy( src );
+        }
+
+        void Copy( const RecorderMetricsList &src )
+        {
+            CopyListContents< RecorderMetrics >( this, m_Recorders, src.m_Recorders );
+        }
+
+        RecorderMetrics *AddNewRecorderMetrics()
+        {
+            // We must make sure the object added to the QVariantList has
+            // a parent of 'this'
+
+            RecorderMetrics *pObject = new RecorderMetrics( this );
+            m_Recorders.append( QVariant::fromValue<QObject *>( pObject ));
+
+            return pObject;
+        }
+
+};
+
+} // namespace DTC
+
+Q_DECLARE_METATYPE( DTC::RecorderMetricsList  )
+Q_DECLARE_METATYPE( DTC::RecorderMetricsList* )
+
+namespace DTC
+{
+inline void RecorderMetricsList::InitializeCustomTypes()
+{
+    qRegisterMetaType< RecorderMetricsList  >();
+    qRegisterMetaType< RecorderMetricsList* >();
+
+    RecorderMetrics::InitializeCustomTypes();
+}
+}
+
+#endif
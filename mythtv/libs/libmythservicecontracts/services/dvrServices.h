@@ -25,6 +25,7 @@
 #include "datacontracts/input.h"
 #include "datacontracts/inputList.h"
 #include "datacontracts/cutList.h"
+#include "datacontracts/recorderMetricsList.h"
 
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
@@ -45,7 +46,7 @@
 class SERVICE_PUBLIC DvrServices : public Service  //, public QScriptable ???
 {
     Q_OBJECT
-    Q_CLASSINFO( "version"    , "6.1" );
+    Q_CLASSINFO( "version"    , "6.2" );
     Q_CLASSINFO( "RemoveRecorded_Method",                       "POST" )
     Q_CLASSINFO( "DeleteRecording_Method",                      "POST" )
     Q_CLASSINFO( "UnDeleteRecording",                           "POST" )
@@ -72,6 +73,7 @@ class SERVICE_PUBLIC DvrServices : public Service  //, public QScriptable ???
             DTC::TitleInfoList::InitializeCustomTypes();
             DTC::RecRuleFilterList::InitializeCustomTypes();
             DTC::CutList::InitializeCustomTypes();
+            DTC::RecorderMetricsList::InitializeCustomTypes();
         }
 
     public slots:
@@ -135,6 +137,8 @@ class SERVICE_PUBLIC DvrServices : public Service  //, public QScriptable ???
 
         virtual DTC::InputList*    GetInputList          ( ) = 0;
 
+        virtual DTC::RecorderMetricsList* GetRecorderMetricsList ( int InputId ) = 0;
+
         virtual QStringList        GetRecGroupList       ( ) = 0;
 
         virtual QStringList        GetRecStorageGroupList ( ) = 0;
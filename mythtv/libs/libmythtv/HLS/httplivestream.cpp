@@ -42,6 +42,7 @@
 #include "mythlogging.h"
 #include "storagegroup.h"
 #include "httplivestream.h"
+#include "httplivestreamremuxer.h"
 
 #define LOC QString("HLS(%1): ").arg(m_sourceFile)
 #define LOC_ERR QString("HLS(%1) Error: ").arg(m_sourceFile)
@@ -822,6 +823,9 @@ DTC::LiveStreamInfo *HTTPLiveStream::StartStream(void)
     if (GetDBStatus() != kHLSStatusQueued)
         return GetLiveStreamInfo();
 
+    if (StartRemux())
+        return GetLiveStreamInfo();
+
     HTTPLiveStreamThread *streamThread =
         new HTTPLiveStreamThread(GetStreamID());
     MThreadPool::globalInstance()->startReserved(streamThread,
@@ -843,6 +847,86 @@ DTC::LiveStreamInfo *HTTPLiveStream::StartStream(void)
     return GetLiveStreamInfo();
 }
 
+/** \fn HTTPLiveStream::StartRemux(void)
+ *  \brief Sets up the stream to be served straight from the recording
+ *
+ *  If the recording already uses codecs HLS clients can play and its
+ *  bitrate fits the requested one, the playlist is written immediately
+ *  and the segments are cut from the recording on demand by the backend,
+ *  see HTTPLiveStreamRemuxer.  Otherwise nothing is done and the stream
+ *  has to be transcoded.
+ *
+ *  \return true if the stream is being remuxed
+ */
+bool HTTPLiveStream::StartRemux(void)
+{
+    if (!gCoreContext->GetNumSetting("HTTPLiveStreamRemux", 1))
+        return false;
+
+    HTTPLiveStreamRemuxer remuxer(m_sourceFile, m_segmentSize);
+    QString reason = "no seek table or stream info";
+
+    if (!remuxer.Init() ||
+        !remuxer.CanRemux(m_bitrate + m_audioBitrate, reason))
+    {
+        LOG(VB_RECORD, LOG_INFO, LOC +
+            QString("Transcoding, unable to remux: %1").arg(reason));
+        return false;
+    }
+
+    QSize size = remuxer.GetVideoSize();
+    if (size.isValid() &&
+        !UpdateSizeInfo(size.width(), size.height(),
+                        size.width(), size.height()))
+        return false;
+
+    // The audio only variant still needs a transcode, so leave it out
+    uint32_t audioOnlyBitrate = m_audioOnlyBitrate;
+    m_audioOnlyBitrate = 0;
+    bool ok = InitForWrite();
+    m_audioOnlyBitrate = audioOnlyBitrate;
+    m_writing = false;
+
+    if (!ok)
+        return false;
+
+    QString outFile = GetPlaylistName();
+    QString tmpFile = outFile + ".tmp";
+    QFile file(tmpFile);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        LOG(VB_RECORD, LOG_ERR, QString("Error opening %1").arg(tmpFile));
+        return false;
+    }
+
+    QString segmentURL =
+        QString("/HLSRemux/GetSegment?StreamId=%1&Segment=").arg(m_streamid);
+    file.write(remuxer.GetPlaylist(segmentURL + "%1"));
+    file.close();
+
+    if (rename(tmpFile.toLatin1().constData(),
+               outFile.toLatin1().constData()) == -1)
+    {
+        LOG(VB_RECORD, LOG_ERR, LOC +
+            QString("Error renaming %1 to %2").arg(tmpFile).arg(outFile) + ENO);
+        return false;
+    }
+
+    m_startSegment = 1;
+    m_curSegment   = remuxer.GetSegmentCount();
+    m_segmentCount = remuxer.GetSegmentCount();
+
+    LOG(VB_RECORD, LOG_INFO, LOC +
+        QString("Remuxing %1 segments without transcoding")
+            .arg(m_segmentCount));
+
+    return SaveSegmentInfo() &&
+           UpdatePercentComplete(100) &&
+           UpdateStatusMessage("Remuxed, segments are served on demand") &&
+           UpdateStatus(kHLSStatusCompleted);
+}
+
 bool HTTPLiveStream::RemoveStream(int id)
 {
     MSqlQuery query(MSqlQuery::InitCon());
@@ -872,13 +956,16 @@ bool HTTPLiveStream::RemoveStream(int id)
     {
         thisFile = hls->GetFilename(startSegment + x);
 
-        if (!thisFile.isEmpty() && !QFile::remove(thisFile))
+        // Remuxed streams have no segment files
+        if (!thisFile.isEmpty() && QFile::exists(thisFile) &&
+            !QFile::remove(thisFile))
             LOG(VB_GENERAL, LOG_ERR, SLOC +
                 QString("Unable to delete %1.").arg(thisFile));
 
         thisFile = hls->GetFilename(startSegment + x, false, true);
 
-        if (!thisFile.isEmpty() && !QFile::remove(thisFile))
+        if (!thisFile.isEmpty() && QFile::exists(thisFile) &&
+            !QFile::remove(thisFile))
             LOG(VB_GENERAL, LOG_ERR, SLOC +
                 QString("Unable to delete %1.").arg(thisFile));
     }
@@ -894,7 +981,8 @@ bool HTTPLiveStream::RemoveStream(int id)
             QString("Unable to delete %1.").arg(thisFile));
 
     thisFile = hls->GetPlaylistName(true);
-    if (!thisFile.isEmpty() && !QFile::remove(thisFile))
+    if (!thisFile.isEmpty() && QFile::exists(thisFile) &&
+        !QFile::remove(thisFile))
         LOG(VB_GENERAL, LOG_ERR, SLOC +
             QString("Unable to delete %1.").arg(thisFile));
 
@@ -911,6 +999,8 @@ bool HTTPLiveStream::RemoveStream(int id)
     if (!query.exec())
         LOG(VB_RECORD, LOG_ERR, "Error deleting stream info in RemoveStream");
 
+    HTTPLiveStreamRemuxer::ClearCache(hls->GetSourceFile());
+
     delete hls;
     return true;
 }
@@ -72,6 +72,8 @@ class MTV_PUBLIC HTTPLiveStream
 
     bool CheckStop(void);
 
+    bool StartRemux(void);
+
            DTC::LiveStreamInfo     *StartStream(void);
     static DTC::LiveStreamInfo     *StopStream(int id);
     static bool                     RemoveStream(int id);
@@ -0,0 +1,439 @@
+/*  -*- Mode: c++ -*-
+ *
+ *   Class HTTPLiveStreamRemuxer
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+// C++ headers
+#include <algorithm>
+#include <cmath>
+
+#include <QFile>
+#include <QFileInfo>
+
+#include "mythcorecontext.h"
+#include "mythdate.h"
+#include "mythlogging.h"
+#include "programinfo.h"
+#include "recordingfile.h"
+#include "httplivestreamremuxer.h"
+
+#define LOC QString("HLSRemux(%1): ").arg(m_sourceFile)
+
+static const int kTSPacketSize = 188;
+
+/// Bytes scanned at the start of the recording for the PAT and PMT
+static const int kStreamHeaderScanSize = 4 * 1024 * 1024;
+
+QMutex                    HTTPLiveStreamRemuxer::s_cacheLock;
+QHash<QString,QByteArray> HTTPLiveStreamRemuxer::s_cache;
+QList<QString>            HTTPLiveStreamRemuxer::s_cacheOrder;
+qint64                    HTTPLiveStreamRemuxer::s_cacheBytes = 0;
+const qint64              HTTPLiveStreamRemuxer::kMaxCacheBytes =
+    64 * 1024 * 1024;
+
+HTTPLiveStreamRemuxer::HTTPLiveStreamRemuxer(const QString &sourceFile,
+                                             uint16_t segmentSize)
+  : m_sourceFile(sourceFile),
+    m_segmentSize(segmentSize ? segmentSize : 4),
+    m_recordedId(0),
+    m_sourceBitrate(0),
+    m_recordingFinished(false)
+{
+}
+
+HTTPLiveStreamRemuxer::~HTTPLiveStreamRemuxer()
+{
+}
+
+/** \fn HTTPLiveStreamRemuxer::Init(void)
+ *  \brief Loads the recording's file info and seek table and splits it
+ *         into segments.
+ *  \return true if at least one segment could be built
+ */
+bool HTTPLiveStreamRemuxer::Init(void)
+{
+    if (m_sourceFile.startsWith("myth://") || !QFile::exists(m_sourceFile))
+        return false;
+
+    ProgramInfo pginfo(m_sourceFile);
+    if (!pginfo.GetRecordingID())
+    {
+        LOG(VB_RECORD, LOG_DEBUG, LOC + "Not a recording, can not remux");
+        return false;
+    }
+
+    m_recordedId = pginfo.GetRecordingID();
+    m_recordingFinished =
+        (pginfo.GetRecordingEndTime() < MythDate::current());
+
+    RecordingFile recFile;
+    recFile.m_recordingId = m_recordedId;
+    if (!recFile.Load())
+        return false;
+
+    m_videoCodec = recFile.m_videoCodec;
+    m_audioCodec = recFile.m_audioCodec;
+    m_container  = RecordingFile::AVContainerToString(
+        recFile.m_containerFormat);
+    m_videoSize  = recFile.m_videoResolution;
+
+    if (!LoadSegmentMap(pginfo) || !LoadStreamHeader())
+    {
+        m_segments.clear();
+        return false;
+    }
+
+    uint64_t totalms = 0;
+    for (int i = 0; i < m_segments.size(); ++i)
+        totalms += m_segments[i].duration;
+
+    if (totalms)
+        m_sourceBitrate = (uint32_t)(QFileInfo(m_sourceFile).size() * 8000 /
+                                     totalms);
+
+    LOG(VB_RECORD, LOG_INFO, LOC +
+        QString("%1 segments, %2 kbps source, video %3, audio %4")
+            .arg(m_segments.size()).arg(m_sourceBitrate / 1000)
+            .arg(m_videoCodec).arg(m_audioCodec));
+
+    return true;
+}
+
+/** \fn HTTPLiveStreamRemuxer::CanRemux(uint32_t, QString&) const
+ *  \brief Returns true if the recording can be sent to HLS clients as is.
+ *
+ *  The recording must be a finished H.264 transport stream with AAC or
+ *  MP3 audio, and its bitrate must not exceed the bitrate requested by
+ *  the client.
+ *
+ *  \param bitrate Total (video and audio) bitrate requested by the client
+ *  \param reason  Set to the reason remuxing is not possible
+ */
+bool HTTPLiveStreamRemuxer::CanRemux(uint32_t bitrate, QString &reason) const
+{
+    if (m_segments.isEmpty())
+        reason = "no usable seek table";
+    else if (!m_recordingFinished)
+        reason = "recording in progress";
+    else if (m_container != "MPEG2-TS" &&
+             !m_sourceFile.endsWith(".ts", Qt::CaseInsensitive))
+        reason = QString("container '%1' is not MPEG-TS").arg(m_container);
+    else if (m_videoCodec != "H264")
+        reason = QString("video codec '%1' is not H.264").arg(m_videoCodec);
+    else if (m_audioCodec != "AAC" && m_audioCodec != "MP3")
+        reason = QString("audio codec '%1' is not AAC").arg(m_audioCodec);
+    else if (bitrate && m_sourceBitrate > bitrate)
+        reason = QString("source bitrate %1 kbps exceeds %2 kbps")
+            .arg(m_sourceBitrate / 1000).arg(bitrate / 1000);
+    else
+        return true;
+
+    return false;
+}
+
+/** \fn HTTPLiveStreamRemuxer::LoadSegmentMap(const ProgramInfo&)
+ *  \brief Groups the keyframes in the position map into segments of
+ *         roughly m_segmentSize seconds each.
+ */
+bool HTTPLiveStreamRemuxer::LoadSegmentMap(const ProgramInfo &pginfo)
+{
+    frm_pos_map_t posMap;
+    frm_pos_map_t durMap;
+    pginfo.QueryPositionMap(posMap, MARK_GOP_BYFRAME);
+    pginfo.QueryPositionMap(durMap, MARK_DURATION_MS);
+
+    if (posMap.size() < 2)
+    {
+        LOG(VB_RECORD, LOG_INFO, LOC + "No keyframe position map");
+        return false;
+    }
+
+    double fps = pginfo.QueryAverageFrameRate() / 1000.0;
+    if (fps <= 0.0)
+        fps = 25.0;
+
+    uint64_t filesize = QFileInfo(m_sourceFile).size();
+    uint64_t target   = m_segmentSize * 1000;
+    uint64_t segStart = 0;
+    uint64_t segTime  = 0;
+
+    m_segments.clear();
+
+    frm_pos_map_t::const_iterator it = posMap.begin();
+    for (; it != posMap.end(); ++it)
+    {
+        uint64_t offset = it.value() - (it.value() % kTSPacketSize);
+        uint64_t ms = durMap.contains(it.key()) ?
+            durMap[it.key()] : (uint64_t)(it.key() * 1000 / fps);
+
+        if (it == posMap.begin())
+        {
+            // Anything before the first keyframe can not be decoded
+            segStart = offset;
+            segTime  = ms;
+            continue;
+        }
+
+        if (ms >= segTime + target && offset > segStart)
+        {
+            m_segments.push_back(Segment(segStart, offset, ms - segTime));
+            segStart = offset;
+            segTime  = ms;
+        }
+    }
+
+    // The rest of the file is the last segment
+    uint64_t lastms = durMap.isEmpty() ?
+        (uint64_t)(posMap.lastKey() * 1000 / fps) : durMap.last();
+    if (filesize > segStart)
+        m_segments.push_back(
+            Segment(segStart, filesize - (filesize % kTSPacketSize),
+                    (lastms > segTime) ? lastms - segTime : target));
+
+    return !m_segments.isEmpty();
+}
+
+/** \fn HTTPLiveStreamRemuxer::LoadStreamHeader(void)
+ *  \brief Copies the first PAT and PMT packets of the recording so they
+ *         can be prepended to every segment.
+ */
+bool HTTPLiveStreamRemuxer::LoadStreamHeader(void)
+{
+    QFile file(m_sourceFile);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Unable to open recording");
+        return false;
+    }
+
+    QByteArray buf = file.read(kStreamHeaderScanSize);
+    file.close();
+
+    QByteArray pat;
+    QByteArray pmt;
+    int pmtPid = -1;
+
+    for (int pos = 0; pos + kTSPacketSize <= buf.size();
+         pos += kTSPacketSize)
+    {
+        const unsigned char *pkt =
+            reinterpret_cast<const unsigned char*>(buf.constData() + pos);
+
+        if (pkt[0] != 0x47)
+        {
+            LOG(VB_RECORD, LOG_INFO, LOC + "Recording is not packet aligned");
+            return false;
+        }
+
+        int  pid  = ((pkt[1] & 0x1f) << 8) | pkt[2];
+        bool pusi = pkt[1] & 0x40;
+
+        if (pid == 0 && pusi && pat.isEmpty())
+        {
+            int payload = 4;
+            if (pkt[3] & 0x20)
+                payload += 1 + pkt[4];
+            if (payload >= kTSPacketSize)
+                continue;
+            payload += 1 + pkt[payload];   // pointer field
+            if (payload + 12 > kTSPacketSize)
+                continue;
+
+            // First program entry that is not the NIT
+            int sectionLen = ((pkt[payload + 1] & 0x0f) << 8) |
+                pkt[payload + 2];
+            int end = std::min(payload + 3 + sectionLen - 4, kTSPacketSize);
+            for (int p = payload + 8; p + 4 <= end; p += 4)
+            {
+                if ((pkt[p] << 8 | pkt[p + 1]) != 0)
+                {
+                    pmtPid = ((pkt[p + 2] & 0x1f) << 8) | pkt[p + 3];
+                    break;
+                }
+            }
+
+            if (pmtPid >= 0)
+                pat = buf.mid(pos, kTSPacketSize);
+        }
+        else if (pmtPid >= 0 && pid == pmtPid)
+        {
+            if (pusi && !pmt.isEmpty())
+                break;
+            if (pusi || !pmt.isEmpty())
+                pmt.append(buf.mid(pos, kTSPacketSize));
+        }
+        else if (!pmt.isEmpty())
+        {
+            break;
+        }
+    }
+
+    if (pat.isEmpty() || pmt.isEmpty())
+    {
+        LOG(VB_RECORD, LOG_INFO, LOC + "Unable to find PAT and PMT");
+        return false;
+    }
+
+    m_streamHeader = pat + pmt;
+    return true;
+}
+
+/** \fn HTTPLiveStreamRemuxer::GetPlaylist(const QString&) const
+ *  \brief Returns the complete media playlist for the recording.
+ *  \param segmentURL URL of a segment with %1 in place of the segment number
+ */
+QByteArray HTTPLiveStreamRemuxer::GetPlaylist(const QString &segmentURL) const
+{
+    uint maxDuration = 0;
+    for (int i = 0; i < m_segments.size(); ++i)
+        maxDuration = std::max(maxDuration, m_segments[i].duration);
+
+    QByteArray playlist = QString(
+        "#EXTM3U\n"
+        "#EXT-X-VERSION:3\n"
+        "#EXT-X-ALLOW-CACHE:YES\n"
+        "#EXT-X-PLAYLIST-TYPE:VOD\n"
+        "#EXT-X-TARGETDURATION:%1\n"
+        "#EXT-X-MEDIA-SEQUENCE:1\n"
+        ).arg((int)ceil(maxDuration / 1000.0)).toLatin1();
+
+    for (int i = 0; i < m_segments.size(); ++i)
+    {
+        playlist += QString(
+            "#EXTINF:%1,\n"
+            "%2\n"
+            ).arg(m_segments[i].duration / 1000.0, 0, 'f', 3)
+             .arg(segmentURL.arg(i + 1)).toLatin1();
+    }
+
+    playlist += "#EXT-X-ENDLIST\n";
+
+    return playlist;
+}
+
+/** \fn HTTPLiveStreamRemuxer::GetSegment(uint, QByteArray&)
+ *  \brief Returns a segment, from the cache if possible.
+ *  \param segment Segment number, starting at 1
+ */
+bool HTTPLiveStreamRemuxer::GetSegment(uint segment, QByteArray &data)
+{
+    if (segment < 1 || segment > (uint)m_segments.size())
+        return false;
+
+    QString key = QString("%1#%2").arg(m_sourceFile).arg(segment);
+
+    if (CacheLookup(key, data))
+        return true;
+
+    if (!ReadSegment(segment, data))
+        return false;
+
+    CacheInsert(key, data);
+    return true;
+}
+
+bool HTTPLiveStreamRemuxer::ReadSegment(uint segment, QByteArray &data)
+{
+    const Segment &seg = m_segments[segment - 1];
+
+    QFile file(m_sourceFile);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(seg.startOffset))
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Unable to read segment %1").arg(segment));
+        return false;
+    }
+
+    qint64 len = seg.endOffset - seg.startOffset;
+
+    data.clear();
+    data.reserve(m_streamHeader.size() + len);
+    data.append(m_streamHeader);
+    data.append(file.read(len));
+
+    return data.size() > m_streamHeader.size();
+}
+
+bool HTTPLiveStreamRemuxer::CacheLookup(const QString &key, QByteArray &data)
+{
+    QMutexLocker locker(&s_cacheLock);
+
+    QHash<QString,QByteArray>::const_iterator it = s_cache.find(key);
+    if (it == s_cache.end())
+        return false;
+
+    data = *it;
+    s_cacheOrder.removeOne(key);
+    s_cacheOrder.append(key);
+
+    return true;
+}
+
+void HTTPLiveStreamRemuxer::CacheInsert(const QString &key,
+                                        const QByteArray &data)
+{
+    if (data.size() > kMaxCacheBytes / 4)
+        return;
+
+    QMutexLocker locker(&s_cacheLock);
+
+    if (s_cache.contains(key))
+        return;
+
+    while (!s_cacheOrder.isEmpty() &&
+           s_cacheBytes + data.size() > kMaxCacheBytes)
+    {
+        QString oldest = s_cacheOrder.takeFirst();
+        s_cacheBytes -= s_cache.take(oldest).size();
+    }
+
+    s_cache[key] = data;
+    s_cacheOrder.append(key);
+    s_cacheBytes += data.size();
+}
+
+/** \fn HTTPLiveStreamRemuxer::ClearCache(const QString&)
+ *  \brief Drops cached segments of one recording, or of all recordings
+ *         if sourceFile is empty.
+ */
+void HTTPLiveStreamRemuxer::ClearCache(const QString &sourceFile)
+{
+    QMutexLocker locker(&s_cacheLock);
+
+    if (sourceFile.isEmpty())
+    {
+        s_cache.clear();
+        s_cacheOrder.clear();
+        s_cacheBytes = 0;
+        return;
+    }
+
+    QString prefix = sourceFile + "#";
+    QList<QString>::iterator it = s_cacheOrder.begin();
+    while (it != s_cacheOrder.end())
+    {
+        if ((*it).startsWith(prefix))
+        {
+            s_cacheBytes -= s_cache.take(*it).size();
+            it = s_cacheOrder.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
@@ -0,0 +1,87 @@
+#ifndef HTTPLIVESTREAMREMUXER_H
+#define HTTPLIVESTREAMREMUXER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+#include "mythtvexp.h"
+
+class ProgramInfo;
+
+/** \class HTTPLiveStreamRemuxer
+ *  \brief Serves an existing MPEG-TS recording as HLS segments without
+ *         transcoding it.
+ *
+ *  The recording is cut at keyframes taken from its seek table, so the
+ *  segments are plain byte ranges of the original transport stream with
+ *  the PAT and PMT prepended.  This only works when the recording already
+ *  uses codecs every HLS client can play, see CanRemux().
+ *
+ *  Recently used segments are kept in a process wide LRU cache since
+ *  several clients frequently watch the same recording.
+ */
+class MTV_PUBLIC HTTPLiveStreamRemuxer
+{
+  public:
+    HTTPLiveStreamRemuxer(const QString &sourceFile, uint16_t segmentSize);
+   ~HTTPLiveStreamRemuxer();
+
+    bool Init(void);
+    bool CanRemux(uint32_t bitrate, QString &reason) const;
+
+    QString  GetSourceFile(void) const { return m_sourceFile; }
+    uint     GetSegmentCount(void) const { return m_segments.size(); }
+    QSize    GetVideoSize(void) const { return m_videoSize; }
+    uint32_t GetSourceBitrate(void) const { return m_sourceBitrate; }
+
+    QByteArray GetPlaylist(const QString &segmentURL) const;
+    bool       GetSegment(uint segment, QByteArray &data);
+
+    static void ClearCache(const QString &sourceFile = QString());
+
+  private:
+    bool LoadSegmentMap(const ProgramInfo &pginfo);
+    bool LoadStreamHeader(void);
+    bool ReadSegment(uint segment, QByteArray &data);
+
+    static bool CacheLookup(const QString &key, QByteArray &data);
+    static void CacheInsert(const QString &key, const QByteArray &data);
+
+    class Segment
+    {
+      public:
+        Segment() : startOffset(0), endOffset(0), duration(0) {}
+        Segment(uint64_t start, uint64_t end, uint ms) :
+            startOffset(start), endOffset(end), duration(ms) {}
+        uint64_t startOffset;
+        uint64_t endOffset;
+        uint     duration;   ///< in milliseconds
+    };
+
+    QString           m_sourceFile;
+    uint16_t          m_segmentSize;
+    uint              m_recordedId;
+    QString           m_videoCodec;
+    QString           m_audioCodec;
+    QString           m_container;
+    QSize             m_videoSize;
+    uint32_t          m_sourceBitrate;
+    bool              m_recordingFinished;
+    QByteArray        m_streamHeader;   ///< PAT and PMT packets
+    QVector<Segment>  m_segments;
+
+    static QMutex                    s_cacheLock;
+    static QHash<QString,QByteArray> s_cache;
+    static QList<QString>            s_cacheOrder;
+    static qint64                    s_cacheBytes;
+    static const qint64              kMaxCacheBytes;
+};
+
+#endif
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
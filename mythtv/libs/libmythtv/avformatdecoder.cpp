@@ -1626,6 +1626,9 @@ void AvFormatDecoder::InitVideoCodec(AVStream *stream, AVCodecContext *enc,
         }
     }
 
+    if (m_trickPlay)
+        enc->skip_frame = AVDISCARD_NONKEY;
+
     if (selectedStream)
     {
         fps = normalized_fps(stream, enc);
@@ -5143,6 +5146,33 @@ QString AvFormatDecoder::GetRawEncodingType(void)
     return ff_codec_id_string(ic->streams[stream]->codec->codec_id);
 }
 
+/** \fn AvFormatDecoder::SetTrickPlay(bool)
+ *  \brief Tells libavcodec to skip every frame but keyframes.
+ *
+ *   At high fast forward and rewind speeds only keyframes are shown, so
+ *   there is no point decoding the frames in between.
+ */
+void AvFormatDecoder::SetTrickPlay(bool enable)
+{
+    if (enable == m_trickPlay)
+        return;
+
+    DecoderBase::SetTrickPlay(enable);
+
+    int stream = selectedTrack[kTrackTypeVideo].av_stream_index;
+    if (stream < 0 || !ic)
+        return;
+
+    AVCodecContext *enc = ic->streams[stream]->codec;
+    if (!enc)
+        return;
+
+    enc->skip_frame = enable ? AVDISCARD_NONKEY : AVDISCARD_DEFAULT;
+
+    LOG(VB_PLAYBACK, LOG_INFO, LOC +
+        QString("Trick play %1").arg(enable ? "enabled" : "disabled"));
+}
+
 void *AvFormatDecoder::GetVideoCodecPrivate(void)
 {
     return NULL; // TODO is this still needed
@@ -165,6 +165,7 @@ class AvFormatDecoder : public DecoderBase
     virtual void SetIdrOnlyKeyframes(bool value) {
         m_h264_parser->use_I_forKeyframes(!value);
     }
+    virtual void SetTrickPlay(bool enable);
 
     virtual int64_t NormalizeVideoTimecode(int64_t timecode);
     virtual int64_t NormalizeVideoTimecode(AVStream *st, int64_t timecode);
@@ -73,6 +73,9 @@ const uint ChannelScanSM::kDVBTableTimeout  = 30 * 1000;
 const uint ChannelScanSM::kATSCTableTimeout = 10 * 1000;
 /// No logic here, lets just wait at least 15 seconds.
 const uint ChannelScanSM::kMPEGTableTimeout = 15 * 1000;
+/// NIT's should be sent every 10 seconds, wait that long for it
+/// once all the other tables of a DVB transport have arrived.
+const uint ChannelScanSM::kNITTimeout       = 12 * 1000;
 
 QString ChannelScanSM::loc(const ChannelScanSM *siscan)
 {
@@ -156,10 +159,12 @@ ChannelScanSM::ChannelScanSM(ScanMonitor *_scan_monitor,
       m_extendScanList(false),
       // Optional state
       m_scanDTVTunerType(DTVTunerType::kTunerTypeUnknown),
+      m_coordinator(NULL),
       // State
       m_scanning(false),
       m_threadExit(false),
       m_waitingForTables(false),
+      m_nitWaitStart(0),
       // Transports List
       m_transportsScanned(0),
       m_currentTestingDecryption(false),
@@ -362,6 +367,105 @@ bool ChannelScanSM::ScanExistingTransports(uint sourceid, bool follow_nit)
     return m_scanning;
 }
 
+/**
+ *  \brief Scans the given transports, used by ShareTransports() to hand
+ *         a share of the scan to another tuner.
+ *
+ *   When the scanner is part of a ScanCoordinator the list may be empty,
+ *   the scanner then waits for transports found by the other tuners.
+ */
+bool ChannelScanSM::ScanTransportList(
+    const transport_scan_items_t &transports, bool follow_nit)
+{
+    QMutexLocker locker(&m_lock);
+
+    if (m_scanning)
+        return false;
+
+    m_scanTransports    = transports;
+    m_current           = m_scanTransports.end();
+    m_nextIt            = m_scanTransports.begin();
+    m_extendScanList    = follow_nit;
+    m_waitingForTables  = false;
+    m_transportsScanned = 0;
+    m_timer.start();
+    m_scanning = m_coordinator || !m_scanTransports.empty();
+
+    return m_scanning;
+}
+
+/** \fn ChannelScanSM::ShareTransports(const QList<ChannelScanSM*>&,ScanCoordinator*)
+ *  \brief Divides the transports this scanner is about to scan between
+ *         itself and the helpers, one scanner per tuner.
+ *
+ *   The transports are dealt out in turn so every tuner gets a similar
+ *   mix of frequencies. This must be called after one of the Scan*()
+ *   methods filled in the transport list and before StartScanner().
+ */
+bool ChannelScanSM::ShareTransports(
+    const QList<ChannelScanSM*> &helpers, ScanCoordinator *coordinator)
+{
+    QMutexLocker locker(&m_lock);
+
+    if (!m_scanning || helpers.empty() || m_nextIt != m_scanTransports.begin())
+        return false;
+
+    uint count = helpers.size() + 1;
+    vector<transport_scan_items_t> shares(count);
+    list<TransportScanItem>::const_iterator it = m_scanTransports.begin();
+    for (uint i = 0; it != m_scanTransports.end(); ++it, ++i)
+        shares[i % count].push_back(*it);
+
+    m_coordinator = coordinator;
+    m_coordinator->AddScanner(this);
+    QSet<uint32_t>::const_iterator sit = m_tsScanned.begin();
+    for (; sit != m_tsScanned.end(); ++sit)
+        m_coordinator->MarkScanned(*sit);
+
+    m_scanTransports = shares[0];
+    m_current        = m_scanTransports.end();
+    m_nextIt         = m_scanTransports.begin();
+
+    for (uint i = 1; i < count; i++)
+    {
+        ChannelScanSM *helper = helpers[i - 1];
+        helper->SetCoordinator(coordinator);
+        coordinator->AddScanner(helper);
+        helper->ScanTransportList(shares[i], m_extendScanList);
+
+        LOG(VB_CHANSCAN, LOG_INFO, LOC +
+            QString("%1 transports for %2")
+                .arg(shares[i].size()).arg(loc(helper)));
+    }
+
+    LOG(VB_CHANSCAN, LOG_INFO, LOC +
+        QString("Scanning with %1 tuners, %2 transports for this one")
+            .arg(count).arg(m_scanTransports.size()));
+
+    return true;
+}
+
+bool ChannelScanSM::IsScanned(uint32_t netid_tsid) const
+{
+    return m_tsScanned.contains(netid_tsid) ||
+        (m_coordinator && m_coordinator->IsScanned(netid_tsid));
+}
+
+void ChannelScanSM::MarkScanned(uint32_t netid_tsid)
+{
+    m_tsScanned.insert(netid_tsid);
+    if (m_coordinator)
+        m_coordinator->MarkScanned(netid_tsid);
+}
+
+void ChannelScanSM::ReportScanComplete(void)
+{
+    if (m_coordinator)
+        m_coordinator->ScanComplete();
+    else
+        m_scanMonitor->ScanComplete();
+}
+
 void ChannelScanSM::HandlePAT(const ProgramAssociationTable *pat)
 {
     QMutexLocker locker(&m_lock);
@@ -453,7 +557,7 @@ void ChannelScanSM::HandleSDT(uint tsid, const ServiceDescriptionTable *sdt)
     }
 
     uint id = sdt->OriginalNetworkID() << 16 | sdt->TSID();
-    m_tsScanned.insert(id);
+    MarkScanned(id);
 
     for (uint i = 0; !m_currentTestingDecryption && i < sdt->ServiceCount(); i++)
     {
@@ -634,6 +738,7 @@ bool ChannelScanSM::TestNextProgramEncryption(void)
 
             m_currentTestingDecryption = true;
             m_timer.start();
+            m_nitWaitStart = 0;
             return true;
         }
 
@@ -679,7 +784,7 @@ void ChannelScanSM::UpdateScanTransports(const NetworkInformationTable *nit)
         uint32_t netid = nit->OriginalNetworkID(i);
         uint32_t id    = netid << 16 | tsid;
 
-        if (m_tsScanned.contains(id) || m_extendTransports.contains(id))
+        if (IsScanned(id) || m_extendTransports.contains(id))
             continue;
 
         const desc_list_t& list =
@@ -852,8 +957,17 @@ bool ChannelScanSM::UpdateChannelInfo(bool wait_until_complete)
         }
         if (sd->HasCachedAnyNIT() || sd->HasCachedAnySDTs())
         {
-            transport_tune_complete &= !m_currentInfo->nits.empty();
             transport_tune_complete &= !m_currentInfo->sdts.empty();
+
+            // Not every transport carries a NIT, note when it is the
+            // only table missing so HasTimedOut() need not wait long.
+            if (transport_tune_complete && m_currentInfo->nits.empty() &&
+                !m_nitWaitStart)
+            {
+                m_nitWaitStart = max(m_timer.elapsed(), 1);
+            }
+
+            transport_tune_complete &= !m_currentInfo->nits.empty();
         }
         if (transport_tune_complete)
         {
@@ -999,6 +1113,7 @@ bool ChannelScanSM::UpdateChannelInfo(bool wait_until_complete)
 
         m_setOtherTables = false;
         m_otherTableTime = 0;
+        m_nitWaitStart = 0;
 
         if (m_scanning)
         {
@@ -1567,6 +1682,13 @@ bool ChannelScanSM::HasTimedOut(void)
     }
 #endif // USING_DVB
 
+    // all the tables but the NIT are in, has the NIT timed out?
+    if (m_nitWaitStart &&
+        (m_timer.elapsed() > m_nitWaitStart + (int)kNITTimeout) &&
+        (m_timer.elapsed() > (int)m_otherTableTime))
+    {
+        return true;
+    }
 
     // have the tables have timed out?
     if (m_timer.elapsed() > (int)m_channelTimeout)
@@ -1670,14 +1792,19 @@ void ChannelScanSM::HandleActiveScan(void)
         QMap<uint32_t,DTVMultiplex>::iterator it = m_extendTransports.begin();
         while (it != m_extendTransports.end())
         {
-            if (!m_tsScanned.contains(it.key()))
+            if (!IsScanned(it.key()))
             {
                 QString name = QString("TransportID %1").arg(it.key() & 0xffff);
                 TransportScanItem item(m_sourceID, name, *it, m_signalTimeout);
                 LOG(VB_CHANSCAN, LOG_INFO, LOC + "Adding " + name + " - " +
                     item.tuning.toString());
-                m_scanTransports.push_back(item);
-                m_tsScanned.insert(it.key());
+                // With other tuners scanning too, let whichever is idle
+                // first scan the new transport.
+                if (m_coordinator)
+                    m_coordinator->AddTransport(item);
+                else
+                    m_scanTransports.push_back(item);
+                MarkScanned(it.key());
             }
             ++it;
         }
@@ -1685,9 +1812,34 @@ void ChannelScanSM::HandleActiveScan(void)
         m_nextIt = m_current;
         ++m_nextIt;
     }
+    else if (m_coordinator)
+    {
+        // there is no current transport to retry with DVB-T2
+        m_dvbt2Tried = true;
+
+        TransportScanItem item;
+        if (m_coordinator->TakeTransport(this, item))
+        {
+            LOG(VB_CHANSCAN, LOG_INFO, LOC + "Taking over " +
+                item.FriendlyName + " - " + item.tuning.toString());
+            m_scanTransports.push_back(item);
+            m_nextIt = --m_scanTransports.end();
+        }
+        else if (m_coordinator->IsFinished())
+        {
+            ReportScanComplete();
+            m_scanning = false;
+            m_current = m_nextIt = m_scanTransports.end();
+        }
+        else
+        {
+            // Another tuner may still find transports for us
+            m_current = m_nextIt = m_scanTransports.end();
+        }
+    }
     else
     {
-        m_scanMonitor->ScanComplete();
+        ReportScanComplete();
         m_scanning = false;
         m_current = m_nextIt = m_scanTransports.end();
     }
@@ -1779,6 +1931,7 @@ void ChannelScanSM::ScanTransport(const transport_scan_items_it_t &transport)
     m_signalMonitor->Start();
 
     m_timer.start();
+    m_nitWaitStart = 0;
     m_waitingForTables = (item.tuning.sistandard != "analog");
 }
 
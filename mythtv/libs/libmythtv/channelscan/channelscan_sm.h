@@ -46,6 +46,7 @@
 #include "scanmonitor.h"
 #include "signalmonitorlistener.h"
 #include "dtvconfparserhelpers.h" // for DTVTunerType
+#include "scancoordinator.h"
 
 class MThread;
 class MSqlQuery;
@@ -114,15 +115,22 @@ class ChannelScanSM : public MPEGStreamListener,
     bool ScanIPTVChannels(uint sourceid, const fbox_chan_map_t &iptv_channels);
 
     bool ScanExistingTransports(uint sourceid, bool follow_nit);
+    bool ScanTransportList(const transport_scan_items_t &transports,
+                           bool follow_nit);
+
+    bool ShareTransports(const QList<ChannelScanSM*> &helpers,
+                         ScanCoordinator *coordinator);
 
     void SetAnalog(bool is_analog);
     void SetSourceID(int _SourceID)   { m_sourceID                = _SourceID; }
     void SetSignalTimeout(uint val)    { m_signalTimeout = val; }
     void SetChannelTimeout(uint val)   { m_channelTimeout = val; }
     void SetScanDTVTunerType(DTVTunerType t) { m_scanDTVTunerType = t; }
+    void SetCoordinator(ScanCoordinator *c) { m_coordinator = c; }
 
     uint GetSignalTimeout(void)  const { return m_signalTimeout; }
     uint GetChannelTimeout(void) const { return m_channelTimeout; }
+    DTVTunerType GetScanDTVTunerType(void) const { return m_scanDTVTunerType; }
 
     SignalMonitor    *GetSignalMonitor(void) { return m_signalMonitor; }
     DTVSignalMonitor *GetDTVSignalMonitor(void);
@@ -194,11 +202,16 @@ class ChannelScanSM : public MPEGStreamListener,
 
     bool AddToList(uint mplexid);
 
+    bool IsScanned(uint32_t netid_tsid) const;
+    void MarkScanned(uint32_t netid_tsid);
+    void ReportScanComplete(void);
+
     static QString loc(const ChannelScanSM*);
 
     static const uint kDVBTableTimeout;
     static const uint kATSCTableTimeout;
     static const uint kMPEGTableTimeout;
+    static const uint kNITTimeout;
 
   private:
     // Set in constructor
@@ -217,6 +230,7 @@ class ChannelScanSM : public MPEGStreamListener,
 
     // Optional info
     DTVTunerType      m_scanDTVTunerType;
+    ScanCoordinator  *m_coordinator;
 
     /// The big lock
     mutable QMutex    m_lock;
@@ -226,6 +240,8 @@ class ChannelScanSM : public MPEGStreamListener,
     volatile bool     m_threadExit;
     bool              m_waitingForTables;
     QTime             m_timer;
+    /// When all but the NIT had arrived, 0 if not yet
+    int               m_nitWaitStart;
 
     // Transports List
     int                         m_transportsScanned;
@@ -257,7 +273,10 @@ inline void ChannelScanSM::UpdateScanPercentCompleted(void)
 {
     int tmp = (m_transportsScanned * 100) /
               (m_scanTransports.size() + m_extendTransports.size());
-    m_scanMonitor->ScanPercentComplete(tmp);
+    if (m_coordinator)
+        m_coordinator->ScanPercentComplete(this, tmp);
+    else
+        m_scanMonitor->ScanPercentComplete(tmp);
 }
 
 void AnalogSignalHandler::AllGood(void)
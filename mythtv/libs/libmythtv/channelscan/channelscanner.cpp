@@ -49,6 +49,7 @@ using namespace std;
 
 ChannelScanner::ChannelScanner() :
     scanMonitor(NULL), channel(NULL), sigmonScanner(NULL), iptvScanner(NULL),
+    scanCoordinator(NULL),
 #ifdef USING_VBOX
     vboxScanner(NULL),
 #endif
@@ -69,6 +70,18 @@ ChannelScanner::~ChannelScanner()
 
 void ChannelScanner::Teardown(void)
 {
+    while (!helperScanners.empty())
+        delete helperScanners.takeLast();
+
+    while (!helperChannels.empty())
+        delete helperChannels.takeLast();
+
+    if (scanCoordinator)
+    {
+        delete scanCoordinator;
+        scanCoordinator = NULL;
+    }
+
     if (sigmonScanner)
     {
         delete sigmonScanner;
@@ -104,6 +117,88 @@ void ChannelScanner::Teardown(void)
     }
 }
 
+static ChannelBase *create_channel(const QString &card_type,
+                                   const QString &device)
+{
+#ifdef USING_DVB
+    if ("DVB" == card_type)
+        return new DVBChannel(device);
+#endif
+
+#ifdef USING_V4L2
+    if (("V4L" == card_type) || ("MPEG" == card_type))
+        return new V4LChannel(NULL, device);
+#endif
+
+#ifdef USING_HDHOMERUN
+    if ("HDHOMERUN" == card_type)
+    {
+        return new HDHRChannel(NULL, device);
+    }
+#endif // USING_HDHOMERUN
+
+#ifdef USING_ASI
+    if ("ASI" == card_type)
+    {
+        return new ASIChannel(NULL, device);
+    }
+#endif // USING_ASI
+
+#ifdef USING_IPTV
+    if ("FREEBOX" == card_type)
+    {
+        return new IPTVChannel(NULL, device);
+    }
+#endif
+
+#ifdef USING_VBOX
+    if ("VBOX" == card_type)
+    {
+        return new IPTVChannel(NULL, device);
+    }
+#endif
+
+    if ("EXTERNAL" == card_type)
+    {
+        return new ExternalChannel(NULL, device);
+    }
+
+    return NULL;
+}
+
+/// Returns the other inputs sharing an input group and the video source
+/// with inputid, which are on a tuner of their own.
+static vector<uint> get_helper_inputs(uint inputid, uint sourceid)
+{
+    vector<uint> helpers;
+
+    QString rawtype = CardUtil::GetRawInputType(inputid);
+    QStringList devices(CardUtil::GetVideoDevice(inputid));
+
+    vector<uint> groups = CardUtil::GetInputGroups(inputid);
+    for (uint i = 0; i < groups.size(); i++)
+    {
+        vector<uint> inputs = CardUtil::GetGroupInputIDs(groups[i]);
+        for (uint j = 0; j < inputs.size(); j++)
+        {
+            uint other = inputs[j];
+            QString device = CardUtil::GetVideoDevice(other);
+            if (device.isEmpty() || devices.contains(device) ||
+                CardUtil::GetSourceID(other) != sourceid ||
+                CardUtil::GetRawInputType(other) != rawtype ||
+                CardUtil::IsTunerShared(inputid, other))
+            {
+                continue;
+            }
+
+            devices.push_back(device);
+            helpers.push_back(other);
+        }
+    }
+
+    return helpers;
+}
+
 // full scan of existing transports broken
 // existing transport scan broken
 void ChannelScanner::Scan(
@@ -139,10 +234,10 @@ void ChannelScanner::Scan(
         return;
     }
 
-    sigmonScanner->StartScanner();
     scanMonitor->ScanUpdateStatusText("");
 
     bool ok = false;
+    bool shareable = false;
 
     if ((ScanTypeSetting::FullScan_ATSC   == scantype) ||
         (ScanTypeSetting::FullScan_DVBC   == scantype) ||
@@ -166,6 +261,7 @@ void ChannelScanner::Scan(
 
         ok = sigmonScanner->ScanTransports(
             sourceid, freq_std, mod, tbl, tbl_start, tbl_end);
+        shareable = ScanTypeSetting::FullScan_Analog != scantype;
     }
     else if ((ScanTypeSetting::NITAddScan_DVBT  == scantype) ||
              (ScanTypeSetting::NITAddScan_DVBT2 == scantype) ||
@@ -176,6 +272,7 @@ void ChannelScanner::Scan(
         LOG(VB_CHANSCAN, LOG_INFO, LOC + "ScanTransports()");
 
         ok = sigmonScanner->ScanTransportsStartingOn(sourceid, startChan);
+        shareable = true;
     }
     else if (ScanTypeSetting::FullTransportScan == scantype)
     {
@@ -186,6 +283,7 @@ void ChannelScanner::Scan(
         if (ok)
         {
             scanMonitor->ScanPercentComplete(0);
+            shareable = true;
         }
         else
         {
@@ -219,6 +317,7 @@ void ChannelScanner::Scan(
         if (ok)
         {
             scanMonitor->ScanPercentComplete(0);
+            shareable = true;
         }
         else
         {
@@ -261,6 +360,17 @@ void ChannelScanner::Scan(
         ok = sigmonScanner->ScanCurrentTransport(sistandard);
     }
 
+    if (ok && sigmonScanner)
+    {
+        if (shareable)
+        {
+            StartHelperScanners(cardid, sourceid, do_test_decryption);
+            for (int i = 0; i < helperScanners.size(); i++)
+                helperScanners[i]->StartScanner();
+        }
+        sigmonScanner->StartScanner();
+    }
+
     if (!ok)
     {
         LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to handle tune complete.");
@@ -269,6 +379,98 @@ void ChannelScanner::Scan(
     }
 }
 
+/** \fn ChannelScanner::StartHelperScanners(uint, uint, bool)
+ *  \brief Shares the transports to scan with the other free tuners in
+ *         the input group of cardid.
+ *
+ *   Inputs whose device can not be opened, because a recorder is using
+ *   it for instance, are left alone.
+ */
+void ChannelScanner::StartHelperScanners(
+    uint cardid, uint sourceid, bool do_test_decryption)
+{
+    vector<uint> inputs = get_helper_inputs(cardid, sourceid);
+    if (inputs.empty())
+        return;
+
+    QString card_type = CardUtil::GetRawInputType(cardid);
+
+    for (uint i = 0; i < inputs.size(); i++)
+    {
+        QString device = CardUtil::GetVideoDevice(inputs[i]);
+        ChannelBase *chan = create_channel(card_type, device);
+        if (!chan)
+            continue;
+
+        chan->SetInputID(inputs[i]);
+        if (!chan->Open())
+        {
+            LOG(VB_CHANSCAN, LOG_INFO, LOC +
+                QString("Not scanning with %1, it is busy").arg(device));
+            delete chan;
+            continue;
+        }
+
+        ChannelScanSM *scanner = new ChannelScanSM(
+            scanMonitor, card_type, chan, sourceid,
+            sigmonScanner->GetSignalTimeout(),
+            sigmonScanner->GetChannelTimeout(),
+            CardUtil::GetInputName(inputs[i]), do_test_decryption);
+        scanner->SetScanDTVTunerType(sigmonScanner->GetScanDTVTunerType());
+
+        helperChannels.push_back(chan);
+        helperScanners.push_back(scanner);
+    }
+
+    if (helperScanners.empty())
+        return;
+
+    scanCoordinator = new ScanCoordinator(scanMonitor);
+    if (!sigmonScanner->ShareTransports(helperScanners, scanCoordinator))
+    {
+        while (!helperScanners.empty())
+            delete helperScanners.takeLast();
+        while (!helperChannels.empty())
+            delete helperChannels.takeLast();
+        delete scanCoordinator;
+        scanCoordinator = NULL;
+        return;
+    }
+
+    LOG(VB_GENERAL, LOG_INFO, LOC +
+        QString("Scanning with %1 tuners").arg(helperScanners.size() + 1));
+}
+
+/** \fn ChannelScanner::GetChannelList(void)
+ *  \brief Stops the scanners and returns what they found, as if it was
+ *         all found by the scanner of the selected input.
+ */
+ScanDTVTransportList ChannelScanner::GetChannelList(void)
+{
+    ScanDTVTransportList transports;
+    if (!sigmonScanner)
+        return transports;
+
+    for (int i = 0; i < helperScanners.size(); i++)
+        helperScanners[i]->StopScanner();
+    sigmonScanner->StopScanner();
+
+    transports = sigmonScanner->GetChannelList();
+
+    uint cardid = channel ? channel->GetInputID() : 0;
+    for (int i = 0; i < helperScanners.size(); i++)
+    {
+        ScanDTVTransportList list = helperScanners[i]->GetChannelList();
+        for (uint j = 0; j < list.size(); j++)
+        {
+            list[j].cardid = cardid;
+            transports.push_back(list[j]);
+        }
+    }
+
+    return transports;
+}
+
 DTVConfParser::return_t ChannelScanner::ImportDVBUtils(
     uint sourceid, int cardtype, const QString &file)
 {
@@ -405,48 +607,7 @@ void ChannelScanner::PreScanCommon(
         channel_timeout = max(channel_timeout, need_nit * 7 * 1000U);
     }
 
-#ifdef USING_DVB
-    if ("DVB" == card_type)
-        channel = new DVBChannel(device);
-#endif
-
-#ifdef USING_V4L2
-    if (("V4L" == card_type) || ("MPEG" == card_type))
-        channel = new V4LChannel(NULL, device);
-#endif
-
-#ifdef USING_HDHOMERUN
-    if ("HDHOMERUN" == card_type)
-    {
-        channel = new HDHRChannel(NULL, device);
-    }
-#endif // USING_HDHOMERUN
-
-#ifdef USING_ASI
-    if ("ASI" == card_type)
-    {
-        channel = new ASIChannel(NULL, device);
-    }
-#endif // USING_ASI
-
-#ifdef USING_IPTV
-    if ("FREEBOX" == card_type)
-    {
-        channel = new IPTVChannel(NULL, device);
-    }
-#endif
-
-#ifdef USING_VBOX
-    if ("VBOX" == card_type)
-    {
-        channel = new IPTVChannel(NULL, device);
-    }
-#endif
-
-    if ("EXTERNAL" == card_type)
-    {
-        channel = new ExternalChannel(NULL, device);
-    }
+    channel = create_channel(card_type, device);
 
     if (!channel)
     {
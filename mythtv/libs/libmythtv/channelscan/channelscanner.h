@@ -32,10 +32,12 @@
 
 // Qt headers
 #include <QCoreApplication>
+#include <QList>
 
 // MythTV headers
 #include "mythtvexp.h"
 #include "dtvconfparser.h"
+#include "dtvmultiplex.h"
 #include "iptvchannelfetcher.h"
 #include "scanmonitor.h"
 #include "channelscantypes.h"
@@ -48,6 +50,7 @@ class ScanMonitor;
 class IPTVChannelFetcher;
 class ChannelScanSM;
 class ChannelBase;
+class ScanCoordinator;
 
 // Not (yet?) implemented from old scanner
 // do_delete_channels, do_rename_channels, atsc_format
@@ -89,6 +92,8 @@ class MTV_PUBLIC ChannelScanner
     virtual bool ImportVBox(uint cardid, const QString &inputname, uint sourceid,
                             bool ftaOnly, ServiceRequirements serviceType);
 
+    ScanDTVTransportList GetChannelList(void);
+
   protected:
     virtual void Teardown(void);
 
@@ -98,6 +103,9 @@ class MTV_PUBLIC ChannelScanner
         uint sourceid, bool do_ignore_signal_timeout,
         bool do_test_decryption);
 
+    void StartHelperScanners(uint cardid, uint sourceid,
+                             bool do_test_decryption);
+
     virtual void MonitorProgress(
         bool /*lock*/, bool /*strength*/, bool /*snr*/, bool /*rotor*/) { }
 
@@ -112,6 +120,11 @@ class MTV_PUBLIC ChannelScanner
     ChannelScanSM      *sigmonScanner;
     IPTVChannelFetcher *iptvScanner;
 
+    /// scanners on the other free tuners of the input group
+    QList<ChannelScanSM*> helperScanners;
+    QList<ChannelBase*>   helperChannels;
+    ScanCoordinator      *scanCoordinator;
+
     /// imported channels
     DTVChannelList      channels;
     fbox_chan_map_t     iptv_channels;
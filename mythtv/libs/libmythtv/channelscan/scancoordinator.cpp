@@ -0,0 +1,94 @@
+// -*- Mode: c++ -*-
+
+// MythTV headers
+#include "scancoordinator.h"
+#include "scanmonitor.h"
+
+ScanCoordinator::ScanCoordinator(ScanMonitor *monitor) :
+    m_monitor(monitor), m_complete(false)
+{
+}
+
+void ScanCoordinator::AddScanner(const ChannelScanSM *scanner)
+{
+    QMutexLocker locker(&m_lock);
+    m_percent[scanner] = 0;
+}
+
+bool ScanCoordinator::IsScanned(uint32_t netid_tsid) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_scanned.contains(netid_tsid);
+}
+
+/// Returns false if the transport was already marked by another scanner
+bool ScanCoordinator::MarkScanned(uint32_t netid_tsid)
+{
+    QMutexLocker locker(&m_lock);
+    if (m_scanned.contains(netid_tsid))
+        return false;
+    m_scanned.insert(netid_tsid);
+    return true;
+}
+
+void ScanCoordinator::AddTransport(const TransportScanItem &item)
+{
+    QMutexLocker locker(&m_lock);
+    m_pool.push_back(item);
+}
+
+/** \fn ScanCoordinator::TakeTransport(const ChannelScanSM*,TransportScanItem&)
+ *  \brief Hands a transport from the pool to a scanner which has
+ *         finished its own list, the scanner is idle if there is none.
+ */
+bool ScanCoordinator::TakeTransport(
+    const ChannelScanSM *scanner, TransportScanItem &item)
+{
+    QMutexLocker locker(&m_lock);
+
+    if (m_pool.empty())
+    {
+        m_idle.insert(scanner);
+        return false;
+    }
+
+    item = m_pool.takeFirst();
+    m_idle.remove(scanner);
+    return true;
+}
+
+bool ScanCoordinator::IsFinished(void) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_pool.empty() && m_idle.size() == m_percent.size();
+}
+
+void ScanCoordinator::ScanPercentComplete(const ChannelScanSM *scanner, int pct)
+{
+    int total = 0;
+    {
+        QMutexLocker locker(&m_lock);
+        m_percent[scanner] = pct;
+
+        QMap<const ChannelScanSM*, int>::const_iterator it = m_percent.begin();
+        for (; it != m_percent.end(); ++it)
+            total += *it;
+        total /= m_percent.size();
+    }
+
+    m_monitor->ScanPercentComplete(total);
+}
+
+/// Tells the ScanMonitor once, when the last scanner is done
+void ScanCoordinator::ScanComplete(void)
+{
+    {
+        QMutexLocker locker(&m_lock);
+        if (m_complete)
+            return;
+        m_complete = true;
+    }
+
+    m_monitor->ScanPercentComplete(100);
+    m_monitor->ScanComplete();
+}
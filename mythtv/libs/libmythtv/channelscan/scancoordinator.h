@@ -0,0 +1,55 @@
+// -*- Mode: c++ -*-
+#ifndef _SCAN_COORDINATOR_H_
+#define _SCAN_COORDINATOR_H_
+
+#include <stdint.h>
+
+// Qt headers
+#include <QMutex>
+#include <QList>
+#include <QMap>
+#include <QSet>
+
+// MythTV headers
+#include "frequencytables.h"
+
+class ChannelScanSM;
+class ScanMonitor;
+
+/** \class ScanCoordinator
+ *  \brief Lets several ChannelScanSM, one per tuner, share one scan.
+ *
+ *   Each scanner works through its own share of the transport list.
+ *   Transports found in a NIT go to a common pool which is taken from
+ *   by whichever scanner runs out of work first. The ScanMonitor is
+ *   told the scan is complete once every scanner is idle and the pool
+ *   is empty.
+ */
+class ScanCoordinator
+{
+  public:
+    ScanCoordinator(ScanMonitor *monitor);
+
+    void AddScanner(const ChannelScanSM *scanner);
+
+    bool IsScanned(uint32_t netid_tsid) const;
+    bool MarkScanned(uint32_t netid_tsid);
+
+    void AddTransport(const TransportScanItem &item);
+    bool TakeTransport(const ChannelScanSM *scanner, TransportScanItem &item);
+    bool IsFinished(void) const;
+
+    void ScanPercentComplete(const ChannelScanSM *scanner, int pct);
+    void ScanComplete(void);
+
+  private:
+    mutable QMutex                  m_lock;
+    ScanMonitor                    *m_monitor;
+    QMap<const ChannelScanSM*, int> m_percent;   ///< scanner -> % complete
+    QSet<const ChannelScanSM*>      m_idle;
+    QList<TransportScanItem>        m_pool;
+    QSet<uint32_t>                  m_scanned;   ///< netid << 16 | tsid
+    bool                            m_complete;
+};
+
+#endif // _SCAN_COORDINATOR_H_
@@ -1,5 +1,6 @@
 
 #include <algorithm>
+#include <cstdlib>
 using namespace std;
 
 #include "mythconfig.h"
@@ -37,7 +38,7 @@ DecoderBase::DecoderBase(MythPlayer *parent, const ProgramInfo &pginfo)
 
       seeksnap(UINT64_MAX), livetv(false), watchingrecording(false),
 
-      hasKeyFrameAdjustTable(false), lowbuffers(false),
+      hasKeyFrameAdjustTable(false), lowbuffers(false), m_trickPlay(false),
       getrawframes(false), getrawvideo(false),
       errored(false), waitingForChange(false), readAdjust(0),
       justAfterChange(false),
@@ -585,9 +586,10 @@ bool DecoderBase::DoRewind(long long desiredFrame, bool discardFrames)
 
     // Do any Extra frame-by-frame seeking for exactseeks mode
     // And flush pre-seek frame if we are allowed to and need to..
+    // In trick play only keyframes are decoded, so stop at the keyframe.
     int normalframes = (uint64_t)(desiredFrame - (framesPlayed - 1)) > seeksnap
         ? desiredFrame - framesPlayed : 0;
-    normalframes = max(normalframes, 0);
+    normalframes = m_trickPlay ? 0 : max(normalframes, 0);
     SeekReset(lastKey, normalframes, true, discardFrames);
 
     if (discardFrames || (ringBuffer && ringBuffer->IsDisc()))
@@ -680,6 +682,43 @@ long long DecoderBase::GetLastFrameInPosMap(void) const
     return last_frame;
 }
 
+/** \fn DecoderBase::GetNearestKeyframe(long long)
+ *  \brief Returns the keyframe in the position map closest to desiredFrame.
+ *
+ *   Used in trick play, where seeking anywhere but to a keyframe would
+ *   require decoding every frame from the previous keyframe onwards.
+ *   If the position map does not reach desiredFrame it is returned as is.
+ */
+long long DecoderBase::GetNearestKeyframe(long long desiredFrame)
+{
+    if (desiredFrame < 0 || desiredFrame > GetLastFrameInPosMap())
+        return desiredFrame;
+
+    int pre_idx, post_idx;
+    FindPosition(desiredFrame, hasKeyFrameAdjustTable, pre_idx, post_idx);
+
+    QMutexLocker locker(&m_positionMapLock);
+    if (m_positionMap.empty())
+        return desiredFrame;
+
+    long long pre  = GetKey(m_positionMap[pre_idx]);
+    long long post = GetKey(m_positionMap[post_idx]);
+
+    return (llabs(desiredFrame - pre) <= llabs(post - desiredFrame)) ?
+        pre : post;
+}
+
+/// Returns the mean number of frames between keyframes, 0 if unknown
+long long DecoderBase::GetAverageKeyframeDistance(void) const
+{
+    QMutexLocker locker(&m_positionMapLock);
+    if (m_positionMap.size() < 2)
+        return 0;
+
+    return (GetKey(m_positionMap.back()) - GetKey(m_positionMap.front())) /
+        (long long)(m_positionMap.size() - 1);
+}
+
 long long DecoderBase::ConditionallyUpdatePosMap(long long desiredFrame)
 {
     long long last_frame = GetLastFrameInPosMap();
@@ -816,7 +855,7 @@ bool DecoderBase::DoFastForward(long long desiredFrame, bool discardFrames)
     // And flush pre-seek frame if we are allowed to and need to..
     int normalframes = (uint64_t)(desiredFrame - (framesPlayed - 1)) > seeksnap
         ? desiredFrame - framesPlayed : 0;
-    normalframes = max(normalframes, 0);
+    normalframes = m_trickPlay ? 0 : max(normalframes, 0);
     SeekReset(lastKey, normalframes, needflush, discardFrames);
 
     if (discardFrames || transcoding)
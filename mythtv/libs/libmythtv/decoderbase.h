@@ -165,6 +165,11 @@ class DecoderBase
     virtual bool DoRewind(long long desiredFrame, bool doflush = true);
     virtual bool DoFastForward(long long desiredFrame, bool doflush = true);
     virtual void SetIdrOnlyKeyframes(bool value) { }
+    /// Decode only keyframes, used for high speed fast forward and rewind
+    virtual void SetTrickPlay(bool enable) { m_trickPlay = enable; }
+    bool GetTrickPlay(void) const { return m_trickPlay; }
+    long long GetNearestKeyframe(long long desiredFrame);
+    long long GetAverageKeyframeDistance(void) const;
 
     static uint64_t
         TranslatePositionAbsToRel(const frm_dir_map_t &deleteMap,
@@ -340,6 +345,7 @@ class DecoderBase
     bool hasKeyFrameAdjustTable;
 
     bool lowbuffers;
+    bool m_trickPlay;
 
     bool getrawframes;
     bool getrawvideo;
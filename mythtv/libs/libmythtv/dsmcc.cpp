@@ -36,6 +36,7 @@ static uint32_t crc32(const unsigned char *data, int len);
 Dsmcc::Dsmcc()
 {
     m_startTag = 0;
+    m_serviceId = 0;
 }
 
 Dsmcc::~Dsmcc()
@@ -91,6 +91,12 @@ class Dsmcc
     // Creates a new carousel object if there isn't one for this ID.
     ObjCarousel *AddTap(unsigned short componentTag, unsigned carouselId);
 
+    // Set the service the carousel is received from.  Modules are
+    // kept for each service across resets.
+    void SetServiceId(uint serviceId) { m_serviceId = serviceId; }
+    uint GetServiceId(void) const { return m_serviceId; }
+    DSMCCModuleStore *GetModuleStore(void) { return &m_moduleStore; }
+
   protected:
     void ProcessSectionIndication(const unsigned char *data, int Lstartength,
                                   unsigned short streamTag);
@@ -112,6 +118,10 @@ class Dsmcc
 
     // Initial stream
     unsigned short m_startTag;
+
+    // Completed modules of the services we have seen.
+    DSMCCModuleStore m_moduleStore;
+    uint             m_serviceId;
 };
 
 #define COMBINE32(data, idx) \
@@ -5,6 +5,7 @@
 #include <string.h> // For memcmp
 
 #include <QStringList>
+#include <QCryptographicHash>
 
 #include "dsmcccache.h"
 #include "dsmccbiop.h"
@@ -36,8 +37,8 @@ DSMCCCache::DSMCCCache(Dsmcc *dsmcc)
 
 DSMCCCache::~DSMCCCache()
 {
-    QMap<DSMCCCacheReference, DSMCCCacheDir*>::Iterator dir;
-    QMap<DSMCCCacheReference, DSMCCCacheFile*>::Iterator fil;
+    QHash<DSMCCCacheReference, DSMCCCacheDir*>::Iterator dir;
+    QHash<DSMCCCacheReference, DSMCCCacheFile*>::Iterator fil;
 
     for (dir = m_Directories.begin(); dir != m_Directories.end(); ++dir)
         delete *dir;
@@ -129,11 +130,24 @@ bool operator < (const DSMCCCacheReference &ref1,
     return false;
 }
 
+// Operator required for QHash
+bool operator == (const DSMCCCacheReference &ref1,
+                  const DSMCCCacheReference &ref2)
+{
+    return ref1.Equal(ref2);
+}
+
+uint qHash(const DSMCCCacheReference &ref)
+{
+    return qHash(ref.m_Key) ^ ((uint)ref.m_nCarouselId << 16) ^
+        ((uint)ref.m_nModuleId << 8) ^ ref.m_nStreamTag;
+}
+
 // Create a gateway entry.
 DSMCCCacheDir *DSMCCCache::Srg(const DSMCCCacheReference &ref)
 {
     // Check to see that it isn't already there.  It shouldn't be.
-    QMap<DSMCCCacheReference, DSMCCCacheDir*>::Iterator dir =
+    QHash<DSMCCCacheReference, DSMCCCacheDir*>::Iterator dir =
         m_Gateways.find(ref);
 
     if (dir != m_Gateways.end())
@@ -156,7 +170,7 @@ DSMCCCacheDir *DSMCCCache::Srg(const DSMCCCacheReference &ref)
 DSMCCCacheDir *DSMCCCache::Directory(const DSMCCCacheReference &ref)
 {
     // Check to see that it isn't already there.  It shouldn't be.
-    QMap<DSMCCCacheReference, DSMCCCacheDir*>::Iterator dir =
+    QHash<DSMCCCacheReference, DSMCCCacheDir*>::Iterator dir =
         m_Directories.find(ref);
 
     if (dir != m_Directories.end())
@@ -186,7 +200,7 @@ void DSMCCCache::CacheFileData(const DSMCCCacheReference &ref,
         QString("[DSMCCCache] Adding file data size %1 for reference %2")
             .arg(data.size()).arg(ref.toString()));
 
-    QMap<DSMCCCacheReference, DSMCCCacheFile*>::Iterator fil =
+    QHash<DSMCCCacheReference, DSMCCCacheFile*>::Iterator fil =
         m_Files.find(ref);
 
     if (fil == m_Files.end())
@@ -240,7 +254,7 @@ void DSMCCCache::AddDirInfo(DSMCCCacheDir *pDir, const BiopBinding *pBB)
 DSMCCCacheFile *DSMCCCache::FindFileData(DSMCCCacheReference &ref)
 {
     // Find a file.
-    QMap<DSMCCCacheReference, DSMCCCacheFile*>::Iterator fil =
+    QHash<DSMCCCacheReference, DSMCCCacheFile*>::Iterator fil =
         m_Files.find(ref);
 
     if (fil == m_Files.end())
@@ -252,7 +266,7 @@ DSMCCCacheFile *DSMCCCache::FindFileData(DSMCCCacheReference &ref)
 DSMCCCacheDir *DSMCCCache::FindDir(DSMCCCacheReference &ref)
 {
     // Find a directory.
-    QMap<DSMCCCacheReference, DSMCCCacheDir*>::Iterator dir =
+    QHash<DSMCCCacheReference, DSMCCCacheDir*>::Iterator dir =
         m_Directories.find(ref);
 
     if (dir == m_Directories.end())
@@ -264,7 +278,7 @@ DSMCCCacheDir *DSMCCCache::FindDir(DSMCCCacheReference &ref)
 DSMCCCacheDir *DSMCCCache::FindGateway(DSMCCCacheReference &ref)
 {
     // Find a gateway.
-    QMap<DSMCCCacheReference, DSMCCCacheDir*>::Iterator dir =
+    QHash<DSMCCCacheReference, DSMCCCacheDir*>::Iterator dir =
         m_Gateways.find(ref);
 
     if (dir == m_Gateways.end())
@@ -334,3 +348,117 @@ void DSMCCCache::SetGateway(const DSMCCCacheReference &ref)
         m_GatewayRef = ref;
     }
 }
+
+// Remove the files and directories which came from a module which
+// has been replaced by a new version.  They are added again when the
+// new version has been received.
+void DSMCCCache::RemoveModule(unsigned long carouselId,
+                              unsigned short moduleId)
+{
+    QHash<DSMCCCacheReference, DSMCCCacheFile*>::Iterator fil =
+        m_Files.begin();
+    while (fil != m_Files.end())
+    {
+        if ((*fil)->m_Reference.m_nCarouselId == carouselId &&
+            (*fil)->m_Reference.m_nModuleId == moduleId)
+        {
+            delete *fil;
+            fil = m_Files.erase(fil);
+        }
+        else
+            ++fil;
+    }
+
+    QHash<DSMCCCacheReference, DSMCCCacheDir*> *dirs[2] =
+        { &m_Directories, &m_Gateways };
+    for (uint i = 0; i < 2; i++)
+    {
+        QHash<DSMCCCacheReference, DSMCCCacheDir*>::Iterator dir =
+            dirs[i]->begin();
+        while (dir != dirs[i]->end())
+        {
+            if ((*dir)->m_Reference.m_nCarouselId == carouselId &&
+                (*dir)->m_Reference.m_nModuleId == moduleId)
+            {
+                delete *dir;
+                dir = dirs[i]->erase(dir);
+            }
+            else
+                ++dir;
+        }
+    }
+
+    LOG(VB_DSMCC, LOG_INFO, QString("[DSMCCCache] Removed objects of module "
+                                    "%1 on carousel %2")
+        .arg(moduleId).arg(carouselId));
+}
+
+bool operator == (const DSMCCModuleKey &key1, const DSMCCModuleKey &key2)
+{
+    return key1.m_nServiceId == key2.m_nServiceId &&
+        key1.m_nCarouselId == key2.m_nCarouselId &&
+        key1.m_nModuleId == key2.m_nModuleId &&
+        key1.m_nVersion == key2.m_nVersion &&
+        key1.m_nModuleSize == key2.m_nModuleSize;
+}
+
+uint qHash(const DSMCCModuleKey &key)
+{
+    return (key.m_nServiceId << 16) ^ ((uint)key.m_nCarouselId << 8) ^
+        ((uint)key.m_nModuleId << 4) ^ key.m_nVersion ^
+        (uint)key.m_nModuleSize;
+}
+
+/** \class DSMCCModuleStore
+ *
+ *   Completed modules are kept here, after decompression, so that when
+ *   we return to a service the modules which have not changed can be
+ *   used as soon as the DII lists them rather than waiting for every
+ *   block to come round on the carousel again.  The contents are stored
+ *   by their SHA-1 so a module which is carried by several services,
+ *   or which comes back with a new version number but the same data,
+ *   is only held once.  The least recently used contents are dropped
+ *   once kMaxBytes are held.
+ */
+
+void DSMCCModuleStore::Add(const DSMCCModuleKey &key, const QByteArray &data)
+{
+    QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+
+    if (!m_Contents.contains(hash) &&
+        !m_Contents.insert(hash, new QByteArray(data), data.size()))
+    {
+        return; // Larger than the whole store.
+    }
+
+    m_Index.insert(key, hash);
+
+    // Drop the index entries whose contents have been evicted.
+    if (m_Index.size() > 2 * m_Contents.size() + 256)
+    {
+        QHash<DSMCCModuleKey, QByteArray>::Iterator it = m_Index.begin();
+        while (it != m_Index.end())
+        {
+            if (m_Contents.contains(*it))
+                ++it;
+            else
+                it = m_Index.erase(it);
+        }
+    }
+}
+
+QByteArray DSMCCModuleStore::Find(const DSMCCModuleKey &key)
+{
+    QHash<DSMCCModuleKey, QByteArray>::Iterator it = m_Index.find(key);
+    if (it == m_Index.end())
+        return QByteArray();
+
+    QByteArray *data = m_Contents.object(*it);
+    if (data == NULL)
+    {
+        m_Index.erase(it);
+        return QByteArray();
+    }
+
+    return *data; // Shared with the store, not copied.
+}
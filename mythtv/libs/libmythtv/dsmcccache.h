@@ -6,6 +6,9 @@
 #define DSMCC_CACHE_H
 
 #include <QStringList>
+#include <QByteArray>
+#include <QCache>
+#include <QHash>
 #include <QMap>
 
 class BiopBinding;
@@ -57,8 +60,13 @@ class DSMCCCacheReference
     // Operator required for QMap
     friend bool operator < (const DSMCCCacheReference&,
                             const DSMCCCacheReference&);
+    // Operator required for QHash
+    friend bool operator == (const DSMCCCacheReference&,
+                             const DSMCCCacheReference&);
 };
 
+uint qHash(const DSMCCCacheReference &ref);
+
 // A directory
 class DSMCCCacheDir
 {
@@ -108,6 +116,9 @@ class DSMCCCache
     // Return the contents.
     int GetDSMObject(QStringList &objectPath, QByteArray &result);
 
+    // Forget the objects from an old version of a module.
+    void RemoveModule(unsigned long carouselId, unsigned short moduleId);
+
   protected:
     // Find File, Directory or Gateway by reference.
     DSMCCCacheFile *FindFileData(DSMCCCacheReference &ref);
@@ -117,12 +128,52 @@ class DSMCCCache
     DSMCCCacheReference m_GatewayRef; // Reference to the gateway
 
     // The set of directories, files and gateways.
-    QMap<DSMCCCacheReference, DSMCCCacheDir*> m_Directories;
-    QMap<DSMCCCacheReference, DSMCCCacheDir*> m_Gateways;
-    QMap<DSMCCCacheReference, DSMCCCacheFile*> m_Files;
+    QHash<DSMCCCacheReference, DSMCCCacheDir*> m_Directories;
+    QHash<DSMCCCacheReference, DSMCCCacheDir*> m_Gateways;
+    QHash<DSMCCCacheReference, DSMCCCacheFile*> m_Files;
 
   public:
     Dsmcc *m_Dsmcc;
 };
 
+// Identifies one version of a module of a service's carousel.
+class DSMCCModuleKey
+{
+  public:
+    DSMCCModuleKey(uint service, unsigned long car, unsigned short m,
+                   unsigned char v, unsigned long size) :
+        m_nServiceId(service),  m_nCarouselId(car),
+        m_nModuleId(m),         m_nVersion(v),
+        m_nModuleSize(size) {}
+
+    uint           m_nServiceId;
+    unsigned long  m_nCarouselId;
+    unsigned short m_nModuleId;
+    unsigned char  m_nVersion;
+    unsigned long  m_nModuleSize;
+
+    friend bool operator == (const DSMCCModuleKey&, const DSMCCModuleKey&);
+};
+
+uint qHash(const DSMCCModuleKey &key);
+
+class DSMCCModuleStore
+{
+  public:
+    DSMCCModuleStore() : m_Contents(kMaxBytes) {}
+
+    // Save the data of a completed module.
+    void Add(const DSMCCModuleKey &key, const QByteArray &data);
+    // Return the saved data of a module, empty if we don't have it.
+    QByteArray Find(const DSMCCModuleKey &key);
+
+    static const int kMaxBytes = 16 * 1024 * 1024;
+
+  protected:
+    // Module versions and the SHA-1 of their contents.
+    QHash<DSMCCModuleKey, QByteArray> m_Index;
+    // Module contents by SHA-1, cost is the size in bytes.
+    QCache<QByteArray, QByteArray>    m_Contents;
+};
+
 #endif
@@ -193,8 +193,11 @@ void ObjCarousel::AddModuleInfo(DsmccDii *dii, Dsmcc *status,
                 LOG(VB_DSMCC, LOG_INFO, QString("[dsmcc] Updated Module %1")
                         .arg(info->module_id));
 
-                // Remove and delete the cache object.
+                // Remove and delete the cache object and forget the
+                // objects which came from the old version.
                 m_Cache.erase(it);
+                filecache.RemoveModule(cachep->CarouselId(),
+                                       cachep->ModuleId());
                 delete cachep;
                 break;
             }
@@ -218,6 +221,48 @@ void ObjCarousel::AddModuleInfo(DsmccDii *dii, Dsmcc *status,
 
         // Add this module to the cache.
         m_Cache.append(cachep);
+
+        // If we have seen this version of the module before we
+        // don't need to wait for its blocks.
+        QByteArray data =
+            status->GetModuleStore()->Find(ModuleKey(cachep));
+        if (!data.isEmpty())
+        {
+            LOG(VB_DSMCC, LOG_INFO, QString("[dsmcc] Module %1 version %2 "
+                                            "restored from the store")
+                .arg(cachep->ModuleId()).arg(cachep->Version()));
+            cachep->SetCompleted();
+            // BIOP processing takes a writable buffer, so this detaches.
+            ProcessModule(cachep, (unsigned char*) data.data(), data.size());
+        }
+    }
+}
+
+/// The key of a module in the module store of the Dsmcc
+DSMCCModuleKey ObjCarousel::ModuleKey(const DSMCCCacheModuleData *cachep) const
+{
+    return DSMCCModuleKey(filecache.m_Dsmcc->GetServiceId(),
+                          cachep->CarouselId(), cachep->ModuleId(),
+                          cachep->Version(), cachep->ModuleSize());
+}
+
+/** \fn ObjCarousel::ProcessModule(DSMCCCacheModuleData*,unsigned char*,unsigned long)
+ *  \brief Process the BIOP tables of a complete module.
+ *
+ *   Tables may be file contents or the descriptions of
+ *   directories or service gateways (root directories).
+ */
+void ObjCarousel::ProcessModule(DSMCCCacheModuleData *cachep,
+                                unsigned char *data, unsigned long len)
+{
+    unsigned long curp = 0;
+    LOG(VB_DSMCC, LOG_DEBUG, QString("[biop] Module size (uncompressed) = %1").arg(len));
+
+    while (curp < len)
+    {
+        BiopMessage bm;
+        if (!bm.Process(cachep, &filecache, data, &curp))
+            break;
     }
 }
 
@@ -243,19 +288,14 @@ void ObjCarousel::AddModuleData(DsmccDb *ddb, const unsigned char *data)
             if (tmp_data)
             {
                 // It is complete and we have the data
-                unsigned int len   = cachep->DataSize();
-                unsigned long curp = 0;
-                LOG(VB_DSMCC, LOG_DEBUG, QString("[biop] Module size (uncompressed) = %1").arg(len));
+                unsigned int len = cachep->DataSize();
+
+                // Keep it for when we come back to this service.
+                filecache.m_Dsmcc->GetModuleStore()->Add(
+                    ModuleKey(cachep), QByteArray((const char*) tmp_data, len));
 
                 // Now process the BIOP tables in this module.
-                // Tables may be file contents or the descriptions of
-                // directories or service gateways (root directories).
-                while (curp < len)
-                {
-                    BiopMessage bm;
-                    if (!bm.Process(cachep, &filecache, tmp_data, &curp))
-                        break;
-                }
+                ProcessModule(cachep, tmp_data, len);
                 free(tmp_data);
             }
             return;
@@ -30,6 +30,8 @@ class DSMCCCacheModuleData
     ~DSMCCCacheModuleData();
 
     unsigned char *AddModuleData(DsmccDb *ddb, const unsigned char *Data);
+    /// Mark the module complete when its data came from the module store
+    void SetCompleted(void) { m_completed = true; m_blocks.clear(); }
 
     unsigned long  CarouselId(void) const { return m_carousel_id; }
     unsigned short ModuleId(void)   const { return m_module_id;   }
@@ -69,6 +71,13 @@ class ObjCarousel
     void AddModuleInfo(DsmccDii *dii, Dsmcc *status, unsigned short streamTag);
     void AddModuleData(DsmccDb *ddb, const unsigned char *data);
 
+  protected:
+    void ProcessModule(DSMCCCacheModuleData *cachep,
+                       unsigned char *data, unsigned long len);
+    DSMCCModuleKey ModuleKey(const DSMCCCacheModuleData *cachep) const;
+
+  public:
+
     DSMCCCache                     filecache;
     QLinkedList<DSMCCCacheModuleData*> m_Cache;
     /// Component tags matched to this carousel.
@@ -552,6 +552,22 @@ int FileRingBuffer::safe_read(int fd, void *data, uint sz)
         if (tot < sz)
             usleep(60000);
     }
+
+#ifndef _MSC_VER
+    // Streaming readers won't seek, so let the kernel start on the
+    // next couple of blocks while the last one is being consumed.
+    // The callers hold rwlock, so the policy comes from its atomic copy.
+    // Reads start at internalreadpos, as the EOF check above relies on,
+    // so the next block starts right after what was just read.
+    off_t next = internalreadpos + tot;
+    if (tot > 0 && willneedreads.load() &&
+        posix_fadvise(fd, next, 2 * readblocksize, POSIX_FADV_WILLNEED) < 0)
+    {
+        LOG(VB_FILE, LOG_DEBUG, LOC +
+            QString("safe_read(): fadvise willneed failed: ") + ENO);
+    }
+#endif
+
     return tot;
 }
 
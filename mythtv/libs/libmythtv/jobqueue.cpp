@@ -6,12 +6,15 @@
 #include <cstdlib>
 #include <fcntl.h>
 #include <pthread.h>
+#include <algorithm>
 using namespace std;
 
 #include <QDateTime>
+#include <QFile>
 #include <QFileInfo>
 #include <QRegExp>
 #include <QEvent>
+#include <QThread>
 #include <QCoreApplication>
 
 #include "mythconfig.h"
@@ -43,6 +46,34 @@ using namespace std;
 
 #define LOC     QString("JobQueue: ")
 
+/// How long the host holding a recording gets to claim its jobs first
+static const int kLocalityWait = 2 * 60;
+
+/** \brief Keeps the in-use marks a stopped job left on its recording.
+ *
+ *   A job paused with SIGSTOP can't refresh the marks it made itself, and
+ *   after an hour they would no longer protect the recording from being
+ *   deleted or expired. Marks of players are left to the players.
+ */
+static void refresh_paused_inuse_marks(const ProgramInfo &pginfo)
+{
+    MSqlQuery query(MSqlQuery::InitCon());
+    query.prepare(
+        "UPDATE inuseprograms SET lastupdatetime = :UPDATETIME "
+        "WHERE chanid   = :CHANID   AND starttime = :STARTTIME AND "
+        "      hostname = :HOSTNAME AND recusage NOT LIKE :PLAYER AND "
+        "      lastupdatetime < :STALETIME");
+    query.bindValue(":UPDATETIME", MythDate::current());
+    query.bindValue(":CHANID",     pginfo.GetChanID());
+    query.bindValue(":STARTTIME",  pginfo.GetRecordingStartTime());
+    query.bindValue(":HOSTNAME",   gCoreContext->GetHostName());
+    query.bindValue(":PLAYER",     QString("%%1%").arg(kPlayerInUseID));
+    query.bindValue(":STALETIME",  MythDate::current().addSecs(-15 * 60));
+
+    if (!query.exec())
+        MythDB::DBError("refresh_paused_inuse_marks", query);
+}
+
 JobQueue::JobQueue(bool master) :
     m_hostname(gCoreContext->GetHostName()),
     jobsRunning(0),
@@ -50,8 +81,14 @@ JobQueue::JobQueue(bool master) :
     m_pginfo(NULL),
     runningJobsLock(new QMutex(QMutex::Recursive)),
     isMaster(master),
+    hostCPULoad(0.0),
+    hostIOWait(0),
+    hostRecordings(0),
+    lastCPUTotal(0),
+    lastCPUIOWait(0),
     queueThread(new MThread("JobQueue", this)),
-    processQueue(false)
+    processQueue(false),
+    queueWoken(false)
 {
     jobQueueCPU = gCoreContext->GetNumSetting("JobQueueCPU", 0);
 
@@ -81,6 +118,9 @@ JobQueue::~JobQueue(void)
 
     gCoreContext->removeListener(this);
 
+    // Don't leave the jobs we stopped behind us
+    ResumePausedJobs();
+
     delete runningJobsLock;
 }
 
@@ -91,7 +131,15 @@ void JobQueue::customEvent(QEvent *e)
         MythEvent *me = (MythEvent *)e;
         QString message = me->Message();
 
-        if (message.startsWith("LOCAL_JOB"))
+        if (message == "JOBQUEUE_CHANGED" ||
+            message.startsWith("SYSTEM_EVENT REC_STARTED ") ||
+            message.startsWith("SYSTEM_EVENT REC_FINISHED "))
+        {
+            // A job was queued or a command given to one, or a recording
+            // started or finished, either may change what we can run.
+            WakeQueue();
+        }
+        else if (message.startsWith("LOCAL_JOB"))
         {
             // LOCAL_JOB action ID jobID
             // LOCAL_JOB action type chanid recstartts hostname
@@ -202,11 +250,18 @@ void JobQueue::ProcessQueue(void)
         for (rjiter = runningJobs.begin(); rjiter != runningJobs.end();
             ++rjiter)
         {
-            if ((*rjiter).pginfo)
-                (*rjiter).pginfo->UpdateInUseMark();
+            if (!(*rjiter).pginfo)
+                continue;
+
+            (*rjiter).pginfo->UpdateInUseMark();
+            if (pausedForRecording.contains(rjiter.key()))
+                refresh_paused_inuse_marks(*(*rjiter).pginfo);
         }
         runningJobsLock->unlock();
 
+        UpdateHostLoad();
+        UpdateRecordingPause();
+
         jobsRunning = 0;
         GetJobsInQueue(jobs);
 
@@ -341,6 +396,12 @@ void JobQueue::ProcessQueue(void)
                         runningJobsLock->lock();
                         if (runningJobs.contains(jobID))
                             runningJobs[jobID].flag = JOB_STOP;
+                        // A stopped process can't see the STOP command
+                        if (pausedForRecording.contains(jobID))
+                        {
+                            SignalJob(jobID, false);
+                            pausedForRecording.remove(jobID);
+                        }
                         runningJobsLock->unlock();
 
                         // ChangeJobCmds(m_db, jobID, JOB_RUN);
@@ -435,6 +496,31 @@ void JobQueue::ProcessQueue(void)
                 if (startedJobAlready)
                     continue;
 
+                // Leave the job to another host rather than piling it
+                // onto this one while it is saturated
+                QString busyReason;
+                if ((inTimeWindow) && (HostIsBusy(jobs[x], busyReason)))
+                {
+                    message = QString("Skipping '%1' job for %2, %3")
+                                      .arg(JobText(jobs[x].type)).arg(logInfo)
+                                      .arg(busyReason);
+                    LOG(VB_JOBQUEUE, LOG_INFO, LOC + message);
+                    continue;
+                }
+
+                if ((inTimeWindow) &&
+                    (hostname.isEmpty()) &&
+                    (!IsPreferredHost(jobs[x])))
+                {
+                    message = QString("Skipping '%1' job for %2, "
+                                      "waiting for '%3' which holds the "
+                                      "recording to claim it.")
+                                      .arg(JobText(jobs[x].type)).arg(logInfo)
+                                      .arg(jobs[x].filehost);
+                    LOG(VB_JOBQUEUE, LOG_INFO, LOC + message);
+                    continue;
+                }
+
                 if ((inTimeWindow) &&
                     (hostname.isEmpty()) &&
                     (!ChangeJobHost(jobID, m_hostname)))
@@ -491,12 +577,15 @@ void JobQueue::ProcessQueue(void)
 
 
         locker.relock();
-        if (processQueue)
+        if (processQueue && !queueWoken)
         {
+            // Jobs being queued and recordings finishing wake us through
+            // WakeQueue(), the check frequency is only a fallback.
             int st = (startedJobAlready) ? (5 * 1000) : (sleepTime * 1000);
             if (st > 0)
                 queueThreadCond.wait(locker.mutex(), st);
         }
+        queueWoken = false;
     }
 }
 
@@ -609,6 +698,8 @@ bool JobQueue::QueueJob(int jobType, uint chanid, const QDateTime &recstartts,
         return false;
     }
 
+    gCoreContext->SendMessage("JOBQUEUE_CHANGED");
+
     return true;
 }
 
@@ -921,6 +1012,10 @@ bool JobQueue::ChangeJobCmds(int jobID, int newCmds)
         return false;
     }
 
+    // JOB_RUN is how the queue acknowledges a command, don't wake it for that
+    if (newCmds != JOB_RUN)
+        gCoreContext->SendMessage("JOBQUEUE_CHANGED");
+
     return true;
 }
 
@@ -943,6 +1038,9 @@ bool JobQueue::ChangeJobCmds(int jobType, uint chanid,
         return false;
     }
 
+    if (newCmds != JOB_RUN)
+        gCoreContext->SendMessage("JOBQUEUE_CHANGED");
+
     return true;
 }
 
@@ -1278,7 +1376,8 @@ int JobQueue::GetJobsInQueue(QMap<int, JobQueueEntry> &jobs, int findJobs)
 
     query.prepare("SELECT j.id, j.chanid, j.starttime, j.inserttime, j.type, "
                       "j.cmds, j.flags, j.status, j.statustime, j.hostname, "
-                      "j.args, j.comment, r.endtime, j.schedruntime "
+                      "j.args, j.comment, r.endtime, j.schedruntime, "
+                      "r.hostname "
                   "FROM jobqueue j "
                   "LEFT JOIN recorded r "
                   "  ON j.chanid = r.chanid AND j.starttime = r.starttime "
@@ -1366,6 +1465,7 @@ int JobQueue::GetJobsInQueue(QMap<int, JobQueueEntry> &jobs, int findJobs)
         thisJob.hostname = query.value(9).toString();
         thisJob.args = query.value(10).toString();
         thisJob.comment = query.value(11).toString();
+        thisJob.filehost = query.value(14).toString();
 
         if ((thisJob.type & JOB_USERJOB) &&
             (UserJobTypeToIndex(thisJob.type) == 0))
@@ -1420,37 +1520,222 @@ bool JobQueue::ChangeJobHost(int jobID, QString newHostname)
 
 bool JobQueue::AllowedToRun(JobQueueEntry job)
 {
-    QString allowSetting;
-
     if ((!job.hostname.isEmpty()) &&
         (job.hostname != m_hostname))
         return false;
 
-    if (job.type & JOB_USERJOB)
+    QString allowSetting = GetJobAllowSetting(job.type);
+    if (allowSetting.isEmpty())
+        return false;
+
+    if (gCoreContext->GetNumSetting(allowSetting, 1))
+        return true;
+
+    return false;
+}
+
+/// Returns the host setting which allows a host to run jobs of this type
+QString JobQueue::GetJobAllowSetting(int jobType)
+{
+    if (jobType & JOB_USERJOB)
+        return QString("JobAllowUserJob%1").arg(UserJobTypeToIndex(jobType));
+
+    switch (jobType)
     {
-        allowSetting =
-            QString("JobAllowUserJob%1").arg(UserJobTypeToIndex(job.type));
+        case JOB_TRANSCODE:  return "JobAllowTranscode";
+        case JOB_COMMFLAG:   return "JobAllowCommFlag";
+        case JOB_METADATA:   return "JobAllowMetadata";
+        default:             return QString();
     }
-    else
+}
+
+/// Makes ProcessQueue() look at the queue now rather than after its sleep
+void JobQueue::WakeQueue(void)
+{
+    QMutexLocker locker(&queueThreadCondLock);
+    queueWoken = true;
+    queueThreadCond.wakeAll();
+}
+
+/** \fn JobQueue::UpdateHostLoad(void)
+ *  \brief Measures the CPU load, the time spent waiting on I/O since the
+ *         last call, and the number of recordings in progress on this host.
+ */
+void JobQueue::UpdateHostLoad(void)
+{
+#ifndef _WIN32
+    double loads[1];
+    if (getloadavg(loads, 1) != -1)
+        hostCPULoad = loads[0] / max(QThread::idealThreadCount(), 1);
+#endif
+
+#ifdef __linux__
+    QFile stat("/proc/stat");
+    if (stat.open(QIODevice::ReadOnly))
     {
-        switch (job.type)
+        // cpu  user nice system idle iowait irq softirq steal ...
+        QStringList fields = QString(stat.readLine(256))
+            .split(" ", QString::SkipEmptyParts);
+        if (fields.size() > 5 && fields[0] == "cpu")
         {
-            case JOB_TRANSCODE:  allowSetting = "JobAllowTranscode";
-                                 break;
-            case JOB_COMMFLAG:   allowSetting = "JobAllowCommFlag";
-                                 break;
-            case JOB_METADATA:   allowSetting = "JobAllowMetadata";
-                                 break;
-            default:             return false;
+            quint64 total = 0;
+            for (int i = 1; i < fields.size(); ++i)
+                total += fields[i].toULongLong();
+            quint64 iowait = fields[5].toULongLong();
+
+            if (lastCPUTotal && total > lastCPUTotal)
+            {
+                hostIOWait = (int)((100 * (iowait - lastCPUIOWait)) /
+                                   (total - lastCPUTotal));
+            }
+            lastCPUTotal  = total;
+            lastCPUIOWait = iowait;
         }
     }
+#endif
 
-    if (gCoreContext->GetNumSetting(allowSetting, 1))
+    MSqlQuery query(MSqlQuery::InitCon());
+    query.prepare("SELECT COUNT(*) FROM inuseprograms "
+                  "WHERE hostname = :HOSTNAME AND recusage = :RECUSAGE "
+                  "  AND lastupdatetime > :ONEHOURAGO ;");
+    query.bindValue(":HOSTNAME", m_hostname);
+    query.bindValue(":RECUSAGE", kRecorderInUseID);
+    query.bindValue(":ONEHOURAGO", MythDate::current().addSecs(-60 * 60));
+
+    if (!query.exec())
+        MythDB::DBError("JobQueue::UpdateHostLoad()", query);
+    else if (query.next())
+        hostRecordings = query.value(0).toInt();
+
+    LOG(VB_JOBQUEUE, LOG_DEBUG, LOC +
+        QString("Host load %1%, I/O wait %2%, %3 recording(s) in progress")
+            .arg((int)(hostCPULoad * 100)).arg(hostIOWait)
+            .arg(hostRecordings));
+}
+
+/** \fn JobQueue::HostIsBusy(const JobQueueEntry&,QString&) const
+ *  \brief Returns true if this host is too loaded to start the job now.
+ *
+ *   The limits are the JobQueueMaxLoad and JobQueueMaxIOWait host
+ *   settings, both off by default so a lone backend never sits on its
+ *   jobs, and if JobQueuePauseWhileRecording is set low priority jobs
+ *   are not started while this host is recording. Metadata lookups are
+ *   cheap and always allowed.
+ */
+bool JobQueue::HostIsBusy(const JobQueueEntry &job, QString &reason) const
+{
+    if (job.type == JOB_METADATA)
+        return false;
+
+    if (hostRecordings > 0 && IsLowPriority(job.type) &&
+        gCoreContext->GetNumSetting("JobQueuePauseWhileRecording", 0))
+    {
+        reason = QString("%1 recording(s) in progress on this backend.")
+                     .arg(hostRecordings);
         return true;
+    }
+
+    int maxLoad = gCoreContext->GetNumSetting("JobQueueMaxLoad", 0);
+    if (maxLoad > 0 && (hostCPULoad * 100) > maxLoad)
+    {
+        reason = QString("CPU load of %1% is above the %2% limit.")
+                     .arg((int)(hostCPULoad * 100)).arg(maxLoad);
+        return true;
+    }
+
+    int maxIOWait = gCoreContext->GetNumSetting("JobQueueMaxIOWait", 0);
+    if (maxIOWait > 0 && hostIOWait > maxIOWait)
+    {
+        reason = QString("I/O wait of %1% is above the %2% limit.")
+                     .arg(hostIOWait).arg(maxIOWait);
+        return true;
+    }
 
     return false;
 }
 
+/** \fn JobQueue::IsPreferredHost(const JobQueueEntry&) const
+ *  \brief Returns false while the job should be left for the host whose
+ *         storage group holds the recording.
+ *
+ *   Running a job where the file is saves streaming the whole recording
+ *   over the network, so that host gets the first kLocalityWait seconds
+ *   to claim the job, unless it is not allowed to run jobs of this type.
+ */
+bool JobQueue::IsPreferredHost(const JobQueueEntry &job) const
+{
+    if (job.filehost.isEmpty() || job.filehost == m_hostname)
+        return true;
+
+    QDateTime runnable = max(job.inserttime, job.schedruntime);
+    if (runnable.secsTo(MythDate::current()) >= kLocalityWait)
+        return true;
+
+    QString allowSetting = GetJobAllowSetting(job.type);
+    return !gCoreContext->GetNumSettingOnHost(allowSetting, job.filehost, 1);
+}
+
+/// Transcodes and user jobs are the jobs which can wait for a recording
+bool JobQueue::IsLowPriority(int jobType)
+{
+    return (jobType == JOB_TRANSCODE) || (jobType & JOB_USERJOB);
+}
+
+/** \fn JobQueue::UpdateRecordingPause(void)
+ *  \brief Stops the low priority jobs running on this host while it is
+ *         recording, and continues them when it is done.
+ *
+ *   Only done when the JobQueuePauseWhileRecording host setting is set.
+ *   While a job is stopped the queue keeps its in-use marks fresh.
+ */
+void JobQueue::UpdateRecordingPause(void)
+{
+    bool pause = hostRecordings > 0 &&
+        gCoreContext->GetNumSetting("JobQueuePauseWhileRecording", 0);
+
+    if (!pause)
+    {
+        ResumePausedJobs();
+        return;
+    }
+
+    QMutexLocker locker(runningJobsLock);
+
+    QMap<int, RunningJobInfo>::iterator it = runningJobs.begin();
+    for (; it != runningJobs.end(); ++it)
+    {
+        if (!IsLowPriority((*it).type) || pausedForRecording.contains(it.key()))
+            continue;
+
+        if (SignalJob(it.key(), true))
+        {
+            LOG(VB_JOBQUEUE, LOG_INFO, LOC +
+                QString("Pausing '%1' job %2 while recording")
+                    .arg(JobText((*it).type)).arg(it.key()));
+            pausedForRecording.insert(it.key());
+            ChangeJobStatus(it.key(), JOB_PAUSED,
+                            tr("Paused while recording"));
+        }
+    }
+}
+
+void JobQueue::ResumePausedJobs(void)
+{
+    QMutexLocker locker(runningJobsLock);
+
+    QSet<int>::const_iterator it = pausedForRecording.begin();
+    for (; it != pausedForRecording.end(); ++it)
+    {
+        if (SignalJob(*it, false))
+        {
+            LOG(VB_JOBQUEUE, LOG_INFO, LOC +
+                QString("Resuming job %1").arg(*it));
+            ChangeJobStatus(*it, JOB_RUNNING);
+        }
+    }
+    pausedForRecording.clear();
+}
+
 enum JobCmds JobQueue::GetJobCmd(int jobID)
 {
     MSqlQuery query(MSqlQuery::InitCon());
@@ -1696,6 +1981,7 @@ void JobQueue::ProcessJob(JobQueueEntry job)
     jInfo.desc    = GetJobDescription(job.type);
     jInfo.command = GetJobCommand(jobID, job.type, pginfo);
     jInfo.pginfo  = pginfo;
+    jInfo.process = NULL;
 
     runningJobs[jobID] = jInfo;
 
@@ -1831,10 +2117,59 @@ void JobQueue::RemoveRunningJob(int id)
 
         runningJobs.remove(id);
     }
+    pausedForRecording.remove(id);
 
     runningJobsLock->unlock();
 }
 
+/** \fn JobQueue::RunJobCommand(int,const QString&,uint)
+ *  \brief Runs the command of a job like myth_system(), keeping the
+ *         process in runningJobs so SignalJob() can pause it.
+ *
+ *   The shell runs in a process group of its own, so that everything
+ *   a user job script starts is paused along with it.
+ */
+uint JobQueue::RunJobCommand(int jobID, const QString &command, uint flags)
+{
+    flags |= kMSRunShell | kMSAutoCleanup | kMSProcessGroup;
+    MythSystemLegacy *ms = new MythSystemLegacy(command, flags);
+    ms->Run();
+
+    runningJobsLock->lock();
+    if (runningJobs.contains(jobID))
+        runningJobs[jobID].process = ms;
+    runningJobsLock->unlock();
+
+    uint result = ms->Wait(0);
+
+    runningJobsLock->lock();
+    if (runningJobs.contains(jobID))
+        runningJobs[jobID].process = NULL;
+    runningJobsLock->unlock();
+
+    if (!ms->GetSetting("RunInBackground"))
+        delete ms;
+
+    return result;
+}
+
+/** \fn JobQueue::SignalJob(int,bool)
+ *  \brief Stops or continues the processes of a running job.
+ *
+ *   The signal goes to the process group of the job command, SIGSTOP
+ *   can not be caught so every process in it has stopped once it is
+ *   delivered. runningJobsLock must be held.
+ *  \return true if the signal was delivered
+ */
+bool JobQueue::SignalJob(int jobID, bool pause)
+{
+    if (!runningJobs.contains(jobID) || !runningJobs[jobID].process)
+        return false;
+
+    return runningJobs[jobID].process->Signal(
+        pause ? kSignalStop : kSignalContinue);
+}
+
 QString JobQueue::PrettyPrint(off_t bytes)
 {
     // Pretty print "bytes" as KB, MB, GB, TB, etc., subject to the desired
@@ -1994,7 +2329,7 @@ void JobQueue::DoTranscodeThread(int jobID)
                                            .arg(command));
 
         GetMythDB()->GetDBManager()->CloseDatabases();
-        uint result = myth_system(command);
+        uint result = RunJobCommand(jobID, command);
         int status = GetJobStatus(jobID);
 
         if ((result == GENERIC_EXIT_DAEMONIZING_ERROR) ||
@@ -2169,7 +2504,7 @@ void JobQueue::DoMetadataLookupThread(int jobID)
             .arg(command));
 
     GetMythDB()->GetDBManager()->CloseDatabases();
-    retVal = myth_system(command);
+    retVal = RunJobCommand(jobID, command);
     int priority = LOG_NOTICE;
     QString comment;
 
@@ -2306,7 +2641,7 @@ void JobQueue::DoFlagCommercialsThread(int jobID)
             .arg(command));
 
     GetMythDB()->GetDBManager()->CloseDatabases();
-    breaksFound = myth_system(command, kMSLowExitVal);
+    breaksFound = RunJobCommand(jobID, command, kMSLowExitVal);
     int priority = LOG_NOTICE;
     QString comment;
 
@@ -2424,7 +2759,7 @@ void JobQueue::DoUserJobThread(int jobID)
     LOG(VB_JOBQUEUE, LOG_INFO, LOC + QString("Running command: '%1'")
                                        .arg(command));
     GetMythDB()->GetDBManager()->CloseDatabases();
-    uint result = myth_system(command);
+    uint result = RunJobCommand(jobID, command);
 
     if ((result == GENERIC_EXIT_DAEMONIZING_ERROR) ||
         (result == GENERIC_EXIT_CMD_NOT_FOUND))
@@ -10,10 +10,12 @@
 #include <QEvent>
 #include <QMutex>
 #include <QMap>
+#include <QSet>
 
 #include "mythtvexp.h"
 
 class MThread;
+class MythSystemLegacy;
 class ProgramInfo;
 class RecordingInfo;
 
@@ -100,6 +102,7 @@ typedef struct jobqueueentry {
     QString hostname;
     QString args;
     QString comment;
+    QString filehost; ///< host whose storage group holds the recording
 } JobQueueEntry;
 
 typedef struct runningjobinfo {
@@ -109,6 +112,7 @@ typedef struct runningjobinfo {
     QString      desc;
     QString      command;
     ProgramInfo *pginfo;
+    MythSystemLegacy *process;
 } RunningJobInfo;
 
 class JobQueue;
@@ -212,6 +216,16 @@ class MTV_PUBLIC JobQueue : public QObject, public QRunnable
     void ProcessJob(JobQueueEntry job);
 
     bool AllowedToRun(JobQueueEntry job);
+    static QString GetJobAllowSetting(int jobType);
+
+    void WakeQueue(void);
+    void UpdateHostLoad(void);
+    bool HostIsBusy(const JobQueueEntry &job, QString &reason) const;
+    bool IsPreferredHost(const JobQueueEntry &job) const;
+    static bool IsLowPriority(int jobType);
+    void UpdateRecordingPause(void);
+    void ResumePausedJobs(void);
+    bool SignalJob(int jobID, bool pause);
 
     static bool InJobRunWindow(int orStartingWithinMins = 0);
 
@@ -220,6 +234,7 @@ class MTV_PUBLIC JobQueue : public QObject, public QRunnable
     QString GetJobDescription(int jobType);
     QString GetJobCommand(int id, int jobType, ProgramInfo *tmpInfo);
     void RemoveRunningJob(int id);
+    uint RunJobCommand(int jobID, const QString &command, uint flags = 0);
 
     static QString PrettyPrint(off_t bytes);
 
@@ -250,10 +265,21 @@ class MTV_PUBLIC JobQueue : public QObject, public QRunnable
 
     bool isMaster;
 
+    /// Jobs stopped with SIGSTOP because a recording started
+    QSet<int> pausedForRecording;
+
+    // Measured load of this host
+    double  hostCPULoad;
+    int     hostIOWait;
+    int     hostRecordings;
+    quint64 lastCPUTotal;
+    quint64 lastCPUIOWait;
+
     MThread *queueThread;
     QWaitCondition queueThreadCond;
     QMutex queueThreadCondLock;
     bool processQueue;
+    bool queueWoken;
 };
 
 #endif
@@ -205,7 +205,8 @@ HEADERS += mpeg/atsc_huffman.h
 HEADERS += mpeg/freesat_huffman.h   mpeg/freesat_tables.h
 HEADERS += mpeg/iso6937tables.h
 HEADERS += mpeg/tsstats.h           mpeg/streamlisteners.h
-HEADERS += mpeg/H264Parser.h
+HEADERS += mpeg/H264Parser.h       mpeg/HEVCParser.h
+HEADERS += mpeg/shareddemux.h
 
 SOURCES += mpeg/tspacket.cpp        mpeg/pespacket.cpp
 SOURCES += mpeg/mpegtables.cpp      mpeg/atsctables.cpp
@@ -220,7 +221,8 @@ SOURCES += mpeg/dishdescriptors.cpp mpeg/premieredescriptors.cpp
 SOURCES += mpeg/atsc_huffman.cpp
 SOURCES += mpeg/freesat_huffman.cpp
 SOURCES += mpeg/iso6937tables.cpp
-SOURCES += mpeg/H264Parser.cpp
+SOURCES += mpeg/H264Parser.cpp     mpeg/HEVCParser.cpp
+SOURCES += mpeg/shareddemux.cpp
 
 # Channels, and the multiplexes that transmit them
 HEADERS += frequencies.h            frequencytables.h
@@ -301,6 +303,8 @@ HEADERS += HLS/httplivestreambuffer.h
 SOURCES += HLS/httplivestreambuffer.cpp
 HEADERS += HLS/m3u.h
 SOURCES += HLS/m3u.cpp
+HEADERS += HLS/httplivestreamremuxer.h
+SOURCES += HLS/httplivestreamremuxer.cpp
 using_libcrypto:DEFINES += USING_LIBCRYPTO
 using_libcrypto:LIBS    += -lcrypto
 
@@ -534,6 +538,7 @@ using_backend {
     HEADERS += channelscan/panedvbutilsimport.h
     HEADERS += channelscan/panesingle.h
     HEADERS += channelscan/scanmonitor.h
+    HEADERS += channelscan/scancoordinator.h
     HEADERS += channelscan/scanwizardconfig.h
 
     SOURCES += channelscan/channelscan_sm.cpp
@@ -547,6 +552,7 @@ using_backend {
     SOURCES += channelscan/multiplexsetting.cpp
     SOURCES += channelscan/paneanalog.cpp
     SOURCES += channelscan/scanmonitor.cpp
+    SOURCES += channelscan/scancoordinator.cpp
     SOURCES += channelscan/scanwizardconfig.cpp
 
     # EIT stuff
@@ -567,9 +573,11 @@ using_backend {
     HEADERS += recorders/recorderbase.h
     HEADERS += recorders/DeviceReadBuffer.h
     HEADERS += recorders/dtvrecorder.h
+    HEADERS += recorders/recordermetrics.h
     SOURCES += recorders/recorderbase.cpp
     SOURCES += recorders/DeviceReadBuffer.cpp
     SOURCES += recorders/dtvrecorder.cpp
+    SOURCES += recorders/recordermetrics.cpp
 
     # Import recorder
     HEADERS += recorders/importrecorder.h
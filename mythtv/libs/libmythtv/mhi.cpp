@@ -203,7 +203,10 @@ void MHIContext::Restart(int chanid, int sourceid, bool isLive)
         {
             QMutexLocker locker(&m_dsmccLock);
             if (tuneinfo & kTuneCarReset)
+            {
+                m_dsmcc->SetServiceId(chanid);
                 m_dsmcc->Reset();
+            }
             ClearQueue();
         }
 
@@ -222,6 +225,7 @@ void MHIContext::Restart(int chanid, int sourceid, bool isLive)
 
         {
             QMutexLocker locker(&m_dsmccLock);
+            m_dsmcc->SetServiceId(chanid);
             m_dsmcc->Reset();
             ClearQueue();
         }
@@ -0,0 +1,790 @@
+// MythTV headers
+#include "HEVCParser.h"
+#include "mythlogging.h"
+#include "recorders/dtvrecorder.h" // for FrameRate
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+#include "libavcodec/mpegvideo.h"
+#include "libavcodec/golomb.h"
+}
+
+#include <algorithm>
+#include <cmath>
+
+static const float eps = 1E-5;
+
+/*
+  Most of the comments below were cut&paste from ITU-T Rec. H.265
+  as found here:  http://www.itu.int/rec/T-REC-H.265/e
+ */
+
+/*
+  Useful definitions:
+
+  * access unit: A set of NAL units that are associated with each other
+  according to a specified classification rule, are consecutive in
+  decoding order, and contain exactly one coded picture with nuh_layer_id
+  equal to 0.
+
+  * intra random access point (IRAP) picture: A coded picture for which
+  each VCL NAL unit has nal_unit_type in the range of BLA_W_LP to
+  RSV_IRAP_VCL23, inclusive. An IRAP picture contains only I slices, and
+  may be a BLA picture, a CRA picture or an IDR picture. Decoding can
+  start at any IRAP picture, the RASL pictures associated with a CRA or
+  BLA picture are then not output.
+
+  * first_slice_segment_in_pic_flag: The first bit of every slice segment
+  header, equal to 1 for the first slice segment of a picture in
+  decoding order.
+*/
+
+HEVCParser::HEVCParser(void)
+{
+    rbsp_buffer_size = 188 * 2;
+    rbsp_buffer = new uint8_t[rbsp_buffer_size];
+    if (rbsp_buffer == 0)
+        rbsp_buffer_size = 0;
+
+    Reset();
+}
+
+void HEVCParser::Reset(void)
+{
+    state_changed = false;
+    seen_sps = false;
+    SPS_offset = 0;
+
+    sync_accumulator = 0xffffffff;
+    AU_pending = false;
+
+    nal_unit_type = UNKNOWN;
+    nuh_layer_id_msb = 0;
+
+    chroma_format_idc = 1;
+    separate_colour_plane_flag = 0;
+    pic_width = pic_height = 0;
+    conf_win_left_offset = conf_win_right_offset = 0;
+    conf_win_top_offset = conf_win_bottom_offset = 0;
+    aspect_ratio_idc = 0;
+    sar_width = sar_height = 0;
+    unitsInTick = timeScale = 0;
+    vpsUnitsInTick = vpsTimeScale = 0;
+    memset(num_delta_pocs, 0, sizeof(num_delta_pocs));
+
+    pkt_offset = AU_offset = frame_start_offset = keyframe_start_offset = 0;
+    on_frame = on_key_frame = false;
+
+    resetRBSP();
+}
+
+QString HEVCParser::NAL_type_str(uint8_t type)
+{
+    switch (type)
+    {
+      case TRAIL_N:
+        return "TRAIL_N";
+      case TRAIL_R:
+        return "TRAIL_R";
+      case TSA_N:
+        return "TSA_N";
+      case TSA_R:
+        return "TSA_R";
+      case STSA_N:
+        return "STSA_N";
+      case STSA_R:
+        return "STSA_R";
+      case RADL_N:
+        return "RADL_N";
+      case RADL_R:
+        return "RADL_R";
+      case RASL_N:
+        return "RASL_N";
+      case RASL_R:
+        return "RASL_R";
+      case BLA_W_LP:
+        return "BLA_W_LP";
+      case BLA_W_RADL:
+        return "BLA_W_RADL";
+      case BLA_N_LP:
+        return "BLA_N_LP";
+      case IDR_W_RADL:
+        return "IDR_W_RADL";
+      case IDR_N_LP:
+        return "IDR_N_LP";
+      case CRA_NUT:
+        return "CRA_NUT";
+      case VPS_NUT:
+        return "VPS";
+      case SPS_NUT:
+        return "SPS";
+      case PPS_NUT:
+        return "PPS";
+      case AUD_NUT:
+        return "AUD";
+      case EOS_NUT:
+        return "EOS";
+      case EOB_NUT:
+        return "EOB";
+      case FD_NUT:
+        return "FD";
+      case PREFIX_SEI_NUT:
+        return "PREFIX_SEI";
+      case SUFFIX_SEI_NUT:
+        return "SUFFIX_SEI";
+    }
+    return "OTHER";
+}
+
+void HEVCParser::resetRBSP(void)
+{
+    rbsp_index = 0;
+    consecutive_zeros = 0;
+    have_unfinished_NAL = false;
+}
+
+bool HEVCParser::fillRBSP(const uint8_t *byteP, uint32_t byte_count,
+                          bool found_start_code)
+{
+    /*
+      bitstream buffer, must be FF_INPUT_BUFFER_PADDING_SIZE
+      bytes larger then the actual data
+    */
+    uint32_t required_size = rbsp_index + byte_count +
+                             FF_INPUT_BUFFER_PADDING_SIZE;
+    if (rbsp_buffer_size < required_size)
+    {
+        // Round up to packet size
+        required_size = ((required_size / 188) + 1) * 188;
+
+        /* Need a bigger buffer */
+        uint8_t *new_buffer = new uint8_t[required_size];
+
+        if (new_buffer == NULL)
+        {
+            /* Allocation failed. Discard the new bytes */
+            LOG(VB_GENERAL, LOG_ERR,
+                "HEVCParser::fillRBSP: FAILED to allocate RBSP buffer!");
+            return false;
+        }
+
+        /* Copy across bytes from old buffer */
+        memcpy(new_buffer, rbsp_buffer, rbsp_index);
+        delete [] rbsp_buffer;
+        rbsp_buffer = new_buffer;
+        rbsp_buffer_size = required_size;
+    }
+
+    /* Fill rbsp while we have data */
+    while (byte_count)
+    {
+        /* Copy the byte into the rbsp, unless it
+         * is the 0x03 in a 0x000003 */
+        if (consecutive_zeros < 2 || *byteP != 0x03)
+            rbsp_buffer[rbsp_index++] = *byteP;
+
+        if (*byteP == 0)
+            ++consecutive_zeros;
+        else
+            consecutive_zeros = 0;
+
+        ++byteP;
+        --byte_count;
+    }
+
+    /* If we've found the next start code then that, plus the first byte of
+     * the next NAL, plus the preceding zero bytes will all be in the rbsp
+     * buffer. Move rbsp_index back to the end of the actual rbsp data.
+     */
+    if (found_start_code)
+    {
+        if (rbsp_index >= 4)
+        {
+            rbsp_index -= 4;
+            while (rbsp_index > 0 && rbsp_buffer[rbsp_index-1] == 0)
+                --rbsp_index;
+        }
+        else
+        {
+            /* A NAL unit too short to carry anything we look at */
+            rbsp_index = 0;
+        }
+    }
+
+    /* Stick some 0xff on the end for get_bits to run into */
+    memset(&rbsp_buffer[rbsp_index], 0xff, FF_INPUT_BUFFER_PADDING_SIZE);
+    return true;
+}
+
+uint32_t HEVCParser::addBytes(const uint8_t  *bytes,
+                              const uint32_t  byte_count,
+                              const uint64_t  stream_offset)
+{
+    const uint8_t *startP = bytes;
+    const uint8_t *endP;
+    bool           found_start_code;
+
+    state_changed = false;
+    on_frame      = false;
+    on_key_frame  = false;
+
+    while (startP < bytes + byte_count && !on_frame)
+    {
+        endP = avpriv_find_start_code(startP,
+                                  bytes + byte_count, &sync_accumulator);
+
+        found_start_code = ((sync_accumulator & 0xffffff00) == 0x00000100);
+
+        /* Between startP and endP we potentially have some more
+         * bytes of a NAL that we've been parsing (plus some bytes of
+         * start code)
+         */
+        if (have_unfinished_NAL)
+        {
+            if (!fillRBSP(startP, endP - startP, found_start_code))
+            {
+                resetRBSP();
+                return endP - bytes;
+            }
+            processRBSP(found_start_code); /* Call may set have_unfinished_NAL
+                                            * to false */
+        }
+
+        /* Dealt with everything up to endP */
+        startP = endP;
+
+        if (found_start_code)
+        {
+            /* Prepare for accepting the new NAL */
+            resetRBSP();
+
+            /* If we find the start of an AU somewhere from here
+             * to the next start code, the offset to associate with
+             * it is the one passed in to this call, not any of the
+             * subsequent calls.
+             */
+            pkt_offset = stream_offset;
+
+/*
+  The NAL unit header is two bytes long:
+
+  forbidden_zero_bit    f(1)
+  nal_unit_type         u(6)
+  nuh_layer_id          u(6)
+  nuh_temporal_id_plus1 u(3)
+
+  avpriv_find_start_code() leaves the first of these in the low byte of
+  the sync accumulator, the second one is the first byte of the rbsp.
+*/
+            if (sync_accumulator & 0x80)
+            {
+                LOG(VB_GENERAL, LOG_ERR,
+                    "HEVCParser::addBytes: malformed NAL units");
+                continue;
+            }
+
+            nal_unit_type    = (sync_accumulator >> 1) & 0x3f;
+            nuh_layer_id_msb = sync_accumulator & 0x01;
+
+            if (NALisVCL(nal_unit_type) ||
+                nal_unit_type == VPS_NUT || nal_unit_type == SPS_NUT ||
+                nal_unit_type == PPS_NUT || nal_unit_type == AUD_NUT ||
+                nal_unit_type == PREFIX_SEI_NUT ||
+                (nal_unit_type >= 41 && nal_unit_type <= 44) ||
+                (nal_unit_type >= 48 && nal_unit_type <= 55))
+            {
+                /* We need at least the second header byte to know
+                 * which layer this NAL belongs to.
+                 */
+                have_unfinished_NAL = true;
+            }
+        } //found start code
+    }
+
+    return startP - bytes;
+}
+
+void HEVCParser::processRBSP(bool rbsp_complete)
+{
+    GetBitContext gb;
+
+    /* The second NAL unit header byte, plus the first byte of any
+     * slice segment header.
+     */
+    if (!rbsp_complete && rbsp_index < 2)
+        return;
+
+    have_unfinished_NAL = false;
+
+    if (rbsp_index < 1)
+        return;
+
+    init_get_bits(&gb, rbsp_buffer, 8 * rbsp_index);
+
+    uint nuh_layer_id = (nuh_layer_id_msb << 5) | get_bits(&gb, 5);
+    get_bits(&gb, 3); // nuh_temporal_id_plus1
+
+    /* Only the base layer makes up the access units we index */
+    if (nuh_layer_id)
+        return;
+
+    /*
+      7.4.2.4.4 The first of any of the following NAL units preceding
+      the first VCL NAL unit firstBlPicNalUnit of a coded picture
+      specifies the start of a new access unit:
+
+      - access unit delimiter NAL unit (when present)
+      - VPS NAL unit (when present)
+      - SPS NAL unit (when present)
+      - PPS NAL unit (when present)
+      - Prefix SEI NAL unit (when present)
+      - NAL units with nal_unit_type in the range of RSV_NVCL41..RSV_NVCL44
+      - NAL units with nal_unit_type in the range of UNSPEC48..UNSPEC55
+    */
+    if (NALisVCL(nal_unit_type))
+    {
+        if (rbsp_index < 2)
+            return;
+
+        /* first_slice_segment_in_pic_flag */
+        if (!get_bits1(&gb))
+            return;
+
+        set_AU_pending();
+
+        /* Once we know the picture type of a new AU, we can
+         * determine if it is a keyframe or just a frame
+         */
+        AU_pending = false;
+        state_changed = seen_sps;
+
+        on_frame = true;
+        frame_start_offset = AU_offset;
+
+        if (NALisIRAP(nal_unit_type))
+        {
+            on_key_frame = true;
+            keyframe_start_offset = AU_offset;
+        }
+        return;
+    }
+
+    set_AU_pending();
+
+    if (nal_unit_type == VPS_NUT || nal_unit_type == SPS_NUT)
+    {
+        /* Best wait until we have the whole thing */
+        if (!rbsp_complete)
+        {
+            have_unfinished_NAL = true;
+            return;
+        }
+
+        if (nal_unit_type == VPS_NUT)
+        {
+            decode_VPS(&gb);
+        }
+        else
+        {
+            if (!seen_sps)
+                SPS_offset = pkt_offset;
+            decode_SPS(&gb);
+        }
+    }
+}
+
+void HEVCParser::profile_tier_level(GetBitContext *gb,
+                                    uint max_sub_layers_minus1)
+{
+    /*
+      general_profile_space, general_tier_flag, general_profile_idc,
+      general_profile_compatibility_flag[32], the four source flags,
+      44 reserved/constraint bits and general_level_idc.
+     */
+    skip_bits_long(gb, 2 + 1 + 5 + 32 + 4 + 43 + 1 + 8);
+
+    uint8_t sub_layer_profile_present_flag[8];
+    uint8_t sub_layer_level_present_flag[8];
+    for (uint i = 0; i < max_sub_layers_minus1; ++i)
+    {
+        sub_layer_profile_present_flag[i] = get_bits1(gb);
+        sub_layer_level_present_flag[i]   = get_bits1(gb);
+    }
+
+    if (max_sub_layers_minus1 > 0)
+    {
+        for (uint i = max_sub_layers_minus1; i < 8; ++i)
+            get_bits(gb, 2); // reserved_zero_2bits
+    }
+
+    for (uint i = 0; i < max_sub_layers_minus1; ++i)
+    {
+        if (sub_layer_profile_present_flag[i])
+            skip_bits_long(gb, 88);
+        if (sub_layer_level_present_flag[i])
+            get_bits(gb, 8); // sub_layer_level_idc
+    }
+}
+
+/*
+  7.3.2.1 Video parameter set RBSP syntax
+
+  Timing may be signalled here instead of in the SPS VUI.
+*/
+void HEVCParser::decode_VPS(GetBitContext *gb)
+{
+    get_bits(gb, 4);    // vps_video_parameter_set_id
+    get_bits(gb, 2);    // vps_base_layer_internal/available_flag
+    get_bits(gb, 6);    // vps_max_layers_minus1
+    uint max_sub_layers_minus1 = get_bits(gb, 3);
+    get_bits1(gb);      // vps_temporal_id_nesting_flag
+    get_bits(gb, 16);   // vps_reserved_0xffff_16bits
+
+    profile_tier_level(gb, max_sub_layers_minus1);
+
+    bool ordering_info_present = get_bits1(gb);
+    for (uint i = ordering_info_present ? 0 : max_sub_layers_minus1;
+         i <= max_sub_layers_minus1; ++i)
+    {
+        get_ue_golomb_long(gb); // vps_max_dec_pic_buffering_minus1
+        get_ue_golomb_long(gb); // vps_max_num_reorder_pics
+        get_ue_golomb_long(gb); // vps_max_latency_increase_plus1
+    }
+
+    uint max_layer_id = get_bits(gb, 6);
+    uint num_layer_sets_minus1 = get_ue_golomb_long(gb);
+    if (num_layer_sets_minus1 > 1023)
+        return;
+    for (uint i = 1; i <= num_layer_sets_minus1; ++i)
+        skip_bits_long(gb, max_layer_id + 1); // layer_id_included_flag
+
+    if (get_bits1(gb)) // vps_timing_info_present_flag
+    {
+        vpsUnitsInTick = get_bits_long(gb, 32); // vps_num_units_in_tick
+        vpsTimeScale   = get_bits_long(gb, 32); // vps_time_scale
+    }
+}
+
+/*
+  7.3.4 Scaling list data syntax, parsed only to get past it
+*/
+void HEVCParser::scaling_list_data(GetBitContext *gb)
+{
+    for (uint sizeId = 0; sizeId < 4; ++sizeId)
+    {
+        for (uint matrixId = 0; matrixId < 6;
+             matrixId += (sizeId == 3) ? 3 : 1)
+        {
+            if (!get_bits1(gb)) // scaling_list_pred_mode_flag
+            {
+                get_ue_golomb_long(gb); // scaling_list_pred_matrix_id_delta
+                continue;
+            }
+
+            uint coefNum = std::min(64, 1 << (4 + (sizeId << 1)));
+            if (sizeId > 1)
+                get_se_golomb(gb); // scaling_list_dc_coef_minus8
+            for (uint i = 0; i < coefNum; ++i)
+                get_se_golomb(gb); // scaling_list_delta_coef
+        }
+    }
+}
+
+/*
+  7.3.7 Short-term reference picture set syntax, as found in the SPS.
+  Parsed only to get past it, which requires keeping track of the
+  number of pictures in each set for the sets predicted from it.
+*/
+bool HEVCParser::short_term_ref_pic_set(GetBitContext *gb, uint idx)
+{
+    bool inter_ref_pic_set_prediction_flag = (idx != 0) && get_bits1(gb);
+
+    if (inter_ref_pic_set_prediction_flag)
+    {
+        get_bits1(gb);          // delta_rps_sign
+        get_ue_golomb_long(gb); // abs_delta_rps_minus1
+
+        uint ref = idx - 1;     // delta_idx_minus1 is 0 in the SPS
+        uint count = 0;
+        for (uint j = 0; j <= num_delta_pocs[ref]; ++j)
+        {
+            bool used_by_curr_pic_flag = get_bits1(gb);
+            bool use_delta_flag = used_by_curr_pic_flag || get_bits1(gb);
+            if (use_delta_flag)
+                ++count;
+        }
+        num_delta_pocs[idx] = count;
+        return true;
+    }
+
+    uint num_negative_pics = get_ue_golomb_long(gb);
+    uint num_positive_pics = get_ue_golomb_long(gb);
+    if (num_negative_pics > 16 || num_positive_pics > 16)
+        return false;
+
+    for (uint i = 0; i < num_negative_pics + num_positive_pics; ++i)
+    {
+        get_ue_golomb_long(gb); // delta_poc_s0/s1_minus1
+        get_bits1(gb);          // used_by_curr_pic_s0/s1_flag
+    }
+    num_delta_pocs[idx] = num_negative_pics + num_positive_pics;
+    return true;
+}
+
+/*
+  7.3.2.2 Sequence parameter set RBSP syntax
+*/
+void HEVCParser::decode_SPS(GetBitContext *gb)
+{
+    seen_sps = true;
+
+    get_bits(gb, 4);    // sps_video_parameter_set_id
+    uint max_sub_layers_minus1 = get_bits(gb, 3);
+    get_bits1(gb);      // sps_temporal_id_nesting_flag
+
+    profile_tier_level(gb, max_sub_layers_minus1);
+
+    get_ue_golomb_long(gb); // sps_seq_parameter_set_id
+
+    chroma_format_idc = get_ue_golomb_long(gb);
+    separate_colour_plane_flag =
+        (chroma_format_idc == 3) ? get_bits1(gb) : 0;
+
+    pic_width  = get_ue_golomb_long(gb); // pic_width_in_luma_samples
+    pic_height = get_ue_golomb_long(gb); // pic_height_in_luma_samples
+
+    if (get_bits1(gb)) // conformance_window_flag
+    {
+        conf_win_left_offset   = get_ue_golomb_long(gb);
+        conf_win_right_offset  = get_ue_golomb_long(gb);
+        conf_win_top_offset    = get_ue_golomb_long(gb);
+        conf_win_bottom_offset = get_ue_golomb_long(gb);
+    }
+    else
+    {
+        conf_win_left_offset = conf_win_right_offset = 0;
+        conf_win_top_offset = conf_win_bottom_offset = 0;
+    }
+
+    get_ue_golomb_long(gb); // bit_depth_luma_minus8
+    get_ue_golomb_long(gb); // bit_depth_chroma_minus8
+    uint log2_max_pic_order_cnt_lsb = get_ue_golomb_long(gb) + 4;
+
+    bool ordering_info_present = get_bits1(gb);
+    for (uint i = ordering_info_present ? 0 : max_sub_layers_minus1;
+         i <= max_sub_layers_minus1; ++i)
+    {
+        get_ue_golomb_long(gb); // sps_max_dec_pic_buffering_minus1
+        get_ue_golomb_long(gb); // sps_max_num_reorder_pics
+        get_ue_golomb_long(gb); // sps_max_latency_increase_plus1
+    }
+
+    get_ue_golomb_long(gb); // log2_min_luma_coding_block_size_minus3
+    get_ue_golomb_long(gb); // log2_diff_max_min_luma_coding_block_size
+    get_ue_golomb_long(gb); // log2_min_luma_transform_block_size_minus2
+    get_ue_golomb_long(gb); // log2_diff_max_min_luma_transform_block_size
+    get_ue_golomb_long(gb); // max_transform_hierarchy_depth_inter
+    get_ue_golomb_long(gb); // max_transform_hierarchy_depth_intra
+
+    if (get_bits1(gb)) // scaling_list_enabled_flag
+    {
+        if (get_bits1(gb)) // sps_scaling_list_data_present_flag
+            scaling_list_data(gb);
+    }
+
+    get_bits1(gb); // amp_enabled_flag
+    get_bits1(gb); // sample_adaptive_offset_enabled_flag
+
+    if (get_bits1(gb)) // pcm_enabled_flag
+    {
+        get_bits(gb, 4);        // pcm_sample_bit_depth_luma_minus1
+        get_bits(gb, 4);        // pcm_sample_bit_depth_chroma_minus1
+        get_ue_golomb_long(gb); // log2_min_pcm_luma_coding_block_size_minus3
+        get_ue_golomb_long(gb); // log2_diff_max_min_pcm_luma_coding_block_size
+        get_bits1(gb);          // pcm_loop_filter_disabled_flag
+    }
+
+    uint num_short_term_ref_pic_sets = get_ue_golomb_long(gb);
+    if (num_short_term_ref_pic_sets > MAX_SHORT_TERM_REF_PIC_SETS)
+    {
+        LOG(VB_RECORD, LOG_WARNING,
+            "HEVCParser::decode_SPS: invalid num_short_term_ref_pic_sets");
+        return;
+    }
+    for (uint i = 0; i < num_short_term_ref_pic_sets; ++i)
+    {
+        if (!short_term_ref_pic_set(gb, i))
+            return;
+    }
+
+    if (get_bits1(gb)) // long_term_ref_pics_present_flag
+    {
+        uint num_long_term_ref_pics_sps = get_ue_golomb_long(gb);
+        if (num_long_term_ref_pics_sps > 32)
+            return;
+        for (uint i = 0; i < num_long_term_ref_pics_sps; ++i)
+        {
+            get_bits(gb, log2_max_pic_order_cnt_lsb); // lt_ref_pic_poc_lsb_sps
+            get_bits1(gb); // used_by_curr_pic_lt_sps_flag
+        }
+    }
+
+    get_bits1(gb); // sps_temporal_mvp_enabled_flag
+    get_bits1(gb); // strong_intra_smoothing_enabled_flag
+
+    if (get_bits1(gb)) // vui_parameters_present_flag
+        vui_parameters(gb);
+}
+
+/*
+  E.2.1 VUI parameters syntax, up to the timing information
+*/
+void HEVCParser::vui_parameters(GetBitContext *gb)
+{
+    if (get_bits1(gb)) //aspect_ratio_info_present_flag
+    {
+        /*
+          aspect_ratio_idc has the same meaning as in H.264, see
+          table E-1 and H264Parser::vui_parameters()
+         */
+        aspect_ratio_idc = get_bits(gb, 8);
+        if (aspect_ratio_idc == EXTENDED_SAR)
+        {
+            sar_width  = get_bits(gb, 16);
+            sar_height = get_bits(gb, 16);
+        }
+    }
+    else
+    {
+        aspect_ratio_idc = 0;
+        sar_width = sar_height = 0;
+    }
+
+    if (get_bits1(gb)) //overscan_info_present_flag
+        get_bits1(gb); //overscan_appropriate_flag
+
+    if (get_bits1(gb)) //video_signal_type_present_flag
+    {
+        get_bits(gb, 3); //video_format
+        get_bits1(gb);   //video_full_range_flag
+        if (get_bits1(gb)) // colour_description_present_flag
+        {
+            get_bits(gb, 8); // colour_primaries
+            get_bits(gb, 8); // transfer_characteristics
+            get_bits(gb, 8); // matrix_coeffs
+        }
+    }
+
+    if (get_bits1(gb)) //chroma_loc_info_present_flag
+    {
+        get_ue_golomb_long(gb); //chroma_sample_loc_type_top_field
+        get_ue_golomb_long(gb); //chroma_sample_loc_type_bottom_field
+    }
+
+    get_bits1(gb); // neutral_chroma_indication_flag
+    get_bits1(gb); // field_seq_flag
+    get_bits1(gb); // frame_field_info_present_flag
+
+    if (get_bits1(gb)) // default_display_window_flag
+    {
+        get_ue_golomb_long(gb); // def_disp_win_left_offset
+        get_ue_golomb_long(gb); // def_disp_win_right_offset
+        get_ue_golomb_long(gb); // def_disp_win_top_offset
+        get_ue_golomb_long(gb); // def_disp_win_bottom_offset
+    }
+
+    if (get_bits1(gb)) //vui_timing_info_present_flag
+    {
+        unitsInTick = get_bits_long(gb, 32); //vui_num_units_in_tick
+        timeScale   = get_bits_long(gb, 32); //vui_time_scale
+    }
+    else
+    {
+        unitsInTick = timeScale = 0;
+    }
+}
+
+/*
+  Unlike H.264, a tick in H.265 is a whole picture, so the frame
+  rate is simply time_scale / num_units_in_tick.
+*/
+double HEVCParser::frameRate(void) const
+{
+    uint32_t units = unitsInTick ? unitsInTick : vpsUnitsInTick;
+    uint32_t scale = unitsInTick ? timeScale : vpsTimeScale;
+
+    return units ? scale / (double)units : 0;
+}
+
+void HEVCParser::getFrameRate(FrameRate &result) const
+{
+    uint32_t units = unitsInTick ? unitsInTick : vpsUnitsInTick;
+    uint32_t scale = unitsInTick ? timeScale : vpsTimeScale;
+
+    if (units == 0)
+        result = FrameRate(0);
+    else
+        result = FrameRate(scale, units);
+}
+
+uint HEVCParser::aspectRatio(void) const
+{
+    // ITU-T Rec. H.265 table E-1, the same as in H.264
+    static const uint sar[17][2] =
+    {
+        {  0,  0 }, {   1,  1 }, { 12, 11 }, { 10, 11 }, { 16, 11 },
+        { 40, 33 }, {  24, 11 }, { 20, 11 }, { 32, 11 }, { 80, 33 },
+        { 18, 11 }, {  15, 11 }, { 64, 33 }, {160, 99 }, {  4,  3 },
+        {  3,  2 }, {   2,  1 },
+    };
+
+    double aspect = 0.0;
+
+    if (pic_height)
+        aspect = pictureWidthCropped() / (double)pictureHeightCropped();
+
+    if (aspect_ratio_idc == EXTENDED_SAR)
+    {
+        if (sar_height)
+            aspect *= sar_width / (double)sar_height;
+        else
+            aspect = 0.0;
+    }
+    else if (aspect_ratio_idc > 0 && aspect_ratio_idc < 17)
+    {
+        aspect *= sar[aspect_ratio_idc][0] /
+                  (double)sar[aspect_ratio_idc][1];
+    }
+
+    if (aspect == 0.0)
+        return 0;
+    if (fabs(aspect - 1.3333333333333333) < eps)
+        return 2;
+    if (fabs(aspect - 1.7777777777777777) < eps)
+        return 3;
+    if (fabs(aspect - 2.21) < eps)
+        return 4;
+
+    return aspect * 1000000;
+}
+
+/*
+  The conformance window offsets are in chroma sample units,
+  see table 6-1 for SubWidthC and SubHeightC.
+*/
+uint HEVCParser::pictureWidthCropped(void) const
+{
+    uint SubWidthC = (separate_colour_plane_flag ||
+                      chroma_format_idc == 0 ||
+                      chroma_format_idc == 3) ? 1 : 2;
+    uint crop = SubWidthC * (conf_win_left_offset + conf_win_right_offset);
+    return crop < pic_width ? pic_width - crop : pic_width;
+}
+
+uint HEVCParser::pictureHeightCropped(void) const
+{
+    uint SubHeightC = (!separate_colour_plane_flag &&
+                       chroma_format_idc == 1) ? 2 : 1;
+    uint crop = SubHeightC * (conf_win_top_offset + conf_win_bottom_offset);
+    return crop < pic_height ? pic_height - crop : pic_height;
+}
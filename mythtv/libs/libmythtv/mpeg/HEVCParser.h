@@ -0,0 +1,184 @@
+// -*- Mode: c++ -*-
+/*******************************************************************
+ * HEVCParser
+ *
+ * Distributed as part of MythTV (www.mythtv.org)
+ *
+ *      This program is free software; you can redistribute it and/or modify
+ *      it under the terms of the GNU General Public License as published by
+ *      the Free Software Foundation; either version 2 of the License, or
+ *      (at your option) any later version.
+ *
+ *      This program is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *      GNU General Public License for more details.
+ *
+ *      You should have received a copy of the GNU General Public License
+ *      along with this program; if not, write to the Free Software
+ *      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ ********************************************************************/
+
+#ifndef HEVCPARSER_H
+#define HEVCPARSER_H
+
+// H264Parser.h sets up get_bits.h and the av_alias workaround for us
+#include "H264Parser.h"
+
+class FrameRate;
+
+/** \class HEVCParser
+ *  \brief Finds access units and IRAP pictures in an H.265 elementary
+ *         stream for DTVRecorder's seek table, in the same way that
+ *         H264Parser does for H.264.
+ *
+ *  Only the NAL unit headers, the first bit of each slice segment and
+ *  the VPS/SPS are parsed, the latter for the picture size, the sample
+ *  aspect ratio and the frame rate.
+ */
+class HEVCParser {
+  public:
+
+    enum {
+        MAX_SLICE_HEADER_SIZE = 256,
+        MAX_SHORT_TERM_REF_PIC_SETS = 64
+    };
+
+    // ITU-T Rec. H.265 table 7-1
+    enum NAL_unit_type {
+        TRAIL_N        = 0,   // 0 - 31 are VCL NAL units
+        TRAIL_R        = 1,
+        TSA_N          = 2,
+        TSA_R          = 3,
+        STSA_N         = 4,
+        STSA_R         = 5,
+        RADL_N         = 6,
+        RADL_R         = 7,
+        RASL_N         = 8,
+        RASL_R         = 9,
+        BLA_W_LP       = 16,  // 16 - 23 are IRAP pictures
+        BLA_W_RADL     = 17,
+        BLA_N_LP       = 18,
+        IDR_W_RADL     = 19,
+        IDR_N_LP       = 20,
+        CRA_NUT        = 21,
+        RSV_IRAP_22    = 22,
+        RSV_IRAP_23    = 23,
+        VPS_NUT        = 32,
+        SPS_NUT        = 33,
+        PPS_NUT        = 34,
+        AUD_NUT        = 35,
+        EOS_NUT        = 36,
+        EOB_NUT        = 37,
+        FD_NUT         = 38,
+        PREFIX_SEI_NUT = 39,
+        SUFFIX_SEI_NUT = 40,
+        UNKNOWN        = 64
+    };
+
+    HEVCParser(void);
+    ~HEVCParser(void) { delete [] rbsp_buffer; }
+
+    uint32_t addBytes(const uint8_t  *bytes,
+                      const uint32_t  byte_count,
+                      const uint64_t  stream_offset);
+    void Reset(void);
+
+    QString NAL_type_str(uint8_t type);
+
+    bool stateChanged(void) const { return state_changed; }
+
+    uint8_t lastNALtype(void) const { return nal_unit_type; }
+
+    bool onFrameStart(void) const { return on_frame; }
+    bool onKeyFrameStart(void) const { return on_key_frame; }
+
+    uint pictureWidth(void) const { return pic_width; }
+    uint pictureHeight(void) const { return pic_height; }
+    uint pictureWidthCropped(void) const;
+    uint pictureHeightCropped(void) const;
+
+    /** \brief Computes aspect ratio from picture size and sample aspect ratio
+     */
+    uint aspectRatio(void) const;
+    double frameRate(void) const;
+    void getFrameRate(FrameRate &result) const;
+
+    uint64_t frameAUstreamOffset(void) const {return frame_start_offset;}
+    uint64_t keyframeAUstreamOffset(void) const {return keyframe_start_offset;}
+    uint64_t SPSstreamOffset(void) const {return SPS_offset;}
+
+    static bool NALisVCL(uint8_t nal_type)
+        {
+            return nal_type < VPS_NUT;
+        }
+
+    static bool NALisIRAP(uint8_t nal_type)
+        {
+            return (nal_type >= BLA_W_LP && nal_type <= RSV_IRAP_23);
+        }
+
+    uint32_t GetTimeScale(void) const { return timeScale; }
+
+    uint32_t GetUnitsInTick(void) const { return unitsInTick; }
+
+    void reset_SPS(void) { seen_sps = false; }
+    bool seen_SPS(void) const { return seen_sps; }
+
+    bool found_AU(void) const { return AU_pending; }
+
+  private:
+    enum constants {EXTENDED_SAR = 255};
+
+    inline void set_AU_pending(void)
+        {
+            if (!AU_pending)
+            {
+                AU_pending = true;
+                AU_offset = pkt_offset;
+            }
+        }
+
+    void resetRBSP(void);
+    bool fillRBSP(const uint8_t *byteP, uint32_t byte_count,
+                  bool found_start_code);
+    void processRBSP(bool rbsp_complete);
+    void decode_VPS(GetBitContext *gb);
+    void decode_SPS(GetBitContext *gb);
+    void profile_tier_level(GetBitContext *gb, uint max_sub_layers_minus1);
+    void scaling_list_data(GetBitContext *gb);
+    bool short_term_ref_pic_set(GetBitContext *gb, uint idx);
+    void vui_parameters(GetBitContext *gb);
+
+    bool       AU_pending;
+    bool       state_changed;
+    bool       seen_sps;
+
+    uint32_t   sync_accumulator;
+    uint8_t   *rbsp_buffer;
+    uint32_t   rbsp_buffer_size;
+    uint32_t   rbsp_index;
+    uint32_t   consecutive_zeros;
+    bool       have_unfinished_NAL;
+
+    uint8_t    nal_unit_type;
+    uint8_t    nuh_layer_id_msb;   ///< high bit of nuh_layer_id
+
+    uint       chroma_format_idc;
+    uint8_t    separate_colour_plane_flag;
+    uint       pic_width, pic_height;
+    uint       conf_win_left_offset, conf_win_right_offset;
+    uint       conf_win_top_offset, conf_win_bottom_offset;
+    uint8_t    aspect_ratio_idc;
+    uint       sar_width, sar_height;
+    uint32_t   unitsInTick, timeScale;
+    uint32_t   vpsUnitsInTick, vpsTimeScale;
+    uint       num_delta_pocs[MAX_SHORT_TERM_REF_PIC_SETS];
+
+    uint64_t   pkt_offset, AU_offset, frame_start_offset, keyframe_start_offset;
+    uint64_t   SPS_offset;
+    bool       on_frame, on_key_frame;
+};
+
+#endif /* HEVCPARSER_H */
@@ -71,7 +71,7 @@ MPEGStreamData::MPEGStreamData(int desiredProgram, int cardnum,
       _si_time_offset_cnt(0),
       _si_time_offset_indx(0),
       _eit_helper(NULL), _eit_rate(0.0f),
-      _listening_disabled(false),
+      _listening_disabled(false), _pid_generation(0),
       _encryption_lock(QMutex::Recursive), _listener_lock(QMutex::Recursive),
       _cache_tables(cacheTables), _cache_lock(QMutex::Recursive),
       // Single program stuff
@@ -86,6 +86,9 @@ MPEGStreamData::MPEGStreamData(int desiredProgram, int cardnum,
       _pat_single_program(NULL), _pmt_single_program(NULL),
       _invalid_pat_seen(false), _invalid_pat_warning(false)
 {
+    // one slot for each of the 13 bit PIDs
+    _partial_psip_packet_cache.resize(0x2000, NULL);
+
     memset(_si_time_offsets, 0, sizeof(_si_time_offsets));
 
     AddListeningPID(MPEG_PAT_PID);
@@ -183,11 +186,7 @@ void MPEGStreamData::Reset(int desiredProgram)
     SetPATSingleProgram(NULL);
     SetPMTSingleProgram(NULL);
 
-    pid_psip_map_t old = _partial_psip_packet_cache;
-    pid_psip_map_t::iterator it = old.begin();
-    for (; it != old.end(); ++it)
-        DeletePartialPSIP(it.key());
-    _partial_psip_packet_cache.clear();
+    DeletePartialPSIPs();
 
     _pids_listening.clear();
     _pids_notlistening.clear();
@@ -195,6 +194,7 @@ void MPEGStreamData::Reset(int desiredProgram)
     _pids_audio.clear();
 
     _pid_video_single_program = _pid_pmt_single_program = 0xffffffff;
+    _pid_generation++;
 
     _pat_version.clear();
     _pat_section_seen.clear();
@@ -227,15 +227,62 @@ void MPEGStreamData::Reset(int desiredProgram)
     AddListeningPID(MPEG_CAT_PID);
 }
 
-void MPEGStreamData::DeletePartialPSIP(uint pid)
+/** \fn MPEGStreamData::StartPartialPSIP(uint,const TSPacket&)
+ *  \brief Starts assembling a section of pid which begins in tspacket.
+ *
+ *   The buffer of any section being assembled on pid, or of one
+ *   assembled earlier, is reused rather than allocating a new one.
+ */
+PSIPTable *MPEGStreamData::StartPartialPSIP(uint pid,
+                                            const TSPacket &tspacket)
 {
-    pid_psip_map_t::iterator it = _partial_psip_packet_cache.find(pid);
-    if (it != _partial_psip_packet_cache.end())
+    PSIPTable *partial = GetPartialPSIP(pid);
+    if (!partial && !_spare_psip_packets.empty())
+    {
+        partial = _spare_psip_packets.back();
+        _spare_psip_packets.pop_back();
+    }
+
+    if (partial)
+        partial->Reinit(tspacket);
+    else
+        partial = new PSIPTable(tspacket);
+
+    _partial_psip_packet_cache[pid & 0x1fff] = partial;
+    return partial;
+}
+
+/** \fn MPEGStreamData::ReleasePartialPSIP(uint)
+ *  \brief Stops assembling a section of pid.
+ *
+ *   The buffer is kept for the next section started on any PID, so a
+ *   view of the section assembled in it stays valid until then.
+ */
+void MPEGStreamData::ReleasePartialPSIP(uint pid)
+{
+    PSIPTable *&partial = _partial_psip_packet_cache[pid & 0x1fff];
+    if (partial)
+    {
+        _spare_psip_packets.push_back(partial);
+        partial = NULL;
+    }
+}
+
+void MPEGStreamData::DeletePartialPSIPs(void)
+{
+    pid_psip_vec_t::iterator it = _partial_psip_packet_cache.begin();
+    for (; it != _partial_psip_packet_cache.end(); ++it)
+    {
+        delete *it;
+        *it = NULL;
+    }
+
+    for (it = _spare_psip_packets.begin();
+         it != _spare_psip_packets.end(); ++it)
     {
-        PSIPTable *pkt = *it;
-        _partial_psip_packet_cache.erase(it);
-        delete pkt;
+        delete *it;
     }
+    _spare_psip_packets.clear();
 }
 
 /** \fn MPEGStreamData::AssemblePSIP(const TSPacket*,bool&)
@@ -254,13 +301,20 @@ void MPEGStreamData::DeletePartialPSIP(uint pid)
  *   PSI stuffing bytes are 0xFF and will complete the
  *   remaining portion of the TSPacket.  (Section 2.4.4)
  *
+ *   Complete sections are not copied, section is made a view of
+ *   either tspacket or the buffer the section was assembled in, and
+ *   is only valid until the next call.
+ *
  *  \note This method makes the assumption that AddTSPacket
  *        correctly handles duplicate packets.
  *
  *  \param moreTablePackets returns true if we need more packets
+ *  \param section          view to point at the assembled section
+ *  \return &section if a section was assembled, NULL otherwise
  */
 PSIPTable* MPEGStreamData::AssemblePSIP(const TSPacket* tspacket,
-                                        bool &moreTablePackets)
+                                        bool &moreTablePackets,
+                                        PSIPTable &section)
 {
     bool broken = true;
     moreTablePackets = true;
@@ -276,7 +330,7 @@ PSIPTable* MPEGStreamData::AssemblePSIP(const TSPacket* tspacket,
                         "position %1 isn't in the buffer of %2 bytes.")
                     .arg(partial->PSIOffset() + 1 + 3)
                     .arg(partial->TSSizeInBuffer()));
-            DeletePartialPSIP(tspacket->PID());
+            ReleasePartialPSIP(tspacket->PID());
             return NULL;
         }
 
@@ -287,18 +341,18 @@ PSIPTable* MPEGStreamData::AssemblePSIP(const TSPacket* tspacket,
         if (!buggy && !partial->IsGood())
         {
             LOG(VB_SIPARSER, LOG_ERR, LOC + "Discarding broken PSIP packet");
-            DeletePartialPSIP(tspacket->PID());
+            ReleasePartialPSIP(tspacket->PID());
             return NULL;
         }
 
-        PSIPTable* psip = new PSIPTable(*partial);
+        section.SetView(*partial);
 
         // Advance to the next packet
         // pesdata starts only at PSIOffset()+1
-        uint packetStart = partial->PSIOffset() + 1 + psip->SectionLength();
+        uint packetStart = partial->PSIOffset() + 1 + section.SectionLength();
         if (packetStart < partial->TSSizeInBuffer())
         {
-            if (partial->pesdata()[psip->SectionLength()] != 0xff)
+            if (partial->pesdata()[section.SectionLength()] != 0xff)
             {
 #if 0 /* This doesn't work, you can't start PSIP packet like this
          because the PayloadStart() flag won't be set in this TSPacket
@@ -311,19 +365,23 @@ PSIPTable* MPEGStreamData::AssemblePSIP(const TSPacket* tspacket,
                     (packetStart >
                      partial->TSSizeInBuffer() - TSPacket::PAYLOAD_SIZE))
                 {
-                    // Saving will handle deleting the old one
-                    SavePartialPSIP(tspacket->PID(),
-                                   new PSIPTable(*tspacket));
+                    // Starting will reuse the old one
+                    StartPartialPSIP(tspacket->PID(), *tspacket);
                 }
                 else
 #endif
                 {
                     partial->SetPSIOffset(partial->PSIOffset() +
-                                          psip->SectionLength());
+                                          section.SectionLength());
                 }
-                return psip;
+                return &section;
             }
         }
+
+        moreTablePackets = false;
+        // the buffer stays around for the section view
+        ReleasePartialPSIP(tspacket->PID());
+
         // discard incomplete packets
         if (packetStart > partial->TSSizeInBuffer())
         {
@@ -332,18 +390,15 @@ PSIPTable* MPEGStreamData::AssemblePSIP(const TSPacket* tspacket,
                 QString("Packet with %1 bytes doesn't fit "
                         "into a buffer of %2 bytes.")
                     .arg(packetStart).arg(partial->TSSizeInBuffer()));
-            delete psip;
-            psip = NULL;
+            return NULL;
         }
 
-        moreTablePackets = false;
-        DeletePartialPSIP(tspacket->PID());
-        return psip;
+        return &section;
     }
     else if (partial)
     {
         if (broken)
-            DeletePartialPSIP(tspacket->PID());
+            ReleasePartialPSIP(tspacket->PID());
 
         moreTablePackets = false;
         return 0; // partial packet is not yet complete.
@@ -373,29 +428,28 @@ PSIPTable* MPEGStreamData::AssemblePSIP(const TSPacket* tspacket,
     const int pes_length = (pesdata[2] & 0x0f) << 8 | pesdata[3];
     if ((pes_length + offset + extra_offset) > 188)
     {
-        SavePartialPSIP(tspacket->PID(), new PSIPTable(*tspacket));
+        StartPartialPSIP(tspacket->PID(), *tspacket);
         moreTablePackets = false;
         return 0;
     }
 
-    PSIPTable *psip = new PSIPTable(*tspacket); // must be complete packet
+    section.SetView(*tspacket); // must be complete packet
 
     // There might be another section after this one in the
     // current packet. We need room before the end of the
     // packet, and it must not be packet stuffing.
-    if ((offset + psip->SectionLength() < TSPacket::kSize) &&
-        (pesdata[psip->SectionLength() + 1] != 0xff))
+    if ((offset + section.SectionLength() < TSPacket::kSize) &&
+        (pesdata[section.SectionLength() + 1] != 0xff))
     {
         // This isn't stuffing, so we need to put this
         // on as a partial packet.
-        PSIPTable *pesp = new PSIPTable(*tspacket);
-        pesp->SetPSIOffset(offset + psip->SectionLength());
-        SavePartialPSIP(tspacket->PID(), pesp);
-        return psip;
+        PSIPTable *pesp = StartPartialPSIP(tspacket->PID(), *tspacket);
+        pesp->SetPSIOffset(offset + section.SectionLength());
+        return &section;
     }
 
     moreTablePackets = false;
-    return psip;
+    return &section;
 }
 
 bool MPEGStreamData::CreatePATSingleProgram(
@@ -647,6 +701,7 @@ bool MPEGStreamData::CreatePMTSingleProgram(const ProgramMapTable &pmt)
 
     if (!videoPIDs.empty())
         _pid_video_single_program = videoPIDs[0];
+    _pid_generation++;
     for (uint i = 1; i < videoPIDs.size(); i++)
         AddWritingPID(videoPIDs[i]);
 
@@ -909,8 +964,8 @@ void MPEGStreamData::UpdateTimeOffset(uint64_t _si_utc_time)
 
 }
 
-#define DONE_WITH_PSIP_PACKET() { if (psip) delete psip; \
-    if (morePSIPTables) goto HAS_ANOTHER_PSIP; else return; }
+/// Placeholder for the section view until a section is assembled
+static const unsigned char kNoSection[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
 
 /** \fn MPEGStreamData::HandleTSTables(const TSPacket*)
  *  \brief Assembles PSIP packets and processes them.
@@ -918,74 +973,91 @@ void MPEGStreamData::UpdateTimeOffset(uint64_t _si_utc_time)
 void MPEGStreamData::HandleTSTables(const TSPacket* tspacket)
 {
     bool morePSIPTables;
-  HAS_ANOTHER_PSIP:
-    // Assemble PSIP
-    PSIPTable *psip = AssemblePSIP(tspacket, morePSIPTables);
-    if (!psip)
-       return;
+    PSIPTable section(kNoSection);
+    do
+    {
+        // Assemble PSIP
+        PSIPTable *psip = AssemblePSIP(tspacket, morePSIPTables, section);
+        if (!psip)
+           return;
+
+        HandleSection(tspacket, *psip);
+    }
+    while (morePSIPTables);
+}
 
+/** \fn MPEGStreamData::HandleSection(const TSPacket*,const PSIPTable&)
+ *  \brief Validates an assembled PSIP section and processes it.
+ *
+ *   tspacket is the packet the section was completed by, the section
+ *   may have been assembled by a SharedDemux rather than by this.
+ */
+void MPEGStreamData::HandleSection(const TSPacket *tspacket,
+                                   const PSIPTable &psip)
+{
     // drop stuffing packets
-    if ((TableID::ST       == psip->TableID()) ||
-        (TableID::STUFFING == psip->TableID()))
+    if ((TableID::ST       == psip.TableID()) ||
+        (TableID::STUFFING == psip.TableID()))
     {
         LOG(VB_RECORD, LOG_DEBUG, LOC + "Dropping Stuffing table");
-        DONE_WITH_PSIP_PACKET();
+        return;
     }
 
     // Don't do validation on tables without CRC
-    if (!psip->HasCRC())
+    if (!psip.HasCRC())
     {
-        HandleTables(tspacket->PID(), *psip);
-        DONE_WITH_PSIP_PACKET();
+        HandleTables(tspacket->PID(), psip);
+        return;
     }
 
     // Validate PSIP
     // but don't validate PMT/PAT if our driver has the PMT/PAT CRC bug.
     bool buggy = _have_CRC_bug &&
-        ((TableID::PMT == psip->TableID()) ||
-         (TableID::PAT == psip->TableID()));
-    if (!buggy && !psip->IsGood())
+        ((TableID::PMT == psip.TableID()) ||
+         (TableID::PAT == psip.TableID()));
+    if (!buggy && !psip.IsGood())
     {
         LOG(VB_RECORD, LOG_ERR, LOC +
             QString("PSIP packet failed CRC check. pid(0x%1) type(0x%2)")
-                .arg(tspacket->PID(),0,16).arg(psip->TableID(),0,16));
-        DONE_WITH_PSIP_PACKET();
+                .arg(tspacket->PID(),0,16).arg(psip.TableID(),0,16));
+        return;
     }
 
-    if (TableID::MGT <= psip->TableID() && psip->TableID() <= TableID::STT &&
-        !psip->IsCurrent())
+    if (TableID::MGT <= psip.TableID() && psip.TableID() <= TableID::STT &&
+        !psip.IsCurrent())
     { // we don't cache the next table, for now
         LOG(VB_RECORD, LOG_DEBUG, LOC + QString("Table not current 0x%1")
-            .arg(psip->TableID(),2,16,QChar('0')));
-        DONE_WITH_PSIP_PACKET();
+            .arg(psip.TableID(),2,16,QChar('0')));
+        return;
     }
 
     if (tspacket->Scrambled())
     { // scrambled! ATSC, DVB require tables not to be scrambled
         LOG(VB_RECORD, LOG_ERR, LOC +
             "PSIP packet is scrambled, not ATSC/DVB compiant");
-        DONE_WITH_PSIP_PACKET();
+        return;
     }
 
-    if (!psip->VerifyPSIP(!_have_CRC_bug))
+    // The CRC was already checked by IsGood() above
+    if (!psip.VerifyPSIP(false))
     {
         LOG(VB_RECORD, LOG_ERR, LOC + QString("PSIP table 0x%1 is invalid")
-            .arg(psip->TableID(),2,16,QChar('0')));
-        DONE_WITH_PSIP_PACKET();
+            .arg(psip.TableID(),2,16,QChar('0')));
+        return;
     }
 
     // Don't decode redundant packets,
     // but if it is a desired PAT or PMT emit a "heartbeat" signal.
-    if (IsRedundant(tspacket->PID(), *psip))
+    if (IsRedundant(tspacket->PID(), psip))
     {
-        if (TableID::PAT == psip->TableID())
+        if (TableID::PAT == psip.TableID())
         {
             QMutexLocker locker(&_listener_lock);
             ProgramAssociationTable *pat_sp = PATSingleProgram();
             for (uint i = 0; i < _mpeg_sp_listeners.size(); i++)
                 _mpeg_sp_listeners[i]->HandleSingleProgramPAT(pat_sp, false);
         }
-        if (TableID::PMT == psip->TableID() &&
+        if (TableID::PMT == psip.TableID() &&
             tspacket->PID() == _pid_pmt_single_program)
         {
             QMutexLocker locker(&_listener_lock);
@@ -993,14 +1065,11 @@ void MPEGStreamData::HandleTSTables(const TSPacket* tspacket)
             for (uint i = 0; i < _mpeg_sp_listeners.size(); i++)
                 _mpeg_sp_listeners[i]->HandleSingleProgramPMT(pmt_sp, false);
         }
-        DONE_WITH_PSIP_PACKET(); // already parsed this table, toss it.
+        return; // already parsed this table, toss it.
     }
 
-    HandleTables(tspacket->PID(), *psip);
-
-    DONE_WITH_PSIP_PACKET();
+    HandleTables(tspacket->PID(), psip);
 }
-#undef DONE_WITH_PSIP_PACKET
 
 int MPEGStreamData::ProcessData(const unsigned char *buffer, int len)
 {
@@ -1044,8 +1113,47 @@ int MPEGStreamData::ProcessData(const unsigned char *buffer, int len)
 }
 
 bool MPEGStreamData::ProcessTSPacket(const TSPacket& tspacket)
+{
+    bool handleTables;
+    bool ok = DistributeTSPacket(tspacket, handleTables);
+
+    if (handleTables)
+        HandleTSTables(&tspacket);
+
+    return ok;
+}
+
+/** \fn MPEGStreamData::ProcessDemuxedPackets(const unsigned char*,uint)
+ *  \brief Processes a run of count packets a SharedDemux picked out
+ *         for this.
+ *
+ *   Only the packets themselves are handled, the tables in them are
+ *   assembled once by the demux and handed over through HandleSection().
+ */
+void MPEGStreamData::ProcessDemuxedPackets(const unsigned char *buffer,
+                                           uint count)
+{
+    bool handleTables;
+    for (uint i = 0; i < count; i++, buffer += TSPacket::kSize)
+    {
+        DistributeTSPacket(*reinterpret_cast<const TSPacket*>(buffer),
+                           handleTables);
+    }
+}
+
+/** \fn MPEGStreamData::DistributeTSPacket(const TSPacket&,bool&)
+ *  \brief Hands a packet to the encryption monitor and the packet
+ *         listeners.
+ *
+ *  \param handleTables returns true if the tables in the packet
+ *                      should be processed
+ *  \return false if the packet had a transport error
+ */
+bool MPEGStreamData::DistributeTSPacket(const TSPacket& tspacket,
+                                        bool &handleTables)
 {
     bool ok = !tspacket.TransportError();
+    handleTables = false;
 
     if (IsEncryptionTestPID(tspacket.PID()))
     {
@@ -1080,10 +1188,7 @@ bool MPEGStreamData::ProcessTSPacket(const TSPacket& tspacket)
             _ts_writing_listeners[j]->ProcessTSPacket(tspacket);
     }
 
-    if (IsListeningPID(tspacket.PID()) && tspacket.HasPayload())
-    {
-        HandleTSTables(&tspacket);
-    }
+    handleTables = IsListeningPID(tspacket.PID()) && tspacket.HasPayload();
 
     return true;
 }
@@ -1156,6 +1261,49 @@ uint MPEGStreamData::GetPIDs(pid_map_t &pids) const
     return pids.size() - sz;
 }
 
+/** \fn MPEGStreamData::GetDemuxPIDs(uint_vec_t&,uint_vec_t&) const
+ *  \brief Returns the PIDs a SharedDemux should pass on to this.
+ *
+ *  \param packet_pids PIDs whose packets are passed to
+ *                     ProcessDemuxedPackets()
+ *  \param table_pids  PIDs whose sections are passed to HandleSection()
+ */
+void MPEGStreamData::GetDemuxPIDs(uint_vec_t &packet_pids,
+                                  uint_vec_t &table_pids) const
+{
+    packet_pids.clear();
+    table_pids.clear();
+
+    if (_pid_video_single_program < 0x1fff)
+        packet_pids.push_back(_pid_video_single_program);
+
+    pid_map_t::const_iterator it = _pids_audio.begin();
+    for (; it != _pids_audio.end(); ++it)
+        packet_pids.push_back(it.key());
+
+    for (it = _pids_writing.begin(); it != _pids_writing.end(); ++it)
+        packet_pids.push_back(it.key());
+
+    {
+        QMutexLocker locker(&_encryption_lock);
+        QMap<uint, CryptInfo>::const_iterator eit =
+            _encryption_pid_to_info.begin();
+        for (; eit != _encryption_pid_to_info.end(); ++eit)
+            packet_pids.push_back(eit.key());
+    }
+
+    // Tables are not looked for on the video and audio PIDs,
+    // see DistributeTSPacket()
+    for (it = _pids_listening.begin(); it != _pids_listening.end(); ++it)
+    {
+        if (IsListeningPID(it.key()) && !IsVideoPID(it.key()) &&
+            !IsAudioPID(it.key()))
+        {
+            table_pids.push_back(it.key());
+        }
+    }
+}
+
 PIDPriority MPEGStreamData::GetPIDPriority(uint pid) const
 {
     if (_pid_video_single_program == pid)
@@ -1178,20 +1326,6 @@ PIDPriority MPEGStreamData::GetPIDPriority(uint pid) const
     return kPIDPriorityNone;
 }
 
-void MPEGStreamData::SavePartialPSIP(uint pid, PSIPTable* packet)
-{
-    pid_psip_map_t::iterator it = _partial_psip_packet_cache.find(pid);
-    if (it == _partial_psip_packet_cache.end())
-        _partial_psip_packet_cache[pid] = packet;
-    else
-    {
-        PSIPTable *old = *it;
-        _partial_psip_packet_cache.remove(pid);
-        _partial_psip_packet_cache.insert(pid, packet);
-        delete old;
-    }
-}
-
 void MPEGStreamData::SetPATSectionSeen(uint tsid, uint section)
 {
     sections_map_t::iterator it = _pat_section_seen.find(tsid);
@@ -1826,6 +1960,7 @@ void MPEGStreamData::AddEncryptionTestPID(uint pnum, uint pid, bool isvideo)
     AddListeningPID(pid);
 
     _encryption_pid_to_info[pid] = CryptInfo((isvideo) ? 10000 : 500, 8);
+    _pid_generation++;
 
     _encryption_pid_to_pnums[pid].push_back(pnum);
     _encryption_pnum_to_pids[pnum].push_back(pid);
@@ -1869,6 +2004,7 @@ void MPEGStreamData::RemoveEncryptionTestPIDs(uint pnum)
             {
                 _encryption_pid_to_pnums.remove(pid);
                 _encryption_pid_to_info.remove(pid);
+                _pid_generation++;
             }
         }
     }
@@ -1919,6 +2055,7 @@ void MPEGStreamData::ResetDecryptionMonitoringState(void)
     _encryption_pid_to_info.clear();
     _encryption_pid_to_pnums.clear();
     _encryption_pnum_to_pids.clear();
+    _pid_generation++;
 }
 
 bool MPEGStreamData::IsProgramDecrypted(uint pnum) const
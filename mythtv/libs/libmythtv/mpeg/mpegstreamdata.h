@@ -25,7 +25,7 @@ class RingBuffer;
 
 typedef vector<uint>                    uint_vec_t;
 
-typedef QMap<unsigned int, PSIPTable*>  pid_psip_map_t;
+typedef vector<PSIPTable*>              pid_psip_vec_t;
 typedef QMap<const PSIPTable*, int>     psip_refcnt_map_t;
 
 typedef ProgramAssociationTable*               pat_ptr_t;
@@ -98,7 +98,8 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
     virtual ~MPEGStreamData();
 
     void SetCaching(bool cacheTables) { _cache_tables = cacheTables; }
-    void SetListeningDisabled(bool lt) { _listening_disabled = lt; }
+    void SetListeningDisabled(bool lt)
+        { _listening_disabled = lt; _pid_generation++; }
 
     virtual void Reset(void) { Reset(-1); }
     virtual void Reset(int desiredProgram);
@@ -118,9 +119,11 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
 
     // Table processing
     void SetIgnoreCRC(bool haveCRCbug) { _have_CRC_bug = haveCRCbug; }
+    bool IsIgnoringCRC(void) const { return _have_CRC_bug; }
     virtual bool IsRedundant(uint pid, const PSIPTable&) const;
     virtual bool HandleTables(uint pid, const PSIPTable &psip);
     virtual void HandleTSTables(const TSPacket* tspacket);
+    void HandleSection(const TSPacket *tspacket, const PSIPTable &psip);
     virtual bool ProcessTSPacket(const TSPacket& tspacket);
     virtual int  ProcessData(const unsigned char *buffer, int len);
     inline  void HandleAdaptationFieldControl(const TSPacket* tspacket);
@@ -128,21 +131,24 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
     // Listening
     virtual void AddListeningPID(
         uint pid, PIDPriority priority = kPIDPriorityNormal)
-        { _pids_listening[pid] = priority; }
+        { _pids_listening[pid] = priority; _pid_generation++; }
     virtual void AddNotListeningPID(uint pid)
-        { _pids_notlistening[pid] = kPIDPriorityNormal; }
+        { _pids_notlistening[pid] = kPIDPriorityNormal; _pid_generation++; }
     virtual void AddWritingPID(
         uint pid, PIDPriority priority = kPIDPriorityHigh)
-        { _pids_writing[pid] = priority; }
+        { _pids_writing[pid] = priority; _pid_generation++; }
     virtual void AddAudioPID(
         uint pid, PIDPriority priority = kPIDPriorityHigh)
-        { _pids_audio[pid] = priority; }
+        { _pids_audio[pid] = priority; _pid_generation++; }
 
-    virtual void RemoveListeningPID(uint pid) { _pids_listening.remove(pid);  }
+    virtual void RemoveListeningPID(uint pid)
+        { _pids_listening.remove(pid); _pid_generation++; }
     virtual void RemoveNotListeningPID(uint pid)
-        { _pids_notlistening.remove(pid); }
-    virtual void RemoveWritingPID(uint pid) { _pids_writing.remove(pid);    }
-    virtual void RemoveAudioPID(uint pid)   { _pids_audio.remove(pid);      }
+        { _pids_notlistening.remove(pid); _pid_generation++; }
+    virtual void RemoveWritingPID(uint pid)
+        { _pids_writing.remove(pid); _pid_generation++; }
+    virtual void RemoveAudioPID(uint pid)
+        { _pids_audio.remove(pid); _pid_generation++; }
 
     virtual bool IsListeningPID(uint pid) const;
     virtual bool IsNotListeningPID(uint pid) const;
@@ -158,6 +164,12 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
     const pid_map_t& WritingPIDs(void) const
         { return _pids_writing; }
 
+    // Shared demultiplexing, see SharedDemux
+    /// Changes whenever the PIDs returned by GetDemuxPIDs() may change
+    uint PIDGeneration(void) const { return _pid_generation; }
+    void GetDemuxPIDs(uint_vec_t &packet_pids, uint_vec_t &table_pids) const;
+    void ProcessDemuxedPackets(const unsigned char *buffer, uint count);
+
     uint GetPIDs(pid_map_t&) const;
 
     // PID Priorities
@@ -328,14 +340,14 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
 
   protected:
     // Table processing -- for internal use
-    PSIPTable* AssemblePSIP(const TSPacket* tspacket, bool& moreTablePackets);
-    bool AssemblePSIP(PSIPTable& psip, TSPacket* tspacket);
-    void SavePartialPSIP(uint pid, PSIPTable* packet);
+    PSIPTable* AssemblePSIP(const TSPacket* tspacket, bool& moreTablePackets,
+                            PSIPTable &section);
+    PSIPTable* StartPartialPSIP(uint pid, const TSPacket &tspacket);
     PSIPTable* GetPartialPSIP(uint pid)
-        { return _partial_psip_packet_cache[pid]; }
-    void ClearPartialPSIP(uint pid)
-        { _partial_psip_packet_cache.remove(pid); }
-    void DeletePartialPSIP(uint pid);
+        { return _partial_psip_packet_cache[pid & 0x1fff]; }
+    void ReleasePartialPSIP(uint pid);
+    void DeletePartialPSIPs(void);
+    bool DistributeTSPacket(const TSPacket& tspacket, bool &handleTables);
     void ProcessPAT(const ProgramAssociationTable *pat);
     void ProcessCAT(const ConditionalAccessTable *cat);
     void ProcessPMT(const ProgramMapTable *pmt);
@@ -373,6 +385,7 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
     pid_map_t                 _pids_writing;
     pid_map_t                 _pids_audio;
     bool                      _listening_disabled;
+    volatile uint             _pid_generation;
 
     // Encryption monitoring
     mutable QMutex            _encryption_lock;
@@ -398,7 +411,10 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
     sections_map_t            _pmt_section_seen;
 
     // PSIP construction
-    pid_psip_map_t            _partial_psip_packet_cache;
+    /// Sections being assembled, indexed by PID
+    pid_psip_vec_t            _partial_psip_packet_cache;
+    /// Assembly buffers of finished sections, kept for reuse
+    pid_psip_vec_t            _spare_psip_packets;
 
     // Caching
     bool                             _cache_tables;
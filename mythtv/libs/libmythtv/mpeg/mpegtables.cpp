@@ -244,7 +244,9 @@ bool PSIPTable::VerifyPSIP(bool verify_crc) const
         return false;
     }
 
-    unsigned char *bufend = _fullbuffer + _allocSize;
+    // views only know how many bytes follow the start of their section
+    unsigned char *bufend = (IsClone()) ?
+        _fullbuffer + _allocSize : _pesdata + _pesdataSize;
 
     if ((_pesdata + 2) >= bufend)
         return false; // can't query length
@@ -369,7 +369,7 @@ class MTV_PUBLIC TableID
 class MTV_PUBLIC PSIPTable : public PESPacket
 {
     /// Only handles single TS packet PES packets, for PMT/PAT tables basically
-    void InitPESPacket(TSPacket& tspacket)
+    void InitPESPacket(TSPacket& tspacket, bool verify = true)
     {
         if (tspacket.PayloadStart())
             _psiOffset = tspacket.AFCOffset() + tspacket.StartOfFieldPointer();
@@ -383,7 +383,7 @@ class MTV_PUBLIC PSIPTable : public PESPacket
         _badPacket = true;
         // first check if Length() will return something useful and
         // than check if the packet ends in the first TSPacket
-        if ((_pesdata - tspacket.data()) <= (188-3) &&
+        if (verify && (_pesdata - tspacket.data()) <= (188-3) &&
             (_pesdata + Length() - tspacket.data()) <= (188-3))
         {
             _badPacket = !VerifyCRC();
@@ -395,13 +395,7 @@ class MTV_PUBLIC PSIPTable : public PESPacket
     PSIPTable(const TSPacket& tspacket, bool)
         : PESPacket()
     {
-        _pesdata = NULL;
-        _fullbuffer = NULL;
-         _ccLast = tspacket.ContinuityCounter();
-         _allocSize = 0;
-        InitPESPacket(const_cast<TSPacket&>(tspacket));
-        _fullbuffer = const_cast<unsigned char*>(tspacket.data());
-        _pesdataSize = TSPacket::kSize - (_pesdata - _fullbuffer);
+        SetView(tspacket);
     }
 
   public:
@@ -462,6 +456,60 @@ class MTV_PUBLIC PSIPTable : public PESPacket
     }
 
 
+    /// Makes this table view the section starting in tspacket,
+    /// releasing any buffer it owned.
+    void SetView(const TSPacket &tspacket)
+    {
+        if (IsClone())
+            pes_free(_fullbuffer);
+        _ccLast = tspacket.ContinuityCounter();
+        _allocSize = 0;
+        InitPESPacket(const_cast<TSPacket&>(tspacket));
+        _fullbuffer = const_cast<unsigned char*>(tspacket.data());
+        _pesdataSize = TSPacket::kSize - (_pesdata - _fullbuffer);
+    }
+
+    /// Makes this table view the current section of a table being
+    /// assembled, releasing any buffer it owned.
+    void SetView(const PSIPTable &table)
+    {
+        if (IsClone())
+            pes_free(_fullbuffer);
+        _fullbuffer  = table._fullbuffer;
+        _pesdata     = table._pesdata;
+        _psiOffset   = table._psiOffset;
+        _ccLast      = table._ccLast;
+        _badPacket   = table._badPacket;
+        _allocSize   = 0;
+        // a view only counts the bytes from the start of its section
+        _pesdataSize = table._pesdataSize;
+        if (table.IsClone())
+            _pesdataSize -= _pesdata - _fullbuffer;
+    }
+
+    /// Reuses the buffer of this table for assembling a new section
+    /// starting in tspacket. Unlike PSIPTable(const TSPacket&) the CRC
+    /// is only checked once AddTSPacket() completes the section.
+    void Reinit(const TSPacket &tspacket)
+    {
+        if (!IsClone())
+            _fullbuffer = NULL;
+        _ccLast = tspacket.ContinuityCounter();
+        _pesdataSize = TSPacket::kSize;
+        InitPESPacket(const_cast<TSPacket&>(tspacket), false);
+
+        uint len = (4*1024) - 256 + _psiOffset; /* ~4KB */
+        if (_allocSize < len)
+        {
+            if (_fullbuffer)
+                pes_free(_fullbuffer);
+            _allocSize  = len;
+            _fullbuffer = pes_alloc(_allocSize);
+        }
+        _pesdata = _fullbuffer + _psiOffset + 1;
+        memcpy(_fullbuffer, tspacket.data(), TSPacket::kSize);
+    }
+
     static const PSIPTable View(const TSPacket& tspacket)
         { return PSIPTable(tspacket, false); }
 
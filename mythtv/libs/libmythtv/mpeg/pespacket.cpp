@@ -8,12 +8,9 @@ extern "C" {
 #include "mythconfig.h"
 #include "libavcodec/avcodec.h"
 #include "libavformat/avformat.h"
-#include "libavutil/crc.h"
-#include "libavutil/bswap.h"
 }
 
 #include <vector>
-#include <map>
 
 using namespace std;
 
@@ -142,12 +139,72 @@ void PESPacket::GetAsTSPackets(vector<TSPacket> &output, uint cc) const
 #undef INCR_CC
 }
 
+/// Lookup tables for computing the MPEG-2 CRC-32 (polynomial 0x04C11DB7,
+/// most significant bit first) eight bytes at a time. table[0] is the
+/// usual byte at a time table, table[k] advances a byte past k more zeros.
+class MPEGCRCTables
+{
+  public:
+    MPEGCRCTables()
+    {
+        for (uint i = 0; i < 256; i++)
+        {
+            uint32_t crc = i << 24;
+            for (uint j = 0; j < 8; j++)
+                crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+            table[0][i] = crc;
+        }
+        for (uint k = 1; k < 8; k++)
+        {
+            for (uint i = 0; i < 256; i++)
+            {
+                table[k][i] = (table[k-1][i] << 8) ^
+                    table[0][table[k-1][i] >> 24];
+            }
+        }
+    }
+
+    uint32_t table[8][256];
+};
+
+static const MPEGCRCTables &mpeg_crc_tables(void)
+{
+    static const MPEGCRCTables tables;
+    return tables;
+}
+
+static inline uint32_t read_be32(const unsigned char *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] <<  8) |  (uint32_t)p[3];
+}
+
+static uint32_t mpeg_crc32(const unsigned char *data, uint len)
+{
+    const uint32_t (*t)[256] = mpeg_crc_tables().table;
+    uint32_t crc = 0xffffffff;
+
+    for (; len >= 8; data += 8, len -= 8)
+    {
+        uint32_t a = crc ^ read_be32(data);
+        uint32_t b = read_be32(data + 4);
+        crc = t[7][ a >> 24        ] ^ t[6][(a >> 16) & 0xff] ^
+              t[5][(a >>  8) & 0xff] ^ t[4][ a        & 0xff] ^
+              t[3][ b >> 24        ] ^ t[2][(b >> 16) & 0xff] ^
+              t[1][(b >>  8) & 0xff] ^ t[0][ b        & 0xff];
+    }
+
+    for (; len; data++, len--)
+        crc = (crc << 8) ^ t[0][(crc >> 24) ^ *data];
+
+    return crc;
+}
+
 uint PESPacket::CalcCRC(void) const
 {
     if (Length() < 1)
         return 0xffffffff;
-    return av_bswap32(av_crc(av_crc_get_table(AV_CRC_32_IEEE), (uint32_t) -1,
-                             _pesdata, Length() - 1));
+    return mpeg_crc32(_pesdata, Length() - 1);
 }
 
 bool PESPacket::VerifyCRC(void) const
@@ -212,142 +269,137 @@ float SequenceHeader::aspect(bool mpeg1) const
 // Memory allocator to avoid malloc global lock and waste less memory. //
 /////////////////////////////////////////////////////////////////////////
 
-#ifndef USING_VALGRIND
-static vector<unsigned char*> mem188;
-static vector<unsigned char*> free188;
-static map<unsigned char*, bool> alloc188;
+// Every block starts with a small header naming its size class, so
+// pes_free() can put it back on its free list without looking it up.
+// The blocks of a class are carved out of larger chunks, which are only
+// given back once all the blocks of the class are free again.
 
-static vector<unsigned char*> mem4096;
-static vector<unsigned char*> free4096;
-static map<unsigned char*, bool> alloc4096;
+#define PES_HEADER_SIZE   16
+#define PES_HEADER_MAGIC  0x50455350
+#define PES_NUM_CLASSES   4
+#define PES_MALLOC_CLASS  PES_NUM_CLASSES
 
-#define BLOCKS188 512
-static unsigned char* get_188_block()
+typedef struct
 {
-    if (free188.empty())
-    {
-        mem188.push_back((unsigned char*) malloc(188 * BLOCKS188));
-        free188.reserve(BLOCKS188);
-        unsigned char* block_start = mem188.back();
-        for (uint i = 0; i < BLOCKS188; ++i)
-            free188.push_back(i*188 + block_start);
-    }
+    uint32_t size_class;
+    uint32_t magic;
+} pes_header_t;
 
-    unsigned char *ptr = free188.back();
-    free188.pop_back();
-    alloc188[ptr] = true;
-    return ptr;
+#ifndef USING_VALGRIND
+/// TS packets, PSI tables, single private sections and grown sections
+static const uint pes_class_size[PES_NUM_CLASSES]   = { 188, 1024, 4096, 8192 };
+static const uint pes_class_blocks[PES_NUM_CLASSES] = { 512,  256,  128,   32 };
+
+static vector<unsigned char*> pes_chunks[PES_NUM_CLASSES];
+static vector<unsigned char*> pes_free_blocks[PES_NUM_CLASSES];
+static uint                   pes_used_blocks[PES_NUM_CLASSES];
+static QMutex                 pes_alloc_mutex;
+#endif // USING_VALGRIND
+
+static inline pes_header_t *pes_header(unsigned char *ptr)
+{
+    return reinterpret_cast<pes_header_t*>(ptr - PES_HEADER_SIZE);
 }
-#undef BLOCKS188
 
-static bool is_188_block(unsigned char* ptr)
+static inline unsigned char *pes_init_block(unsigned char *block, uint cls)
 {
-    return alloc188.find(ptr) != alloc188.end();
+    pes_header_t *header = reinterpret_cast<pes_header_t*>(block);
+    header->size_class = cls;
+    header->magic      = PES_HEADER_MAGIC;
+    return block + PES_HEADER_SIZE;
 }
 
-static void return_188_block(unsigned char* ptr)
+#ifndef USING_VALGRIND
+static inline uint pes_block_stride(uint cls)
 {
-    alloc188.erase(ptr);
-    free188.push_back(ptr);
-    // free the allocator only if more than 1 block was used
-    if (alloc188.empty() && mem188.size() > 1)
-    {
-        vector<unsigned char*>::iterator it;
-        for (it = mem188.begin(); it != mem188.end(); ++it)
-            free(*it);
-        mem188.clear();
-        free188.clear();
-#if 0
-        LOG(VB_GENERAL, LOG_DEBUG, "freeing all 188 blocks");
-#endif
-    }
+    return (pes_class_size[cls] + PES_HEADER_SIZE + 15) & ~15;
 }
 
-#define BLOCKS4096 128
-static unsigned char* get_4096_block()
+static unsigned char *get_block(uint cls)
 {
-    if (free4096.empty())
+    vector<unsigned char*> &freelist = pes_free_blocks[cls];
+    if (freelist.empty())
     {
-        mem4096.push_back((unsigned char*) malloc(4096 * BLOCKS4096));
-        free4096.reserve(BLOCKS4096);
-        unsigned char* block_start = mem4096.back();
-        for (uint i = 0; i < BLOCKS4096; ++i)
-            free4096.push_back(i*4096 + block_start);
+        uint stride = pes_block_stride(cls);
+        unsigned char *chunk =
+            (unsigned char*) malloc(stride * pes_class_blocks[cls]);
+        if (!chunk)
+            return NULL;
+        pes_chunks[cls].push_back(chunk);
+        freelist.reserve(pes_class_blocks[cls] * pes_chunks[cls].size());
+        // hand out the lowest addresses first
+        for (uint i = pes_class_blocks[cls]; i > 0; --i)
+            freelist.push_back(pes_init_block(chunk + (i-1) * stride, cls));
     }
 
-    unsigned char *ptr = free4096.back();
-    free4096.pop_back();
-    alloc4096[ptr] = true;
+    unsigned char *ptr = freelist.back();
+    freelist.pop_back();
+    pes_used_blocks[cls]++;
     return ptr;
 }
-#undef BLOCKS4096
 
-static bool is_4096_block(unsigned char* ptr)
+static void return_block(unsigned char *ptr, uint cls)
 {
-    return alloc4096.find(ptr) != alloc4096.end();
-}
-
-static void return_4096_block(unsigned char* ptr)
-{
-    alloc4096.erase(ptr);
-    free4096.push_back(ptr);
-
-#if 0 // enable this to debug memory leaks
-        LOG(VB_GENERAL, LOG_DEBUG, QString("%1 4096 blocks remain")
-            .arg(alloc4096.size()));
-        map<unsigned char*, bool>::iterator it;
-        for (it = alloc4096.begin(); it != alloc4096.end(); ++it)
-        {
-            TSPacket *ts = (TSPacket*) it->first;
-            LGO(VB_GENERAL, LOG_DEBUG, QString("PES Packet: pid(0x%1)")
-                .arg(ts->PID(),0,16));
-            if (ts->PID() == 0x1ffb)
-            {
-                LOG(VB_GENERAL, LOG_DEBUG, QString(" tid(0x%1) ext(0x%2)")
-                    .arg(PSIPTable(*ts).TableID(),0,16)
-                    .arg(PSIPTable(*ts).TableIDExtension(),0,16));
-            }
-        }
-#endif
+    pes_free_blocks[cls].push_back(ptr);
+    pes_used_blocks[cls]--;
 
-    // free the allocator only if more than 1 block was used
-    if (alloc4096.empty() && mem4096.size() > 1)
+    // free the allocator only if more than 1 chunk was used
+    if (!pes_used_blocks[cls] && pes_chunks[cls].size() > 1)
     {
-        vector<unsigned char*>::iterator it;
-        for (it = mem4096.begin(); it != mem4096.end(); ++it)
+        vector<unsigned char*>::iterator it = pes_chunks[cls].begin();
+        for (; it != pes_chunks[cls].end(); ++it)
             free(*it);
-        mem4096.clear();
-        free4096.clear();
+        pes_chunks[cls].clear();
+        pes_free_blocks[cls].clear();
 #if 0
-        LOG(VB_GENERAL, LOG_DEBUG, "freeing all 4096 blocks");
+        LOG(VB_GENERAL, LOG_DEBUG, QString("freeing all %1 blocks")
+            .arg(pes_class_size[cls]));
 #endif
     }
 }
-#endif
-
-static QMutex pes_alloc_mutex;
+#endif // USING_VALGRIND
 
 unsigned char *pes_alloc(uint size)
 {
-    QMutexLocker locker(&pes_alloc_mutex);
 #ifndef USING_VALGRIND
-    if (size <= 188)
-        return get_188_block();
-    else if (size <= 4096)
-        return get_4096_block();
+    for (uint cls = 0; cls < PES_NUM_CLASSES; cls++)
+    {
+        if (size <= pes_class_size[cls])
+        {
+            QMutexLocker locker(&pes_alloc_mutex);
+            return get_block(cls);
+        }
+    }
 #endif // USING_VALGRIND
-    return (unsigned char*) malloc(size);
+
+    unsigned char *block = (unsigned char*) malloc(size + PES_HEADER_SIZE);
+    if (!block)
+        return NULL;
+    return pes_init_block(block, PES_MALLOC_CLASS);
 }
 
 void pes_free(unsigned char *ptr)
 {
-    QMutexLocker locker(&pes_alloc_mutex);
+    if (!ptr)
+        return;
+
+    pes_header_t *header = pes_header(ptr);
+    if (header->magic != PES_HEADER_MAGIC)
+    {
+        LOG(VB_GENERAL, LOG_ERR,
+            "pes_free: Buffer was not allocated with pes_alloc()");
+        return;
+    }
+
+    if (header->size_class == PES_MALLOC_CLASS)
+    {
+        header->magic = 0;
+        free(header);
+        return;
+    }
+
 #ifndef USING_VALGRIND
-    if (is_188_block(ptr))
-        return_188_block(ptr);
-    else if (is_4096_block(ptr))
-        return_4096_block(ptr);
-    else
+    QMutexLocker locker(&pes_alloc_mutex);
+    return_block(ptr, header->size_class);
 #endif // USING_VALGRIND
-        free(ptr);
 }
@@ -0,0 +1,323 @@
+// -*- Mode: c++ -*-
+
+// MythTV headers
+#include "shareddemux.h"
+#include "mpegtables.h"
+#include "tspacket.h"
+#include "mythlogging.h"
+
+#define LOC QString("SharedDemux(0x%1): ").arg((intptr_t)this, QT_POINTER_SIZE, 16)
+
+static const unsigned char kNoSection[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+/** \class DemuxSectionAssembler
+ *  \brief Assembles the PSIP sections for a SharedDemux, using the
+ *         partial section cache of MPEGStreamData.
+ */
+class DemuxSectionAssembler : public MPEGStreamData
+{
+  public:
+    DemuxSectionAssembler(SharedDemux *demux) :
+        MPEGStreamData(-1, -1, false), m_demux(demux) {}
+
+    virtual void HandleTSTables(const TSPacket *tspacket)
+    {
+        bool morePSIPTables;
+        PSIPTable section(kNoSection);
+        do
+        {
+            PSIPTable *psip = AssemblePSIP(tspacket, morePSIPTables, section);
+            if (!psip)
+                return;
+
+            m_demux->HandleSection(tspacket, *psip);
+        }
+        while (morePSIPTables);
+    }
+
+    static int Resync(const unsigned char *buffer, int curr_pos, int len)
+    {
+        return ResyncStream(buffer, curr_pos, len);
+    }
+
+  private:
+    SharedDemux *m_demux;
+};
+
+SharedDemux::SharedDemux() :
+    m_listenerCount(0),
+    m_packetMask(0x2000, 0), m_tableMask(0x2000, 0),
+    m_assembler(new DemuxSectionAssembler(this)),
+    m_packets(0), m_sections(0), m_deliveries(0)
+{
+}
+
+SharedDemux::~SharedDemux()
+{
+    delete m_assembler;
+}
+
+/** \fn SharedDemux::AddListener(MPEGStreamData*)
+ *  \return false if there are already kMaxListeners listeners
+ */
+bool SharedDemux::AddListener(MPEGStreamData *data)
+{
+    uint index = m_listeners.size();
+    for (uint i = 0; i < m_listeners.size(); i++)
+    {
+        if (m_listeners[i].data == data)
+            return true;
+        if (!m_listeners[i].data && index == m_listeners.size())
+            index = i;
+    }
+
+    if (index >= kMaxListeners)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Can not share the stream with more than %1 listeners")
+                .arg(kMaxListeners));
+        return false;
+    }
+
+    if (index == m_listeners.size())
+        m_listeners.push_back(Listener());
+
+    m_listeners[index].data = data;
+    m_listenerCount++;
+    UpdatePIDs(index);
+
+    LOG(VB_RECORD, LOG_INFO, LOC + QString("Added listener %1, %2 listeners")
+        .arg(index).arg(m_listenerCount));
+
+    return true;
+}
+
+void SharedDemux::RemoveListener(MPEGStreamData *data)
+{
+    for (uint i = 0; i < m_listeners.size(); i++)
+    {
+        if (m_listeners[i].data != data)
+            continue;
+
+        FlushRun(i);
+        ClearPIDs(i);
+        m_listeners[i] = Listener();
+        m_listenerCount--;
+
+        LOG(VB_RECORD, LOG_INFO, LOC +
+            QString("Removed listener %1, %2 listeners")
+                .arg(i).arg(m_listenerCount));
+        break;
+    }
+
+    while (!m_listeners.empty() && !m_listeners.back().data)
+        m_listeners.pop_back();
+}
+
+/** \fn SharedDemux::Reset(void)
+ *  \brief Drops any partially assembled sections, call this when the
+ *         stream is not continuous with what was last processed.
+ */
+void SharedDemux::Reset(void)
+{
+    m_assembler->Reset();
+    for (uint i = 0; i < m_listeners.size(); i++)
+    {
+        if (m_listeners[i].data)
+            UpdatePIDs(i);
+    }
+}
+
+/** \fn SharedDemux::ProcessData(const unsigned char*,int)
+ *  \brief Demultiplexes the whole packets in buffer.
+ *  \return the number of bytes left over at the end of the buffer,
+ *          as MPEGStreamData::ProcessData() does.
+ */
+int SharedDemux::ProcessData(const unsigned char *buffer, int len)
+{
+    for (uint i = 0; i < m_listeners.size(); i++)
+    {
+        const Listener &l = m_listeners[i];
+        if (l.data && l.generation != l.data->PIDGeneration())
+            UpdatePIDs(i);
+    }
+
+    int pos = 0;
+    bool resync = false;
+
+    while (pos + int(TSPacket::kSize) <= len)
+    { // while we have a whole packet left...
+        if (buffer[pos] != SYNC_BYTE || resync)
+        {
+            int newpos = DemuxSectionAssembler::Resync(buffer, pos+1, len);
+            LOG(VB_RECORD, LOG_DEBUG, LOC +
+                QString("Resyncing @ %1+1 w/len %2 -> %3")
+                .arg(pos).arg(len).arg(newpos));
+            if (newpos == -1)
+            {
+                FlushRuns(~0ULL);
+                return len - pos;
+            }
+            if (newpos == -2)
+            {
+                FlushRuns(~0ULL);
+                return TSPacket::kSize;
+            }
+            pos = newpos;
+        }
+
+        const TSPacket *pkt = reinterpret_cast<const TSPacket*>(&buffer[pos]);
+        pos += TSPacket::kSize; // Advance to next TS packet
+        resync = false;
+        if (!ProcessTSPacket(*pkt))
+        {
+            if (pos + int(TSPacket::kSize) > len)
+                continue;
+            if (buffer[pos] != SYNC_BYTE)
+            {
+                pos -= TSPacket::kSize;
+                resync = true;
+            }
+        }
+    }
+
+    FlushRuns(~0ULL);
+
+    return len - pos;
+}
+
+bool SharedDemux::ProcessTSPacket(const TSPacket &tspacket)
+{
+    const uint pid = tspacket.PID();
+    const unsigned char *data = tspacket.data();
+
+    m_packets++;
+
+    // Extend the run of packets of each listener wanting this packet
+    quint64 mask = m_packetMask[pid];
+    for (uint i = 0; mask; i++, mask >>= 1)
+    {
+        if (!(mask & 1))
+            continue;
+
+        Listener &l = m_listeners[i];
+        if (l.runCount &&
+            l.runStart + l.runCount * TSPacket::kSize == data)
+        {
+            l.runCount++;
+            continue;
+        }
+
+        FlushRun(i);
+        l.runStart = data;
+        l.runCount = 1;
+    }
+
+    if (tspacket.TransportError())
+        return false;
+
+    const quint64 tables = m_tableMask[pid];
+    if (tables && !tspacket.Scrambled() && tspacket.HasPayload())
+    {
+        // The listeners must see the packets before the sections
+        // completed by them.
+        FlushRuns(tables);
+        m_assembler->HandleTSTables(&tspacket);
+    }
+
+    return true;
+}
+
+/** \fn SharedDemux::HandleSection(const TSPacket*,const PSIPTable&)
+ *  \brief Hands a section to each listener wanting the tables on its PID.
+ *
+ *   The section is only valid during this call, listeners wanting to
+ *   keep it make their own copy as they would for their own sections.
+ */
+void SharedDemux::HandleSection(const TSPacket *tspacket,
+                                const PSIPTable &psip)
+{
+    const uint pid = tspacket->PID();
+
+    m_sections++;
+
+    quint64 mask = m_tableMask[pid];
+    for (uint i = 0; mask; i++, mask >>= 1)
+    {
+        if (!(mask & 1))
+            continue;
+
+        MPEGStreamData *data = m_listeners[i].data;
+        data->HandleSection(tspacket, psip);
+        m_deliveries++;
+
+        // a PAT or PMT usually changes the PIDs wanted
+        if (m_listeners[i].generation != data->PIDGeneration())
+        {
+            UpdatePIDs(i);
+            mask = m_tableMask[pid] >> i;
+        }
+    }
+}
+
+void SharedDemux::UpdatePIDs(uint index)
+{
+    Listener &l = m_listeners[index];
+
+    FlushRun(index);
+    ClearPIDs(index);
+
+    l.generation = l.data->PIDGeneration();
+    l.data->GetDemuxPIDs(l.packetPIDs, l.tablePIDs);
+
+    const quint64 bit = 1ULL << index;
+    for (uint i = 0; i < l.packetPIDs.size(); i++)
+        m_packetMask[l.packetPIDs[i] & 0x1fff] |= bit;
+    for (uint i = 0; i < l.tablePIDs.size(); i++)
+        m_tableMask[l.tablePIDs[i] & 0x1fff] |= bit;
+
+    bool ignoreCRC = false;
+    for (uint i = 0; i < m_listeners.size(); i++)
+    {
+        if (m_listeners[i].data)
+            ignoreCRC |= m_listeners[i].data->IsIgnoringCRC();
+    }
+    m_assembler->SetIgnoreCRC(ignoreCRC);
+}
+
+void SharedDemux::ClearPIDs(uint index)
+{
+    Listener &l = m_listeners[index];
+
+    const quint64 bit = 1ULL << index;
+    for (uint i = 0; i < l.packetPIDs.size(); i++)
+        m_packetMask[l.packetPIDs[i] & 0x1fff] &= ~bit;
+    for (uint i = 0; i < l.tablePIDs.size(); i++)
+        m_tableMask[l.tablePIDs[i] & 0x1fff] &= ~bit;
+
+    l.packetPIDs.clear();
+    l.tablePIDs.clear();
+}
+
+void SharedDemux::FlushRun(uint index)
+{
+    Listener &l = m_listeners[index];
+    if (!l.runCount)
+        return;
+
+    const unsigned char *start = l.runStart;
+    uint count = l.runCount;
+    l.runStart = NULL;
+    l.runCount = 0;
+
+    l.data->ProcessDemuxedPackets(start, count);
+}
+
+void SharedDemux::FlushRuns(quint64 mask)
+{
+    for (uint i = 0; mask && i < m_listeners.size(); i++, mask >>= 1)
+    {
+        if ((mask & 1) && m_listeners[i].runCount)
+            FlushRun(i);
+    }
+}
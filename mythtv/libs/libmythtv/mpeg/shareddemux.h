@@ -0,0 +1,92 @@
+// -*- Mode: c++ -*-
+#ifndef _SHARED_DEMUX_H_
+#define _SHARED_DEMUX_H_
+
+// C++ headers
+#include <vector>
+using namespace std;
+
+// Qt headers
+#include <QtGlobal>
+
+// MythTV headers
+#include "mpegstreamdata.h"
+#include "mythtvexp.h"
+
+class DemuxSectionAssembler;
+
+/** \class SharedDemux
+ *  \brief Splits a transport stream between several MPEGStreamData
+ *         listening to the same multiplex.
+ *
+ *   Each packet is only looked at once, using flat per PID tables of
+ *   the listeners wanting the packet itself and the listeners wanting
+ *   the tables in it. Packets are handed to each listener in runs of
+ *   consecutive packets with ProcessDemuxedPackets(), and each PSIP
+ *   section is assembled and CRC checked once and then handed to all
+ *   of its listeners with HandleSection().
+ *
+ *   The PIDs of a listener are read with GetDemuxPIDs() when it is
+ *   added and again whenever its PIDGeneration() changes.
+ *
+ *  \note This is not thread safe, StreamHandler only uses it with
+ *        its listener lock held.
+ *  \sa MPEGStreamData, StreamHandler
+ */
+class MTV_PUBLIC SharedDemux
+{
+    friend class DemuxSectionAssembler;
+
+  public:
+    SharedDemux();
+   ~SharedDemux();
+
+    bool AddListener(MPEGStreamData *data);
+    void RemoveListener(MPEGStreamData *data);
+    uint ListenerCount(void) const { return m_listenerCount; }
+    void Reset(void);
+
+    int ProcessData(const unsigned char *buffer, int len);
+
+    /// Packets handed to ProcessData()
+    quint64 PacketCount(void) const  { return m_packets; }
+    /// Sections assembled from those packets
+    quint64 SectionCount(void) const { return m_sections; }
+    /// Sections handed to listeners, each was assembled only once
+    quint64 SectionDeliveryCount(void) const { return m_deliveries; }
+
+    static const uint kMaxListeners = 64;
+
+  private:
+    class Listener
+    {
+      public:
+        Listener() : data(NULL), generation(0), runStart(NULL), runCount(0) {}
+
+        MPEGStreamData      *data;
+        uint                 generation;
+        uint_vec_t           packetPIDs;
+        uint_vec_t           tablePIDs;
+        const unsigned char *runStart;
+        uint                 runCount;
+    };
+
+    bool ProcessTSPacket(const TSPacket &tspacket);
+    void HandleSection(const TSPacket *tspacket, const PSIPTable &psip);
+    void UpdatePIDs(uint index);
+    void ClearPIDs(uint index);
+    void FlushRun(uint index);
+    void FlushRuns(quint64 mask);
+
+    vector<Listener>       m_listeners;
+    uint                   m_listenerCount;
+    vector<quint64>        m_packetMask; ///< listeners wanting each PID
+    vector<quint64>        m_tableMask;  ///< listeners wanting its tables
+    DemuxSectionAssembler *m_assembler;
+
+    quint64                m_packets;
+    quint64                m_sections;
+    quint64                m_deliveries;
+};
+
+#endif // _SHARED_DEMUX_H_
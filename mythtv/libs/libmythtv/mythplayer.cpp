@@ -3364,7 +3364,11 @@ bool MythPlayer::DecoderGetFrameFFREW(void)
         long long target_frame = decoder->GetFramesRead() + real_skip;
         if (real_skip >= 0)
         {
-            decoder->DoFastForward(target_frame, false);
+            // In trick play land on a keyframe, ffrew_adjust makes up
+            // the difference on the next skip.
+            long long seek_to = decoder->GetTrickPlay() ?
+                decoder->GetNearestKeyframe(target_frame) : target_frame;
+            decoder->DoFastForward(seek_to, false);
         }
         long long seek_frame  = decoder->GetFramesRead();
         ffrew_adjust = seek_frame - target_frame;
@@ -3382,7 +3386,9 @@ bool MythPlayer::DecoderGetFrameREW(void)
     bool      toBegin      = -cur_frame > ffrew_skip + ffrew_adjust;
     long long real_skip    = (toBegin) ? -cur_frame : ffrew_skip + ffrew_adjust;
     long long target_frame = cur_frame + real_skip;
-    bool ret = decoder->DoRewind(target_frame, false);
+    long long seek_to      = decoder->GetTrickPlay() ?
+        decoder->GetNearestKeyframe(target_frame) : target_frame;
+    bool ret = decoder->DoRewind(seek_to, false);
     long long seek_frame  = decoder->GetFramesPlayed();
     ffrew_adjust = target_frame - seek_frame;
     return ret;
@@ -3427,6 +3433,17 @@ bool MythPlayer::DecoderGetFrame(DecodeType decodetype, bool unsafe)
         return false;
     }
 
+    // Once every displayed frame skips at least a GOP only keyframes
+    // are shown, so don't bother decoding anything else. Paused and
+    // normal playback always decode every frame.
+    bool trickplay = false;
+    if (!decodeOneFrame && ffrew_skip != 0 && ffrew_skip != 1)
+    {
+        long long kfdist = decoder->GetAverageKeyframeDistance();
+        trickplay = kfdist > 0 && llabs(ffrew_skip) >= kfdist;
+    }
+    decoder->SetTrickPlay(trickplay);
+
     if (ffrew_skip == 1 || decodeOneFrame)
         ret = decoder->GetFrame(decodetype);
     else if (ffrew_skip != 0)
@@ -3676,6 +3693,10 @@ void MythPlayer::ChangeSpeed(void)
     bool skip_changed = UpdateFFRewSkip();
     videosync->setFrameInterval(frame_interval);
 
+    // Seeks made while paused or at normal speed must be exact again.
+    if (decoder && (ffrew_skip == 0 || ffrew_skip == 1))
+        decoder->SetTrickPlay(false);
+
     if (skip_changed && videoOutput)
     {
         videoOutput->SetPrebuffering(ffrew_skip == 1);
@@ -4807,6 +4828,7 @@ void MythPlayer::GetPlaybackData(InfoMap &infoMap)
     infoMap.insert("decoderrate", player_ctx->buffer->GetDecoderRate());
     infoMap.insert("storagerate", player_ctx->buffer->GetStorageRate());
     infoMap.insert("bufferavail", player_ctx->buffer->GetAvailableBuffer());
+    infoMap.insert("bufferhits",  player_ctx->buffer->GetReadAheadStats());
     infoMap.insert("buffersize",
         QString::number(player_ctx->buffer->GetBufferSize() >> 20));
     infoMap.insert("avsync",
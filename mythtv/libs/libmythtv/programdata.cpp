@@ -1271,6 +1271,20 @@ void ProgramData::HandlePrograms(
 {
     uint unchanged = 0, updated = 0;
 
+    HandlePrograms(sourceid, proglist, unchanged, updated);
+
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("Updated programs: %1 Unchanged programs: %2")
+                .arg(updated) .arg(unchanged));
+}
+
+/** \brief Inserts one batch of programs, adding to the running
+ *         unchanged and updated counts of the caller.
+ */
+void ProgramData::HandlePrograms(
+    uint sourceid, QMap<QString, QList<ProgInfo> > &proglist,
+    uint &unchanged, uint &updated)
+{
     MSqlQuery query(MSqlQuery::InitCon());
 
     QMap<QString, QList<ProgInfo> >::const_iterator mapiter;
@@ -1318,10 +1332,6 @@ void ProgramData::HandlePrograms(
             HandlePrograms(query, chanids[i], sortlist, unchanged, updated);
         }
     }
-
-    LOG(VB_GENERAL, LOG_INFO,
-        QString("Updated programs: %1 Unchanged programs: %2")
-                .arg(updated) .arg(unchanged));
 }
 
 void ProgramData::HandlePrograms(MSqlQuery             &query,
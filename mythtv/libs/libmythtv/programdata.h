@@ -274,6 +274,9 @@ class MTV_PUBLIC ProgramData
   public:
     static void HandlePrograms(uint sourceid,
                                QMap<QString, QList<ProgInfo> > &proglist);
+    static void HandlePrograms(uint sourceid,
+                               QMap<QString, QList<ProgInfo> > &proglist,
+                               uint &unchanged, uint &updated);
 
     static int  fix_end_times(void);
     static bool ClearDataByChannel(
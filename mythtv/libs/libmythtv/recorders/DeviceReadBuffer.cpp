@@ -2,6 +2,7 @@
 using namespace std;
 
 #include "DeviceReadBuffer.h"
+#include "recordermetrics.h"
 #include "mythcorecontext.h"
 #include "mythbaseutil.h"
 #include "mythlogging.h"
@@ -42,7 +43,9 @@ DeviceReadBuffer::DeviceReadBuffer(
       // statistics
       max_used(0),                  avg_used(0),
       avg_buf_write_cnt(0),         avg_buf_read_cnt(0),
-      avg_buf_sleep_cnt(0)
+      avg_buf_sleep_cnt(0),
+      m_fill(0),                    m_maxFill(0),
+      m_size(0)
 {
     for (int i = 0; i < 2; i++)
     {
@@ -63,6 +66,7 @@ DeviceReadBuffer::DeviceReadBuffer(
 
 DeviceReadBuffer::~DeviceReadBuffer()
 {
+    RecorderMetricsRegistry::UnregisterReadBuffer(this);
     Stop();
     if (buffer)
     {
@@ -123,6 +127,11 @@ bool DeviceReadBuffer::Setup(const QString &streamName, int streamfd,
     avg_buf_sleep_cnt = 0;
     lastReport.start();
 
+    m_fill.store(0);
+    m_maxFill.store(0);
+    m_size.store(size);
+    RecorderMetricsRegistry::RegisterReadBuffer(this, videodevice);
+
     LOG(VB_RECORD, LOG_INFO, LOC + QString("buffer size %1 KB").arg(size/1024));
 
     return true;
@@ -167,6 +176,7 @@ void DeviceReadBuffer::Reset(const QString &streamName, int streamfd)
     used          = 0;
     readPtr       = buffer;
     writePtr      = buffer;
+    m_fill.store(0);
 
     error         = false;
 }
@@ -307,6 +317,9 @@ void DeviceReadBuffer::IncrWritePointer(uint len)
     used     += len;
     writePtr += len;
     writePtr  = (writePtr >= endPtr) ? buffer + (writePtr - endPtr) : writePtr;
+    m_fill.store(used);
+    if (used > (uint)m_maxFill.load())
+        m_maxFill.store(used);
 #if REPORT_RING_STATS
     max_used = max(used, max_used);
     avg_used = ((avg_used * avg_buf_write_cnt) + used) / (avg_buf_write_cnt+1);
@@ -321,6 +334,7 @@ void DeviceReadBuffer::IncrReadPointer(uint len)
     used    -= len;
     readPtr += len;
     readPtr  = (readPtr == endPtr) ? buffer : readPtr;
+    m_fill.store(used);
 #if REPORT_RING_STATS
     ++avg_buf_read_cnt;
 #endif
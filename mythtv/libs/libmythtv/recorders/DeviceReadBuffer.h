@@ -6,6 +6,7 @@
 
 #include <unistd.h>
 
+#include <QAtomicInt>
 #include <QMutex>
 #include <QWaitCondition>
 #include <QString>
@@ -59,6 +60,11 @@ class DeviceReadBuffer : protected MThread
 
     uint Read(unsigned char *buf, uint count);
 
+    /// Bytes waiting to be read, readable without locking
+    uint GetFillLevel(void) const    { return m_fill.load(); }
+    uint GetMaxFillLevel(void) const { return m_maxFill.load(); }
+    uint GetBufferSize(void) const   { return m_size.load(); }
+
   private:
     virtual void run(void); // MThread
 
@@ -123,6 +129,10 @@ class DeviceReadBuffer : protected MThread
     size_t           avg_buf_read_cnt;
     size_t           avg_buf_sleep_cnt;
     MythTimer        lastReport;
+    // copies of used and size for RecorderMetricsRegistry
+    QAtomicInt       m_fill;
+    QAtomicInt       m_maxFill;
+    QAtomicInt       m_size;
 };
 
 #endif // _DEVICEREADBUFFER_H_
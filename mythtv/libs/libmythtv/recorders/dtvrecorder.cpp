@@ -88,7 +88,9 @@ DTVRecorder::DTVRecorder(TVRec *rec) :
     _total_duration(0),
     _td_base(0),
     _td_tick_count(0),
-    _td_tick_framerate(0)
+    _td_tick_framerate(0),
+    _metrics(NULL),
+    _metrics_recording(NULL)
 {
     SetPositionMapType(MARK_GOP_BYFRAME);
     _payload_buffer.reserve(TSPacket::kSize * (50 + 1));
@@ -103,6 +105,10 @@ DTVRecorder::DTVRecorder(TVRec *rec) :
         gCoreContext->GetNumSetting("MinimumRecordingQuality", 95);
 
     m_containerFormat = formatMPEG2_TS;
+
+    if (tvrec)
+        _metrics = RecorderMetricsRegistry::Register(tvrec->GetInputId());
+    _metrics_timer.start();
 }
 
 DTVRecorder::~DTVRecorder(void)
@@ -122,6 +128,9 @@ DTVRecorder::~DTVRecorder(void)
         delete _input_pmt;
         _input_pmt = NULL;
     }
+
+    RecorderMetricsRegistry::Unregister(_metrics);
+    _metrics = NULL;
 }
 
 void DTVRecorder::SetOption(const QString &name, const QString &value)
@@ -132,7 +141,11 @@ void DTVRecorder::SetOption(const QString &name, const QString &value)
         _recording_type.detach();
     }
     else
+    {
+        if (name == "videodevice" && _metrics)
+            _metrics->SetDevice(value);
         RecorderBase::SetOption(name, value);
+    }
 }
 
 /** \fn DTVRecorder::SetOption(const QString&,int)
@@ -335,13 +348,19 @@ void DTVRecorder::BufferedWrite(const TSPacket &tspacket, bool insert)
         if (!_payload_buffer.empty())
         {
             if (ringBuffer)
-                ringBuffer->Write(&_payload_buffer[0], _payload_buffer.size());
+                WriteRingBuffer(&_payload_buffer[0], _payload_buffer.size());
             _payload_buffer.clear();
         }
     }
 
     if (ringBuffer)
-        ringBuffer->Write(tspacket.data(), TSPacket::kSize);
+        WriteRingBuffer(tspacket.data(), TSPacket::kSize);
+}
+
+void DTVRecorder::WriteRingBuffer(const unsigned char *data, uint len)
+{
+    _metrics_counters.bytesOut += len;
+    ringBuffer->Write(data, len);
 }
 
 enum { kExtractPTS, kExtractDTS };
@@ -797,6 +816,8 @@ void DTVRecorder::HandleKeyframe(int64_t extra)
     if (!ringBuffer)
         return;
 
+    _metrics_counters.keyframes++;
+
     // Perform ringbuffer switch if needed.
     CheckForRingBufferSwitch();
 
@@ -827,22 +848,28 @@ void DTVRecorder::HandleKeyframe(int64_t extra)
     positionMapLock.unlock();
 }
 
-/** \fn DTVRecorder::FindH264Keyframes(const TSPacket*)
+/** \fn DTVRecorder::FindH2645Keyframes(const TSPacket*)
  *  \brief This searches the TS packet to identify keyframes.
+ *
+ *   H.264 streams are scanned with the H264Parser, H.265 streams with
+ *   the HEVCParser which treats every IRAP picture as a keyframe.
+ *
  *  \param TSPacket Pointer the the TS packet data.
  *  \return Returns true if a keyframe has been found.
  */
-bool DTVRecorder::FindH264Keyframes(const TSPacket *tspacket)
+bool DTVRecorder::FindH2645Keyframes(const TSPacket *tspacket)
 {
     if (!tspacket->HasPayload()) // no payload to scan
         return _first_keyframe >= 0;
 
     if (!ringBuffer)
     {
-        LOG(VB_GENERAL, LOG_ERR, LOC + "FindH264Keyframes: No ringbuffer");
+        LOG(VB_GENERAL, LOG_ERR, LOC + "FindH2645Keyframes: No ringbuffer");
         return _first_keyframe >= 0;
     }
 
+    const bool hevc = (_stream_id[tspacket->PID()] == StreamID::H265Video);
+
     const bool payloadStart = tspacket->PayloadStart();
     if (payloadStart)
     {
@@ -855,11 +882,13 @@ bool DTVRecorder::FindH264Keyframes(const TSPacket *tspacket)
     uint height = 0;
     uint width = 0;
     FrameRate frameRate(0);
+    uint32_t timeScale = 0;
+    uint32_t unitsInTick = 0;
 
     bool hasFrame = false;
     bool hasKeyFrame = false;
 
-    // scan for PES packets and H.264 NAL units
+    // scan for PES packets and H.264 or H.265 NAL units
     uint i = tspacket->AFCOffset();
     for (; i < TSPacket::kSize; ++i)
     {
@@ -929,6 +958,29 @@ bool DTVRecorder::FindH264Keyframes(const TSPacket *tspacket)
 
         // scan for a NAL unit start code
 
+        if (hevc)
+        {
+            uint32_t bytes_used = m_hevc_parser.addBytes
+                                  (tspacket->data() + i, TSPacket::kSize - i,
+                                   ringBuffer->GetWritePosition());
+            i += (bytes_used - 1);
+
+            if (m_hevc_parser.stateChanged() && m_hevc_parser.onFrameStart())
+            {
+                hasKeyFrame = m_hevc_parser.onKeyFrameStart();
+                hasFrame = true;
+                _seen_sps |= hasKeyFrame;
+
+                width = m_hevc_parser.pictureWidthCropped();
+                height = m_hevc_parser.pictureHeightCropped();
+                aspectRatio = m_hevc_parser.aspectRatio();
+                m_hevc_parser.getFrameRate(frameRate);
+                timeScale = m_hevc_parser.GetTimeScale();
+                unitsInTick = m_hevc_parser.GetUnitsInTick();
+            }
+            continue;
+        }
+
         uint32_t bytes_used = m_h264_parser.addBytes
                               (tspacket->data() + i, TSPacket::kSize - i,
                                ringBuffer->GetWritePosition());
@@ -947,10 +999,16 @@ bool DTVRecorder::FindH264Keyframes(const TSPacket *tspacket)
                 height = m_h264_parser.pictureHeight();
                 aspectRatio = m_h264_parser.aspectRatio();
                 m_h264_parser.getFrameRate(frameRate);
+                timeScale = m_h264_parser.GetTimeScale();
+                unitsInTick = m_h264_parser.GetUnitsInTick();
             }
         }
     } // for (; i < TSPacket::kSize; ++i)
 
+    const uint64_t keyframe_offset = hevc ?
+        m_hevc_parser.keyframeAUstreamOffset() :
+        m_h264_parser.keyframeAUstreamOffset();
+
     // If it has been more than 511 frames since the last keyframe,
     // pretend we have one.
     if (hasFrame && !hasKeyFrame &&
@@ -958,7 +1016,7 @@ bool DTVRecorder::FindH264Keyframes(const TSPacket *tspacket)
     {
         hasKeyFrame = true;
         LOG(VB_RECORD, LOG_WARNING, LOC +
-            QString("FindH264Keyframes: %1 frames without a keyframe.")
+            QString("FindH2645Keyframes: %1 frames without a keyframe.")
             .arg(_frames_seen_count - _last_keyframe_seen));
     }
 
@@ -970,10 +1028,10 @@ bool DTVRecorder::FindH264Keyframes(const TSPacket *tspacket)
             .arg(ringBuffer->GetWritePosition())
             .arg(_payload_buffer.size())
             .arg(ringBuffer->GetWritePosition() + _payload_buffer.size())
-            .arg(m_h264_parser.keyframeAUstreamOffset()));
+            .arg(keyframe_offset));
 
         _last_keyframe_seen = _frames_seen_count;
-        HandleH264Keyframe();
+        HandleH2645Keyframe(keyframe_offset);
     }
 
     if (hasFrame)
@@ -983,7 +1041,7 @@ bool DTVRecorder::FindH264Keyframes(const TSPacket *tspacket)
             .arg(ringBuffer->GetWritePosition())
             .arg(_payload_buffer.size())
             .arg(ringBuffer->GetWritePosition() + _payload_buffer.size())
-            .arg(m_h264_parser.keyframeAUstreamOffset()));
+            .arg(keyframe_offset));
 
         _buffer_packets = false;  // We now know if this is a keyframe
         _frames_seen_count++;
@@ -1013,9 +1071,9 @@ bool DTVRecorder::FindH264Keyframes(const TSPacket *tspacket)
     if (frameRate.isNonzero() && frameRate != m_frameRate)
     {
         LOG(VB_RECORD, LOG_INFO, LOC +
-            QString("FindH264Keyframes: timescale: %1, tick: %2, framerate: %3")
-                      .arg( m_h264_parser.GetTimeScale() )
-                      .arg( m_h264_parser.GetUnitsInTick() )
+            QString("FindH2645Keyframes: timescale: %1, tick: %2, framerate: %3")
+                      .arg( timeScale )
+                      .arg( unitsInTick )
                       .arg( frameRate.toDouble() * 1000 ) );
         m_frameRate = frameRate;
         FrameRateChange(frameRate.toDouble() * 1000, _frames_written_count);
@@ -1024,11 +1082,12 @@ bool DTVRecorder::FindH264Keyframes(const TSPacket *tspacket)
     return _seen_sps;
 }
 
-/** \fn DTVRecorder::HandleH264Keyframe(void)
+/** \fn DTVRecorder::HandleH2645Keyframe(uint64_t)
  *  \brief This save the current frame to the position maps
  *         and handles ringbuffer switching.
+ *  \param keyframe_offset Stream offset of the keyframe's access unit
  */
-void DTVRecorder::HandleH264Keyframe(void)
+void DTVRecorder::HandleH2645Keyframe(uint64_t keyframe_offset)
 {
     // Perform ringbuffer switch if needed.
     CheckForRingBufferSwitch();
@@ -1043,7 +1102,7 @@ void DTVRecorder::HandleH264Keyframe(void)
         SendMythSystemRecEvent("REC_STARTED_WRITING", curRecording);
     }
     else
-        startpos = m_h264_parser.keyframeAUstreamOffset();
+        startpos = keyframe_offset;
 
     // Add key frame to position map
     positionMapLock.lock();
@@ -1209,14 +1268,14 @@ void DTVRecorder::FindPSKeyFrames(const uint8_t *buffer, uint len)
             {
                 if (ringBuffer)
                 {
-                    ringBuffer->Write(
+                    WriteRingBuffer(
                         &_payload_buffer[0], _payload_buffer.size());
                 }
                 _payload_buffer.clear();
             }
 
             if (ringBuffer)
-                ringBuffer->Write(bufstart, (bufptr - bufstart));
+                WriteRingBuffer(bufstart, (bufptr - bufstart));
 
             bufstart = bufptr;
         }
@@ -1449,6 +1508,8 @@ bool DTVRecorder::ProcessTSPacket(const TSPacket &tspacket)
 {
     const uint pid = tspacket.PID();
 
+    CountPacketMetrics(pid);
+
     if (pid != 0x1fff)
         _packet_count.fetchAndAddAcquire(1);
 
@@ -1456,6 +1517,7 @@ bool DTVRecorder::ProcessTSPacket(const TSPacket &tspacket)
     uint old_cnt = _continuity_counter[pid];
     if ((pid != 0x1fff) && !CheckCC(pid, tspacket.ContinuityCounter()))
     {
+        _metrics_counters.continuityErrors++;
         int v = _continuity_error_count.fetchAndAddRelaxed(1) + 1;
         double erate = v * 100.0 / _packet_count.fetchAndAddRelaxed(0);
         LOG(VB_RECORD, LOG_WARNING, LOC +
@@ -1502,7 +1564,7 @@ bool DTVRecorder::ProcessVideoTSPacket(const TSPacket &tspacket)
         {
             // Flush the buffer
             if (ringBuffer)
-                ringBuffer->Write(&_payload_buffer[0], _payload_buffer.size());
+                WriteRingBuffer(&_payload_buffer[0], _payload_buffer.size());
             _payload_buffer.clear();
         }
 
@@ -1511,8 +1573,9 @@ bool DTVRecorder::ProcessVideoTSPacket(const TSPacket &tspacket)
     }
 
     // Check for keyframes and count frames
-    if (streamType == StreamID::H264Video)
-        FindH264Keyframes(&tspacket);
+    if (streamType == StreamID::H264Video ||
+        streamType == StreamID::H265Video)
+        FindH2645Keyframes(&tspacket);
     else if (streamType != 0)
         FindMPEG2Keyframes(&tspacket);
     else
@@ -1533,7 +1596,7 @@ bool DTVRecorder::ProcessAudioTSPacket(const TSPacket &tspacket)
         {
             // Flush the buffer
             if (ringBuffer)
-                ringBuffer->Write(&_payload_buffer[0], _payload_buffer.size());
+                WriteRingBuffer(&_payload_buffer[0], _payload_buffer.size());
             _payload_buffer.clear();
         }
 
@@ -1548,6 +1611,8 @@ bool DTVRecorder::ProcessAudioTSPacket(const TSPacket &tspacket)
 /// Common code for processing either audio or video packets
 bool DTVRecorder::ProcessAVTSPacket(const TSPacket &tspacket)
 {
+    CountPacketMetrics(tspacket.PID());
+
     // Sync recording start to first keyframe
     if (_wait_for_keyframe_option && _first_keyframe < 0)
     {
@@ -1565,6 +1630,7 @@ bool DTVRecorder::ProcessAVTSPacket(const TSPacket &tspacket)
     uint old_cnt = _continuity_counter[pid];
     if ((pid != 0x1fff) && !CheckCC(pid, tspacket.ContinuityCounter()))
     {
+        _metrics_counters.continuityErrors++;
         int v = _continuity_error_count.fetchAndAddRelaxed(1) + 1;
         double erate = v * 100.0 / _packet_count.fetchAndAddRelaxed(0);
         LOG(VB_RECORD, LOG_WARNING, LOC +
@@ -1585,6 +1651,36 @@ bool DTVRecorder::ProcessAVTSPacket(const TSPacket &tspacket)
     return true;
 }
 
+/** \fn DTVRecorder::PublishMetrics(void)
+ *  \brief Hands the totals of this recorder to its RecorderMetrics,
+ *         called from the packet processing thread every
+ *         kMetricsInterval ms.
+ */
+void DTVRecorder::PublishMetrics(void)
+{
+    _metrics_timer.restart();
+
+    if (curRecording != _metrics_recording)
+    {
+        _metrics_recording = curRecording;
+        if (curRecording)
+        {
+            _metrics->SetRecording(curRecording->GetChanID(),
+                                   curRecording->GetRecordingStartTime());
+        }
+    }
+
+    _metrics_counters.frames = _frames_written_count;
+    _metrics->Publish(_metrics_counters);
+
+    uint buffer_use, buffer_size, latency;
+    if (ringBuffer &&
+        ringBuffer->GetWriterStats(buffer_use, buffer_size, latency))
+    {
+        _metrics->SetWriterStats(buffer_use, buffer_size, latency);
+    }
+}
+
 RecordingQuality *DTVRecorder::GetRecordingQuality(const RecordingInfo *r) const
 {
     RecordingQuality *recq = RecorderBase::GetRecordingQuality(r);
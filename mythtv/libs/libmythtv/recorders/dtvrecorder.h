@@ -17,8 +17,10 @@ using namespace std;
 #include <QString>
 
 #include "streamlisteners.h"
+#include "recordermetrics.h"
 #include "recorderbase.h"
 #include "H264Parser.h"
+#include "HEVCParser.h"
 
 class MPEGStreamData;
 class TSPacket;
@@ -100,6 +102,9 @@ class DTVRecorder :
     void UpdateFramesWritten(void);
 
     void BufferedWrite(const TSPacket &tspacket, bool insert = false);
+    void WriteRingBuffer(const unsigned char *data, uint len);
+    inline void CountPacketMetrics(uint pid);
+    void PublishMetrics(void);
 
     // MPEG TS "audio only" support
     bool FindAudioKeyframes(const TSPacket *tspacket);
@@ -107,9 +112,9 @@ class DTVRecorder :
     // MPEG2 TS support
     bool FindMPEG2Keyframes(const TSPacket* tspacket);
 
-    // MPEG4 AVC / H.264 TS support
-    bool FindH264Keyframes(const TSPacket* tspacket);
-    void HandleH264Keyframe(void);
+    // MPEG4 AVC / H.264 and HEVC / H.265 TS support
+    bool FindH2645Keyframes(const TSPacket* tspacket);
+    void HandleH2645Keyframe(uint64_t keyframe_offset);
 
     // MPEG2 PS support (Hauppauge PVR-x50/PVR-500)
     void FindPSKeyFrames(const uint8_t *buffer, uint len);
@@ -143,10 +148,11 @@ class DTVRecorder :
     int _progressive_sequence;
     int _repeat_pict;
 
-    // H.264 support
+    // H.264 and H.265 support
     bool _pes_synced;
     bool _seen_sps;
     H264Parser m_h264_parser;
+    HEVCParser m_hevc_parser;
 
     /// Wait for the a GOP/SEQ-start before sending data
     bool _wait_for_keyframe_option;
@@ -194,12 +200,20 @@ class DTVRecorder :
     uint64_t _td_tick_count;
     FrameRate _td_tick_framerate;
 
+    // Live metrics, see RecorderMetricsRegistry
+    RecorderMetrics        *_metrics;
+    RecorderMetricsCounters _metrics_counters;
+    MythTimer               _metrics_timer;
+    const RecordingInfo    *_metrics_recording;
+
     // constants
     /// If the number of regular frames detected since the last
     /// detected keyframe exceeds this value, then we begin marking
     /// random regular frames as keyframes.
     static const uint kMaxKeyFrameDistance;
     static const unsigned char kPayloadStartSeen = 0x2;
+    /// How often the metrics are published, in ms
+    static const int kMetricsInterval = 1000;
 };
 
 inline bool DTVRecorder::CheckCC(uint pid, uint new_cnt)
@@ -213,4 +227,19 @@ inline bool DTVRecorder::CheckCC(uint pid, uint new_cnt)
     return ok;
 }
 
+inline void DTVRecorder::CountPacketMetrics(uint pid)
+{
+    if (!_metrics)
+        return;
+
+    _metrics->CountPacket(pid);
+    _metrics_counters.bytesIn += TSPacket::kSize;
+    _metrics_counters.packets++;
+    if (!(_metrics_counters.packets & 0x3f) &&
+        _metrics_timer.elapsed() >= kMetricsInterval)
+    {
+        PublishMetrics();
+    }
+}
+
 #endif // DTVRECORDER_H
@@ -8,6 +8,13 @@
 # include <sys/socket.h>
 # include <netinet/in.h>
 # include <netinet/ip.h>
+# include <cerrno>
+#endif
+
+// recvmmsg() lets us pick up everything queued on the socket in a
+// handful of system calls, it is available since Linux 2.6.33.
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+#define USING_RECVMMSG 1
 #endif
 
 // Qt headers
@@ -352,6 +359,14 @@ IPTVStreamHandlerReadHelper::IPTVStreamHandlerReadHelper(
 
 void IPTVStreamHandlerReadHelper::ReadPending(void)
 {
+#ifdef USING_RECVMMSG
+    if (0 == m_stream)
+    {
+        ReadPendingBatched();
+        return;
+    }
+#endif
+
     QHostAddress sender;
     quint16 senderPort;
     bool sender_null = m_sender.isNull();
@@ -404,6 +419,106 @@ void IPTVStreamHandlerReadHelper::ReadPending(void)
     }
 }
 
+#ifdef USING_RECVMMSG
+/** \brief Reads the data stream straight into the packet buffer's
+ *         receive slots and hands the TS payloads to the listeners.
+ *
+ *  The first datagram is read through QUdpSocket, since that is what
+ *  re-arms its read notifier, the rest of what is queued on the socket
+ *  is read IPTV_RECV_BATCH datagrams per recvmmsg() call. No QByteArray
+ *  is allocated per datagram and the listener lock is taken once per
+ *  batch rather than once per datagram.
+ */
+void IPTVStreamHandlerReadHelper::ReadPendingBatched(void)
+{
+    PacketBuffer *buffer = m_parent->m_buffer;
+    bool sender_null = m_sender.isNull();
+    int fd = m_socket->socketDescriptor();
+
+    unsigned char *slots[IPTV_RECV_BATCH];
+    uint sizes[IPTV_RECV_BATCH];
+    struct mmsghdr msgs[IPTV_RECV_BATCH];
+    struct iovec iovs[IPTV_RECV_BATCH];
+    struct sockaddr_storage addrs[IPTV_RECV_BATCH];
+
+    if (buffer->GetEmptySlots(slots, 1))
+    {
+        QHostAddress sender;
+        quint16 senderPort;
+        qint64 len = m_socket->readDatagram(
+            reinterpret_cast<char*>(slots[0]), PacketBuffer::kSlotSize,
+            &sender, &senderPort);
+        sizes[0] = (len > 0 && (sender_null || sender == m_sender)) ? len : 0;
+        buffer->PushDataSlots(slots, sizes, 1);
+    }
+
+    bool more = true;
+    while (more)
+    {
+        uint count = buffer->GetEmptySlots(slots, IPTV_RECV_BATCH);
+        if (!count)
+        {
+            LOG(VB_RECORD, LOG_WARNING, LOC_WH +
+                "Out of receive slots, dropping data");
+            break;
+        }
+
+        memset(msgs, 0, sizeof(msgs[0]) * count);
+        for (uint i = 0; i < count; i++)
+        {
+            iovs[i].iov_base = slots[i];
+            iovs[i].iov_len  = PacketBuffer::kSlotSize;
+            msgs[i].msg_hdr.msg_iov     = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen  = 1;
+            msgs[i].msg_hdr.msg_name    = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            sizes[i] = 0;
+        }
+
+        int got = recvmmsg(fd, msgs, count, MSG_DONTWAIT, NULL);
+        if (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            LOG(VB_RECORD, LOG_ERR, LOC_WH + "recvmmsg failed " + ENO);
+        }
+
+        for (int i = 0; i < got; i++)
+        {
+            if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+            {
+                LOG(VB_RECORD, LOG_WARNING, LOC_WH +
+                    QString("Dropping datagram larger than %1 bytes")
+                    .arg(PacketBuffer::kSlotSize));
+                continue;
+            }
+            if (!sender_null &&
+                QHostAddress(reinterpret_cast<sockaddr*>(&addrs[i])) !=
+                m_sender)
+            {
+                LOG(VB_RECORD, LOG_WARNING, LOC_WH +
+                    QString("Received on socket(%1) %2 bytes from non "
+                            "expected sender:%3 (expected:%4) ignoring")
+                    .arg(m_stream).arg(msgs[i].msg_len)
+                    .arg(QHostAddress(reinterpret_cast<sockaddr*>(
+                                          &addrs[i])).toString())
+                    .arg(m_sender.toString()));
+                continue;
+            }
+            sizes[i] = msgs[i].msg_len;
+        }
+        buffer->PushDataSlots(slots, sizes, count);
+        more = (got == (int)count);
+
+        buffer->PopTSPayloads(m_payloads);
+        if (!m_payloads.empty())
+        {
+            m_parent->m_write_helper->ProcessTSPayloads(m_payloads);
+            buffer->FreeSlots(m_payloads);
+            m_payloads.clear();
+        }
+    }
+}
+#endif // USING_RECVMMSG
+
 IPTVStreamHandlerWriteHelper::IPTVStreamHandlerWriteHelper(IPTVStreamHandler *p)
   : m_parent(p),                m_timer(0),             m_timer_rtcp(0),
     m_last_sequence_number(0),  m_last_timestamp(0),    m_previous_last_sequence_number(0),
@@ -485,25 +600,8 @@ void IPTVStreamHandlerWriteHelper::timerEvent(QTimerEvent* event)
                 continue;
             }
 
-            uint exp_seq_num = m_last_sequence_number + 1;
-            uint seq_num = ts_packet.GetSequenceNumber();
-            if (m_last_sequence_number &&
-                ((exp_seq_num&0xFFFF) != (seq_num&0xFFFF)))
-            {
-                LOG(VB_RECORD, LOG_INFO, LOC_WH +
-                    QString("Sequence number mismatch %1!=%2")
-                    .arg(seq_num).arg(exp_seq_num));
-                if (seq_num > exp_seq_num)
-                {
-                    m_lost_interval = seq_num - exp_seq_num;
-                    m_lost += m_lost_interval;
-                }
-            }
-            m_last_sequence_number = seq_num;
-            m_last_timestamp = ts_packet.GetTimeStamp();
-            LOG(VB_RECORD, LOG_DEBUG,
-                QString("Processing RTP packet(seq:%1 ts:%2)")
-                .arg(m_last_sequence_number).arg(m_last_timestamp));
+            UpdateRTPStatistics(ts_packet.GetSequenceNumber(),
+                                ts_packet.GetTimeStamp());
 
             m_parent->_listener_lock.lock();
 
@@ -529,6 +627,61 @@ void IPTVStreamHandlerWriteHelper::timerEvent(QTimerEvent* event)
     }
 }
 
+void IPTVStreamHandlerWriteHelper::UpdateRTPStatistics(
+    uint seq_num, uint timestamp)
+{
+    uint exp_seq_num = m_last_sequence_number + 1;
+    if (m_last_sequence_number &&
+        ((exp_seq_num&0xFFFF) != (seq_num&0xFFFF)))
+    {
+        LOG(VB_RECORD, LOG_INFO, LOC_WH +
+            QString("Sequence number mismatch %1!=%2")
+            .arg(seq_num).arg(exp_seq_num));
+        if (seq_num > exp_seq_num)
+        {
+            m_lost_interval = seq_num - exp_seq_num;
+            m_lost += m_lost_interval;
+        }
+    }
+    m_last_sequence_number = seq_num;
+    m_last_timestamp = timestamp;
+    LOG(VB_RECORD, LOG_DEBUG,
+        QString("Processing RTP packet(seq:%1 ts:%2)")
+        .arg(m_last_sequence_number).arg(m_last_timestamp));
+}
+
+/** \brief Hands a batch of in order TS payloads to every listener,
+ *         taking the listener lock once for the whole batch.
+ */
+void IPTVStreamHandlerWriteHelper::ProcessTSPayloads(
+    const vector<PacketBuffer::TSPayload> &payloads)
+{
+    if (m_parent->m_use_rtp_streaming)
+    {
+        vector<PacketBuffer::TSPayload>::const_iterator it = payloads.begin();
+        for (; it != payloads.end(); ++it)
+            UpdateRTPStatistics((*it).sequence, (*it).timestamp);
+    }
+
+    QMutexLocker locker(&m_parent->_listener_lock);
+    vector<PacketBuffer::TSPayload>::const_iterator it = payloads.begin();
+    for (; it != payloads.end(); ++it)
+    {
+        int remainder = 0;
+        IPTVStreamHandler::StreamDataList::const_iterator sit;
+        sit = m_parent->_stream_data_list.begin();
+        for (; sit != m_parent->_stream_data_list.end(); ++sit)
+            remainder = sit.key()->ProcessData((*it).data, (*it).size);
+
+        if (remainder != 0)
+        {
+            LOG(VB_RECORD, LOG_INFO, LOC_WH +
+                QString("data_length = %1 remainder = %2")
+                .arg((*it).size).arg(remainder));
+        }
+    }
+}
+
 void IPTVStreamHandlerWriteHelper::SendRTCPReport(void)
 {
     if (m_parent->m_rtcp_dest.isNull())
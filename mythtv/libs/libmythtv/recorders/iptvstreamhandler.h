@@ -17,9 +17,11 @@ using namespace std;
 
 #include "channelutil.h"
 #include "streamhandler.h"
+#include "packetbuffer.h"
 
 #define IPTV_SOCKET_COUNT   3
 #define RTCP_TIMER          10
+#define IPTV_RECV_BATCH     32
 
 class IPTVStreamHandler;
 class DTVSignalMonitor;
@@ -38,11 +40,15 @@ class IPTVStreamHandlerReadHelper : QObject
   public slots:
     void ReadPending(void);
 
+  private:
+    void ReadPendingBatched(void);
+
   private:
     IPTVStreamHandler *m_parent;
     QUdpSocket *m_socket;
     QHostAddress m_sender;
     uint m_stream;
+    vector<PacketBuffer::TSPayload> m_payloads;
 };
 
 class IPTVStreamHandlerWriteHelper : QObject
@@ -63,9 +69,11 @@ public:
     }
 
     void SendRTCPReport(void);
+    void ProcessTSPayloads(const vector<PacketBuffer::TSPayload> &payloads);
 
 private:
     void timerEvent(QTimerEvent*);
+    void UpdateRTPStatistics(uint seq_num, uint timestamp);
 
 private:
     IPTVStreamHandler *m_parent;
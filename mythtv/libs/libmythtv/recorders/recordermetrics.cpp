@@ -0,0 +1,320 @@
+// -*- Mode: c++ -*-
+
+// Qt headers
+#include <QStringList>
+#include <QThread>
+
+// MythTV headers
+#include "recordermetrics.h"
+#include "DeviceReadBuffer.h"
+#include "mythdate.h"
+
+QMutex                                  RecorderMetricsRegistry::s_lock;
+QList<RecorderMetrics*>                 RecorderMetricsRegistry::s_recorders;
+QMap<const DeviceReadBuffer*, QString>  RecorderMetricsRegistry::s_readBuffers;
+
+RecorderMetrics::RecorderMetrics(uint inputid) :
+    m_inputid(inputid), m_created(MythDate::current()), m_chanid(0),
+    m_sequence(0), m_updated(0),
+    m_writeBufferUse(0), m_writeBufferSize(0),
+    m_writeLatency(0), m_maxWriteLatency(0)
+{
+}
+
+/** \fn RecorderMetrics::Publish(const RecorderMetricsCounters&)
+ *  \brief Makes the recorder's totals visible to GetSnapshot().
+ *
+ *   The sequence number is odd while the counters are being copied,
+ *   readers retry until they see the same even number before and
+ *   after copying them.
+ */
+void RecorderMetrics::Publish(const RecorderMetricsCounters &counters)
+{
+    m_sequence.fetchAndAddOrdered(1);
+    m_counters = counters;
+    m_sequence.fetchAndAddOrdered(1);
+
+    m_updated.store(m_created.secsTo(MythDate::current()));
+}
+
+void RecorderMetrics::SetWriterStats(
+    uint buffer_use, uint buffer_size, uint latency_ms)
+{
+    m_writeBufferUse.store(buffer_use);
+    m_writeBufferSize.store(buffer_size);
+    m_writeLatency.store(latency_ms);
+    if (latency_ms > (uint)m_maxWriteLatency.load())
+        m_maxWriteLatency.store(latency_ms);
+}
+
+void RecorderMetrics::SetDevice(const QString &device)
+{
+    QMutexLocker locker(&m_labelLock);
+    m_device = device;
+}
+
+void RecorderMetrics::SetRecording(uint chanid, const QDateTime &recstartts)
+{
+    QMutexLocker locker(&m_labelLock);
+    m_chanid     = chanid;
+    m_recstartts = recstartts;
+}
+
+RecorderMetricsCounters RecorderMetrics::ReadCounters(void) const
+{
+    while (true)
+    {
+        int seq = m_sequence.loadAcquire();
+        if (seq & 1)
+        {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+
+        RecorderMetricsCounters counters = m_counters;
+
+        if (m_sequence.fetchAndAddOrdered(0) == seq)
+            return counters;
+    }
+}
+
+RecorderMetricsSnapshot RecorderMetrics::GetSnapshot(void) const
+{
+    RecorderMetricsSnapshot snap;
+
+    snap.inputid = m_inputid;
+    snap.created = m_created;
+    {
+        QMutexLocker locker(&m_labelLock);
+        snap.device     = m_device;
+        snap.chanid     = m_chanid;
+        snap.recstartts = m_recstartts;
+    }
+
+    snap.counters        = ReadCounters();
+    snap.updated         = m_created.addSecs(m_updated.load());
+    snap.writeBufferUse  = m_writeBufferUse.load();
+    snap.writeBufferSize = m_writeBufferSize.load();
+    snap.writeLatency    = m_writeLatency.load();
+    snap.maxWriteLatency = m_maxWriteLatency.load();
+
+    for (uint pid = 0; pid <= 0x1fff; pid++)
+    {
+        uint cnt = m_pidPackets[pid].load();
+        if (cnt)
+            snap.pidPackets[pid] = cnt;
+    }
+
+    return snap;
+}
+
+/** \fn RecorderMetricsRegistry::Register(uint)
+ *  \brief Creates the metrics of a new recorder, they are deleted
+ *         by Unregister().
+ */
+RecorderMetrics *RecorderMetricsRegistry::Register(uint inputid)
+{
+    RecorderMetrics *metrics = new RecorderMetrics(inputid);
+
+    QMutexLocker locker(&s_lock);
+    s_recorders.push_back(metrics);
+
+    return metrics;
+}
+
+void RecorderMetricsRegistry::Unregister(RecorderMetrics *metrics)
+{
+    if (!metrics)
+        return;
+
+    QMutexLocker locker(&s_lock);
+    s_recorders.removeAll(metrics);
+    delete metrics;
+}
+
+void RecorderMetricsRegistry::RegisterReadBuffer(
+    const DeviceReadBuffer *drb, const QString &device)
+{
+    QMutexLocker locker(&s_lock);
+    s_readBuffers[drb] = device;
+}
+
+void RecorderMetricsRegistry::UnregisterReadBuffer(const DeviceReadBuffer *drb)
+{
+    QMutexLocker locker(&s_lock);
+    s_readBuffers.remove(drb);
+}
+
+/** \fn RecorderMetricsRegistry::GetSnapshots(uint)
+ *  \param inputid only return the recorders of this input, unless 0
+ */
+QList<RecorderMetricsSnapshot> RecorderMetricsRegistry::GetSnapshots(
+    uint inputid)
+{
+    QList<RecorderMetricsSnapshot> snaps;
+
+    QMutexLocker locker(&s_lock);
+    QList<RecorderMetrics*>::const_iterator it = s_recorders.begin();
+    for (; it != s_recorders.end(); ++it)
+    {
+        if (!inputid || (*it)->m_inputid == inputid)
+            snaps.push_back((*it)->GetSnapshot());
+    }
+
+    return snaps;
+}
+
+QList<ReadBufferSnapshot> RecorderMetricsRegistry::GetReadBufferSnapshots(void)
+{
+    QList<ReadBufferSnapshot> snaps;
+
+    QMutexLocker locker(&s_lock);
+    QMap<const DeviceReadBuffer*, QString>::const_iterator it =
+        s_readBuffers.begin();
+    for (; it != s_readBuffers.end(); ++it)
+    {
+        ReadBufferSnapshot snap;
+        snap.device  = *it;
+        snap.used    = it.key()->GetFillLevel();
+        snap.size    = it.key()->GetBufferSize();
+        snap.maxUsed = it.key()->GetMaxFillLevel();
+        snaps.push_back(snap);
+    }
+
+    return snaps;
+}
+
+static QString escape_label(const QString &value)
+{
+    QString ret = value;
+    ret.replace("\\", "\\\\");
+    ret.replace("\"", "\\\"");
+    ret.replace("\n", "\\n");
+    return ret;
+}
+
+static void add_header(QString &out, const char *name, const char *type,
+                       const char *help)
+{
+    out += QString("# HELP %1 %2\n# TYPE %1 %3\n")
+        .arg(name).arg(help).arg(type);
+}
+
+static void add_sample(QString &out, const char *name,
+                       const QString &labels, double value)
+{
+    out += QString("%1{%2} %3\n").arg(name).arg(labels)
+        .arg(value, 0, 'g', 15);
+}
+
+/** \fn RecorderMetricsRegistry::ToPrometheusText(void)
+ *  \brief Returns the metrics in the Prometheus text exposition format.
+ *
+ *   Recorders are labelled with their input id and device, the
+ *   counters start at zero when the recorder is created.
+ */
+QString RecorderMetricsRegistry::ToPrometheusText(void)
+{
+    QList<RecorderMetricsSnapshot> recs = GetSnapshots();
+    QList<ReadBufferSnapshot> drbs = GetReadBufferSnapshots();
+    QDateTime now = MythDate::current();
+
+    QStringList labels;
+    for (int i = 0; i < recs.size(); i++)
+    {
+        labels.push_back(QString("inputid=\"%1\",device=\"%2\",chanid=\"%3\"")
+                         .arg(recs[i].inputid)
+                         .arg(escape_label(recs[i].device))
+                         .arg(recs[i].chanid));
+    }
+
+    QString out;
+
+#define ADD_RECORDER_METRIC(NAME, TYPE, HELP, VALUE) \
+    do { \
+        add_header(out, NAME, TYPE, HELP); \
+        for (int i = 0; i < recs.size(); i++) \
+        { \
+            const RecorderMetricsSnapshot &r = recs[i]; \
+            add_sample(out, NAME, labels[i], (double)(VALUE)); \
+        } \
+    } while (0)
+
+    ADD_RECORDER_METRIC("mythtv_recorder_bytes_in_total", "counter",
+                        "Transport stream bytes received by the recorder.",
+                        r.counters.bytesIn);
+    ADD_RECORDER_METRIC("mythtv_recorder_bytes_out_total", "counter",
+                        "Bytes written to the recording.",
+                        r.counters.bytesOut);
+    ADD_RECORDER_METRIC("mythtv_recorder_packets_total", "counter",
+                        "Transport stream packets received by the recorder.",
+                        r.counters.packets);
+    ADD_RECORDER_METRIC("mythtv_recorder_continuity_errors_total", "counter",
+                        "Continuity counter errors seen by the recorder.",
+                        r.counters.continuityErrors);
+    ADD_RECORDER_METRIC("mythtv_recorder_keyframes_total", "counter",
+                        "Keyframes written to the recording.",
+                        r.counters.keyframes);
+    ADD_RECORDER_METRIC("mythtv_recorder_frames_written_total", "counter",
+                        "Frames written to the recording.",
+                        r.counters.frames);
+    ADD_RECORDER_METRIC("mythtv_recorder_write_buffer_bytes", "gauge",
+                        "Bytes waiting to be written to disk.",
+                        r.writeBufferUse);
+    ADD_RECORDER_METRIC("mythtv_recorder_write_buffer_size_bytes", "gauge",
+                        "Size of the write buffer.",
+                        r.writeBufferSize);
+    ADD_RECORDER_METRIC("mythtv_recorder_write_latency_seconds", "gauge",
+                        "Duration of the last write to disk.",
+                        r.writeLatency * 0.001);
+    ADD_RECORDER_METRIC("mythtv_recorder_write_latency_max_seconds", "gauge",
+                        "Longest write to disk of the recording.",
+                        r.maxWriteLatency * 0.001);
+    ADD_RECORDER_METRIC("mythtv_recorder_update_age_seconds", "gauge",
+                        "Time since the recorder last published its counters.",
+                        r.updated.secsTo(now));
+
+#undef ADD_RECORDER_METRIC
+
+    add_header(out, "mythtv_recorder_pid_packets_total", "counter",
+               "Transport stream packets received per PID.");
+    for (int i = 0; i < recs.size(); i++)
+    {
+        QMap<uint, quint64>::const_iterator it = recs[i].pidPackets.begin();
+        for (; it != recs[i].pidPackets.end(); ++it)
+        {
+            add_sample(out, "mythtv_recorder_pid_packets_total",
+                       labels[i] + QString(",pid=\"0x%1\"").arg(it.key(), 0, 16),
+                       *it);
+        }
+    }
+
+    add_header(out, "mythtv_read_buffer_bytes", "gauge",
+               "Bytes waiting in the device read buffer.");
+    for (int i = 0; i < drbs.size(); i++)
+    {
+        add_sample(out, "mythtv_read_buffer_bytes",
+                   QString("device=\"%1\"").arg(escape_label(drbs[i].device)),
+                   drbs[i].used);
+    }
+
+    add_header(out, "mythtv_read_buffer_max_bytes", "gauge",
+               "Most bytes waiting in the device read buffer.");
+    for (int i = 0; i < drbs.size(); i++)
+    {
+        add_sample(out, "mythtv_read_buffer_max_bytes",
+                   QString("device=\"%1\"").arg(escape_label(drbs[i].device)),
+                   drbs[i].maxUsed);
+    }
+
+    add_header(out, "mythtv_read_buffer_size_bytes", "gauge",
+               "Size of the device read buffer.");
+    for (int i = 0; i < drbs.size(); i++)
+    {
+        add_sample(out, "mythtv_read_buffer_size_bytes",
+                   QString("device=\"%1\"").arg(escape_label(drbs[i].device)),
+                   drbs[i].size);
+    }
+
+    return out;
+}
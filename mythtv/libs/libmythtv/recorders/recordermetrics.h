@@ -0,0 +1,147 @@
+// -*- Mode: c++ -*-
+#ifndef _RECORDER_METRICS_H_
+#define _RECORDER_METRICS_H_
+
+#include <stdint.h>
+
+#include <QAtomicInt>
+#include <QDateTime>
+#include <QString>
+#include <QMutex>
+#include <QList>
+#include <QMap>
+
+#include "mythtvexp.h"
+
+class DeviceReadBuffer;
+
+/// Totals a recorder adds to as it processes the stream
+class RecorderMetricsCounters
+{
+  public:
+    RecorderMetricsCounters() :
+        bytesIn(0), bytesOut(0), packets(0), continuityErrors(0),
+        keyframes(0), frames(0) {}
+
+    quint64 bytesIn;          ///< TS bytes handed to the recorder
+    quint64 bytesOut;         ///< bytes handed to the RingBuffer
+    quint64 packets;
+    quint64 continuityErrors;
+    quint64 keyframes;
+    quint64 frames;           ///< frames written
+};
+
+/// A copy of the metrics of one recorder at one point in time
+class RecorderMetricsSnapshot
+{
+  public:
+    RecorderMetricsSnapshot() :
+        inputid(0), chanid(0), writeBufferUse(0), writeBufferSize(0),
+        writeLatency(0), maxWriteLatency(0) {}
+
+    uint                    inputid;
+    QString                 device;
+    uint                    chanid;
+    QDateTime               recstartts;
+    QDateTime               created;
+    QDateTime               updated;   ///< when the counters were published
+    RecorderMetricsCounters counters;
+    QMap<uint, quint64>     pidPackets;
+    uint                    writeBufferUse;
+    uint                    writeBufferSize;
+    uint                    writeLatency;    ///< ms
+    uint                    maxWriteLatency; ///< ms
+};
+
+/// A copy of the fill level of one DeviceReadBuffer
+class ReadBufferSnapshot
+{
+  public:
+    ReadBufferSnapshot() : used(0), size(0), maxUsed(0) {}
+
+    QString device;
+    uint    used;
+    uint    size;
+    uint    maxUsed;
+};
+
+/** \class RecorderMetrics
+ *  \brief Live statistics of one recorder.
+ *
+ *   Each value has a single writer and is read without locking. The
+ *   recorder keeps its totals in a RecorderMetricsCounters of its own
+ *   and hands them to Publish() every so often, the per PID packet
+ *   counts are updated as packets arrive.
+ *
+ *  \sa RecorderMetricsRegistry
+ */
+class MTV_PUBLIC RecorderMetrics
+{
+    friend class RecorderMetricsRegistry;
+
+  public:
+    /// Called by the thread processing the stream
+    void CountPacket(uint pid)
+    {
+        QAtomicInt &cnt = m_pidPackets[pid & 0x1fff];
+        cnt.store(cnt.load() + 1);
+    }
+    void Publish(const RecorderMetricsCounters &counters);
+    void SetWriterStats(uint buffer_use, uint buffer_size, uint latency_ms);
+
+    void SetDevice(const QString &device);
+    void SetRecording(uint chanid, const QDateTime &recstartts);
+
+    RecorderMetricsSnapshot GetSnapshot(void) const;
+
+  private:
+    RecorderMetrics(uint inputid);
+
+    RecorderMetricsCounters ReadCounters(void) const;
+
+    uint                    m_inputid;
+    QDateTime               m_created;
+    mutable QMutex          m_labelLock;   ///< protects the labels below
+    QString                 m_device;
+    uint                    m_chanid;
+    QDateTime               m_recstartts;
+
+    mutable QAtomicInt      m_sequence;    ///< odd while publishing
+    RecorderMetricsCounters m_counters;
+    QAtomicInt              m_updated;     ///< secs since m_created
+    QAtomicInt              m_writeBufferUse;
+    QAtomicInt              m_writeBufferSize;
+    QAtomicInt              m_writeLatency;
+    QAtomicInt              m_maxWriteLatency;
+    QAtomicInt              m_pidPackets[0x1fff + 1];
+};
+
+/** \class RecorderMetricsRegistry
+ *  \brief Keeps track of the RecorderMetrics of the recorders and the
+ *         DeviceReadBuffers of this process.
+ *
+ *   Only registering and taking snapshots takes the registry lock,
+ *   updating the metrics does not.
+ */
+class MTV_PUBLIC RecorderMetricsRegistry
+{
+  public:
+    static RecorderMetrics *Register(uint inputid);
+    static void Unregister(RecorderMetrics *metrics);
+
+    static void RegisterReadBuffer(const DeviceReadBuffer *drb,
+                                   const QString &device);
+    static void UnregisterReadBuffer(const DeviceReadBuffer *drb);
+
+    static QList<RecorderMetricsSnapshot> GetSnapshots(uint inputid = 0);
+    static QList<ReadBufferSnapshot> GetReadBufferSnapshots(void);
+
+    static QString ToPrometheusText(void);
+
+  private:
+    static QMutex                                  s_lock;
+    static QList<RecorderMetrics*>                 s_recorders;
+    static QMap<const DeviceReadBuffer*, QString>  s_readBuffers;
+};
+
+#endif // _RECORDER_METRICS_H_
@@ -13,7 +13,8 @@
 
 PacketBuffer::PacketBuffer(unsigned int bitrate) :
     m_bitrate(bitrate),
-    m_next_empty_packet_key(0ULL)
+    m_next_empty_packet_key(0ULL),
+    m_slab(NULL)
 {
     while (!m_next_empty_packet_key)
     {
@@ -23,6 +24,11 @@ PacketBuffer::PacketBuffer(unsigned int bitrate) :
     }
 }
 
+PacketBuffer::~PacketBuffer()
+{
+    delete [] m_slab;
+}
+
 bool PacketBuffer::HasAvailablePacket(void) const
 {
     return !m_available_packets.empty();
@@ -59,3 +65,38 @@ void PacketBuffer::FreePacket(const UDPPacket &packet)
     if (top == (m_next_empty_packet_key & (0xFFFFFFFFULL<<32)))
         m_empty_packets[packet.GetKey()] = packet;
 }
+
+uint PacketBuffer::GetEmptySlots(unsigned char **slots, uint max)
+{
+    if (!m_slab)
+    {
+        m_slab = new unsigned char[kSlotCount * kSlotSize];
+        m_empty_slots.reserve(kSlotCount);
+        for (int i = kSlotCount - 1; i >= 0; i--)
+            m_empty_slots.push_back(i);
+        m_ready_payloads.reserve(kSlotCount);
+    }
+
+    uint count = 0;
+    while (count < max && !m_empty_slots.empty())
+    {
+        slots[count++] = m_slab + m_empty_slots.back() * kSlotSize;
+        m_empty_slots.pop_back();
+    }
+
+    return count;
+}
+
+void PacketBuffer::PopTSPayloads(vector<TSPayload> &payloads)
+{
+    payloads.insert(payloads.end(),
+                    m_ready_payloads.begin(), m_ready_payloads.end());
+    m_ready_payloads.clear();
+}
+
+void PacketBuffer::FreeSlots(const vector<TSPayload> &payloads)
+{
+    vector<TSPayload>::const_iterator it = payloads.begin();
+    for (; it != payloads.end(); ++it)
+        FreeSlot((*it).slot);
+}
@@ -7,6 +7,9 @@
 #ifndef _PACKET_BUFFER_H_
 #define _PACKET_BUFFER_H_
 
+#include <vector>
+using namespace std;
+
 #include <QList>
 #include <QMap>
 
@@ -16,7 +19,7 @@ class PacketBuffer
 {
   public:
     PacketBuffer(unsigned int bitrate);
-    virtual ~PacketBuffer() { }
+    virtual ~PacketBuffer();
 
     virtual void PushDataPacket(const UDPPacket&) = 0;
 
@@ -40,6 +43,53 @@ class PacketBuffer
      */
     void FreePacket(const UDPPacket &);
 
+    /** \brief A transport stream payload ready for processing, which
+     *         still lives in the receive slot it was read into.
+     */
+    class TSPayload
+    {
+      public:
+        TSPayload() :
+            data(NULL), size(0), sequence(0), timestamp(0), slot(-1) { }
+        TSPayload(const unsigned char *d, uint sz, int s) :
+            data(d), size(sz), sequence(0), timestamp(0), slot(s) { }
+        const unsigned char *data;
+        uint size;
+        uint sequence;      ///< RTP sequence number, 0 for raw UDP
+        uint timestamp;     ///< RTP timestamp, 0 for raw UDP
+        int  slot;
+    };
+
+    /// Size of a receive slot, large enough for any non jumbo datagram
+    static const uint kSlotSize  = 2048;
+    /// Number of receive slots, must be a power of two
+    static const uint kSlotCount = 512;
+
+    /// \brief Hands out up to max empty receive slots of kSlotSize bytes
+    ///        for reading datagrams into, returns the number handed out.
+    uint GetEmptySlots(unsigned char **slots, uint max);
+
+    /** \brief Adds datagrams that were read into slots from GetEmptySlots().
+     *
+     *  A size of 0 marks a slot that didn't receive anything, it is
+     *  returned for reuse right away.
+     */
+    virtual void PushDataSlots(unsigned char * const *slots,
+                               const uint *sizes, uint count) = 0;
+
+    /// \brief Appends the TS payloads that are ready, in order, to payloads.
+    void PopTSPayloads(vector<TSPayload> &payloads);
+
+    /// \brief Returns the slots of processed payloads for reuse.
+    void FreeSlots(const vector<TSPayload> &payloads);
+
+  protected:
+    int  SlotIndex(const unsigned char *slot) const
+    {
+        return (slot - m_slab) / kSlotSize;
+    }
+    void FreeSlot(int slot) { m_empty_slots.push_back(slot); }
+
   protected:
     uint m_bitrate;
 
@@ -51,6 +101,15 @@ class PacketBuffer
 
     /// Ordered list of available packets
     QList<UDPPacket> m_available_packets;
+
+    /// Receive slots, only allocated once GetEmptySlots() is used
+    unsigned char *m_slab;
+
+    /// Indices of receive slots ready for reuse
+    vector<int> m_empty_slots;
+
+    /// Ordered list of payloads waiting in receive slots
+    vector<TSPayload> m_ready_payloads;
 };
 
 #endif // _PACKET_BUFFER_H_
@@ -10,6 +10,12 @@ using namespace std;
 #include "rtppacketbuffer.h"
 #include "rtpdatapacket.h"
 #include "rtpfecpacket.h"
+#include "mythlogging.h"
+
+/// Packets further ahead than this mean the stream was restarted
+#define MAX_SEQUENCE_JUMP (PacketBuffer::kSlotCount / 2)
+/// Give up on a missing packet once this many later packets arrived
+#define MAX_HELD_PACKETS  128
 
 void RTPPacketBuffer::PushDataPacket(const UDPPacket &udp_packet)
 {
@@ -71,3 +77,103 @@ void RTPPacketBuffer::PushFECPacket(
     // for now just free the packet for immediate reuse
     FreePacket(packet);
 }
+
+/** \brief Parses the RTP headers of a batch of datagrams and queues the
+ *         TS payloads in sequence number order.
+ *
+ *  Payloads stay in their receive slots, only their offsets are kept.
+ *  A missing packet holds back everything after it until either it
+ *  turns up or MAX_HELD_PACKETS later packets have arrived, at which
+ *  point it is counted as lost.
+ */
+void RTPPacketBuffer::PushDataSlots(unsigned char * const *slots,
+                                    const uint *sizes, uint count)
+{
+    for (uint i = 0; i < count; i++)
+    {
+        const unsigned char *d = slots[i];
+        uint size = sizes[i];
+        int  slot = SlotIndex(d);
+
+        // RFC 3550 fixed header, carrying an MPEG-2 transport stream
+        if (size < 12 || (d[0] >> 6) != 2 ||
+            (d[1] & 0x7f) != RTPDataPacket::kPayLoadTypeTS)
+        {
+            FreeSlot(slot);
+            continue;
+        }
+
+        uint off = 12 + 4 * (d[0] & 0xf);
+        if ((d[0] & 0x10) && off + 4 <= size)
+            off += 4 * (1 + ((d[off + 2] << 8) | d[off + 3]));
+        uint end = size;
+        if (d[0] & 0x20)
+            end -= min((uint)d[size - 1], size);
+        if (off >= end)
+        {
+            FreeSlot(slot);
+            continue;
+        }
+
+        TSPayload payload(d + off, end - off, slot);
+        payload.sequence  = (d[2] << 8) | d[3];
+        payload.timestamp = ((uint)d[4] << 24) | (d[5] << 16) |
+                            (d[6] << 8) | d[7];
+
+        if (!m_sequence_started)
+        {
+            m_next_sequence    = payload.sequence;
+            m_sequence_started = true;
+        }
+
+        uint ahead = (payload.sequence - m_next_sequence) & 0xFFFF;
+        if (ahead >= 0x8000)
+        {
+            // late or duplicate, we already gave up on this one
+            FreeSlot(slot);
+            continue;
+        }
+        if (ahead >= MAX_SEQUENCE_JUMP)
+        {
+            LOG(VB_RECORD, LOG_INFO,
+                QString("RTP sequence jumped from %1 to %2, resyncing")
+                .arg(m_next_sequence).arg(payload.sequence));
+            ReleaseInOrder(true);
+            m_next_sequence = payload.sequence;
+        }
+
+        TSPayload &entry = m_window[payload.sequence & (kSlotCount - 1)];
+        if (entry.slot >= 0)
+        {
+            FreeSlot(slot); // duplicate
+            continue;
+        }
+        entry = payload;
+        m_held++;
+    }
+
+    ReleaseInOrder(false);
+}
+
+void RTPPacketBuffer::ReleaseInOrder(bool flush)
+{
+    while (m_held)
+    {
+        TSPayload &entry = m_window[m_next_sequence & (kSlotCount - 1)];
+        if (entry.slot >= 0)
+        {
+            m_ready_payloads.push_back(entry);
+            entry.slot = -1;
+            m_held--;
+        }
+        else if (flush || m_held >= MAX_HELD_PACKETS)
+        {
+            m_lost_packets++;
+        }
+        else
+        {
+            break; // wait for the missing packet
+        }
+        m_next_sequence = (m_next_sequence + 1) & 0xFFFF;
+    }
+}
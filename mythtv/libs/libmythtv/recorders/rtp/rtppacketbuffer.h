@@ -18,7 +18,12 @@ class RTPPacketBuffer : public PacketBuffer
     RTPPacketBuffer(unsigned int bitrate) :
         PacketBuffer(bitrate),
         m_large_sequence_number_seen_recently(0),
-        m_current_sequence(0ULL)
+        m_current_sequence(0ULL),
+        m_window(kSlotCount),
+        m_next_sequence(0),
+        m_sequence_started(false),
+        m_held(0),
+        m_lost_packets(0)
     {
     }
 
@@ -28,12 +33,31 @@ class RTPPacketBuffer : public PacketBuffer
     /// Adds SMPTE 2022 Forward Error Correction Stream packet
     virtual void PushFECPacket(const UDPPacket&, unsigned int fec_stream_num);
 
+    /// Adds a batch of RFC 3550 RTP datagrams sitting in receive slots
+    virtual void PushDataSlots(unsigned char * const *slots,
+                               const uint *sizes, uint count);
+
+    /// Returns the number of packets given up on while reordering
+    uint64_t GetLostPackets(void) const { return m_lost_packets; }
+
+  private:
+    void ReleaseInOrder(bool flush);
+
   private:
     int m_large_sequence_number_seen_recently;
     uint64_t m_current_sequence;
 
     /// The key is the RTP sequence number + sequence if applicable
     QMap<uint64_t, RTPDataPacket> m_unordered_packets;
+
+    /// Reorder window for slot payloads, indexed by sequence number
+    vector<TSPayload> m_window;
+    /// Sequence number of the next payload to hand out
+    uint m_next_sequence;
+    bool m_sequence_started;
+    /// Number of payloads waiting in m_window
+    uint m_held;
+    uint64_t m_lost_packets;
 };
 
 #endif // _RTP_PACKET_BUFFER_H_
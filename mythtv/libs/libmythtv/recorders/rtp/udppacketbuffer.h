@@ -25,6 +25,24 @@ class UDPPacketBuffer : public PacketBuffer
     {
         FreePacket(packet);
     }
+
+    /// Raw UDP datagrams are TS payloads already and can't be reordered
+    virtual void PushDataSlots(unsigned char * const *slots,
+                               const uint *sizes, uint count)
+    {
+        for (uint i = 0; i < count; i++)
+        {
+            if (sizes[i])
+            {
+                m_ready_payloads.push_back(
+                    TSPayload(slots[i], sizes[i], SlotIndex(slots[i])));
+            }
+            else
+            {
+                FreeSlot(SlotIndex(slots[i]));
+            }
+        }
+    }
 };
 
 #endif // _UDP_PACKET_BUFFER_H_
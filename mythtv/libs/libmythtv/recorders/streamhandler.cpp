@@ -26,7 +26,8 @@ StreamHandler::StreamHandler(const QString &device) :
     _open_pid_filters(0),
     _mpts_tfw(NULL),
 
-    _listener_lock(QMutex::Recursive)
+    _listener_lock(QMutex::Recursive),
+    _using_demux(false)
 {
 }
 
@@ -92,6 +93,7 @@ void StreamHandler::AddListener(MPEGStreamData *data,
     else
     {
         _stream_data_list[data] = output_file;
+        _demux.AddListener(data);
     }
 
     _listener_lock.unlock();
@@ -128,6 +130,7 @@ void StreamHandler::RemoveListener(MPEGStreamData *data)
         if (!(*it).isEmpty())
             RemoveNamedOutputFile(*it);
         _stream_data_list.erase(it);
+        _demux.RemoveListener(data);
     }
 
     if (_stream_data_list.empty())
@@ -380,6 +383,40 @@ PIDPriority StreamHandler::GetPIDPriority(uint pid) const
     return tmp;
 }
 
+/** \fn StreamHandler::ProcessListenerData(const unsigned char*,int)
+ *  \brief Hands the transport stream in buffer to the listeners.
+ *
+ *   When several recorders share the multiplex each packet is only
+ *   demultiplexed, and each table only assembled, once by _demux.
+ *
+ *  \note The _listener_lock must be held when this is called.
+ *  \return the number of bytes left over at the end of the buffer
+ */
+int StreamHandler::ProcessListenerData(const unsigned char *buffer, int len)
+{
+    bool use_demux = (_stream_data_list.size() > 1) &&
+        (_demux.ListenerCount() == (uint)_stream_data_list.size());
+
+    if (use_demux != _using_demux)
+    {
+        LOG(VB_RECORD, LOG_INFO, LOC + QString("%1 the shared demux")
+            .arg(use_demux ? "Starting" : "Stopping"));
+        if (use_demux)
+            _demux.Reset();
+        _using_demux = use_demux;
+    }
+
+    if (use_demux)
+        return _demux.ProcessData(buffer, len);
+
+    int remainder = 0;
+    StreamDataList::const_iterator sit = _stream_data_list.begin();
+    for (; sit != _stream_data_list.end(); ++sit)
+        remainder = sit.key()->ProcessData(buffer, len);
+
+    return remainder;
+}
+
 void StreamHandler::WriteMPTS(unsigned char * buffer, uint len)
 {
     if (_mpts_tfw == NULL)
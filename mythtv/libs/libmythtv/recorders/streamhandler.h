@@ -13,6 +13,7 @@ using namespace std;
 
 #include "DeviceReadBuffer.h" // for ReaderPausedCB
 #include "mpegstreamdata.h" // for PIDPriority
+#include "shareddemux.h"
 #include "mthread.h"
 #include "mythdate.h"
 
@@ -90,6 +91,8 @@ class StreamHandler : protected MThread, public DeviceReaderCB
 
     PIDPriority GetPIDPriority(uint pid) const;
 
+    int ProcessListenerData(const unsigned char *buffer, int len);
+
     // DeviceReaderCB
     virtual void ReaderPaused(int fd) { (void) fd; }
     virtual void PriorityEvent(int fd) { (void) fd; }
@@ -134,6 +137,9 @@ class StreamHandler : protected MThread, public DeviceReaderCB
     typedef QMap<MPEGStreamData*,QString> StreamDataList;
     mutable QMutex    _listener_lock;
     StreamDataList    _stream_data_list;
+    /// Splits the stream between the listeners when there are several
+    SharedDemux       _demux;
+    bool              _using_demux;
 };
 
 #endif // _STREAM_HANDLER_H_
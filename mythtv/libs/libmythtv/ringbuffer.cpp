@@ -39,11 +39,14 @@
 #define BUFFER_FACTOR_NETWORK  2
 #define BUFFER_FACTOR_BITRATE  2
 #define BUFFER_FACTOR_MATROSKA 2
+#define BUFFER_FACTOR_SEQUENTIAL 2
 
 const int  RingBuffer::kDefaultOpenTimeout = 2000; // ms
 const int  RingBuffer::kLiveTVOpenTimeout  = 10000;
 
 #define CHUNK 32768 /* readblocksize increments */
+#define SEQUENTIAL_BLOCK_MINIMUM (256 * 1024)
+#define STALL_THRESHOLD_MS 20 /* waits longer than this are stalls */
 
 #define LOC      QString("RingBuf(%1): ").arg(filename)
 
@@ -56,6 +59,10 @@ extern "C" {
 }
 bool        RingBuffer::gAVformat_net_initialised = false;
 
+QMutex      RingBuffer::s_readAheadStatsLock;
+RingBuffer::ReadAheadStats
+            RingBuffer::s_readAheadStats[kReadAheadPolicyCount];
+
 /*
   Locking relations:
     rwlock->poslock->rbrlock->rbwlock
@@ -243,6 +250,11 @@ RingBuffer::RingBuffer(RingBufferType rbtype) :
     oldfile(false),           livetvchain(NULL),
     ignoreliveeof(false),     readAdjust(0),
     readOffset(0),            readInternalMode(false),
+    readaheadpolicy(kReadAheadInteractive),
+    willneedreads(0),
+    readaheadlowprio(false),
+    readaheadhits(0),         readaheadmisses(0),
+    readaheadstalls(0),       readaheadstallms(0),
     bitrateMonitorEnabled(false),
     bitrateInitialized(false)
 {
@@ -281,6 +293,14 @@ RingBuffer::~RingBuffer(void)
     assert(!isRunning());
     wait();
 
+    if (readaheadhits || readaheadmisses)
+    {
+        LOG(VB_FILE, LOG_INFO, LOC +
+            QString("Read ahead (%1): %2")
+                .arg(ReadAheadPolicyToString(readaheadpolicy))
+                .arg(GetReadAheadStats()));
+    }
+
     delete [] readAheadBuffer;
     readAheadBuffer = NULL;
 
@@ -390,6 +410,38 @@ void RingBuffer::SetBufferSizeFactors(bool estbitrate, bool matroska)
     CreateReadAheadBuffer();
 }
 
+/** \fn RingBuffer::SetReadAheadPolicy(ReadAheadPolicy)
+ *  \brief Tells RingBuffer how the data is going to be consumed.
+ *
+ *   Sequential and batch readers get a larger buffer and larger reads,
+ *   and the kernel is asked to read ahead of them. The batch policy
+ *   additionally drops the read ahead thread to the idle I/O priority
+ *   so that it does not compete with playback and recording.
+ */
+void RingBuffer::SetReadAheadPolicy(ReadAheadPolicy policy)
+{
+    if (policy >= kReadAheadPolicyCount)
+        return;
+
+    rwlock.lockForWrite();
+    if (policy == readaheadpolicy)
+    {
+        rwlock.unlock();
+        return;
+    }
+    LOG(VB_FILE, LOG_INFO, LOC + QString("SetReadAheadPolicy(%1)")
+        .arg(ReadAheadPolicyToString(policy)));
+    readaheadpolicy = policy;
+    willneedreads.store(policy != kReadAheadInteractive);
+    CalcReadAheadThresh();
+    bool resize = readAheadBuffer;
+    rwlock.unlock();
+
+    // otherwise the read ahead thread sizes the buffer when it starts
+    if (resize)
+        CreateReadAheadBuffer();
+}
+
 /** \fn RingBuffer::CalcReadAheadThresh(void)
  *  \brief Calculates fill_min, fill_threshold, and readblocksize
  *         from the estimated effective bitrate of the stream.
@@ -437,6 +489,10 @@ void RingBuffer::CalcReadAheadThresh(void)
         readblocksize = bitrateInitialized ? max(rbs,readblocksize) : rbs;
     }
 
+    // Nobody is going to seek, so favour few large reads over latency.
+    if (readaheadpolicy != kReadAheadInteractive)
+        readblocksize = max(readblocksize, SEQUENTIAL_BLOCK_MINIMUM);
+
     // minumum seconds of buffering before allowing read
     float secs_min = 0.3;
     // set the minimum buffering before allowing ffmpeg read
@@ -877,6 +933,8 @@ void RingBuffer::CreateReadAheadBuffer(void)
         if (unknownbitrate)
             newsize *= BUFFER_FACTOR_BITRATE;
     }
+    if (readaheadpolicy != kReadAheadInteractive)
+        newsize *= BUFFER_FACTOR_SEQUENTIAL;
 
     // N.B. Don't try and make it smaller - bad things happen...
     if (readAheadBuffer && oldsize >= newsize)
@@ -967,6 +1025,18 @@ void RingBuffer::run(void)
             continue;
         }
 
+        // Once lowered the priority is kept, we don't know what
+        // priority the process had before it asked for batch reads.
+        if (!readaheadlowprio && readaheadpolicy == kReadAheadBatch)
+        {
+            readaheadlowprio = true;
+            if (!myth_ioprio(8, true))
+            {
+                LOG(VB_FILE, LOG_WARNING, LOC +
+                    "Failed to lower read ahead I/O priority");
+            }
+        }
+
         long long totfree = ReadBufFree();
 
         const uint KB32  = 32*1024;
@@ -1035,7 +1105,9 @@ void RingBuffer::run(void)
                             .arg(readblocksize/1024));
                     readtimeavg = 225;
                 }
-                else if (readtimeavg > 300 && readblocksize > CHUNK)
+                else if (readtimeavg > 300 && readblocksize > CHUNK &&
+                         (readaheadpolicy == kReadAheadInteractive ||
+                          readblocksize > SEQUENTIAL_BLOCK_MINIMUM))
                 {
                     readblocksize -= CHUNK;
                     LOG(VB_FILE, LOG_INFO, LOC +
@@ -1498,6 +1570,7 @@ int RingBuffer::ReadPriv(void *buf, int count, bool peek)
     }
 
     int avail = ReadBufAvail();
+    bool hit = (avail >= count) || ateof;
     MythTimer t(MythTimer::kStartRunning);
 
     // Wait up to 10000 ms for any data
@@ -1517,6 +1590,8 @@ int RingBuffer::ReadPriv(void *buf, int count, bool peek)
         if (avail > 0)
             break;
     }
+    if (!readInternalMode)
+        UpdateReadAheadStats(hit, t.elapsed());
     if (t.elapsed() > 2000)
     {
         LOG(VB_GENERAL, LOG_WARNING, LOC + loc_desc +
@@ -1679,6 +1754,82 @@ QString RingBuffer::GetAvailableBuffer(void)
     return QString("%1%").arg((int)(((float)avail / (float)bufferSize) * 100.0));
 }
 
+/** \brief Returns a summary of how often reads were served straight
+ *         from the read ahead buffer and how often the reader stalled.
+ */
+QString RingBuffer::GetReadAheadStats(void)
+{
+    uint64_t total = readaheadhits + readaheadmisses;
+    if (!total)
+        return "N/A";
+
+    return QString("%1% hits, %2 stalls (%3 ms)")
+        .arg((int)((readaheadhits * 100) / total))
+        .arg(readaheadstalls).arg(readaheadstallms);
+}
+
+void RingBuffer::UpdateReadAheadStats(bool hit, int waitms)
+{
+    bool stall = !hit && (waitms > STALL_THRESHOLD_MS);
+
+    if (hit)
+        readaheadhits++;
+    else
+        readaheadmisses++;
+    if (stall)
+    {
+        readaheadstalls++;
+        readaheadstallms += waitms;
+    }
+
+    QMutexLocker locker(&s_readAheadStatsLock);
+    ReadAheadStats &stats = s_readAheadStats[readaheadpolicy];
+    if (hit)
+        stats.hits++;
+    else
+        stats.misses++;
+    if (stall)
+    {
+        stats.stalls++;
+        stats.stallms += waitms;
+    }
+}
+
+/** \brief Returns the read counters accumulated by every RingBuffer in
+ *         this process that used the given read ahead policy.
+ *
+ *  \param hits    Reads served without waiting for the read ahead thread
+ *  \param misses  Reads that had to wait for data
+ *  \param stalls  Misses that waited long enough to be noticeable
+ *  \param stallms Total time spent in stalls
+ */
+void RingBuffer::GetReadAheadPolicyStats(ReadAheadPolicy policy,
+                                         uint64_t &hits, uint64_t &misses,
+                                         uint64_t &stalls, uint64_t &stallms)
+{
+    hits = misses = stalls = stallms = 0;
+    if (policy >= kReadAheadPolicyCount)
+        return;
+
+    QMutexLocker locker(&s_readAheadStatsLock);
+    const ReadAheadStats &stats = s_readAheadStats[policy];
+    hits    = stats.hits;
+    misses  = stats.misses;
+    stalls  = stats.stalls;
+    stallms = stats.stallms;
+}
+
+QString RingBuffer::ReadAheadPolicyToString(ReadAheadPolicy policy)
+{
+    switch (policy)
+    {
+        case kReadAheadInteractive: return "Interactive";
+        case kReadAheadSequential:  return "Sequential";
+        case kReadAheadBatch:       return "Batch";
+        default:                    return "Unknown";
+    }
+}
+
 uint64_t RingBuffer::UpdateDecoderRate(uint64_t latest)
 {
     if (!bitrateMonitorEnabled)
@@ -1858,6 +2009,25 @@ bool RingBuffer::WriterSetBlocking(bool block)
     return false;
 }
 
+/** \fn RingBuffer::GetWriterStats(uint&,uint&,uint&) const
+ *  \brief Returns the buffer fill and the last write latency of the
+ *         ThreadedFileWriter.
+ *  \return false if this is not writing to a local file
+ */
+bool RingBuffer::GetWriterStats(uint &buffer_use, uint &buffer_size,
+                                uint &latency_ms) const
+{
+    QReadLocker lock(&rwlock);
+
+    if (!tfw)
+        return false;
+
+    buffer_use  = tfw->GetBufferUse();
+    buffer_size = tfw->GetBufferSize();
+    latency_ms  = tfw->GetWriteLatency();
+    return true;
+}
+
 /** \brief Tell RingBuffer if this is an old file or not.
  *
  *  Normally the RingBuffer determines that the file is old
@@ -4,6 +4,7 @@
 #define _RINGBUFFER_H_
 
 #include <QReadWriteLock>
+#include <QAtomicInt>
 #include <QWaitCondition>
 #include <QString>
 #include <QMutex>
@@ -42,6 +43,22 @@ enum RingBufferType
     kRingBuffer_MHEG
 };
 
+/** \brief How the read ahead thread should fill its buffer.
+ *
+ *  The policy is picked by whoever opens the RingBuffer, since only the
+ *  caller knows how the data is going to be consumed.
+ */
+enum ReadAheadPolicy
+{
+    /// Playback, frequent seeks, keep reads small so seeks are cheap.
+    kReadAheadInteractive = 0,
+    /// Streaming to a client, large reads, kernel read ahead hints.
+    kReadAheadSequential,
+    /// Background jobs such as commflag, large reads at idle I/O priority.
+    kReadAheadBatch,
+    kReadAheadPolicyCount
+};
+
 class MTV_PUBLIC RingBuffer : protected MThread
 {
     friend class ICRingBuffer;
@@ -62,6 +79,7 @@ class MTV_PUBLIC RingBuffer : protected MThread
     void EnableBitrateMonitor(bool enable) { bitrateMonitorEnabled = enable; }
     void SetBufferSizeFactors(bool estbitrate, bool matroska);
     void SetWaitForWrite(void) { waitforwrite = true; }
+    void SetReadAheadPolicy(ReadAheadPolicy policy);
 
     // Gets
     QString   GetSafeFilename(void) { return safefilename; }
@@ -81,6 +99,8 @@ class MTV_PUBLIC RingBuffer : protected MThread
     QString GetStorageRate(void);
     QString GetAvailableBuffer(void);
     uint    GetBufferSize(void) { return bufferSize; }
+    QString GetReadAheadStats(void);
+    ReadAheadPolicy GetReadAheadPolicy(void) const { return readaheadpolicy; }
     long long GetWritePosition(void) const;
     /// \brief Returns the size of the file we are reading/writing,
     ///        or -1 if the query fails.
@@ -159,6 +179,8 @@ class MTV_PUBLIC RingBuffer : protected MThread
     void Sync(void);
     long long WriterSeek(long long pos, int whence, bool has_lock = false);
     bool WriterSetBlocking(bool lock = true);
+    bool GetWriterStats(uint &buffer_use, uint &buffer_size,
+                        uint &latency_ms) const;
 
     long long SetAdjustFilesize(void);
 
@@ -170,6 +192,11 @@ class MTV_PUBLIC RingBuffer : protected MThread
 
     static void AVFormatInitNetwork(void);
 
+    static QString ReadAheadPolicyToString(ReadAheadPolicy policy);
+    static void GetReadAheadPolicyStats(ReadAheadPolicy policy,
+                                        uint64_t &hits, uint64_t &misses,
+                                        uint64_t &stalls, uint64_t &stallms);
+
   protected:
     RingBuffer(RingBufferType rbtype);
 
@@ -195,6 +222,8 @@ class MTV_PUBLIC RingBuffer : protected MThread
     uint64_t UpdateDecoderRate(uint64_t latest = 0);
     uint64_t UpdateStorageRate(uint64_t latest = 0);
 
+    void UpdateReadAheadStats(bool hit, int waitms);
+
   protected:
     RingBufferType type;
     mutable QReadWriteLock poslock;
@@ -262,6 +291,15 @@ class MTV_PUBLIC RingBuffer : protected MThread
     int       readOffset;         // protected by rwlock
     bool      readInternalMode;   // protected by rwlock
 
+    // Read ahead policy
+    ReadAheadPolicy readaheadpolicy; // protected by rwlock
+    QAtomicInt willneedreads;     // policy != interactive, no locking
+    bool      readaheadlowprio;   // only used by read ahead thread
+    uint64_t  readaheadhits;      // protected by rwlock (see note 2)
+    uint64_t  readaheadmisses;    // protected by rwlock (see note 2)
+    uint64_t  readaheadstalls;    // protected by rwlock (see note 2)
+    uint64_t  readaheadstallms;   // protected by rwlock (see note 2)
+
     // bitrate monitors
     bool              bitrateMonitorEnabled;
     QMutex            decoderReadLock;
@@ -275,6 +313,10 @@ class MTV_PUBLIC RingBuffer : protected MThread
     // fragile state of affairs and care must be taken when modifying
     // code or locking around this variable.
 
+    // note 2: the read ahead counters are only modified by the reading
+    // thread while it holds a read lock; they are statistics so a torn
+    // read from another thread is harmless.
+
     /// Condition to signal that the read ahead thread is running
     QWaitCondition generalWait;         // protected by rwlock
 
@@ -285,6 +327,18 @@ class MTV_PUBLIC RingBuffer : protected MThread
 
   private:
     static bool gAVformat_net_initialised;
+
+    class ReadAheadStats
+    {
+      public:
+        ReadAheadStats() : hits(0), misses(0), stalls(0), stallms(0) {}
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t stalls;
+        uint64_t stallms;
+    };
+    static QMutex         s_readAheadStatsLock;
+    static ReadAheadStats s_readAheadStats[kReadAheadPolicyCount];
     bool bitrateInitialized;
 };
 
@@ -0,0 +1,257 @@
+/*
+ *  Class TestPSIPAssembly
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QFile>
+
+#include "test_psipassembly.h"
+#include "pespacket.h"
+
+#define EIT_PID 0x12
+
+bool SectionCounter::HandleTables(uint /*pid*/, const PSIPTable &psip)
+{
+    // the EIT helper keeps a copy of every table it is handed
+    PSIPTable copy(psip);
+
+    m_sections++;
+    m_bytes += copy.SectionLength();
+    if (!copy.IsGood() || copy.CalcCRC() != copy.CRC())
+        m_badSections++;
+
+    return true;
+}
+
+/// MPEG-2 CRC-32, one bit at a time
+static uint bitwise_crc(const unsigned char *data, uint len)
+{
+    uint crc = 0xffffffff;
+    for (uint i = 0; i < len; i++)
+    {
+        crc ^= ((uint)data[i]) << 24;
+        for (uint j = 0; j < 8; j++)
+            crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+    }
+    return crc;
+}
+
+/// Builds a present/following EIT section of length bytes with a valid CRC
+static QByteArray make_section(uint serviceid, uint section, uint length)
+{
+    QByteArray sect(length, 0);
+    unsigned char *d = reinterpret_cast<unsigned char*>(sect.data());
+
+    d[0] = TableID::PF_EIT;
+    d[1] = 0xf0 | ((length - 3) >> 8);
+    d[2] = (length - 3) & 0xff;
+    d[3] = serviceid >> 8;
+    d[4] = serviceid & 0xff;
+    d[5] = 0xc1; // version 0, current
+    d[6] = section;
+    d[7] = 0xff;
+    for (uint i = 8; i < length - 4; i++)
+        d[i] = (i * 7 + serviceid) & 0x7f;
+
+    uint crc = bitwise_crc(d, length - 4);
+    d[length - 4] = (crc >> 24) & 0xff;
+    d[length - 3] = (crc >> 16) & 0xff;
+    d[length - 2] = (crc >>  8) & 0xff;
+    d[length - 1] = crc & 0xff;
+
+    return sect;
+}
+
+/// Splits back to back sections into TS packets of pid
+static QByteArray packetize(uint pid, const QByteArray &sections,
+                            const QVector<int> &starts)
+{
+    QByteArray ts;
+    uint cc = 0;
+    int pos = 0;
+    int next = 0;
+    const int size = sections.size();
+
+    while (pos < size)
+    {
+        unsigned char pkt[188];
+        memset(pkt, 0xff, sizeof(pkt));
+        pkt[0] = SYNC_BYTE;
+        pkt[1] = (pid >> 8) & 0x1f;
+        pkt[2] = pid & 0xff;
+        pkt[3] = 0x10 | cc;
+        cc = (cc + 1) & 0xf;
+
+        while (next < starts.size() && starts[next] < pos)
+            next++;
+
+        bool pusi = (next < starts.size()) && (starts[next] < pos + 183);
+        int n = qMin(pusi ? 183 : 184, size - pos);
+
+        // Multiplexers don't start a section in the last bytes of a
+        // packet, the section header would be split across packets.
+        for (int i = next; i < starts.size() && starts[i] < pos + n; i++)
+        {
+            if (starts[i] > pos + n - 3)
+            {
+                n = starts[i] - pos;
+                break;
+            }
+        }
+        pusi = pusi && (starts[next] < pos + n);
+
+        unsigned char *out = pkt + 4;
+        if (pusi)
+        {
+            pkt[1] |= 0x40;
+            *out++ = starts[next] - pos;
+        }
+        memcpy(out, sections.constData() + pos, n);
+        pos += n;
+
+        ts.append(reinterpret_cast<const char*>(pkt), sizeof(pkt));
+    }
+
+    return ts;
+}
+
+void TestPSIPAssembly::initTestCase(void)
+{
+    // A mix of sections sharing TS packets and sections spanning
+    // up to 23 TS packets, as seen on the EIT PIDs of a busy multiplex.
+    static const uint sizes[] = { 40, 96, 150, 400, 1021, 2500, 4096, 64 };
+    const uint nsizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    QByteArray sections;
+    QVector<int> starts;
+    m_eitSections = 0;
+    for (uint service = 1; service <= 64; service++)
+    {
+        for (uint section = 0; section < 2 * nsizes; section++)
+        {
+            starts.push_back(sections.size());
+            sections.append(make_section(
+                service, section, sizes[(service + section) % nsizes]));
+            m_eitSections++;
+        }
+    }
+
+    m_eitStream = packetize(EIT_PID, sections, starts);
+}
+
+void TestPSIPAssembly::crc_test(void)
+{
+    for (uint length = 12; length <= 600; length++)
+    {
+        QByteArray sect = make_section(1, 0, length);
+        const PSIPTable psip = PSIPTable::ViewData(
+            reinterpret_cast<const unsigned char*>(sect.constData()));
+
+        QCOMPARE(psip.CalcCRC(), psip.CRC());
+        QVERIFY(psip.IsGood());
+    }
+
+    QByteArray sect = make_section(1, 0, 4096);
+    const PSIPTable psip = PSIPTable::ViewData(
+        reinterpret_cast<const unsigned char*>(sect.constData()));
+    QCOMPARE(psip.CalcCRC(), psip.CRC());
+
+    sect[2000] = char(sect.at(2000) ^ 0x10);
+    const PSIPTable broken = PSIPTable::ViewData(
+        reinterpret_cast<const unsigned char*>(sect.constData()));
+    QVERIFY(broken.CalcCRC() != broken.CRC());
+    QVERIFY(!broken.IsGood());
+}
+
+void TestPSIPAssembly::pes_alloc_test(void)
+{
+    static const uint sizes[] =
+        { 0, 1, 188, 189, 1024, 3840, 4096, 4097, 8192, 8193, 65536 };
+
+    for (uint i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        unsigned char *buf = pes_alloc(sizes[i]);
+        QVERIFY(buf != NULL);
+        QCOMPARE((quintptr)buf & 0xf, (quintptr)0);
+        memset(buf, 0xa5, sizes[i]);
+        pes_free(buf);
+    }
+
+    // freed blocks are handed out again
+    unsigned char *first = pes_alloc(188);
+    pes_free(first);
+    unsigned char *second = pes_alloc(188);
+    QCOMPARE(second, first);
+    pes_free(second);
+
+    pes_free(NULL);
+}
+
+void TestPSIPAssembly::assembly_test(void)
+{
+    SectionCounter sd;
+    sd.AddListeningPID(EIT_PID);
+
+    QCOMPARE(sd.ProcessData(
+                 reinterpret_cast<const unsigned char*>(m_eitStream.constData()),
+                 m_eitStream.size()), 0);
+    QCOMPARE(sd.m_sections, m_eitSections);
+    QCOMPARE(sd.m_badSections, 0U);
+
+    // and once more a packet at a time, with every packet repeated
+    SectionCounter sd2;
+    sd2.AddListeningPID(EIT_PID);
+    for (int pos = 0; pos < m_eitStream.size(); pos += 188)
+    {
+        const unsigned char *pkt =
+            reinterpret_cast<const unsigned char*>(m_eitStream.constData()) + pos;
+        sd2.ProcessData(pkt, 188);
+        sd2.ProcessData(pkt, 188);
+    }
+    QCOMPARE(sd2.m_badSections, 0U);
+    QVERIFY(sd2.m_sections >= m_eitSections);
+}
+
+void TestPSIPAssembly::eit_benchmark(void)
+{
+    QByteArray stream = m_eitStream;
+
+    QString capture = qgetenv("MYTHTV_EIT_CAPTURE");
+    if (!capture.isEmpty())
+    {
+        QFile file(capture);
+        QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable(capture));
+        stream = file.readAll();
+    }
+
+    const unsigned char *data =
+        reinterpret_cast<const unsigned char*>(stream.constData());
+
+    SectionCounter sd;
+    sd.AddListeningPID(EIT_PID);
+
+    QBENCHMARK
+    {
+        sd.m_sections = 0;
+        sd.ProcessData(data, stream.size());
+    }
+
+    QCOMPARE(sd.m_badSections, 0U);
+    if (capture.isEmpty())
+        QCOMPARE(sd.m_sections, m_eitSections);
+}
+
+QTEST_APPLESS_MAIN(TestPSIPAssembly)
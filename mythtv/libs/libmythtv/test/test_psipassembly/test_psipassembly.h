@@ -0,0 +1,66 @@
+/*
+ *  Class TestPSIPAssembly
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+#include <QByteArray>
+
+#include "mpegstreamdata.h"
+#include "mpegtables.h"
+
+/// Counts the sections handed out by MPEGStreamData, copying each
+/// one like the EIT helper does.
+class SectionCounter : public MPEGStreamData
+{
+  public:
+    SectionCounter() :
+        MPEGStreamData(-1, -1, false),
+        m_sections(0), m_badSections(0), m_bytes(0) {}
+
+    virtual bool IsRedundant(uint, const PSIPTable&) const { return false; }
+    virtual bool HandleTables(uint pid, const PSIPTable &psip);
+
+    uint    m_sections;
+    uint    m_badSections;
+    quint64 m_bytes;
+};
+
+class TestPSIPAssembly: public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase(void);
+
+    /** compares the table driven CRC with a bit at a time one */
+    void crc_test(void);
+
+    /** checks the size classes and the buffer headers of pes_alloc() */
+    void pes_alloc_test(void);
+
+    /** feeds sections spanning several TS packets, and several sections
+     *  sharing TS packets, through MPEGStreamData */
+    void assembly_test(void);
+
+    /** replays an EIT heavy stream, set MYTHTV_EIT_CAPTURE to the
+     *  path of a TS capture to replay that instead */
+    void eit_benchmark(void);
+
+  private:
+    QByteArray m_eitStream;
+    uint       m_eitSections;
+};
@@ -44,6 +44,7 @@ HEADERS += mythuianimation.h mythuiscrollbar.h
 HEADERS += mythnotificationcenter.h mythnotificationcenter_private.h
 HEADERS += mythuicomposite.h mythnotification.h mythuidefines.h
 HEADERS += mythuimultifilebrowser.h
+HEADERS += mythglyphcache.h
 
 SOURCES  = mythmainwindow.cpp mythpainter.cpp mythimage.cpp mythrect.cpp
 SOURCES += myththemebase.cpp  mythpainter_qimage.cpp mythpainter_yuva.cpp
@@ -66,6 +67,7 @@ SOURCES += mythuianimation.cpp mythuiscrollbar.cpp
 SOURCES += mythnotificationcenter.cpp mythnotification.cpp
 SOURCES += mythuicomposite.cpp mythuimultifilebrowser.cpp
 SOURCES += mythuiwebbrowser.cpp
+SOURCES += mythglyphcache.cpp
 
 inc.path = $${PREFIX}/include/mythtv/libmythui/
 
@@ -0,0 +1,269 @@
+#include <algorithm>
+
+// QT headers
+#include <QPainter>
+#include <QTextLayout>
+#include <QtCore/qmath.h>
+
+// libmythbase headers
+#include "mythlogging.h"
+
+// libmythui headers
+#include "mythimage.h"
+#include "mythpainter.h"
+
+// Own header
+#include "mythglyphcache.h"
+
+MythGlyphAtlas::MythGlyphAtlas(MythPainter *painter, const QRawFont &font,
+                               const QColor &color, bool yuv)
+  : m_painter(painter), m_font(font), m_color(color), m_yuv(yuv),
+    m_shelfX(0), m_shelfY(0), m_shelfHeight(0)
+{
+}
+
+MythGlyphAtlas::~MythGlyphAtlas()
+{
+    QVector<MythImage*>::iterator it = m_pages.begin();
+    for (; it != m_pages.end(); ++it)
+        (*it)->DecrRef();
+    m_pages.clear();
+}
+
+/** \fn MythGlyphAtlas::GetGlyph(quint32)
+ *  \brief Returns the glyph, rendering it into the atlas the first time.
+ *  \return NULL if the glyph does not fit on a page. The pointer is only
+ *          valid until the next call.
+ */
+const MythGlyphAtlas::Glyph *MythGlyphAtlas::GetGlyph(quint32 index)
+{
+    QHash<quint32, Glyph>::const_iterator it = m_glyphs.find(index);
+    if (it != m_glyphs.end())
+        return &(*it);
+
+    Glyph glyph;
+    if (!AddGlyph(index, glyph))
+        return NULL;
+
+    return &(*m_glyphs.insert(index, glyph));
+}
+
+bool MythGlyphAtlas::AddGlyph(quint32 index, Glyph &glyph)
+{
+    QRectF bounds = m_font.boundingRect(index);
+    if (bounds.isEmpty())
+        return true; // Whitespace, nothing to draw.
+
+    // One pixel of padding for the antialiasing
+    QRect box = bounds.toAlignedRect().adjusted(-1, -1, 1, 1);
+    if (box.width() > kPageSize || box.height() > kPageSize)
+        return false;
+
+    if (m_pages.empty() || m_shelfX + box.width() > kPageSize)
+    {
+        m_shelfX = 0;
+        m_shelfY += m_shelfHeight;
+        m_shelfHeight = 0;
+    }
+
+    if (m_pages.empty() || m_shelfY + box.height() > kPageSize)
+    {
+        QImage blank(kPageSize, kPageSize, QImage::Format_ARGB32);
+        blank.fill(0);
+
+        MythImage *page = m_painter->GetFormatImage();
+        page->SetFileName(QString("MythGlyphAtlas: %1 %2px")
+                          .arg(m_font.familyName()).arg(m_font.pixelSize()));
+        page->Assign(blank);
+        // The colour was converted before we were created.
+        if (m_yuv)
+            page->SetToYUV();
+        m_pages.push_back(page);
+
+        m_shelfX = 0;
+        m_shelfY = 0;
+        m_shelfHeight = 0;
+    }
+
+    MythImage *page = m_pages.back();
+
+    QGlyphRun run;
+    run.setRawFont(m_font);
+    run.setGlyphIndexes(QVector<quint32>() << index);
+    run.setPositions(QVector<QPointF>()
+                     << QPointF(m_shelfX - box.x(), m_shelfY - box.y()));
+
+    QPainter painter(page);
+    painter.setPen(m_color);
+    painter.drawGlyphRun(QPointF(0, 0), run);
+    painter.end();
+    page->SetChanged();
+
+    glyph.m_page   = page;
+    glyph.m_src    = QRect(m_shelfX, m_shelfY, box.width(), box.height());
+    glyph.m_offset = box.topLeft();
+
+    m_shelfX += box.width();
+    m_shelfHeight = std::max(m_shelfHeight, box.height());
+
+    return true;
+}
+
+/** \class MythGlyphCache
+ *
+ *   Drawing text by rasterizing every distinct string into its own image
+ *   means a scrolling list or the program guide creates, and with OpenGL
+ *   uploads, a new image for nearly every string it shows. Instead the
+ *   glyphs of each font face, size and colour are rendered once into a
+ *   MythGlyphAtlas, and strings are drawn as a run of glyphs blitted from
+ *   the atlas pages. The result of shaping a string, which is the costly
+ *   part of laying it out, is kept as well.
+ */
+
+MythGlyphCache::MythGlyphCache(MythPainter *painter)
+  : m_painter(painter), m_yuv(false), m_shapedText(kMaxShapedText)
+{
+}
+
+MythGlyphCache::~MythGlyphCache()
+{
+    QHash<QString, MythGlyphAtlas*>::iterator it = m_atlases.begin();
+    for (; it != m_atlases.end(); ++it)
+        delete *it;
+    m_atlases.clear();
+    m_atlasExpireList.clear();
+}
+
+QString MythGlyphCache::FontKey(const QRawFont &font)
+{
+    return QString("%1/%2/%3/%4").arg(font.familyName())
+        .arg(font.styleName()).arg(font.weight()).arg(font.pixelSize());
+}
+
+MythGlyphAtlas *MythGlyphCache::GetAtlas(const QRawFont &font,
+                                         const QColor &color)
+{
+    QString key = FontKey(font) + QString("/%1").arg(color.rgba(), 0, 16);
+
+    QHash<QString, MythGlyphAtlas*>::iterator it = m_atlases.find(key);
+    if (it != m_atlases.end())
+    {
+        if (m_atlasExpireList.back() != key)
+        {
+            m_atlasExpireList.remove(key);
+            m_atlasExpireList.push_back(key);
+        }
+        return *it;
+    }
+
+    LOG(VB_GUI, LOG_DEBUG, QString("MythGlyphCache: New atlas %1").arg(key));
+
+    MythGlyphAtlas *atlas = new MythGlyphAtlas(m_painter, font, color, m_yuv);
+    m_atlases.insert(key, atlas);
+    m_atlasExpireList.push_back(key);
+    return atlas;
+}
+
+/** \fn MythGlyphCache::GetShapedText(const QFont&,const QString&,int&)
+ *  \brief Returns the glyph runs of a single line of text, positioned
+ *         relative to the top left of the line.
+ *
+ *   The result is only valid until the next call.
+ */
+const QList<QGlyphRun> *MythGlyphCache::GetShapedText(const QFont &font,
+                                                      const QString &msg,
+                                                      int &width)
+{
+    QString key = font.key() + QChar('/') + msg;
+
+    ShapedText *shaped = m_shapedText.object(key);
+    if (!shaped)
+    {
+        QFont tmpfont = font;
+        tmpfont.setStyleStrategy(QFont::OpenGLCompatible);
+
+        QTextLayout layout(msg, tmpfont);
+        layout.beginLayout();
+        QTextLine line = layout.createLine();
+        if (line.isValid())
+            line.setNumColumns(msg.length());
+        layout.endLayout();
+
+        shaped = new ShapedText();
+        shaped->m_runs  = layout.glyphRuns();
+        shaped->m_width =
+            line.isValid() ? qCeil(line.naturalTextWidth()) : 0;
+        m_shapedText.insert(key, shaped);
+    }
+
+    width = shaped->m_width;
+    return &shaped->m_runs;
+}
+
+/** \fn MythGlyphCache::PlaceGlyphs(const QList<QGlyphRun>&,const QColor&,const QPoint&,const QRect&,MythGlyphPlacements&)
+ *  \brief Adds where to draw each glyph of the runs, drawn at origin and
+ *         clipped to clip, to placements.
+ *
+ *   Glyphs missing from the atlases are rendered into them first, so all
+ *   the text of a draw should be placed before any of it is drawn.
+ *
+ *  \return false if a glyph is too large for the atlas.
+ */
+bool MythGlyphCache::PlaceGlyphs(const QList<QGlyphRun> &runs,
+                                 const QColor &color, const QPoint &origin,
+                                 const QRect &clip,
+                                 MythGlyphPlacements &placements)
+{
+    QList<QGlyphRun>::const_iterator run = runs.begin();
+    for (; run != runs.end(); ++run)
+    {
+        MythGlyphAtlas *atlas = GetAtlas(run->rawFont(), color);
+
+        QVector<quint32> indexes   = run->glyphIndexes();
+        QVector<QPointF> positions = run->positions();
+        for (int i = 0; i < indexes.size() && i < positions.size(); ++i)
+        {
+            const MythGlyphAtlas::Glyph *glyph = atlas->GetGlyph(indexes[i]);
+            if (!glyph)
+                return false;
+            if (!glyph->m_page)
+                continue;
+
+            QPoint pos = origin + glyph->m_offset +
+                QPoint(qRound(positions[i].x()), qRound(positions[i].y()));
+            QRect dest(pos, glyph->m_src.size());
+            QRect clipped = dest.intersected(clip);
+            if (clipped.isEmpty())
+                continue;
+
+            QRect src(glyph->m_src.topLeft() +
+                      (clipped.topLeft() - dest.topLeft()), clipped.size());
+            placements.push_back(
+                MythGlyphPlacement(glyph->m_page, src, clipped));
+        }
+    }
+
+    return true;
+}
+
+/// Drops the least recently used atlases once there are too many pages
+void MythGlyphCache::Expire(void)
+{
+    int pages = 0;
+    QHash<QString, MythGlyphAtlas*>::const_iterator it = m_atlases.begin();
+    for (; it != m_atlases.end(); ++it)
+        pages += (*it)->PageCount();
+
+    while (pages > kMaxPages && !m_atlasExpireList.empty())
+    {
+        QString key = m_atlasExpireList.front();
+        m_atlasExpireList.pop_front();
+
+        MythGlyphAtlas *atlas = m_atlases.take(key);
+        if (atlas)
+        {
+            pages -= atlas->PageCount();
+            delete atlas;
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef MYTHGLYPHCACHE_H_
+#define MYTHGLYPHCACHE_H_
+
+#include <list>
+
+#include <QCache>
+#include <QColor>
+#include <QFont>
+#include <QGlyphRun>
+#include <QHash>
+#include <QList>
+#include <QRawFont>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+class MythImage;
+class MythPainter;
+
+/// Where to draw one glyph from a glyph atlas page
+class MythGlyphPlacement
+{
+  public:
+    MythGlyphPlacement() : m_page(NULL) {}
+    MythGlyphPlacement(MythImage *page, const QRect &src, const QRect &dest) :
+        m_page(page), m_src(src), m_dest(dest) {}
+
+    MythImage *m_page;
+    QRect      m_src;
+    QRect      m_dest;
+};
+typedef QVector<MythGlyphPlacement> MythGlyphPlacements;
+
+/** \class MythGlyphAtlas
+ *  \brief The glyphs of one font face, size and colour, rendered once and
+ *         packed into MythImage pages.
+ */
+class MythGlyphAtlas
+{
+  public:
+    MythGlyphAtlas(MythPainter *painter, const QRawFont &font,
+                   const QColor &color, bool yuv);
+   ~MythGlyphAtlas();
+
+    class Glyph
+    {
+      public:
+        Glyph() : m_page(NULL) {}
+        MythImage *m_page;   ///< NULL for glyphs with nothing to draw
+        QRect      m_src;    ///< Area of the page holding the glyph
+        QPoint     m_offset; ///< Top left of m_src relative to the pen
+    };
+
+    const Glyph *GetGlyph(quint32 index);
+    int PageCount(void) const { return m_pages.size(); }
+
+    static const int kPageSize = 512;
+
+  private:
+    bool AddGlyph(quint32 index, Glyph &glyph);
+
+    MythPainter          *m_painter;
+    QRawFont              m_font;
+    QColor                m_color;
+    bool                  m_yuv;
+    QVector<MythImage*>   m_pages;
+    QHash<quint32, Glyph> m_glyphs;
+
+    // Shelf packing of the last page
+    int                   m_shelfX;
+    int                   m_shelfY;
+    int                   m_shelfHeight;
+};
+
+/** \class MythGlyphCache
+ *  \brief Shaped text and glyph atlases shared by all the text a
+ *         MythPainter draws.
+ */
+class MythGlyphCache
+{
+  public:
+    MythGlyphCache(MythPainter *painter);
+   ~MythGlyphCache();
+
+    void SetPagesAreYUV(bool yuv) { m_yuv = yuv; }
+
+    const QList<QGlyphRun> *GetShapedText(const QFont &font,
+                                          const QString &msg, int &width);
+    bool PlaceGlyphs(const QList<QGlyphRun> &runs, const QColor &color,
+                     const QPoint &origin, const QRect &clip,
+                     MythGlyphPlacements &placements);
+    void Expire(void);
+
+    static const int kMaxPages      = 24;
+    static const int kMaxShapedText = 2048;
+
+  private:
+    class ShapedText
+    {
+      public:
+        QList<QGlyphRun> m_runs;
+        int              m_width;
+    };
+
+    MythGlyphAtlas *GetAtlas(const QRawFont &font, const QColor &color);
+    static QString FontKey(const QRawFont &font);
+
+    MythPainter                     *m_painter;
+    bool                             m_yuv;
+    QHash<QString, MythGlyphAtlas*>  m_atlases;
+    std::list<QString>               m_atlasExpireList;
+    QCache<QString, ShapedText>      m_shapedText;
+};
+
+#endif
@@ -12,6 +12,7 @@
 
 // libmythui headers
 #include "mythfontproperties.h"
+#include "mythglyphcache.h"
 #include "mythimage.h"
 #include "mythuianimation.h"	// UIEffects
 
@@ -19,14 +20,38 @@
 #include "mythpainter.h"
 
 MythPainter::MythPainter()
-  : m_Parent(0), m_HardwareCacheSize(0), m_SoftwareCacheSize(0),
+  : m_Parent(0), m_HardwareCacheSize(0), m_glyphCache(new MythGlyphCache(this)),
+    m_useGlyphAtlas(true), m_SoftwareCacheSize(0),
     m_showBorders(false), m_showNames(false)
 {
     SetMaximumCacheSizes(96, 48);
 }
 
+MythPainter::~MythPainter()
+{
+    if (!m_glyphCache)
+        return;
+
+    // The derived painter is already gone, so the atlas pages must not
+    // hand themselves back to it when they are released.
+    {
+        QMutexLocker locker(&m_allocationLock);
+        QSet<MythImage*>::iterator it = m_allocatedImages.begin();
+        for (; it != m_allocatedImages.end(); ++it)
+            (*it)->SetParent(NULL);
+        m_allocatedImages.clear();
+    }
+
+    delete m_glyphCache;
+    m_glyphCache = NULL;
+}
+
 void MythPainter::Teardown(void)
 {
+    // The atlas pages are format images, release them first.
+    delete m_glyphCache;
+    m_glyphCache = NULL;
+
     ExpireImages(0);
 
     QMutexLocker locker(&m_allocationLock);
@@ -78,6 +103,9 @@ void MythPainter::DrawText(const QRect &r, const QString &msg,
                            int flags, const MythFontProperties &font,
                            int alpha, const QRect &boundRect)
 {
+    if (DrawTextFromAtlas(r, msg, flags, font, alpha, boundRect))
+        return;
+
     MythImage *im = GetImageFromString(msg, flags, r, font);
     if (!im)
         return;
@@ -130,6 +158,10 @@ void MythPainter::DrawTextLayout(const QRect & canvasRect,
     if (canvasRect.isNull())
         return;
 
+    if (DrawTextLayoutFromAtlas(canvasRect, layouts, formats, font, alpha,
+                                destRect))
+        return;
+
     QRect      canvas(canvasRect);
     QRect      dest(destRect);
 
@@ -195,6 +227,167 @@ void MythPainter::PushTransformation(const UIEffects &zoom, QPointF center)
     (void)center;
 }
 
+/** \fn MythPainter::CanUseGlyphAtlas(int,const QString&,const MythFontProperties&) const
+ *  \brief Returns true if the text can be drawn from the glyph atlases.
+ *
+ *   Outlines, gradient fills and wrapped text are still drawn into an
+ *   image of the whole string.
+ */
+bool MythPainter::CanUseGlyphAtlas(int flags, const QString &msg,
+                                   const MythFontProperties &font) const
+{
+    return m_glyphCache && m_useGlyphAtlas && !font.hasOutline() &&
+        font.GetBrush().style() == Qt::SolidPattern &&
+        !(flags & Qt::TextWordWrap) && !msg.contains(QChar('\n'));
+}
+
+bool MythPainter::DrawTextFromAtlas(const QRect &r, const QString &msg,
+                                    int flags, const MythFontProperties &font,
+                                    int alpha, const QRect &boundRect)
+{
+    if (!CanUseGlyphAtlas(flags, msg, font))
+        return false;
+
+    if (msg.isEmpty())
+        return true;
+
+    m_glyphCache->Expire();
+
+    int width = 0;
+    const QList<QGlyphRun> *runs =
+        m_glyphCache->GetShapedText(font.face(), msg, width);
+
+    QPoint shadowOffset(0, 0);
+    QColor shadowColor;
+    int shadowAlpha = 255;
+    if (font.hasShadow())
+        font.GetShadow(shadowOffset, shadowColor, shadowAlpha);
+
+    // Place the text where DrawTextPriv() would have drawn it in the image
+    QFontMetrics fm(font.face());
+    int totalHeight = fm.height() + std::abs(shadowOffset.y());
+    int paddingY = (r.height() - totalHeight) / 2;
+    QRect textRect(r.x() + std::max(0, -shadowOffset.x()),
+                   r.y() + paddingY + std::max(0, -shadowOffset.y()),
+                   r.width(), r.height());
+
+    QPoint origin(textRect.topLeft());
+    if (flags & Qt::AlignRight)
+        origin.setX(textRect.x() + textRect.width() - width);
+    else if (flags & Qt::AlignHCenter)
+        origin.setX(textRect.x() + (textRect.width() - width) / 2);
+    if (flags & Qt::AlignBottom)
+        origin.setY(textRect.y() + textRect.height() - fm.height());
+    else if (flags & Qt::AlignVCenter)
+        origin.setY(textRect.y() + (textRect.height() - fm.height()) / 2);
+
+    QRect clip(r);
+    if (!boundRect.isEmpty())
+        clip = clip.intersected(boundRect);
+
+    MythGlyphPlacements glyphs;
+    if (font.hasShadow())
+    {
+        shadowColor.setAlpha(shadowAlpha);
+        if (!m_glyphCache->PlaceGlyphs(*runs, shadowColor,
+                                       origin + shadowOffset, clip, glyphs))
+            return false;
+    }
+
+    if (!m_glyphCache->PlaceGlyphs(*runs, font.GetBrush().color(),
+                                   origin, clip, glyphs))
+        return false;
+
+    DrawGlyphPlacements(glyphs, alpha);
+    return true;
+}
+
+bool MythPainter::DrawTextLayoutFromAtlas(const QRect &canvasRect,
+                                          const LayoutVector &layouts,
+                                          const FormatVector &formats,
+                                          const MythFontProperties &font,
+                                          int alpha, const QRect &destRect)
+{
+    // Formats are used for outlines and per range colours.
+    if (!formats.isEmpty() || !CanUseGlyphAtlas(0, QString(), font))
+        return false;
+
+    m_glyphCache->Expire();
+
+    // The layouts are drawn at the canvas position of an image the size
+    // of the canvas, of which the dest size is shown at dest.
+    QRect clip(destRect.topLeft(),
+               QSize(std::min(destRect.width(), canvasRect.width()),
+                     std::min(destRect.height(), canvasRect.height())));
+    QPoint origin = destRect.topLeft() + canvasRect.topLeft();
+
+    QPoint shadowOffset;
+    QColor shadowColor;
+    int shadowAlpha = 255;
+    if (font.hasShadow())
+    {
+        font.GetShadow(shadowOffset, shadowColor, shadowAlpha);
+        shadowColor.setAlpha(shadowAlpha);
+
+        MythPoint shadow(shadowOffset);
+        shadow.NormPoint(); // scale it to screen resolution
+        shadowOffset = shadow.toQPoint();
+    }
+
+    MythGlyphPlacements glyphs;
+    for (int pass = font.hasShadow() ? 0 : 1; pass < 2; ++pass)
+    {
+        QColor color = pass ? font.GetBrush().color() : shadowColor;
+        QPoint offset = pass ? QPoint(0, 0) : shadowOffset;
+
+        LayoutVector::const_iterator Ipara = layouts.begin();
+        for (; Ipara != layouts.end(); ++Ipara)
+        {
+            QPoint pos = origin + offset + (*Ipara)->position().toPoint();
+            if (!m_glyphCache->PlaceGlyphs((*Ipara)->glyphRuns(), color,
+                                           pos, clip, glyphs))
+                return false;
+        }
+    }
+
+    DrawGlyphPlacements(glyphs, alpha);
+    return true;
+}
+
+/// Draws the glyphs in order, batched by atlas page
+void MythPainter::DrawGlyphPlacements(const MythGlyphPlacements &glyphs,
+                                      int alpha)
+{
+    QVector<QRect> dest;
+    QVector<QRect> src;
+    MythImage *page = NULL;
+
+    MythGlyphPlacements::const_iterator it = glyphs.begin();
+    for (; it != glyphs.end(); ++it)
+    {
+        if (it->m_page != page)
+        {
+            if (page)
+                DrawGlyphs(page, dest, src, alpha);
+            page = it->m_page;
+            dest.clear();
+            src.clear();
+        }
+        dest.push_back(it->m_dest);
+        src.push_back(it->m_src);
+    }
+
+    if (page)
+        DrawGlyphs(page, dest, src, alpha);
+}
+
+void MythPainter::DrawGlyphs(MythImage *page, const QVector<QRect> &dest,
+                             const QVector<QRect> &src, int alpha)
+{
+    for (int i = 0; i < dest.size(); ++i)
+        DrawImage(dest[i], page, src[i], alpha);
+}
+
 void MythPainter::DrawTextPriv(MythImage *im, const QString &msg, int flags,
                                const QRect &r, const MythFontProperties &font)
 {
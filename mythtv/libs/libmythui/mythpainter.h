@@ -24,6 +24,8 @@ class QColor;
 
 class MythFontProperties;
 class MythImage;
+class MythGlyphCache;
+class MythGlyphPlacement;
 class UIEffects;
 
 typedef QVector<QTextLayout *>            LayoutVector;
@@ -39,8 +41,9 @@ class MUI_PUBLIC MythPainter
      *  to do cleanup in the MythPainter destructor because
      *  DeleteImagePriv() is a pure virtual in this class. Instead
      *  children should call MythPainter::Teardown() for cleanup.
+     *  Only the glyph cache is deleted here if Teardown() didn't run.
      */
-    virtual ~MythPainter() {}
+    virtual ~MythPainter();
 
     virtual QString GetName(void) = 0;
     virtual bool SupportsAnimation(void) = 0;
@@ -98,6 +101,9 @@ class MUI_PUBLIC MythPainter
 
     void SetMaximumCacheSizes(int hardware, int software);
 
+    /// Draw plain text from glyph atlases rather than an image per string
+    void SetUseGlyphAtlas(bool use) { m_useGlyphAtlas = use; }
+
   protected:
     void DrawTextPriv(MythImage *im, const QString &msg, int flags,
                       const QRect &r, const MythFontProperties &font);
@@ -114,6 +120,23 @@ class MUI_PUBLIC MythPainter
                                 const QBrush &fillBrush,
                                 const QPen &linePen);
 
+    bool CanUseGlyphAtlas(int flags, const QString &msg,
+                          const MythFontProperties &font) const;
+    bool DrawTextFromAtlas(const QRect &r, const QString &msg, int flags,
+                           const MythFontProperties &font, int alpha,
+                           const QRect &boundRect);
+    bool DrawTextLayoutFromAtlas(const QRect &canvasRect,
+                                 const LayoutVector &layouts,
+                                 const FormatVector &formats,
+                                 const MythFontProperties &font, int alpha,
+                                 const QRect &destRect);
+    void DrawGlyphPlacements(const QVector<MythGlyphPlacement> &glyphs,
+                             int alpha);
+    /// Draws areas of one glyph atlas page, the default draws each one
+    /// with DrawImage().
+    virtual void DrawGlyphs(MythImage *page, const QVector<QRect> &dest,
+                            const QVector<QRect> &src, int alpha);
+
     /// Creates a reference counted image, call DecrRef() to delete.
     virtual MythImage* GetFormatImagePriv(void) = 0;
     virtual void DeleteFormatImagePriv(MythImage *im) = 0;
@@ -129,6 +152,9 @@ class MUI_PUBLIC MythPainter
     int m_HardwareCacheSize;
     int m_MaxHardwareCacheSize;
 
+    MythGlyphCache *m_glyphCache;
+    bool            m_useGlyphAtlas;
+
   private:
     int64_t m_SoftwareCacheSize;
     int64_t m_MaxSoftwareCacheSize;
@@ -188,6 +188,18 @@ void MythOpenGLPainter::DrawImage(const QRect &r, MythImage *im,
                                &src, &r, 0, alpha);
 }
 
+// All the glyphs share the texture of the atlas page.
+void MythOpenGLPainter::DrawGlyphs(MythImage *page, const QVector<QRect> &dest,
+                                   const QVector<QRect> &src, int alpha)
+{
+    if (!realRender)
+        return;
+
+    int tex = GetTextureFromCache(page);
+    for (int i = 0; i < dest.size(); ++i)
+        realRender->DrawBitmap(tex, target, &src[i], &dest[i], 0, alpha);
+}
+
 void MythOpenGLPainter::DrawRect(const QRect &area, const QBrush &fillBrush,
                                  const QPen &linePen, int alpha)
 {
@@ -40,6 +40,8 @@ class MUI_PUBLIC MythOpenGLPainter : public MythPainter
   protected:
     virtual MythImage* GetFormatImagePriv(void) { return new MythImage(this); }
     virtual void DeleteFormatImagePriv(MythImage *im);
+    virtual void DrawGlyphs(MythImage *page, const QVector<QRect> &dest,
+                            const QVector<QRect> &src, int alpha);
 
     void       ClearCache(void);
     void       DeleteTextures(void);
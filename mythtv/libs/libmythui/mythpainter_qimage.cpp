@@ -157,6 +157,31 @@ void MythQImagePainter::DrawImage(const QRect &r, MythImage *im,
     painter->setOpacity(1.0);
 }
 
+void MythQImagePainter::DrawGlyphs(MythImage *page, const QVector<QRect> &dest,
+                                   const QVector<QRect> &src, int alpha)
+{
+    if (!painter || dest.isEmpty())
+        return;
+
+    QRect bounds;
+    for (int i = 0; i < dest.size(); ++i)
+        bounds |= dest[i];
+    CheckPaintMode(bounds);
+
+    // Neighbouring glyph areas overlap, so they must always be blended.
+    if (copy)
+    {
+        copy = false;
+        painter->setCompositionMode(QPainter::CompositionMode_SourceOver);
+    }
+
+    QImage image = *page;
+    painter->setOpacity(static_cast<float>(alpha) / 255.0);
+    for (int i = 0; i < dest.size(); ++i)
+        painter->drawImage(dest[i].topLeft(), image, src[i]);
+    painter->setOpacity(1.0);
+}
+
 void MythQImagePainter::DrawText(const QRect &r, const QString &msg,
                                  int flags, const MythFontProperties &font,
                                  int alpha, const QRect &boundRect)
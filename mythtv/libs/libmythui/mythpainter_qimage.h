@@ -49,6 +49,9 @@ class MUI_PUBLIC MythQImagePainter : public MythPainter
     virtual MythImage* GetFormatImagePriv(void) { return new MythImage(this); }
     virtual void DeleteFormatImagePriv(MythImage *im) { }
 
+    virtual void DrawGlyphs(MythImage *page, const QVector<QRect> &dest,
+                            const QVector<QRect> &src, int alpha);
+
     void CheckPaintMode(const QRect &area);
 
     QPainter *painter;
@@ -3,12 +3,19 @@
 
 #include "mythpainter_yuva.h"
 #include "mythfontproperties.h"
+#include "mythglyphcache.h"
 #include "mythlogging.h"
 
 #define MAX_FONT_CACHE 32
 
 QColor inline rgb_to_yuv(const QColor &original);
 
+MythYUVAPainter::MythYUVAPainter() : MythQImagePainter()
+{
+    // Text is drawn with converted fonts, so the glyphs are already YUV.
+    m_glyphCache->SetPagesAreYUV(true);
+}
+
 MythYUVAPainter::~MythYUVAPainter()
 {
     Teardown();
@@ -38,13 +45,17 @@ void MythYUVAPainter::DrawText(const QRect &dest, const QString &msg, int flags,
     {
         // We pull an image here, in the hopes that when DrawText
         // pulls an image this will still be in the cache and have
-        // the right properties.
-        MythImage *im = GetImageFromString(msg, flags, dest, *converted);
-        if (im)
+        // the right properties. Text drawn from the glyph atlas
+        // doesn't use one.
+        if (!CanUseGlyphAtlas(flags, msg, *converted))
         {
-            im->SetToYUV();
-            im->DecrRef();
-            im = NULL;
+            MythImage *im = GetImageFromString(msg, flags, dest, *converted);
+            if (im)
+            {
+                im->SetToYUV();
+                im->DecrRef();
+                im = NULL;
+            }
         }
 
         MythQImagePainter::DrawText(dest, msg, flags, *converted,
@@ -52,6 +63,27 @@ void MythYUVAPainter::DrawText(const QRect &dest, const QString &msg, int flags,
     }
 }
 
+void MythYUVAPainter::DrawTextLayout(const QRect &canvasRect,
+                                     const LayoutVector &layouts,
+                                     const FormatVector &formats,
+                                     const MythFontProperties &font, int alpha,
+                                     const QRect &destRect)
+{
+    // Glyphs are drawn as they are, so they need the converted colours.
+    // A rendered image is converted by DrawImage().
+    MythFontProperties *converted = GetConvertedFont(font);
+    if (converted && formats.isEmpty() &&
+        CanUseGlyphAtlas(0, QString(), *converted))
+    {
+        MythQImagePainter::DrawTextLayout(canvasRect, layouts, formats,
+                                          *converted, alpha, destRect);
+        return;
+    }
+
+    MythQImagePainter::DrawTextLayout(canvasRect, layouts, formats,
+                                      font, alpha, destRect);
+}
+
 void MythYUVAPainter::DrawRect(const QRect &area, const QBrush &fillBrush,
                                const QPen &linePen, int alpha)
 {
@@ -10,7 +10,7 @@ class MythFontProperties;
 class MUI_PUBLIC MythYUVAPainter : public MythQImagePainter
 {
   public:
-    MythYUVAPainter() : MythQImagePainter() { }
+    MythYUVAPainter();
    ~MythYUVAPainter();
 
     QString GetName(void) { return QString("YUVA"); }
@@ -20,6 +20,11 @@ class MUI_PUBLIC MythYUVAPainter : public MythQImagePainter
     virtual void DrawText(const QRect &dest, const QString &msg, int flags,
                           const MythFontProperties &font, int alpha,
                           const QRect &boundRect);
+    virtual void DrawTextLayout(const QRect &canvasRect,
+                                const LayoutVector &layouts,
+                                const FormatVector &formats,
+                                const MythFontProperties &font, int alpha,
+                                const QRect &destRect);
     virtual void DrawRect(const QRect &area, const QBrush &fillBrush,
                           const QPen &linePen, int alpha);
     virtual void DrawRoundRect(const QRect &area, int cornerRadius,
@@ -167,7 +167,7 @@ MythUIHelperPrivate::MythUIHelperPrivate(MythUIHelper *p)
       m_cacheSize(0), m_maxCacheSize(30 * 1024 * 1024),
       m_screenxbase(0), m_screenybase(0), m_screenwidth(0), m_screenheight(0),
       screensaver(NULL), screensaverEnabled(false), display_res(NULL),
-      screenSetup(false), m_imageThreadPool(new MThreadPool("MythUIHelper")),
+      screenSetup(false), m_imageThreadPool(new MThreadPool("MythUIHelper", true)),
       parent(p), m_fontStretch(100)
 {
     callbacks.exec_program = NULL;
@@ -0,0 +1,196 @@
+/*
+ *  Class TestGlyphAtlas
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include "mythpainter_qimage.h"
+
+#include "test_glyphatlas.h"
+
+static const int kRows      = 14;
+static const int kRowHeight = 34;
+static const int kRowWidth  = 1200;
+
+void TestGlyphAtlas::initTestCase(void)
+{
+    QFont face("Liberation Sans");
+    face.setPixelSize(22);
+    m_font.SetFace(face);
+    m_font.SetColor(QColor(Qt::white));
+
+    // Recording list style titles, every row a different string
+    for (int i = 0; i < 500; ++i)
+    {
+        m_items << QString("%1 - Episode %2: The title of a recorded "
+                           "program, %3 min")
+                   .arg(QChar('A' + i % 26)).arg(i).arg(30 + i % 90);
+    }
+}
+
+QRect TestGlyphAtlas::InkBounds(const QImage &image) const
+{
+    QRect bounds;
+    for (int y = 0; y < image.height(); ++y)
+    {
+        const QRgb *line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+        for (int x = 0; x < image.width(); ++x)
+        {
+            if (qAlpha(line[x]))
+                bounds |= QRect(x, y, 1, 1);
+        }
+    }
+    return bounds;
+}
+
+void TestGlyphAtlas::DrawRows(MythQImagePainter &painter, QImage &canvas,
+                              int first)
+{
+    canvas.fill(0);
+    painter.Begin(&canvas);
+    for (int row = 0; row < kRows; ++row)
+    {
+        const QString &msg = m_items[(first + row) % m_items.size()];
+        QRect rect(10, row * kRowHeight, kRowWidth, kRowHeight);
+        painter.DrawText(rect, msg, Qt::AlignLeft | Qt::AlignVCenter,
+                         m_font, 255, rect);
+    }
+    painter.End();
+}
+
+QRect TestGlyphAtlas::DrawInk(MythQImagePainter &painter, QImage &canvas,
+                              const QRect &rect, const QString &msg,
+                              int flags, const MythFontProperties &font)
+{
+    canvas.fill(0);
+    painter.Begin(&canvas);
+    painter.DrawText(rect, msg, flags, font, 255, rect);
+    painter.End();
+    return InkBounds(canvas);
+}
+
+void TestGlyphAtlas::placement_test_data(void)
+{
+    QTest::addColumn<int>("flags");
+    QTest::addColumn<bool>("shadow");
+
+    QTest::newRow("left top")       << int(Qt::AlignLeft | Qt::AlignTop)
+                                    << false;
+    QTest::newRow("left vcenter")   << int(Qt::AlignLeft | Qt::AlignVCenter)
+                                    << false;
+    QTest::newRow("left bottom")    << int(Qt::AlignLeft | Qt::AlignBottom)
+                                    << false;
+    QTest::newRow("hcenter top")    << int(Qt::AlignHCenter | Qt::AlignTop)
+                                    << false;
+    QTest::newRow("center")         << int(Qt::AlignCenter)
+                                    << false;
+    QTest::newRow("right bottom")   << int(Qt::AlignRight | Qt::AlignBottom)
+                                    << false;
+    QTest::newRow("shadow left top") << int(Qt::AlignLeft | Qt::AlignTop)
+                                     << true;
+    QTest::newRow("shadow center")  << int(Qt::AlignCenter)
+                                    << true;
+}
+
+void TestGlyphAtlas::placement_test(void)
+{
+    QFETCH(int, flags);
+    QFETCH(bool, shadow);
+
+    QImage canvas(400, 100, QImage::Format_ARGB32_Premultiplied);
+    QRect rect(100, 20, 200, 60);
+
+    MythFontProperties font = m_font;
+    if (shadow)
+        font.SetShadow(true, QPoint(3, 3), QColor(Qt::black), 255);
+
+    MythQImagePainter painter;
+
+    painter.SetUseGlyphAtlas(true);
+    QRect atlas = DrawInk(painter, canvas, rect, "Hello World", flags, font);
+    QVERIFY(!atlas.isEmpty());
+    QVERIFY(rect.contains(atlas));
+
+    // The same text drawn without the atlas has the same extent
+    painter.SetUseGlyphAtlas(false);
+    QRect image = DrawInk(painter, canvas, rect, "Hello World", flags, font);
+    QVERIFY(qAbs(image.left()   - atlas.left())   <= 2);
+    QVERIFY(qAbs(image.right()  - atlas.right())  <= 2);
+    QVERIFY(qAbs(image.top()    - atlas.top())    <= 2);
+    QVERIFY(qAbs(image.bottom() - atlas.bottom()) <= 2);
+}
+
+void TestGlyphAtlas::fallback_test(void)
+{
+    QImage canvas(400, 200, QImage::Format_ARGB32_Premultiplied);
+    QRect outlinedRect(0, 0, 150, 40);
+    QRect wrappedRect(200, 0, 150, 200);
+
+    MythQImagePainter painter;
+    painter.SetUseGlyphAtlas(true);
+
+    MythFontProperties outlined = m_font;
+    outlined.SetOutline(true, QColor(Qt::black), 2, 255);
+
+    canvas.fill(0);
+    painter.Begin(&canvas);
+    painter.DrawText(outlinedRect, "Outlined", Qt::AlignLeft, outlined, 255,
+                     outlinedRect);
+    painter.DrawText(wrappedRect, "Wrapped text on several lines",
+                     Qt::AlignLeft | Qt::TextWordWrap, m_font, 255,
+                     wrappedRect);
+    painter.End();
+
+    // Each text is drawn, and only inside its own rect
+    QRect all = InkBounds(canvas);
+    QRect outlinedInk = InkBounds(canvas.copy(outlinedRect));
+    QRect wrappedInk  = InkBounds(canvas.copy(wrappedRect));
+    QVERIFY(!outlinedInk.isEmpty());
+    QVERIFY(!wrappedInk.isEmpty());
+    QCOMPARE(outlinedInk.translated(outlinedRect.topLeft()) |
+             wrappedInk.translated(wrappedRect.topLeft()), all);
+
+    // and the wrapped text does wrap
+    QFontMetrics metrics(*m_font.GetFace());
+    QVERIFY(wrappedInk.height() > metrics.height());
+}
+
+void TestGlyphAtlas::scroll_benchmark_data(void)
+{
+    QTest::addColumn<bool>("atlas");
+
+    QTest::newRow("string images") << false;
+    QTest::newRow("glyph atlas")   << true;
+}
+
+void TestGlyphAtlas::scroll_benchmark(void)
+{
+    QFETCH(bool, atlas);
+
+    QImage canvas(kRowWidth + 20, kRows * kRowHeight,
+                  QImage::Format_ARGB32_Premultiplied);
+
+    MythQImagePainter painter;
+    painter.SetUseGlyphAtlas(atlas);
+
+    int first = 0;
+    QBENCHMARK
+    {
+        DrawRows(painter, canvas, first);
+        first = (first + 1) % m_items.size();
+    }
+}
+
+QTEST_MAIN(TestGlyphAtlas)
@@ -0,0 +1,57 @@
+/*
+ *  Class TestGlyphAtlas
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+#include <QStringList>
+#include <QImage>
+
+#include "mythfontproperties.h"
+
+class MythQImagePainter;
+
+class TestGlyphAtlas: public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase(void);
+
+    /** checks that atlas text lands inside its rect, where text
+     *  drawn without the atlas lands, for each alignment */
+    void placement_test_data(void);
+    void placement_test(void);
+
+    /** text the atlas can not draw must still be drawn, each in
+     *  its own rect */
+    void fallback_test(void);
+
+    /** scrolls a text heavy button list one row per frame, the way
+     *  MythUIButtonList draws its visible items */
+    void scroll_benchmark_data(void);
+    void scroll_benchmark(void);
+
+  private:
+    QRect InkBounds(const QImage &image) const;
+    QRect DrawInk(MythQImagePainter &painter, QImage &canvas,
+                  const QRect &rect, const QString &msg, int flags,
+                  const MythFontProperties &font);
+    void DrawRows(MythQImagePainter &painter, QImage &canvas, int first);
+
+    MythFontProperties m_font;
+    QStringList        m_items;
+};
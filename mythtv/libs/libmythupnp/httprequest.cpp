@@ -51,6 +51,7 @@
 #include "serializers/soapSerializer.h"
 #include "serializers/jsonSerializer.h"
 #include "serializers/xmlplistSerializer.h"
+#include "httpresponsestream.h"
 
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
@@ -167,6 +168,7 @@ HTTPRequest::HTTPRequest() : m_procReqLineExp ( "[ \r\n][ \r\n]*"  ),
                              m_bSOAPRequest   ( false ),
                              m_eResponseType  ( ResponseTypeUnknown),
                              m_nResponseStatus( 200 ),
+                             m_pResponseStream( NULL ),
                              m_pPostProcess   ( NULL ),
                              m_bKeepAlive     ( true ),
                              m_nKeepAliveTimeout ( 0 )
@@ -178,6 +180,15 @@ HTTPRequest::HTTPRequest() : m_procReqLineExp ( "[ \r\n][ \r\n]*"  ),
 //
 /////////////////////////////////////////////////////////////////////////////
 
+HTTPRequest::~HTTPRequest()
+{
+    delete m_pResponseStream;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
 RequestType HTTPRequest::SetRequestType( const QString &sType )
 {
     // HTTP
@@ -248,7 +259,11 @@ QString HTTPRequest::BuildResponseHeader( long long nSize )
             SetResponseHeader("Content-Disposition", QString("inline; filename=\"%2\"").arg(QString(filename.toLatin1())));
         }
 
-        SetResponseHeader("Content-Length", QString::number(nSize));
+        // A negative size means the body is sent by HTTPResponseStream
+        if (nSize < 0)
+            SetResponseHeader("Transfer-Encoding", "chunked");
+        else
+            SetResponseHeader("Content-Length", QString::number(nSize));
 
         // See DLNA  7.4.1.3.11.4.3 Tolerance to unavailable contentFeatures.dlna.org header
         //
@@ -315,6 +330,11 @@ qint64 HTTPRequest::SendResponse( void )
 {
     qint64      nBytes    = 0;
 
+    // The header and most of the body have already gone out in chunks
+
+    if (m_pResponseStream != NULL && m_pResponseStream->IsStreaming())
+        return m_pResponseStream->Finish();
+
     switch( m_eResponseType )
     {
         // The following are all eligable for gzip compression
@@ -434,52 +454,7 @@ qint64 HTTPRequest::SendResponse( void )
         }
     }
 
-    // ----------------------------------------------------------------------
-    // SECURITY: Access-Control-Allow-Origin Wildcard
-    //
-    // This is a REALLY bad idea, so bad in fact that I'm including it here but
-    // commented out in the hope that anyone thinking of adding it in the future
-    // will see it and then read this comment.
-    //
-    // Browsers do not verify that the origin is on the same network. This means
-    // that a malicious script embedded or included into ANY webpage you visit
-    // could then access servers on your local network including MythTV. They
-    // can grab data, delete data including recordings and videos, schedule
-    // recordings and generally ruin your day.
-    //
-    // This might seem paranoid and a remote possibility, but then that's how
-    // a lot of exploits are born. Do NOT allow wildcards.
-    //
-    //m_mapRespHeaders[ "Access-Control-Allow-Origin" ] = "*";
-    // ----------------------------------------------------------------------
-
-    // ----------------------------------------------------------------------
-    // SECURITY: Allow the WebFrontend on the Master backend and ONLY this
-    // machine to access resources on a frontend or slave web server
-    //
-    // TODO: Add hostname:port combo as well as ip:port
-    //
-    // http://www.w3.org/TR/cors/#introduction
-    // ----------------------------------------------------------------------
-    QString masterAddrPort = QString("%1:%2").arg(gCoreContext->GetMasterServerIP())
-                                             .arg(gCoreContext->GetMasterServerStatusPort());
-    QString masterTLSAddrPort = QString("%1:%2").arg(gCoreContext->GetMasterServerIP())
-                                                .arg(gCoreContext->GetSetting( "BackendSSLPort", "6554" ));
-
-    QStringList allowedOrigins;
-    allowedOrigins << QString("http://%1").arg(masterAddrPort);
-    allowedOrigins << QString("https://%2").arg(masterTLSAddrPort);
-
-    if (!m_mapHeaders[ "origin" ].isEmpty())
-    {
-        if (allowedOrigins.contains(m_mapHeaders[ "origin" ]))
-            SetResponseHeader( "Access-Control-Allow-Origin" ,
-                               m_mapHeaders[ "origin" ]);
-        else
-            LOG(VB_GENERAL, LOG_CRIT, QString("HTTPRequest: Cross-origin request "
-                                              "received with origin (%1)")
-                                                 .arg(m_mapHeaders[ "origin" ]));
-    }
+    AddCORSHeaders();
 
     // ----------------------------------------------------------------------
     // Write out Header.
@@ -536,6 +511,60 @@ qint64 HTTPRequest::SendResponse( void )
 //
 /////////////////////////////////////////////////////////////////////////////
 
+void HTTPRequest::AddCORSHeaders( void )
+{
+    // ----------------------------------------------------------------------
+    // SECURITY: Access-Control-Allow-Origin Wildcard
+    //
+    // This is a REALLY bad idea, so bad in fact that I'm including it here but
+    // commented out in the hope that anyone thinking of adding it in the future
+    // will see it and then read this comment.
+    //
+    // Browsers do not verify that the origin is on the same network. This means
+    // that a malicious script embedded or included into ANY webpage you visit
+    // could then access servers on your local network including MythTV. They
+    // can grab data, delete data including recordings and videos, schedule
+    // recordings and generally ruin your day.
+    //
+    // This might seem paranoid and a remote possibility, but then that's how
+    // a lot of exploits are born. Do NOT allow wildcards.
+    //
+    //m_mapRespHeaders[ "Access-Control-Allow-Origin" ] = "*";
+    // ----------------------------------------------------------------------
+
+    // ----------------------------------------------------------------------
+    // SECURITY: Allow the WebFrontend on the Master backend and ONLY this
+    // machine to access resources on a frontend or slave web server
+    //
+    // TODO: Add hostname:port combo as well as ip:port
+    //
+    // http://www.w3.org/TR/cors/#introduction
+    // ----------------------------------------------------------------------
+    QString masterAddrPort = QString("%1:%2").arg(gCoreContext->GetMasterServerIP())
+                                             .arg(gCoreContext->GetMasterServerStatusPort());
+    QString masterTLSAddrPort = QString("%1:%2").arg(gCoreContext->GetMasterServerIP())
+                                                .arg(gCoreContext->GetSetting( "BackendSSLPort", "6554" ));
+
+    QStringList allowedOrigins;
+    allowedOrigins << QString("http://%1").arg(masterAddrPort);
+    allowedOrigins << QString("https://%2").arg(masterTLSAddrPort);
+
+    if (!m_mapHeaders[ "origin" ].isEmpty())
+    {
+        if (allowedOrigins.contains(m_mapHeaders[ "origin" ]))
+            SetResponseHeader( "Access-Control-Allow-Origin" ,
+                               m_mapHeaders[ "origin" ]);
+        else
+            LOG(VB_GENERAL, LOG_CRIT, QString("HTTPRequest: Cross-origin request "
+                                              "received with origin (%1)")
+                                                 .arg(m_mapHeaders[ "origin" ]));
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
 qint64 HTTPRequest::SendResponseFile( QString sFileName )
 {
     qint64      nBytes  = 0;
@@ -1806,26 +1835,63 @@ Serializer *HTTPRequest::GetSerializer()
                                                        m_sNameSpace, m_sMethod);
     else
     {
+        // Large responses are sent in chunks while they are being serialized
+
+        QIODevice *pDevice = &m_response;
+
+        if (m_pResponseStream == NULL && CanStreamResponse())
+        {
+            m_pResponseStream = new HTTPResponseStream( this );
+            pDevice = m_pResponseStream;
+        }
+
         QString sAccept = GetRequestHeader( "Accept", "*/*" );
         
         if (sAccept.contains( "application/json", Qt::CaseInsensitive ))    
-            pSerializer = (Serializer *)new JSONSerializer(&m_response,
+            pSerializer = (Serializer *)new JSONSerializer(pDevice,
                                                            m_sMethod);
         else if (sAccept.contains( "text/javascript", Qt::CaseInsensitive ))    
-            pSerializer = (Serializer *)new JSONSerializer(&m_response,
+            pSerializer = (Serializer *)new JSONSerializer(pDevice,
                                                            m_sMethod);
         else if (sAccept.contains( "text/x-apple-plist+xml", Qt::CaseInsensitive ))
-            pSerializer = (Serializer *)new XmlPListSerializer(&m_response);
-    }
+            pSerializer = (Serializer *)new XmlPListSerializer(pDevice);
 
-    // Default to XML
+        // Default to XML
 
-    if (pSerializer == NULL)
-        pSerializer = (Serializer *)new XmlSerializer(&m_response, m_sMethod);
+        if (pSerializer == NULL)
+            pSerializer = (Serializer *)new XmlSerializer(pDevice, m_sMethod);
+
+        // Needed up front in case the headers go out before
+        // FormatActionResponse() is called.
+
+        m_sResponseTypeText = pSerializer->GetContentType();
+    }
 
     return pSerializer;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Chunked responses need HTTP/1.1 and lose the ETag, so don't stream when
+// the client is revalidating a cached copy.  SOAP clients are mostly UPnP
+// devices, which cope badly with anything unusual.
+/////////////////////////////////////////////////////////////////////////////
+
+bool HTTPRequest::CanStreamResponse( void )
+{
+    if (m_bSOAPRequest || m_eType == RequestTypeHead)
+        return false;
+
+    if (m_nMajor < 1 || (m_nMajor == 1 && m_nMinor < 1))
+        return false;
+
+    if (!GetRequestHeader( "If-None-Match", "" ).isEmpty())
+        return false;
+
+    // The debug dump in SendResponse() wants the whole body
+
+    return getenv("HTTPREQUEST_DEBUG") == NULL;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 //
 /////////////////////////////////////////////////////////////////////////////
@@ -91,6 +91,8 @@ typedef struct
 
 /////////////////////////////////////////////////////////////////////////////
 
+class HTTPResponseStream;
+
 class IPostProcess
 {
     public:
@@ -104,6 +106,8 @@ class IPostProcess
 
 class UPNP_PUBLIC HTTPRequest
 {
+    friend class HTTPResponseStream;
+
     protected:
 
         static const char  *m_szServerHeaders;
@@ -150,6 +154,7 @@ class UPNP_PUBLIC HTTPRequest
         QString             m_sFileName;
 
         QBuffer             m_response;
+        HTTPResponseStream *m_pResponseStream;
 
         IPostProcess       *m_pPostProcess;
 
@@ -185,6 +190,8 @@ class UPNP_PUBLIC HTTPRequest
         void            ParseCookies        ( void );
 
         QString         BuildResponseHeader ( long long nSize );
+        void            AddCORSHeaders      ( void );
+        bool            CanStreamResponse   ( void );
 
         qint64          SendData            ( QIODevice *pDevice, qint64 llStart, qint64 llBytes );
         qint64          SendFile            ( QFile &file, qint64 llStart, qint64 llBytes );
@@ -202,7 +209,7 @@ class UPNP_PUBLIC HTTPRequest
     public:
         
                         HTTPRequest     ();
-        virtual        ~HTTPRequest     () {};
+        virtual        ~HTTPRequest     ();
 
         bool            ParseRequest    ();
 
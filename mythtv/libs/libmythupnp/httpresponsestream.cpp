@@ -0,0 +1,226 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: httpresponsestream.cpp
+// Created     : Oct. 19, 2026
+//
+// Purpose     : Chunked transfer encoding of large serialized responses
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "httpresponsestream.h"
+#include "httprequest.h"
+
+#include "mythlogging.h"
+
+#include "zlib.h"
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+HTTPResponseStream::HTTPResponseStream( HTTPRequest *pRequest )
+                  : m_pRequest  ( pRequest ),
+                    m_bStreaming( false    ),
+                    m_bFailed   ( false    ),
+                    m_pZStream  ( NULL     ),
+                    m_nBytesSent( 0        )
+{
+    open( QIODevice::WriteOnly );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+HTTPResponseStream::~HTTPResponseStream()
+{
+    if (m_pZStream != NULL)
+    {
+        deflateEnd( m_pZStream );
+        delete m_pZStream;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+qint64 HTTPResponseStream::writeData( const char *pData, qint64 nLen )
+{
+    if (m_bFailed)
+        return -1;
+
+    if (!m_bStreaming)
+    {
+        m_pRequest->m_response.write( pData, nLen );
+
+        if (m_pRequest->m_response.size() >= kStreamThreshold)
+        {
+            if (!BeginStreaming())
+                return -1;
+        }
+
+        return nLen;
+    }
+
+    if (!Append( pData, nLen, false ))
+        return -1;
+
+    return nLen;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Sends the response header followed by whatever has been held back so far.
+/////////////////////////////////////////////////////////////////////////////
+
+bool HTTPResponseStream::BeginStreaming()
+{
+    m_bStreaming = true;
+
+    m_pRequest->m_eResponseType   = ResponseTypeOther;
+    m_pRequest->m_nResponseStatus = 200;
+
+    if (m_pRequest->m_mapHeaders[ "accept-encoding" ].contains( "gzip" ))
+    {
+        m_pZStream = new z_stream;
+
+        m_pZStream->zalloc = Z_NULL;
+        m_pZStream->zfree  = Z_NULL;
+        m_pZStream->opaque = Z_NULL;
+
+        if (deflateInit2( m_pZStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                          15 + 16, 8, Z_DEFAULT_STRATEGY ) == Z_OK) // gzip
+        {
+            m_pRequest->SetResponseHeader( "Content-Encoding", "gzip" );
+        }
+        else
+        {
+            delete m_pZStream;
+            m_pZStream = NULL;
+        }
+    }
+
+    // There is no ETag since the body isn't complete yet, the serializer's
+    // headers are added by FormatActionResponse() once it is too late.
+
+    m_pRequest->AddCORSHeaders();
+
+    QByteArray sHeader = m_pRequest->BuildResponseHeader( -1 ).toUtf8();
+
+    LOG(VB_HTTP, LOG_INFO,
+        QString("HTTPResponseStream: Streaming response to %1")
+            .arg(m_pRequest->GetPeerAddress()));
+
+    if (m_pRequest->WriteBlock( sHeader.constData(),
+                                sHeader.length() ) != sHeader.length())
+    {
+        LOG(VB_HTTP, LOG_ERR, "HTTPResponseStream: Error writing header.");
+        m_bFailed = true;
+        return false;
+    }
+
+    m_nBytesSent += sHeader.length();
+
+    QByteArray held;
+    held.swap( m_pRequest->m_response.buffer() );
+    m_pRequest->m_response.seek( 0 );
+
+    m_chunk.reserve( kChunkSize + 1024 );
+
+    return Append( held.constData(), held.size(), false );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool HTTPResponseStream::Append( const char *pData, qint64 nLen, bool bFinish )
+{
+    if (m_pZStream != NULL)
+    {
+        char out[ 16384 ];
+
+        m_pZStream->next_in  = (Bytef*)pData;
+        m_pZStream->avail_in = nLen;
+
+        do
+        {
+            m_pZStream->avail_out = sizeof( out );
+            m_pZStream->next_out  = (Bytef*)out;
+
+            if (deflate( m_pZStream, bFinish ? Z_FINISH : Z_NO_FLUSH )
+                == Z_STREAM_ERROR)
+            {
+                LOG(VB_HTTP, LOG_ERR, "HTTPResponseStream: deflate failed.");
+                m_bFailed = true;
+                return false;
+            }
+
+            m_chunk.append( out, sizeof( out ) - m_pZStream->avail_out );
+        }
+        while (m_pZStream->avail_out == 0);
+    }
+    else
+        m_chunk.append( pData, nLen );
+
+    if (m_chunk.size() >= kChunkSize || bFinish)
+        return SendChunk();
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool HTTPResponseStream::SendChunk()
+{
+    if (m_chunk.isEmpty())
+        return true;
+
+    QByteArray frame;
+    frame.reserve( m_chunk.size() + 16 );
+    frame.append( QByteArray::number( m_chunk.size(), 16 ));
+    frame.append( "\r\n" );
+    frame.append( m_chunk );
+    frame.append( "\r\n" );
+
+    m_chunk.resize( 0 );
+
+    if (m_pRequest->WriteBlock( frame.constData(),
+                                frame.length() ) != frame.length())
+    {
+        LOG(VB_HTTP, LOG_ERR, "HTTPResponseStream: Error writing chunk.");
+        m_bFailed = true;
+        return false;
+    }
+
+    m_nBytesSent += frame.length();
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Flushes the compressor and sends the last chunk, returns the total number
+// of bytes sent or -1 if the connection should be closed.
+/////////////////////////////////////////////////////////////////////////////
+
+qint64 HTTPResponseStream::Finish()
+{
+    if (m_bFailed || !Append( NULL, 0, true ))
+        return -1;
+
+    static const char kLastChunk[] = "0\r\n\r\n";
+
+    if (m_pRequest->WriteBlock( kLastChunk, sizeof( kLastChunk ) - 1 )
+        != (qint64)sizeof( kLastChunk ) - 1)
+    {
+        m_bFailed = true;
+        return -1;
+    }
+
+    m_nBytesSent += sizeof( kLastChunk ) - 1;
+
+    return m_nBytesSent;
+}
@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: httpresponsestream.h
+// Created     : Oct. 19, 2026
+//
+// Purpose     : Chunked transfer encoding of large serialized responses
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef HTTPRESPONSESTREAM_H_
+#define HTTPRESPONSESTREAM_H_
+
+#include <QIODevice>
+#include <QByteArray>
+
+struct z_stream_s;
+class HTTPRequest;
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Output device handed to the serializers of HTTP/1.1 service requests.
+//
+// Small responses are simply collected in HTTPRequest::m_response and sent
+// by SendResponse() as before, with a Content-Length, ETag and optional
+// gzip compression of the whole body.  Once a response grows past
+// kStreamThreshold the headers are sent straight away with
+// "Transfer-Encoding: chunked" and the rest of the body follows in chunks
+// while it is still being serialized, gzip'd on the fly if the client
+// accepts it.  HTTPRequest::SendResponse() then only has to send the
+// terminating chunk.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class HTTPResponseStream : public QIODevice
+{
+    public:
+
+        static const qint64 kStreamThreshold = 256 * 1024;
+        static const int    kChunkSize       =  64 * 1024;
+
+                 HTTPResponseStream( HTTPRequest *pRequest );
+        virtual ~HTTPResponseStream();
+
+        bool     IsStreaming() const { return m_bStreaming; }
+        qint64   Finish     ();
+
+        virtual bool isSequential() const { return true; }
+
+    protected:
+
+        virtual qint64 readData ( char *, qint64 ) { return -1; }
+        virtual qint64 writeData( const char *pData, qint64 nLen );
+
+    private:
+
+        bool     BeginStreaming();
+        bool     Append        ( const char *pData, qint64 nLen, bool bFinish );
+        bool     SendChunk     ();
+
+        HTTPRequest       *m_pRequest;
+        bool               m_bStreaming;
+        bool               m_bFailed;
+        struct z_stream_s *m_pZStream;
+        QByteArray         m_chunk;
+        qint64             m_nBytesSent;
+};
+
+#endif
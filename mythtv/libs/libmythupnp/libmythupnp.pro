@@ -27,14 +27,14 @@ HEADERS += configuration.h
 HEADERS += soapclient.h mythxmlclient.h mmembuf.h upnpexp.h
 HEADERS += upnpserviceimpl.h
 HEADERS += servicehost.h wsdl.h htmlserver.h serverSideScripting.h xsd.h
-HEADERS += upnphelpers.h websocket.h
+HEADERS += upnphelpers.h websocket.h httpresponsestream.h
 
 HEADERS += services/rtti.h
 HEADERS += serviceHosts/rttiServiceHost.h
 
 HEADERS += serializers/serializer.h     serializers/xmlSerializer.h 
 HEADERS += serializers/jsonSerializer.h serializers/soapSerializer.h
-HEADERS += serializers/xmlplistSerializer.h
+HEADERS += serializers/xmlplistSerializer.h serializers/dtcSerializer.h
 
 HEADERS += websocket_extensions/*.h
 
@@ -50,19 +50,23 @@ SOURCES += configuration.cpp soapclient.cpp mythxmlclient.cpp mmembuf.cpp
 SOURCES += upnpserviceimpl.cpp
 SOURCES += htmlserver.cpp serverSideScripting.cpp
 SOURCES += servicehost.cpp wsdl.cpp upnpsubscription.cpp xsd.cpp
-SOURCES += upnphelpers.cpp websocket.cpp
+SOURCES += upnphelpers.cpp websocket.cpp httpresponsestream.cpp
 
 SOURCES += services/rtti.cpp
 
 SOURCES += serializers/serializer.cpp     serializers/xmlSerializer.cpp
 SOURCES += serializers/jsonSerializer.cpp 
-SOURCES += serializers/xmlplistSerializer.cpp
+SOURCES += serializers/xmlplistSerializer.cpp serializers/dtcSerializer.cpp
 
 SOURCES += websocket_extensions/*.cpp
 
 INCLUDEPATH += ../libmythbase ../libmythservicecontracts ..
 INCLUDEPATH += ./serializers
 
+# The data contracts used by dtcSerializer.cpp need the enums in
+# programtypes.h, the code for them is in libmythservicecontracts.
+INCLUDEPATH += ../libmyth
+
 DEPENDPATH  += ../libmythbase ..
 LIBS      += -L../libmythbase -lmythbase-$$LIBVERSION
 LIBS      += -L../libmythservicecontracts -lmythservicecontracts-$$LIBVERSION
@@ -0,0 +1,342 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: dtcSerializer.cpp
+// Created     : Oct. 19, 2026
+//
+// Purpose     : Reflection free serialization of the large data contracts
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "dtcSerializer.h"
+#include "serializer.h"
+
+#include "datacontracts/programAndChannel.h"
+#include "datacontracts/programGuide.h"
+#include "datacontracts/programList.h"
+
+#include <cstring>
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////
+
+bool DTCSerializer::Serialize( Serializer *pSer, const QObject *pObject )
+{
+    const QMetaObject *pMeta   = pObject->metaObject();
+
+    // The getters of the PTR and RO_REF properties aren't const, the
+    // reflective path calls them through QObject::property() as well.
+
+    QObject           *pMutable = const_cast< QObject* >( pObject );
+
+    if (pMeta == &DTC::Program::staticMetaObject)
+        SerializeProgram( pSer, static_cast< DTC::Program* >( pMutable ));
+    else if (pMeta == &DTC::ChannelInfo::staticMetaObject)
+        SerializeChannelInfo( pSer, static_cast< DTC::ChannelInfo* >( pMutable ));
+    else if (pMeta == &DTC::RecordingInfo::staticMetaObject)
+        SerializeRecordingInfo( pSer, static_cast< DTC::RecordingInfo* >( pMutable ));
+    else if (pMeta == &DTC::ProgramGuide::staticMetaObject)
+        SerializeProgramGuide( pSer, static_cast< DTC::ProgramGuide* >( pMutable ));
+    else if (pMeta == &DTC::ProgramList::staticMetaObject)
+        SerializeProgramList( pSer, static_cast< DTC::ProgramList* >( pMutable ));
+    else
+        return false;
+
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// The ETag only has to change when the content does, so the raw value is
+// hashed rather than its text representation.
+//////////////////////////////////////////////////////////////////////////////
+
+template<>
+void DTCSerializer::Add< QString >( Serializer *pSer, const char *pszName,
+                                    const QString &value, bool bHash )
+{
+    if (bHash)
+    {
+        pSer->m_hash.addData( pszName, strlen( pszName ));
+        pSer->m_hash.addData( reinterpret_cast< const char* >( value.constData() ),
+                              value.size() * sizeof( QChar ));
+    }
+
+    pSer->AddString( pszName, value );
+}
+
+template<>
+void DTCSerializer::Add< qlonglong >( Serializer *pSer, const char *pszName,
+                                      const qlonglong &value, bool bHash )
+{
+    if (bHash)
+    {
+        pSer->m_hash.addData( pszName, strlen( pszName ));
+        pSer->m_hash.addData( reinterpret_cast< const char* >( &value ),
+                              sizeof( value ));
+    }
+
+    pSer->AddInt( pszName, value );
+}
+
+template<>
+void DTCSerializer::Add< int >( Serializer *pSer, const char *pszName,
+                                const int &value, bool bHash )
+{
+    Add< qlonglong >( pSer, pszName, value, bHash );
+}
+
+template<>
+void DTCSerializer::Add< uint >( Serializer *pSer, const char *pszName,
+                                 const uint &value, bool bHash )
+{
+    Add< qlonglong >( pSer, pszName, value, bHash );
+}
+
+template<>
+void DTCSerializer::Add< bool >( Serializer *pSer, const char *pszName,
+                                 const bool &value, bool bHash )
+{
+    if (bHash)
+    {
+        pSer->m_hash.addData( pszName, strlen( pszName ));
+        pSer->m_hash.addData( value ? "1" : "0", 1 );
+    }
+
+    pSer->AddBool( pszName, value );
+}
+
+template<>
+void DTCSerializer::Add< double >( Serializer *pSer, const char *pszName,
+                                   const double &value, bool bHash )
+{
+    if (bHash)
+    {
+        pSer->m_hash.addData( pszName, strlen( pszName ));
+        pSer->m_hash.addData( reinterpret_cast< const char* >( &value ),
+                              sizeof( value ));
+    }
+
+    pSer->AddDouble( pszName, value );
+}
+
+template<>
+void DTCSerializer::Add< QDateTime >( Serializer *pSer, const char *pszName,
+                                      const QDateTime &value, bool bHash )
+{
+    if (bHash)
+    {
+        qint64 nMSecs = value.isValid() ? value.toMSecsSinceEpoch() : -1;
+
+        pSer->m_hash.addData( pszName, strlen( pszName ));
+        pSer->m_hash.addData( reinterpret_cast< const char* >( &nMSecs ),
+                              sizeof( nMSecs ));
+    }
+
+    pSer->AddDateTime( pszName, value );
+}
+
+template<>
+void DTCSerializer::Add< QDate >( Serializer *pSer, const char *pszName,
+                                  const QDate &value, bool bHash )
+{
+    if (bHash)
+    {
+        qint64 nDay = value.toJulianDay();
+
+        pSer->m_hash.addData( pszName, strlen( pszName ));
+        pSer->m_hash.addData( reinterpret_cast< const char* >( &nDay ),
+                              sizeof( nDay ));
+    }
+
+    pSer->AddDate( pszName, value );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Child objects and lists still go through AddProperty() so each serializer
+// lays them out as before, their contents come back through
+// SerializeObjectProperties() and so through the fast path again.
+//////////////////////////////////////////////////////////////////////////////
+
+void DTCSerializer::AddObject( Serializer *pSer, const QObject *pParent,
+                               const char *pszName, QObject *pChild )
+{
+    pSer->m_hash.addData( pszName, strlen( pszName ));
+
+    pSer->AddProperty( pszName, QVariant::fromValue< QObject* >( pChild ),
+                       pParent->metaObject(), NULL );
+}
+
+void DTCSerializer::AddList( Serializer *pSer, const QObject *pParent,
+                             const char *pszName, const QVariantList &list )
+{
+    pSer->m_hash.addData( pszName, strlen( pszName ));
+
+    pSer->AddProperty( pszName, list, pParent->metaObject(), NULL );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Enums need the QMetaProperty for their key names, so use the reflective
+// path for just that property.
+//////////////////////////////////////////////////////////////////////////////
+
+void DTCSerializer::AddReflected( Serializer *pSer, const QObject *pObject,
+                                  const char *pszName )
+{
+    const QMetaObject *pMeta = pObject->metaObject();
+    int                nIdx  = pMeta->indexOfProperty( pszName );
+
+    if (nIdx >= 0)
+        pSer->SerializeProperty( pObject, pMeta, pMeta->property( nIdx ));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////
+
+void DTCSerializer::SerializeProgram( Serializer *pSer, DTC::Program *pProgram )
+{
+    Add( pSer, "StartTime"    , pProgram->StartTime()     );
+    Add( pSer, "EndTime"      , pProgram->EndTime()       );
+    Add( pSer, "Title"        , pProgram->Title()         );
+    Add( pSer, "SubTitle"     , pProgram->SubTitle()      );
+    Add( pSer, "Category"     , pProgram->Category()      );
+    Add( pSer, "CatType"      , pProgram->CatType()       );
+    Add( pSer, "Repeat"       , pProgram->Repeat()        );
+    Add( pSer, "VideoProps"   , pProgram->VideoProps()    );
+    Add( pSer, "AudioProps"   , pProgram->AudioProps()    );
+    Add( pSer, "SubProps"     , pProgram->SubProps()      );
+
+    if (pProgram->SerializeDetails())
+    {
+        Add( pSer, "SeriesId"     , pProgram->SeriesId()      );
+        Add( pSer, "ProgramId"    , pProgram->ProgramId()     );
+        Add( pSer, "Stars"        , pProgram->Stars()         );
+        Add( pSer, "LastModified" , pProgram->LastModified()  );
+        Add( pSer, "ProgramFlags" , pProgram->ProgramFlags()  );
+        Add( pSer, "Airdate"      , pProgram->Airdate()       );
+        Add( pSer, "Description"  , pProgram->Description()   );
+        Add( pSer, "Inetref"      , pProgram->Inetref()       );
+        Add( pSer, "Season"       , pProgram->Season()        );
+        Add( pSer, "Episode"      , pProgram->Episode()       );
+        Add( pSer, "TotalEpisodes", pProgram->TotalEpisodes() );
+        Add( pSer, "FileSize"     , pProgram->FileSize()      );
+        Add( pSer, "FileName"     , pProgram->FileName()      );
+        Add( pSer, "HostName"     , pProgram->HostName()      );
+    }
+
+    if (pProgram->SerializeChannel())
+        AddObject( pSer, pProgram, "Channel"  , pProgram->Channel()   );
+
+    if (pProgram->SerializeRecording())
+        AddObject( pSer, pProgram, "Recording", pProgram->Recording() );
+
+    if (pProgram->SerializeArtwork())
+        AddObject( pSer, pProgram, "Artwork"  , pProgram->Artwork()   );
+
+    if (pProgram->SerializeCast())
+        AddObject( pSer, pProgram, "Cast"     , pProgram->Cast()      );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////
+
+void DTCSerializer::SerializeChannelInfo( Serializer *pSer, DTC::ChannelInfo *pChannel )
+{
+    Add( pSer, "ChanId"       , pChannel->ChanId()        );
+    Add( pSer, "ChanNum"      , pChannel->ChanNum()       );
+    Add( pSer, "CallSign"     , pChannel->CallSign()      );
+    Add( pSer, "IconURL"      , pChannel->IconURL()       );
+    Add( pSer, "ChannelName"  , pChannel->ChannelName()   );
+
+    if (pChannel->SerializeDetails())
+    {
+        Add( pSer, "MplexId"      , pChannel->MplexId()       );
+        Add( pSer, "ServiceId"    , pChannel->ServiceId()     );
+        Add( pSer, "ATSCMajorChan", pChannel->ATSCMajorChan() );
+        Add( pSer, "ATSCMinorChan", pChannel->ATSCMinorChan() );
+        Add( pSer, "Format"       , pChannel->Format()        );
+        Add( pSer, "FrequencyId"  , pChannel->FrequencyId()   );
+        Add( pSer, "FineTune"     , pChannel->FineTune()      );
+        Add( pSer, "ChanFilters"  , pChannel->ChanFilters()   );
+        Add( pSer, "SourceId"     , pChannel->SourceId()      );
+        Add( pSer, "InputId"      , pChannel->InputId()       );
+        Add( pSer, "CommFree"     , pChannel->CommFree()      );
+        Add( pSer, "UseEIT"       , pChannel->UseEIT()        );
+        Add( pSer, "Visible"      , pChannel->Visible()       );
+        Add( pSer, "XMLTVID"      , pChannel->XMLTVID()       );
+        Add( pSer, "DefaultAuth"  , pChannel->DefaultAuth()   );
+    }
+
+    AddList( pSer, pChannel, "Programs", pChannel->Programs() );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////
+
+void DTCSerializer::SerializeRecordingInfo( Serializer *pSer,
+                                            DTC::RecordingInfo *pRecording )
+{
+    Add( pSer, "RecordedId", pRecording->RecordedId() );
+
+    AddReflected( pSer, pRecording, "Status" );
+
+    Add( pSer, "Priority"  , pRecording->Priority()   );
+    Add( pSer, "StartTs"   , pRecording->StartTs()    );
+    Add( pSer, "EndTs"     , pRecording->EndTs()      );
+
+    if (pRecording->SerializeDetails())
+    {
+        Add( pSer, "FileSize"    , pRecording->FileSize()          );
+        Add( pSer, "FileName"    , pRecording->FileName()          );
+        Add( pSer, "HostName"    , pRecording->HostName()          );
+        Add( pSer, "LastModified", pRecording->LastModified()      );
+        Add( pSer, "RecordId"    , pRecording->RecordId()          );
+        Add( pSer, "RecGroup"    , pRecording->RecGroup()          );
+        Add( pSer, "PlayGroup"   , pRecording->PlayGroup()         );
+        Add( pSer, "StorageGroup", pRecording->StorageGroup()      );
+        Add( pSer, "RecType"     , (int)pRecording->RecType()      );
+        Add( pSer, "DupInType"   , (int)pRecording->DupInType()    );
+        Add( pSer, "DupMethod"   , (int)pRecording->DupMethod()    );
+        Add( pSer, "EncoderId"   , pRecording->EncoderId()         );
+        Add( pSer, "EncoderName" , pRecording->EncoderName()       );
+        Add( pSer, "Profile"     , pRecording->Profile()           );
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////
+
+void DTCSerializer::SerializeProgramGuide( Serializer *pSer, DTC::ProgramGuide *pGuide )
+{
+    Add( pSer, "StartTime"     , pGuide->StartTime()      );
+    Add( pSer, "EndTime"       , pGuide->EndTime()        );
+    Add( pSer, "Details"       , pGuide->Details()        );
+    Add( pSer, "StartIndex"    , pGuide->StartIndex()     );
+    Add( pSer, "Count"         , pGuide->Count()          );
+    Add( pSer, "TotalAvailable", pGuide->TotalAvailable() );
+    Add( pSer, "AsOf"          , pGuide->AsOf()           , false ); // transient
+    Add( pSer, "Version"       , pGuide->Version()        );
+    Add( pSer, "ProtoVer"      , pGuide->ProtoVer()       );
+
+    AddList( pSer, pGuide, "Channels", pGuide->Channels() );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////
+
+void DTCSerializer::SerializeProgramList( Serializer *pSer, DTC::ProgramList *pList )
+{
+    Add( pSer, "StartIndex"    , pList->StartIndex()     );
+    Add( pSer, "Count"         , pList->Count()          );
+    Add( pSer, "TotalAvailable", pList->TotalAvailable() );
+    Add( pSer, "AsOf"          , pList->AsOf()           , false ); // transient
+    Add( pSer, "Version"       , pList->Version()        );
+    Add( pSer, "ProtoVer"      , pList->ProtoVer()       );
+
+    AddList( pSer, pList, "Programs", pList->Programs() );
+}
@@ -0,0 +1,71 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: dtcSerializer.h
+// Created     : Oct. 19, 2026
+//
+// Purpose     : Reflection free serialization of the large data contracts
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef __DTCSERIALIZER_H__
+#define __DTCSERIALIZER_H__
+
+#include <QVariant>
+
+class QObject;
+class Serializer;
+
+namespace DTC
+{
+    class Program;
+    class ChannelInfo;
+    class RecordingInfo;
+    class ProgramGuide;
+    class ProgramList;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// Hand written property walkers for the data contracts which make up the
+// bulk of Dvr/GetRecordedList, Dvr/GetUpcomingList, Guide/GetProgramList and
+// Guide/GetProgramGuide responses.
+//
+// Serializer::SerializeObjectProperties() normally looks up every
+// QMetaProperty, parses its Q_CLASSINFO metadata and boxes the value into a
+// QVariant.  The functions here call the getters directly and hand the
+// values to the serializer's typed Add*() writers.  The property order,
+// DESIGNABLE conditions and transient flags must be kept in step with the
+// Q_PROPERTY declarations of each class.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+class DTCSerializer
+{
+    public:
+
+        static bool Serialize( Serializer *pSer, const QObject *pObject );
+
+    private:
+
+        template< typename T >
+        static void Add       ( Serializer *pSer, const char *pszName,
+                                const T &value, bool bHash = true );
+
+        static void AddObject ( Serializer *pSer, const QObject *pParent,
+                                const char *pszName, QObject *pChild );
+
+        static void AddList   ( Serializer *pSer, const QObject *pParent,
+                                const char *pszName, const QVariantList &list );
+
+        static void AddReflected( Serializer *pSer, const QObject *pObject,
+                                  const char *pszName );
+
+        static void SerializeProgram      ( Serializer *pSer, DTC::Program       *pProgram );
+        static void SerializeChannelInfo  ( Serializer *pSer, DTC::ChannelInfo   *pChannel );
+        static void SerializeRecordingInfo( Serializer *pSer, DTC::RecordingInfo *pRecording );
+        static void SerializeProgramGuide ( Serializer *pSer, DTC::ProgramGuide  *pGuide );
+        static void SerializeProgramList  ( Serializer *pSer, DTC::ProgramList   *pList );
+};
+
+#endif
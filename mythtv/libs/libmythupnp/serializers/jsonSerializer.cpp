@@ -13,7 +13,6 @@
 #include "jsonSerializer.h"
 #include "mythdate.h"
 
-#include <QTextCodec>
 #include <QVariant>
 
 //////////////////////////////////////////////////////////////////////////////
@@ -21,8 +20,9 @@
 //////////////////////////////////////////////////////////////////////////////
 
 JSONSerializer::JSONSerializer( QIODevice *pDevice, const QString &sRequestName )
-               : m_Stream( pDevice ), m_bCommaNeeded( false )
+               : m_pDevice( pDevice ), m_bCommaNeeded( false )
 {
+    m_buffer.reserve( kBufferSize + 4096 );
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -31,6 +31,7 @@ JSONSerializer::JSONSerializer( QIODevice *pDevice, const QString &sRequestName
 
 JSONSerializer::~JSONSerializer()
 {
+    Flush();
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -51,7 +52,7 @@ void JSONSerializer::BeginSerialize( QString &sName )
 {
     m_bCommaNeeded = false;
 
-    m_Stream << "{";
+    Write( "{" );
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -62,9 +63,9 @@ void JSONSerializer::EndSerialize()
 {
     m_bCommaNeeded = false;
     
-    m_Stream << "}";
+    Write( "}" );
 
-    m_Stream.flush();
+    Flush();
 }
 
 
@@ -76,7 +77,9 @@ void JSONSerializer::BeginObject( const QString &sName, const QObject  *pObject
 {
     m_bCommaNeeded = false;
     
-    m_Stream << "\"" << sName << "\": {";
+    Write( "\"" );
+    Write( sName );
+    Write( "\": {" );
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -87,7 +90,7 @@ void JSONSerializer::EndObject  ( const QString &sName, const QObject  *pObject
 {
     m_bCommaNeeded = false;
     
-    m_Stream << "}";
+    Write( "}" );
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -100,15 +103,86 @@ void JSONSerializer::AddProperty( const QString       &sName,
                                   const QMetaProperty *pMetaProp )
 {
     if (m_bCommaNeeded)
-        m_Stream << ", ";
+        Write( ", " );
 
-    m_Stream << "\"" << sName << "\": ";
+    Write( "\"" );
+    Write( sName );
+    Write( "\": " );
 
     RenderValue( vValue );
 
     m_bCommaNeeded = true;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Typed writers used by DTCSerializer.  Every value is rendered as a string,
+// exactly as RenderValue() does for the same QVariant.
+//////////////////////////////////////////////////////////////////////////////
+
+void JSONSerializer::BeginProperty( const char *pszName )
+{
+    if (m_bCommaNeeded)
+        Write( ", " );
+
+    Write( "\"" );
+    Write( pszName );
+    Write( "\": " );
+
+    m_bCommaNeeded = true;
+}
+
+void JSONSerializer::AddString( const char *pszName, const QString &sValue )
+{
+    BeginProperty( pszName );
+
+    Write( "\"" );
+    WriteEncoded( sValue );
+    Write( "\"" );
+}
+
+void JSONSerializer::AddInt( const char *pszName, qlonglong nValue )
+{
+    BeginProperty( pszName );
+
+    m_buffer.append( '"' );
+    m_buffer.append( QByteArray::number( nValue ));
+    m_buffer.append( '"' );
+}
+
+void JSONSerializer::AddBool( const char *pszName, bool bValue )
+{
+    BeginProperty( pszName );
+
+    Write( bValue ? "\"true\"" : "\"false\"" );
+}
+
+void JSONSerializer::AddDouble( const char *pszName, double dValue )
+{
+    BeginProperty( pszName );
+
+    Write( "\"" );
+    Write( QVariant( dValue ).toString() );
+    Write( "\"" );
+}
+
+void JSONSerializer::AddDateTime( const char *pszName, const QDateTime &dtValue )
+{
+    BeginProperty( pszName );
+
+    Write( "\"" );
+    Write( MythDate::toString( dtValue, MythDate::ISODate ));
+    Write( "\"" );
+}
+
+void JSONSerializer::AddDate( const char *pszName, const QDate &dValue )
+{
+    BeginProperty( pszName );
+
+    Write( "\"" );
+    Write( dValue.toString( Qt::ISODate ));
+    Write( "\"" );
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //
 //////////////////////////////////////////////////////////////////////////////
@@ -127,9 +201,9 @@ void JSONSerializer::RenderValue( const QVariant &vValue )
         bool bSavedCommaNeeded = m_bCommaNeeded;
         m_bCommaNeeded = false;
 
-        m_Stream << "{";
+        Write( "{" );
         SerializeObjectProperties( pObject );
-        m_Stream << "}";
+        Write( "}" );
 
         m_bCommaNeeded = bSavedCommaNeeded;
 
@@ -147,14 +221,17 @@ void JSONSerializer::RenderValue( const QVariant &vValue )
         case QVariant::Map:         RenderMap       ( vValue.toMap()        );  break;
         case QVariant::DateTime:
         {
-            m_Stream << "\"" << Encode( 
-                MythDate::toString( vValue.toDateTime(), MythDate::ISODate ) )
-                << "\"";
+            Write( "\"" );
+            WriteEncoded(
+                MythDate::toString( vValue.toDateTime(), MythDate::ISODate ) );
+            Write( "\"" );
             break;
         }
         default:
         {
-            m_Stream << "\"" << Encode( vValue.toString() ) << "\"";
+            Write( "\"" );
+            WriteEncoded( vValue.toString() );
+            Write( "\"" );
             break;
         }
     }
@@ -168,7 +245,7 @@ void JSONSerializer::RenderList( const QVariantList &list )
 {
     bool bFirst = true;
 
-    m_Stream << "[";
+    Write( "[" );
 
     QListIterator< QVariant > it( list );
 
@@ -177,12 +254,12 @@ void JSONSerializer::RenderList( const QVariantList &list )
         if (bFirst)
             bFirst = false;
         else
-            m_Stream << ",";
+            Write( "," );
 
         RenderValue( it.next() );
     }
 
-    m_Stream << "]";
+    Write( "]" );
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -193,7 +270,7 @@ void JSONSerializer::RenderStringList( const QStringList &list )
 {
     bool bFirst = true;
 
-    m_Stream << "[";
+    Write( "[" );
 
     QListIterator< QString > it( list );
 
@@ -202,12 +279,14 @@ void JSONSerializer::RenderStringList( const QStringList &list )
         if (bFirst)
             bFirst = false;
         else
-            m_Stream << ",";
+            Write( "," );
 
-          m_Stream << "\"" << Encode( it.next() ) << "\"";
+        Write( "\"" );
+        WriteEncoded( it.next() );
+        Write( "\"" );
     }
 
-    m_Stream << "]";
+    Write( "]" );
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -218,7 +297,7 @@ void JSONSerializer::RenderMap( const QVariantMap &map )
 {
     bool bFirst = true;
 
-    m_Stream << "{";
+    Write( "{" );
 
     QMapIterator< QString, QVariant > it( map );
 
@@ -229,44 +308,129 @@ void JSONSerializer::RenderMap( const QVariantMap &map )
         if (bFirst)
             bFirst = false;
         else
-            m_Stream << ",";
+            Write( "," );
+
+        Write( "\"" );
+        Write( it.key() );
+        Write( "\":\"" );
+        WriteEncoded( it.value().toString() );
+        Write( "\"" );
+    }
+
+    Write( "}" );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////
+
+void JSONSerializer::Write( const char *pszText )
+{
+    m_buffer.append( pszText );
+
+    if (m_buffer.size() >= kBufferSize)
+        Flush();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////
+
+void JSONSerializer::Write( const QString &sText )
+{
+    m_buffer.append( sText.toUtf8() );
+
+    if (m_buffer.size() >= kBufferSize)
+        Flush();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Escapes and UTF-8 encodes the string into the buffer in a single pass.
+//////////////////////////////////////////////////////////////////////////////
+
+void JSONSerializer::WriteEncoded( const QString &sIn )
+{
+    static const char hex[] = "0123456789abcdef";
+
+    const QChar *pChars = sIn.constData();
+    int          nLen   = sIn.size();
+
+    for (int nIdx = 0; nIdx < nLen; ++nIdx)
+    {
+        uint ch = pChars[ nIdx ].unicode();
+
+        if (ch < 0x80)
+        {
+            switch (ch)
+            {
+                case '\\': m_buffer.append( "\\\\" ); break;
+                case '"' : m_buffer.append( "\\\"" ); break;
+                case '/' : m_buffer.append( "\\/"  ); break;
+                case '\b': m_buffer.append( "\\b"  ); break;
+                case '\f': m_buffer.append( "\\f"  ); break;
+                case '\n': m_buffer.append( "\\n"  ); break;
+                case '\r': m_buffer.append( "\\r"  ); break;
+                case '\t': m_buffer.append( "\\t"  ); break;
+                default:
+                    if (ch < 0x20)
+                    {
+                        m_buffer.append( "\\u00" );
+                        m_buffer.append( hex[ ch >> 4 ] );
+                        m_buffer.append( hex[ ch & 0xf ] );
+                    }
+                    else
+                        m_buffer.append( (char)ch );
+                    break;
+            }
+            continue;
+        }
+
+        if (QChar::isHighSurrogate( ch ) && (nIdx + 1 < nLen) &&
+            pChars[ nIdx + 1 ].isLowSurrogate())
+        {
+            ch = QChar::surrogateToUcs4( ch, pChars[ ++nIdx ].unicode() );
+        }
+        else if (QChar::isSurrogate( ch ))
+        {
+            ch = QChar::ReplacementCharacter;
+        }
+
+        if (ch < 0x800)
+        {
+            m_buffer.append( (char)(0xc0 | (ch >> 6)) );
+        }
+        else if (ch < 0x10000)
+        {
+            m_buffer.append( (char)(0xe0 | (ch >> 12)) );
+            m_buffer.append( (char)(0x80 | ((ch >> 6) & 0x3f)) );
+        }
+        else
+        {
+            m_buffer.append( (char)(0xf0 | (ch >> 18)) );
+            m_buffer.append( (char)(0x80 | ((ch >> 12) & 0x3f)) );
+            m_buffer.append( (char)(0x80 | ((ch >> 6) & 0x3f)) );
+        }
 
-        m_Stream << "\"" << it.key() << "\":";
-        m_Stream << "\"" << Encode( it.value().toString() ) << "\"";
+        m_buffer.append( (char)(0x80 | (ch & 0x3f)) );
     }
 
-    m_Stream << "}";
+    if (m_buffer.size() >= kBufferSize)
+        Flush();
 }
 
 //////////////////////////////////////////////////////////////////////////////
 //
 //////////////////////////////////////////////////////////////////////////////
 
-QString JSONSerializer::Encode(const QString &sIn)
+void JSONSerializer::Flush()
 {
-    if (sIn.isEmpty())
-        return sIn;
-
-    QString sStr = sIn;
-
-    // -=>TODO: Would it be better to just loop through string once and build 
-    // new string with encoded chars instead of calling replace multiple times?
-    // It might perform better.
-
-    sStr.replace( '\\', "\\\\" ); // This must be first
-    sStr.replace( '"' , "\\\"" ); 
-
-    sStr.replace( '\b', "\\b"  );
-    sStr.replace( '\f', "\\f"  );
-    sStr.replace( '\n', "\\n"  );
-    sStr.replace( "\r", "\\r"  );
-    sStr.replace( "\t", "\\t"  );
-    sStr.replace(  "/", "\\/"  );
-
-    // we don't handle hex values yet...
-    /*
-    if(ch>='\u0000' && ch<='\u001F')
-        sb.append("\\u####"); 
-    */
-    return sStr;
+    if (m_buffer.isEmpty())
+        return;
+
+    if (m_pDevice != NULL)
+        m_pDevice->write( m_buffer );
+
+    // resize() rather than clear() keeps the reserved capacity
+
+    m_buffer.resize( 0 );
 }
@@ -13,7 +13,8 @@
 #ifndef __JSONSERIALIZER_H__
 #define __JSONSERIALIZER_H__
 
-#include <QTextStream>
+#include <QIODevice>
+#include <QByteArray>
 #include <QStringList>
 #include <QVariantMap>
 
@@ -33,7 +34,13 @@ class UPNP_PUBLIC JSONSerializer : public Serializer
 
     protected:
 
-        QTextStream   m_Stream;
+        // Output is UTF-8 encoded straight into m_buffer, which is handed
+        // to the device whenever it fills up.
+
+        static const int kBufferSize = 64 * 1024;
+
+        QIODevice    *m_pDevice;
+        QByteArray    m_buffer;
         bool          m_bCommaNeeded;
 
         virtual void BeginSerialize( QString &sName );
@@ -48,13 +55,27 @@ class UPNP_PUBLIC JSONSerializer : public Serializer
                                   const QMetaProperty *pMetaProp );
 
 
+        virtual bool HasFastPath() const { return true; }
+
+        virtual void AddString  ( const char *pszName, const QString   &sValue  );
+        virtual void AddInt     ( const char *pszName, qlonglong        nValue  );
+        virtual void AddBool    ( const char *pszName, bool             bValue  );
+        virtual void AddDouble  ( const char *pszName, double           dValue  );
+        virtual void AddDateTime( const char *pszName, const QDateTime &dtValue );
+        virtual void AddDate    ( const char *pszName, const QDate     &dValue  );
+
+        void BeginProperty   ( const char *pszName );
+
         void RenderValue     ( const QVariant     &vValue );
 
         void RenderStringList( const QStringList  &list );
         void RenderList      ( const QVariantList &list );
         void RenderMap       ( const QVariantMap  &map  );
 
-        QString Encode       ( const QString &sIn );
+        void Write           ( const char    *pszText );
+        void Write           ( const QString &sText   );
+        void WriteEncoded    ( const QString &sIn     );
+        void Flush           ();
 
     public:
 
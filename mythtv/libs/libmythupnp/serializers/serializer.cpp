@@ -11,6 +11,7 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "serializer.h"
+#include "dtcSerializer.h"
 
 #include <QMetaObject>
 #include <QMetaProperty>
@@ -103,6 +104,11 @@ void Serializer::SerializeObjectProperties( const QObject *pObject )
 {
     if (pObject != NULL)
     {
+        // Use the hand written serializer if there is one for this type.
+
+        if (HasFastPath() && DTCSerializer::Serialize( this, pObject ))
+            return;
+
         const QMetaObject *pMetaObject = pObject->metaObject();
 
         int nCount = pMetaObject->propertyCount();
@@ -113,33 +119,79 @@ void Serializer::SerializeObjectProperties( const QObject *pObject )
 
             if (metaProperty.isDesignable( pObject ))
             {
-                const char *pszPropName = metaProperty.name();
-                QString     sPropName( pszPropName );
-
-                if ( sPropName.compare( "objectName" ) == 0)
+                if ( qstrcmp( metaProperty.name(), "objectName" ) == 0)
                     continue;
-                
-                bool bHash = false;
 
-                if (ReadPropertyMetadata( pObject, 
-                                          sPropName, 
-                                          "transient").toLower() != "true" )
-                {
-                    bHash = true;
-                    m_hash.addData( sPropName.toUtf8() );
-                }
+                SerializeProperty( pObject, pMetaObject, metaProperty );
+            }
+        }
+    }
+}
 
-                QVariant value( pObject->property( pszPropName ) );
+//////////////////////////////////////////////////////////////////////////////
+//
+//////////////////////////////////////////////////////////////////////////////
 
-                if (bHash && !value.canConvert< QObject* >()) 
-                {
-                    m_hash.addData( value.toString().toUtf8() );
-                }
+void Serializer::SerializeProperty( const QObject       *pObject,
+                                    const QMetaObject   *pMetaObject,
+                                    const QMetaProperty &metaProperty )
+{
+    const char *pszPropName = metaProperty.name();
+    QString     sPropName( pszPropName );
 
-                AddProperty( sPropName, value, pMetaObject, &metaProperty );
-            }
-        }
+    bool bHash = false;
+
+    if (ReadPropertyMetadata( pObject, 
+                              sPropName, 
+                              "transient").toLower() != "true" )
+    {
+        bHash = true;
+        m_hash.addData( sPropName.toUtf8() );
+    }
+
+    QVariant value( pObject->property( pszPropName ) );
+
+    if (bHash && !value.canConvert< QObject* >()) 
+    {
+        m_hash.addData( value.toString().toUtf8() );
     }
+
+    AddProperty( sPropName, value, pMetaObject, &metaProperty );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Default typed writers, only used by serializers that enable the fast path
+// without providing their own.
+//////////////////////////////////////////////////////////////////////////////
+
+void Serializer::AddString( const char *pszName, const QString &sValue )
+{
+    AddProperty( pszName, sValue, NULL, NULL );
+}
+
+void Serializer::AddInt( const char *pszName, qlonglong nValue )
+{
+    AddProperty( pszName, nValue, NULL, NULL );
+}
+
+void Serializer::AddBool( const char *pszName, bool bValue )
+{
+    AddProperty( pszName, bValue, NULL, NULL );
+}
+
+void Serializer::AddDouble( const char *pszName, double dValue )
+{
+    AddProperty( pszName, dValue, NULL, NULL );
+}
+
+void Serializer::AddDateTime( const char *pszName, const QDateTime &dtValue )
+{
+    AddProperty( pszName, dtValue, NULL, NULL );
+}
+
+void Serializer::AddDate( const char *pszName, const QDate &dValue )
+{
+    AddProperty( pszName, dValue, NULL, NULL );
 }
 
 /////////////////////////////////////////////////////////////////////////////
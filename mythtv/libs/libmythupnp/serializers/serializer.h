@@ -18,7 +18,9 @@
 
 #include <QList>
 #include <QMetaType>
+#include <QMetaProperty>
 #include <QCryptographicHash>
+#include <QDateTime>
 
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
@@ -30,6 +32,8 @@
 
 class UPNP_PUBLIC Serializer
 {
+    friend class DTCSerializer;
+
     protected:
 
         QCryptographicHash  m_hash;
@@ -45,10 +49,29 @@ class UPNP_PUBLIC Serializer
                                   const QMetaObject   *pMetaParent,
                                   const QMetaProperty *pMetaProp ) = 0;
 
+        //////////////////////////////////////////////////////////////////////
+        // Typed property writers used by DTCSerializer, which writes the
+        // most frequently returned data contracts without going through
+        // QMetaProperty and QVariant.  They are only called when
+        // HasFastPath() returns true.
+        //////////////////////////////////////////////////////////////////////
+
+        virtual bool HasFastPath() const { return false; }
+
+        virtual void AddString  ( const char *pszName, const QString   &sValue  );
+        virtual void AddInt     ( const char *pszName, qlonglong        nValue  );
+        virtual void AddBool    ( const char *pszName, bool             bValue  );
+        virtual void AddDouble  ( const char *pszName, double           dValue  );
+        virtual void AddDateTime( const char *pszName, const QDateTime &dtValue );
+        virtual void AddDate    ( const char *pszName, const QDate     &dValue  );
+
         //////////////////////////////////////////////////////////////////////
 
         void SerializeObject          ( const QObject *pObject, const QString &sName );
         void SerializeObjectProperties( const QObject *pObject );
+        void SerializeProperty        ( const QObject       *pObject,
+                                        const QMetaObject   *pMetaObject,
+                                        const QMetaProperty &metaProperty );
 
         QString    ReadPropertyMetadata  ( const QObject *pObject, 
                                                  QString  sPropName, 
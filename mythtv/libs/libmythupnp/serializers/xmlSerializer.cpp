@@ -131,6 +131,54 @@ void XmlSerializer::AddProperty( const QString       &sName,
     m_pXmlWriter->writeEndElement();
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Typed writers used by DTCSerializer, these produce the same elements as
+// AddProperty() would for the equivalent QVariant.
+//////////////////////////////////////////////////////////////////////////////
+
+void XmlSerializer::AddString( const char *pszName, const QString &sValue )
+{
+    m_pXmlWriter->writeTextElement( QLatin1String( pszName ), sValue );
+}
+
+void XmlSerializer::AddInt( const char *pszName, qlonglong nValue )
+{
+    m_pXmlWriter->writeTextElement( QLatin1String( pszName ),
+                                    QString::number( nValue ));
+}
+
+void XmlSerializer::AddBool( const char *pszName, bool bValue )
+{
+    m_pXmlWriter->writeTextElement( QLatin1String( pszName ),
+                                    bValue ? QLatin1String( "true"  )
+                                           : QLatin1String( "false" ));
+}
+
+void XmlSerializer::AddDouble( const char *pszName, double dValue )
+{
+    m_pXmlWriter->writeTextElement( QLatin1String( pszName ),
+                                    QVariant( dValue ).toString() );
+}
+
+void XmlSerializer::AddDateTime( const char *pszName, const QDateTime &dtValue )
+{
+    m_pXmlWriter->writeStartElement( QLatin1String( pszName ));
+
+    if (dtValue.isNull())
+        m_pXmlWriter->writeAttribute( "xsi:nil", "true" );
+
+    m_pXmlWriter->writeCharacters(
+        MythDate::toString( dtValue, MythDate::ISODate ) );
+
+    m_pXmlWriter->writeEndElement();
+}
+
+void XmlSerializer::AddDate( const char *pszName, const QDate &dValue )
+{
+    m_pXmlWriter->writeTextElement( QLatin1String( pszName ),
+                                    dValue.toString( Qt::ISODate ));
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //
 //////////////////////////////////////////////////////////////////////////////
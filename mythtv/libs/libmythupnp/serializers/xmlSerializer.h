@@ -49,6 +49,15 @@ class UPNP_PUBLIC XmlSerializer : public Serializer
                                   const QMetaObject   *pMetaParent,
                                   const QMetaProperty *pMetaProp );
 
+        virtual bool HasFastPath() const { return true; }
+
+        virtual void AddString  ( const char *pszName, const QString   &sValue  );
+        virtual void AddInt     ( const char *pszName, qlonglong        nValue  );
+        virtual void AddBool    ( const char *pszName, bool             bValue  );
+        virtual void AddDouble  ( const char *pszName, double           dValue  );
+        virtual void AddDateTime( const char *pszName, const QDateTime &dtValue );
+        virtual void AddDate    ( const char *pszName, const QDate     &dValue  );
+
         void    RenderValue     ( const QString &sName, const QVariant     &vValue );
 
         void    RenderEnum      ( const QString       &sName ,
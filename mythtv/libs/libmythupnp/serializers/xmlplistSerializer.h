@@ -33,6 +33,9 @@ class UPNP_PUBLIC XmlPListSerializer : public XmlSerializer
                                              const QObject *pObject,
                                                    bool    needKey );
 
+        // The Add*() calls write XML elements, not plist key/value pairs
+        virtual bool HasFastPath() const { return false; }
+
     public:
                  XmlPListSerializer( QIODevice *pDevice );
         virtual ~XmlPListSerializer();
@@ -58,6 +58,9 @@ void UPnpCDSExtensionResults::Add( CDSObjects objects )
 QString UPnpCDSExtensionResults::GetResultXML(FilterMap &filter,
                                               bool ignoreChildren)
 {
+    if (!m_sResultXML.isEmpty())
+        return m_sResultXML;
+
     QString sXML;
 
     CDSObjects::const_iterator it = m_List.begin();
@@ -212,6 +215,34 @@ void UPnpCDS::RegisterFeature(UPnPFeature* feature)
     m_features.AddFeature(feature); // m_features takes ownership
 }
 
+/** \fn UPnpCDS::ProcessEvent(const QString&)
+ *  \brief Drops the cached trees of any extension whose content is changed
+ *         by the given backend event and tells subscribed clients.
+ */
+void UPnpCDS::ProcessEvent( const QString &sEvent )
+{
+    QStringList containers;
+
+    UPnpCDSExtensionList::iterator it = m_extensions.begin();
+    for (; it != m_extensions.end(); ++it)
+    {
+        if (!(*it)->IsCacheStale(sEvent))
+            continue;
+
+        (*it)->InvalidateCache();
+        containers << (*it)->m_sExtensionId
+                   << QString::number((*it)->GetUpdateId());
+    }
+
+    if (containers.isEmpty())
+        return;
+
+    uint16_t nId = GetValue<uint16_t>("SystemUpdateID");
+
+    SetValue< QString  >( "ContainerUpdateIDs", containers.join(",") );
+    SetValue< uint16_t >( "SystemUpdateID"    , nId + 1 );
+}
+
 /////////////////////////////////////////////////////////////////////////////
 //
 /////////////////////////////////////////////////////////////////////////////
@@ -788,6 +819,9 @@ void UPnpCDS::HandleGetServiceResetToken(HTTPRequest* pRequest)
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 
+// Upper bound on the number of CDSObjects held by each extension's cache
+const int UPnpCDSExtension::kMaxCachedObjects = 20000;
+
 UPnpCDSExtension::~UPnpCDSExtension()
 {
     if (m_pRoot)
@@ -801,6 +835,33 @@ UPnpCDSExtension::~UPnpCDSExtension()
 //
 /////////////////////////////////////////////////////////////////////////////
 
+UPnpCDSCacheEntry::UPnpCDSCacheEntry( const CDSObjects &objects )
+{
+    m_objects.reserve(objects.count());
+
+    CDSObjects::const_iterator it = objects.begin();
+    for (; it != objects.end(); ++it)
+    {
+        (*it)->IncrRef();
+        m_objects.append(*it);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+UPnpCDSCacheEntry::~UPnpCDSCacheEntry()
+{
+    QVector<CDSObject*>::iterator it = m_objects.begin();
+    for (; it != m_objects.end(); ++it)
+        (*it)->DecrRef();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
 bool UPnpCDSExtension::IsBrowseRequestForUs( UPnpCDSRequest *pRequest )
 {
     if (!pRequest->m_sObjectId.startsWith(m_sExtensionId, Qt::CaseSensitive))
@@ -822,6 +883,82 @@ UPnpCDSExtensionResults *UPnpCDSExtension::Browse( UPnpCDSRequest *pRequest )
     if (!IsBrowseRequestForUs( pRequest ))
         return( NULL );
 
+    QString sKey = QString("%1:%2").arg(pRequest->m_eBrowseFlag)
+                                   .arg(pRequest->m_sObjectId);
+
+    UPnpCDSExtensionResults *pResults = GetCachedResults(sKey, pRequest);
+
+    if (pResults != NULL)
+    {
+        LOG(VB_UPNP, LOG_DEBUG, QString("Browse (%1): '%2' served from cache")
+                                    .arg(m_sExtensionId)
+                                    .arg(pRequest->m_sObjectId));
+        return pResults;
+    }
+
+    // ----------------------------------------------------------------------
+    // Load the whole container once, later pages come from the cache
+    // ----------------------------------------------------------------------
+
+    uint16_t nUpdateId = GetUpdateId();
+
+    UPnpCDSRequest request = *pRequest;
+
+    if (request.m_eBrowseFlag == CDS_BrowseDirectChildren)
+    {
+        request.m_nStartingIndex  = 0;
+        request.m_nRequestedCount = UINT16_MAX;
+    }
+
+    pResults = LoadResults(&request);
+
+    if (pResults == NULL || pResults->m_eErrorCode != UPnPResult_Success)
+        return pResults;
+
+    // A list which was cut short by UINT16_MAX can't be paged from memory
+    if (pResults->m_nTotalMatches <= pResults->m_List.count())
+    {
+        m_cacheLock.lock();
+        // Don't keep a result that was loaded before an invalidation
+        if (nUpdateId == m_nUpdateId)
+            m_cache.insert(sKey, new UPnpCDSCacheEntry(pResults->m_List),
+                           pResults->m_List.count() + 1);
+        m_cacheLock.unlock();
+
+        UPnpCDSExtensionResults *pCached = GetCachedResults(sKey, pRequest);
+
+        if (pCached != NULL)
+        {
+            delete pResults;
+            return pCached;
+        }
+    }
+
+    // Not cached, either too big or invalidated meanwhile, so trim the
+    // full list down to the page which was asked for
+    if (pRequest->m_eBrowseFlag == CDS_BrowseDirectChildren)
+    {
+        int nStart = qMin(int(pRequest->m_nStartingIndex),
+                          pResults->m_List.count());
+
+        while (nStart-- > 0)
+            pResults->m_List.takeFirst()->DecrRef();
+
+        while (pResults->m_List.count() > pRequest->m_nRequestedCount)
+            pResults->m_List.takeLast()->DecrRef();
+    }
+
+    pResults->m_nUpdateID = nUpdateId;
+
+    return pResults;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+UPnpCDSExtensionResults *UPnpCDSExtension::LoadResults( UPnpCDSRequest *pRequest )
+{
     // ----------------------------------------------------------------------
     // Split the request ID into token key/value
     //
@@ -890,6 +1027,114 @@ UPnpCDSExtensionResults *UPnpCDSExtension::Browse( UPnpCDSRequest *pRequest )
 //
 /////////////////////////////////////////////////////////////////////////////
 
+UPnpCDSExtensionResults *UPnpCDSExtension::GetCachedResults(
+    const QString &sKey, const UPnpCDSRequest *pRequest )
+{
+    UPnpCDSExtensionResults *pResults = NULL;
+    QVector<QString>         fragments;
+    uint16_t                 nUpdateId;
+    int                      nStart;
+
+    {
+        QMutexLocker locker(&m_cacheLock);
+
+        UPnpCDSCacheEntry *pEntry = m_cache.object(sKey);
+
+        if (pEntry == NULL)
+            return NULL;
+
+        int nTotal = pEntry->m_objects.size();
+        nStart     = 0;
+
+        // StartingIndex only applies to BrowseDirectChildren
+        if (pRequest->m_eBrowseFlag == CDS_BrowseDirectChildren)
+            nStart = qMin(int(pRequest->m_nStartingIndex), nTotal);
+
+        int nCount = qMin(int(pRequest->m_nRequestedCount), nTotal - nStart);
+
+        pResults = new UPnpCDSExtensionResults();
+        pResults->m_nTotalMatches = nTotal;
+        pResults->m_nUpdateID     = m_nUpdateId;
+
+        for (int i = nStart; i < nStart + nCount; ++i)
+            pResults->Add(pEntry->m_objects[i]);
+
+        fragments = pEntry->m_fragments.value(pRequest->m_sFilter)
+                                       .mid(nStart, nCount);
+        nUpdateId = m_nUpdateId;
+    }
+
+    // ----------------------------------------------------------------------
+    // Render the objects we haven't seen with this filter yet, outside
+    // the lock, then remember them for the next client
+    // ----------------------------------------------------------------------
+
+    FilterMap filter = static_cast<FilterMap>(pRequest->m_sFilter.split(','));
+    bool      bIgnoreChildren = (pRequest->m_eBrowseFlag == CDS_BrowseMetadata);
+    bool      bRendered = false;
+
+    fragments.resize(pResults->m_List.count());
+
+    for (int i = 0; i < pResults->m_List.count(); ++i)
+    {
+        if (fragments[i].isEmpty())
+        {
+            fragments[i] = pResults->m_List[i]->toXml(filter, bIgnoreChildren);
+            bRendered = true;
+        }
+
+        pResults->m_sResultXML += fragments[i];
+    }
+
+    if (bRendered)
+    {
+        QMutexLocker locker(&m_cacheLock);
+
+        UPnpCDSCacheEntry *pEntry = m_cache.object(sKey);
+
+        if (pEntry != NULL && nUpdateId == m_nUpdateId)
+        {
+            QVector<QString> &cached = pEntry->m_fragments[pRequest->m_sFilter];
+            cached.resize(pEntry->m_objects.size());
+
+            for (int i = 0; i < fragments.size(); ++i)
+                cached[nStart + i] = fragments[i];
+        }
+    }
+
+    return pResults;
+}
+
+/** \fn UPnpCDSExtension::InvalidateCache(void)
+ *  \brief Throws away every cached Browse result and bumps our update id,
+ *         called when the backend tells us the content has changed.
+ */
+void UPnpCDSExtension::InvalidateCache( void )
+{
+    QMutexLocker locker(&m_cacheLock);
+
+    m_cache.clear();
+    m_nUpdateId++;
+
+    LOG(VB_UPNP, LOG_INFO, QString("UPnpCDSExtension(%1): Cache invalidated, "
+                                   "UpdateID %2")
+                               .arg(m_sExtensionId).arg(m_nUpdateId));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+uint16_t UPnpCDSExtension::GetUpdateId( void )
+{
+    QMutexLocker locker(&m_cacheLock);
+    return m_nUpdateId;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
 bool UPnpCDSExtension::IsSearchRequestForUs( UPnpCDSRequest *pRequest )
 {
     if ( !m_sClass.startsWith( pRequest->m_sSearchClass ))
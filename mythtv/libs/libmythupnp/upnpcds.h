@@ -15,6 +15,10 @@
 
 #include <QList>
 #include <QMap>
+#include <QHash>
+#include <QCache>
+#include <QMutex>
+#include <QVector>
 #include <QString>
 #include <QObject>
 
@@ -117,6 +121,9 @@ class UPNP_PUBLIC UPnpCDSExtensionResults
         uint16_t                m_nTotalMatches;
         uint16_t                m_nUpdateID;
 
+        // Pre-rendered DIDL-Lite for m_List, used in place of toXml() when set
+        QString                 m_sResultXML;
+
     public:
 
         UPnpCDSExtensionResults() : m_eErrorCode( UPnPResult_Success ),
@@ -207,6 +214,26 @@ typedef QMap<UPnPShortcutFeature::ShortCutType, QString> CDSShortCutList;
 typedef QMap<QString, QString> IDTokenMap;
 typedef QPair<QString, QString> IDToken;
 
+/**
+ * \brief The complete result of one Browse, kept by the extension so that
+ *        every page of the same container is served from memory.
+ *
+ * The DIDL-Lite fragment of each object is rendered the first time a page
+ * containing it is requested and kept per filter string.
+ */
+class UPNP_PUBLIC UPnpCDSCacheEntry
+{
+    public:
+
+        QVector<CDSObject*>               m_objects;
+        QHash<QString, QVector<QString> > m_fragments;
+
+    public:
+
+        explicit UPnpCDSCacheEntry( const CDSObjects &objects );
+        ~UPnpCDSCacheEntry();
+};
+
 class UPNP_PUBLIC UPnpCDSExtension
 {
     public:
@@ -253,13 +280,25 @@ class UPNP_PUBLIC UPnpCDSExtension
                                       const QString &Name,
                                       const QString &Value );
 
+        UPnpCDSExtensionResults *LoadResults   ( UPnpCDSRequest *pRequest );
+        UPnpCDSExtensionResults *GetCachedResults( const QString &sKey,
+                                                   const UPnpCDSRequest *pRequest );
+
         CDSObject *m_pRoot;
 
+    private:
+
+        QMutex                                 m_cacheLock;
+        QCache<QString, UPnpCDSCacheEntry>     m_cache;
+        uint16_t                               m_nUpdateId;
+
     public:
 
         UPnpCDSExtension( QString sName, 
                           QString sExtensionId, 
-                          QString sClass ) : m_pRoot(NULL)
+                          QString sClass ) : m_pRoot(NULL),
+                                             m_cache(kMaxCachedObjects),
+                                             m_nUpdateId(0)
         {
             m_sName        = QObject::tr(sName.toLatin1().constData());
             m_sExtensionId = sExtensionId;
@@ -273,6 +312,14 @@ class UPNP_PUBLIC UPnpCDSExtension
         virtual UPnpCDSExtensionResults *Browse( UPnpCDSRequest *pRequest );
         virtual UPnpCDSExtensionResults *Search( UPnpCDSRequest *pRequest );
 
+        /// Returns true if the backend event means our content has changed
+        virtual bool            IsCacheStale( const QString & /*sEvent*/ )
+                                                            { return false; }
+        void                    InvalidateCache( void );
+        uint16_t                GetUpdateId    ( void );
+
+        static const int        kMaxCachedObjects;
+
         virtual QString         GetSearchCapabilities() { return( "" ); }
         virtual QString         GetSortCapabilities  () { return( "" ); }
         virtual CDSShortCutList GetShortCuts         () { return m_shortcuts; }
@@ -337,6 +384,8 @@ class UPNP_PUBLIC UPnpCDS : public Eventing
                                       const QString &objectID );
         void     RegisterFeature    ( UPnPFeature *feature );
 
+        void     ProcessEvent       ( const QString &sEvent );
+
         virtual QStringList GetBasePaths();
         
         virtual bool ProcessRequest( HTTPRequest *pRequest );
@@ -8,6 +8,7 @@
 #include "mythsocket.h"
 #include "programinfo.h"
 #include "mythlogging.h"
+#include "mthread.h"
 
 FileTransfer::FileTransfer(QString &filename, MythSocket *remote,
                            bool usereadahead, int timeout_ms) :
@@ -15,7 +16,8 @@ FileTransfer::FileTransfer(QString &filename, MythSocket *remote,
     readthreadlive(true), readsLocked(false),
     rbuffer(RingBuffer::Create(filename, false, usereadahead, timeout_ms, true)),
     sock(remote), ateof(false), lock(QMutex::NonRecursive),
-    writemode(false)
+    writemode(false), streamThread(NULL), streaming(false),
+    streamEOF(false), streamSent(0), streamLimit(0)
 {
     pginfo = new ProgramInfo(filename);
     pginfo->MarkAsInUse(true, kFileTransferInUseID);
@@ -27,7 +29,8 @@ FileTransfer::FileTransfer(QString &filename, MythSocket *remote, bool write) :
     readthreadlive(true), readsLocked(false),
     rbuffer(RingBuffer::Create(filename, write)),
     sock(remote), ateof(false), lock(QMutex::NonRecursive),
-    writemode(write)
+    writemode(write), streamThread(NULL), streaming(false),
+    streamEOF(false), streamSent(0), streamLimit(0)
 {
     pginfo = new ProgramInfo(filename);
     pginfo->MarkAsInUse(true, kFileTransferInUseID);
@@ -41,6 +44,13 @@ FileTransfer::~FileTransfer()
 {
     Stop();
 
+    if (streamThread)
+    {
+        streamThread->wait();
+        delete streamThread;
+        streamThread = NULL;
+    }
+
     if (sock) // FileTransfer becomes responsible for deleting the socket
         sock->DecrRef();
 
@@ -85,6 +95,7 @@ void FileTransfer::Stop(void)
         QMutexLocker locker(&lock);
         readsLocked = true;
     }
+    streamCond.wakeAll();
 
     if (writemode)
         rbuffer->WriterFlush();
@@ -221,7 +232,8 @@ int FileTransfer::WriteBlock(int size)
     return (ret < 0) ? -1 : tot;
 }
 
-long long FileTransfer::Seek(long long curpos, long long pos, int whence)
+long long FileTransfer::Seek(long long curpos, long long pos, int whence,
+                            long long *streamed)
 {
     if (pginfo)
         pginfo->UpdateInUseMark();
@@ -245,7 +257,17 @@ long long FileTransfer::Seek(long long curpos, long long pos, int whence)
 
     long long ret = rbuffer->Seek(pos, whence);
 
+    // Nothing is streamed while paused, so everything sent up to
+    // here came from before the seek.
+    if (streamed)
+    {
+        QMutexLocker locker(&streamLock);
+        *streamed = streamSent;
+        streamEOF = false;
+    }
+
     Unpause();
+    streamCond.wakeAll();
 
     if (pginfo)
         pginfo->UpdateInUseMark();
@@ -253,6 +275,157 @@ long long FileTransfer::Seek(long long curpos, long long pos, int whence)
     return ret;
 }
 
+/** \fn FileTransfer::RequestStream(long long)
+ *  \brief Starts writing the file to the data socket continuously, instead
+ *         of a block per REQUEST_BLOCK.
+ *
+ *   The client gives credit as the total number of bytes it will take
+ *   since the stream started, limit here and then in AddStreamCredit(),
+ *   which keeps the data in flight within its window.
+ */
+bool FileTransfer::RequestStream(long long limit)
+{
+    if (writemode || !rbuffer || !readthreadlive)
+        return false;
+
+    if (pginfo)
+        pginfo->UpdateInUseMark();
+
+    QMutexLocker locker(&streamLock);
+    if (streaming)
+    {
+        streamLimit = max(streamLimit, limit);
+        streamCond.wakeAll();
+        return true;
+    }
+
+    if (streamThread)
+        streamThread->wait();
+    else
+        streamThread = new MThread("FileTransferStream", this);
+
+    streaming   = true;
+    streamEOF   = false;
+    streamSent  = 0;
+    streamLimit = limit;
+    streamThread->start();
+
+    return true;
+}
+
+/// Credit only ever grows, so credits handled out of order do no harm
+void FileTransfer::AddStreamCredit(long long limit)
+{
+    QMutexLocker locker(&streamLock);
+    if (limit > streamLimit)
+    {
+        streamLimit = limit;
+        streamCond.wakeAll();
+    }
+}
+
+/// Stops streaming and returns the number of bytes that were streamed
+long long FileTransfer::StopStream(void)
+{
+    {
+        QMutexLocker locker(&streamLock);
+        if (!streaming)
+            return streamSent;
+        streaming = false;
+        streamCond.wakeAll();
+    }
+
+    // Interrupt a read waiting on the file to grow
+    Pause();
+    if (streamThread)
+        streamThread->wait();
+    if (readthreadlive)
+        Unpause();
+
+    QMutexLocker locker(&streamLock);
+    return streamSent;
+}
+
+/// Returns the number of bytes streamed, ateof is set once the stream
+/// is waiting at the end of the file.
+long long FileTransfer::GetStreamStatus(bool &ateof)
+{
+    if (pginfo)
+        pginfo->UpdateInUseMark();
+
+    QMutexLocker locker(&streamLock);
+    ateof = streamEOF;
+    return streamSent;
+}
+
+bool FileTransfer::IsStreaming(void)
+{
+    QMutexLocker locker(&streamLock);
+    return streaming;
+}
+
+void FileTransfer::run(void)
+{
+    while (true)
+    {
+        int request;
+        {
+            QMutexLocker locker(&streamLock);
+            if (!streaming || !readthreadlive)
+                break;
+            if (streamSent >= streamLimit)
+            {
+                streamCond.wait(&streamLock, 100 /*ms*/);
+                continue;
+            }
+            request = (int) min((long long)kStreamChunk,
+                                streamLimit - streamSent);
+        }
+
+        QMutexLocker locker(&lock);
+        if (readsLocked)
+        {
+            readsUnlockedCond.wait(&lock, 100 /*ms*/);
+            continue;
+        }
+
+        streamBuffer.resize(kStreamChunk);
+        int ret = rbuffer->Read(&streamBuffer[0], request);
+
+        if (ret <= 0)
+        {
+            bool stopped = rbuffer->GetStopReads();
+            locker.unlock();
+
+            QMutexLocker slocker(&streamLock);
+            if (ret < 0)
+            {
+                LOG(VB_FILE, LOG_ERR, "FileTransfer: Stream read failed");
+                streaming = false;
+                break;
+            }
+            streamEOF = !stopped;
+            streamCond.wait(&streamLock, 100 /*ms*/);
+            continue;
+        }
+
+        if (sock->Write(&streamBuffer[0], (uint)ret) != ret)
+        {
+            LOG(VB_FILE, LOG_ERR, "FileTransfer: Stream write failed");
+            QMutexLocker slocker(&streamLock);
+            streaming = false;
+            break;
+        }
+
+        QMutexLocker slocker(&streamLock);
+        streamSent += ret;
+        streamEOF = false;
+    }
+
+    if (pginfo)
+        pginfo->UpdateInUseMark();
+}
+
 uint64_t FileTransfer::GetFileSize(void)
 {
     if (pginfo)
@@ -10,6 +10,7 @@ using namespace std;
 
 // Qt headers
 #include <QMutex>
+#include <QRunnable>
 #include <QWaitCondition>
 
 // MythTV headers
@@ -18,9 +19,10 @@ using namespace std;
 class ProgramInfo;
 class RingBuffer;
 class MythSocket;
+class MThread;
 class QString;
 
-class FileTransfer : public ReferenceCounter
+class FileTransfer : public ReferenceCounter, public QRunnable
 {
     friend class QObject; // quiet OSX gcc warning
 
@@ -41,7 +43,14 @@ class FileTransfer : public ReferenceCounter
     int RequestBlock(int size);
     int WriteBlock(int size);
 
-    long long Seek(long long curpos, long long pos, int whence);
+    long long Seek(long long curpos, long long pos, int whence,
+                   long long *streamed = NULL);
+
+    bool RequestStream(long long limit);
+    void AddStreamCredit(long long limit);
+    long long StopStream(void);
+    long long GetStreamStatus(bool &ateof);
+    bool IsStreaming(void);
 
     uint64_t GetFileSize(void);
     QString GetFileName(void);
@@ -51,6 +60,8 @@ class FileTransfer : public ReferenceCounter
   private:
    ~FileTransfer();
 
+    void run(void); // QRunnable
+
     volatile bool  readthreadlive;
     bool           readsLocked;
     QWaitCondition readsUnlockedCond;
@@ -65,6 +76,18 @@ class FileTransfer : public ReferenceCounter
     QMutex lock;
 
     bool writemode;
+
+    // Streaming, the data socket is written by streamThread
+    MThread       *streamThread;
+    vector<char>   streamBuffer;
+    QMutex         streamLock;
+    QWaitCondition streamCond;
+    bool           streaming;
+    bool           streamEOF;
+    long long      streamSent;  ///< bytes written since RequestStream()
+    long long      streamLimit; ///< total the client has given credit for
+
+    static const int kStreamChunk = 64 * 1024;
 };
 
 #endif
@@ -0,0 +1,611 @@
+// C++ headers
+#include <algorithm>
+#include <climits>
+using namespace std;
+
+// Qt headers
+#include <QStringList>
+
+// MythTV headers
+#include "guideindex.h"
+#include "mythlogging.h"
+#include "mythtimer.h"
+#include "mythdbcon.h"
+#include "mythdate.h"
+
+#define LOC QString("GuideIndex: ")
+
+QMutex      GuideIndex::s_lock;
+GuideIndex *GuideIndex::s_index = NULL;
+
+GuideIndex *GuideIndex::GetIndex(void)
+{
+    QMutexLocker locker(&s_lock);
+    if (!s_index)
+        s_index = new GuideIndex();
+    return s_index;
+}
+
+GuideIndex::~GuideIndex()
+{
+    QWriteLocker locker(&m_lock);
+    qDeleteAll(m_channels);
+    m_channels.clear();
+}
+
+uint GuideIndex::SliceOf(const QDateTime &dt)
+{
+    return dt.toTime_t() / kSliceSecs;
+}
+
+bool GuideIndex::IsFresh(const GuideIndexChannel *chan,
+                         const QDateTime &now) const
+{
+    return chan && chan->loaded.isValid() &&
+        chan->loaded.secsTo(now) < kMaxAgeSecs;
+}
+
+/** \brief Makes sure the listings of the given channels starting from
+ *         start are in the index.
+ *
+ *  Any missing or stale channels are loaded with a single query.
+ *  \param cacheHit set if nothing had to be loaded
+ *  \return false if the index can not serve this window, the caller
+ *          should query the database itself.
+ */
+bool GuideIndex::Prefetch(const QList<uint> &chanids, const QDateTime &start,
+                          bool &cacheHit)
+{
+    cacheHit = false;
+
+    QDateTime now = MythDate::current();
+    if (start < now.addSecs(-kHistorySecs))
+        return false;
+
+    QList<uint> needed;
+    {
+        QReadLocker locker(&m_lock);
+        QList<uint>::const_iterator it = chanids.begin();
+        for (; it != chanids.end(); ++it)
+        {
+            if (!IsFresh(m_channels.value(*it), now))
+                needed.push_back(*it);
+        }
+    }
+
+    if (needed.empty())
+    {
+        cacheHit = true;
+        return true;
+    }
+
+    return Load(needed);
+}
+
+/** \brief Copies the listings of chanid overlapping [start, end) into
+ *         destination, in the same way Guide::GetProgramGuide() selects
+ *         them from the program table.
+ *
+ *  Call Prefetch() for the channels first.
+ */
+bool GuideIndex::GetPrograms(uint chanid, const QDateTime &start,
+                             const QDateTime &end, const ProgramList &schedList,
+                             ProgramList &destination)
+{
+    destination.clear();
+
+    QReadLocker locker(&m_lock);
+
+    // A channel emptied by Invalidate() since Prefetch() is a miss too
+    const GuideIndexChannel *chan = m_channels.value(chanid);
+    if (!chan || !chan->loaded.isValid() || start < chan->from)
+        return false;
+
+    QDateTime startLimit = start.addDays(-1);
+    uint lastSlice = SliceOf(end);
+
+    QMap<uint, QVector<GuideIndexEntry> >::const_iterator it =
+        chan->slices.lowerBound(SliceOf(startLimit));
+    for (; it != chan->slices.end() && it.key() <= lastSlice; ++it)
+    {
+        QVector<GuideIndexEntry>::const_iterator eit = (*it).begin();
+        for (; eit != (*it).end(); ++eit)
+        {
+            if ((*eit).endtime < start || (*eit).starttime >= end ||
+                (*eit).starttime < startLimit)
+            {
+                continue;
+            }
+            destination.push_back(NewProgramInfo(*chan, *eit, schedList));
+        }
+    }
+
+    return true;
+}
+
+class GuideIndexMatch
+{
+  public:
+    GuideIndexMatch() : chan(NULL), entry(NULL) {}
+    GuideIndexMatch(const GuideIndexChannel *c, const GuideIndexEntry *e) :
+        chan(c), entry(e) {}
+
+    const GuideIndexChannel *chan;
+    const GuideIndexEntry   *entry;
+};
+
+static bool match_starttime(const GuideIndexMatch &a, const GuideIndexMatch &b)
+{
+    return a.entry->starttime < b.entry->starttime;
+}
+
+static bool match_title(const GuideIndexMatch &a, const GuideIndexMatch &b)
+{
+    return QString::compare(a.entry->title, b.entry->title,
+                            Qt::CaseInsensitive) < 0;
+}
+
+static bool match_channel(const GuideIndexMatch &a, const GuideIndexMatch &b)
+{
+    return a.chan->channum < b.chan->channum;
+}
+
+static bool match_duration(const GuideIndexMatch &a, const GuideIndexMatch &b)
+{
+    return a.entry->starttime.secsTo(a.entry->endtime) <
+        b.entry->starttime.secsTo(b.entry->endtime);
+}
+
+static bool is_like_pattern(const QString &str)
+{
+    return str.contains('%') || str.contains('_');
+}
+
+/** \brief Finds listings as Guide::GetProgramList() does without a
+ *         person filter.
+ *
+ *  \return false if the filter can not be handled by the index, the
+ *          caller should query the database itself.
+ */
+bool GuideIndex::Search(const GuideIndexFilter &filter,
+                        const ProgramList &schedList,
+                        uint start, uint limit, ProgramList &destination,
+                        uint &totalAvailable, bool &cacheHit)
+{
+    destination.clear();
+    totalAvailable = 0;
+    cacheHit = false;
+
+    // LIKE wildcards in the filters are left to the database
+    if (is_like_pattern(filter.title) || is_like_pattern(filter.category) ||
+        is_like_pattern(filter.keyword))
+    {
+        return false;
+    }
+
+    QDateTime now = MythDate::current();
+    if (filter.startTime < now.addSecs(-kHistorySecs))
+        return false;
+
+    if (filter.chanid)
+    {
+        if (!Prefetch(QList<uint>() << filter.chanid, filter.startTime,
+                      cacheHit))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        bool loadAll = false;
+        QList<uint> needed;
+        {
+            QReadLocker locker(&m_lock);
+            if (!m_allLoaded || m_allLoadedTime.secsTo(now) >= kMaxAgeSecs)
+            {
+                loadAll = true;
+            }
+            else
+            {
+                // Channels dropped by Invalidate() since the last full load
+                QHash<uint, GuideIndexChannel*>::const_iterator it;
+                for (it = m_channels.begin(); it != m_channels.end(); ++it)
+                {
+                    if (!(*it)->loaded.isValid())
+                        needed.push_back(it.key());
+                }
+            }
+        }
+
+        if (loadAll)
+        {
+            if (!Load(QList<uint>()))
+                return false;
+        }
+        else if (!needed.empty())
+        {
+            if (!Load(needed))
+                return false;
+        }
+        else
+        {
+            cacheHit = true;
+        }
+    }
+
+    QReadLocker locker(&m_lock);
+
+    QList<const GuideIndexChannel*> channels;
+    if (filter.chanid)
+        channels.push_back(m_channels.value(filter.chanid));
+    else
+    {
+        QHash<uint, GuideIndexChannel*>::const_iterator it;
+        for (it = m_channels.begin(); it != m_channels.end(); ++it)
+            channels.push_back(*it);
+    }
+
+    uint lastSlice = filter.endTime.isValid() ?
+        SliceOf(filter.endTime) : UINT_MAX;
+
+    QVector<GuideIndexMatch> matches;
+    QList<const GuideIndexChannel*>::const_iterator cit = channels.begin();
+    for (; cit != channels.end(); ++cit)
+    {
+        const GuideIndexChannel *chan = *cit;
+        if (!chan || !chan->visible)
+            continue;
+
+        // Listings are loaded by end time, so any slice may hold a
+        // listing still running at the start of the search.
+        QMap<uint, QVector<GuideIndexEntry> >::const_iterator it =
+            chan->slices.begin();
+        for (; it != chan->slices.end() && it.key() <= lastSlice; ++it)
+        {
+            QVector<GuideIndexEntry>::const_iterator eit = (*it).begin();
+            for (; eit != (*it).end(); ++eit)
+            {
+                const GuideIndexEntry &e = *eit;
+                if (e.endtime < filter.startTime)
+                    continue;
+                if (filter.endTime.isValid() && e.starttime > filter.endTime)
+                    continue;
+                if (!filter.title.isEmpty() &&
+                    !e.title.contains(filter.title, Qt::CaseInsensitive))
+                    continue;
+                if (!filter.category.isEmpty() &&
+                    QString::compare(e.category, filter.category,
+                                     Qt::CaseInsensitive) != 0)
+                    continue;
+                if (!filter.keyword.isEmpty() &&
+                    !e.title.contains(filter.keyword, Qt::CaseInsensitive) &&
+                    !e.subtitle.contains(filter.keyword, Qt::CaseInsensitive) &&
+                    !e.description.contains(filter.keyword,
+                                            Qt::CaseInsensitive))
+                    continue;
+
+                matches.push_back(GuideIndexMatch(chan, &e));
+            }
+        }
+    }
+
+    // Channels are kept in a hash, so always order by start time first
+    stable_sort(matches.begin(), matches.end(), match_starttime);
+    if (filter.sort == "title")
+        stable_sort(matches.begin(), matches.end(), match_title);
+    else if (filter.sort == "channel")
+        stable_sort(matches.begin(), matches.end(), match_channel);
+    else if (filter.sort == "duration")
+        stable_sort(matches.begin(), matches.end(), match_duration);
+    if (filter.descending)
+        reverse(matches.begin(), matches.end());
+
+    totalAvailable = matches.size();
+
+    // Same hard limit as LoadFromProgram()
+    uint count = limit ? limit : 20000;
+    uint end   = totalAvailable;
+    if (start >= totalAvailable)
+        end = start;
+    else if (totalAvailable - start > count)
+        end = start + count;
+
+    for (uint i = start; i < end; ++i)
+    {
+        destination.push_back(
+            NewProgramInfo(*matches[i].chan, *matches[i].entry, schedList));
+    }
+
+    return true;
+}
+
+/** \brief Drops the channels of a video source, or a single multiplex of
+ *         it, so they are read again the next time they are needed.
+ *
+ *  A sourceid of 0 drops everything.
+ */
+void GuideIndex::Invalidate(uint sourceid, uint mplexid)
+{
+    int dropped = 0;
+    {
+        QWriteLocker locker(&m_lock);
+
+        m_generation++;
+
+        if (!sourceid)
+        {
+            dropped = m_channels.size();
+            qDeleteAll(m_channels);
+            m_channels.clear();
+            m_allLoaded = false;
+        }
+        else
+        {
+            // Keep an empty channel behind so a search knows to reload it
+            QHash<uint, GuideIndexChannel*>::iterator it = m_channels.begin();
+            for (; it != m_channels.end(); ++it)
+            {
+                GuideIndexChannel *chan = *it;
+                if (chan->sourceid != sourceid ||
+                    (mplexid && chan->mplexid != mplexid) ||
+                    !chan->loaded.isValid())
+                {
+                    continue;
+                }
+
+                GuideIndexChannel *empty = new GuideIndexChannel(chan->chanid);
+                empty->sourceid = chan->sourceid;
+                empty->mplexid  = chan->mplexid;
+                *it = empty;
+                delete chan;
+                dropped++;
+            }
+        }
+    }
+
+    LOG(VB_SCHEDULE, LOG_DEBUG, LOC +
+        QString("Dropped %1 channels for source %2 multiplex %3")
+        .arg(dropped).arg(sourceid).arg(mplexid));
+
+    QMutexLocker locker(&m_statsLock);
+    m_stats.invalidations++;
+}
+
+/** \brief Reads the listings of the given channels, or all channels if
+ *         the list is empty, into the index.
+ *
+ *  The query runs without holding the index lock. If Invalidate() is
+ *  called meanwhile the results are thrown away and false is returned.
+ */
+bool GuideIndex::Load(const QList<uint> &chanids)
+{
+    uint generation;
+    {
+        QReadLocker locker(&m_lock);
+        generation = m_generation;
+    }
+
+    QDateTime now  = MythDate::current();
+    QDateTime from = now.addSecs(-kHistorySecs);
+
+    QString querystr =
+        "SELECT program.chanid, program.starttime, program.endtime, "
+        "       program.title, program.subtitle, program.description, "
+        "       program.category, channel.channum, channel.callsign, "
+        "       channel.name, program.previouslyshown, channel.commmethod, "
+        "       channel.outputfilters, program.seriesid, program.programid, "
+        "       program.airdate, program.stars, program.originalairdate, "
+        "       program.category_type, oldrecstatus.recordid, "
+        "       oldrecstatus.rectype, oldrecstatus.recstatus, "
+        "       oldrecstatus.findid, program.videoprop+0, "
+        "       program.audioprop+0, program.subtitletypes+0, "
+        "       program.syndicatedepisodenumber, program.partnumber, "
+        "       program.parttotal, program.season, program.episode, "
+        "       program.totalepisodes, channel.visible, channel.sourceid, "
+        "       channel.mplexid "
+        "FROM program "
+        "LEFT JOIN channel ON program.chanid = channel.chanid "
+        "LEFT JOIN oldrecorded AS oldrecstatus ON "
+        "    oldrecstatus.future = 0 AND "
+        "    program.title = oldrecstatus.title AND "
+        "    channel.callsign = oldrecstatus.station AND "
+        "    program.starttime = oldrecstatus.starttime "
+        "WHERE program.endtime >= :FROM AND "
+        "      program.manualid = 0 ";
+
+    if (!chanids.empty())
+    {
+        QStringList ids;
+        QList<uint>::const_iterator it = chanids.begin();
+        for (; it != chanids.end(); ++it)
+            ids.push_back(QString::number(*it));
+        querystr += QString("AND program.chanid IN (%1) ").arg(ids.join(","));
+    }
+
+    querystr += "ORDER BY program.chanid, program.starttime";
+
+    MythTimer t;
+    t.start();
+
+    MSqlQuery query(MSqlQuery::InitCon());
+    query.setForwardOnly(true);
+    query.prepare(querystr);
+    query.bindValue(":FROM", from);
+
+    if (!query.exec())
+    {
+        MythDB::DBError("GuideIndex::Load", query);
+        return false;
+    }
+
+    QHash<uint, GuideIndexChannel*> loaded;
+    QHash<QString, QString> categories;
+    GuideIndexChannel *chan = NULL;
+    int programs = 0;
+
+    while (query.next())
+    {
+        uint chanid = query.value(0).toUInt();
+        if (!chan || chan->chanid != chanid)
+        {
+            chan = new GuideIndexChannel(chanid);
+            chan->channum         = query.value(7).toString();
+            chan->callsign        = query.value(8).toString();
+            chan->name            = query.value(9).toString();
+            chan->commfree        =
+                query.value(11).toInt() == COMM_DETECT_COMMFREE;
+            chan->playbackfilters = query.value(12).toString();
+            chan->visible         = query.value(32).toInt() != 0;
+            chan->sourceid        = query.value(33).toUInt();
+            chan->mplexid         = query.value(34).toUInt();
+            chan->loaded          = now;
+            chan->from            = from;
+            loaded[chanid] = chan;
+        }
+
+        GuideIndexEntry e;
+        e.starttime         = MythDate::as_utc(query.value(1).toDateTime());
+        e.endtime           = MythDate::as_utc(query.value(2).toDateTime());
+        e.title             = query.value(3).toString();
+        e.subtitle          = query.value(4).toString();
+        e.description       = query.value(5).toString();
+        e.repeat            = query.value(10).toInt();
+        e.seriesid          = query.value(13).toString();
+        e.programid         = query.value(14).toString();
+        e.year              = query.value(15).toUInt();
+        e.stars             = query.value(16).toDouble();
+        e.originalairdate   = query.value(17).toDate();
+        e.catType           =
+            string_to_myth_category_type(query.value(18).toString());
+        e.recordid          = query.value(19).toUInt();
+        e.rectype           = RecordingType(query.value(20).toInt());
+        e.recstatus         = RecStatus::Type(query.value(21).toInt());
+        e.findid            = query.value(22).toUInt();
+        e.videoprops        = query.value(23).toInt();
+        e.audioprops        = query.value(24).toInt();
+        e.subtitletypes     = query.value(25).toInt();
+        e.syndicatedepisode = query.value(26).toString();
+        e.partnumber        = query.value(27).toUInt();
+        e.parttotal         = query.value(28).toUInt();
+        e.season            = query.value(29).toUInt();
+        e.episode           = query.value(30).toUInt();
+        e.totalepisodes     = query.value(31).toUInt();
+
+        // There are only a few hundred categories, share their strings
+        QString category = query.value(6).toString();
+        QHash<QString, QString>::const_iterator cit =
+            categories.find(category);
+        if (cit == categories.end())
+            cit = categories.insert(category, category);
+        e.category = *cit;
+
+        chan->slices[SliceOf(e.starttime)].push_back(e);
+        chan->count++;
+        programs++;
+    }
+
+    // Channels without listings are still worth remembering
+    QList<uint>::const_iterator it = chanids.begin();
+    for (; it != chanids.end(); ++it)
+    {
+        if (!loaded.contains(*it))
+        {
+            chan = new GuideIndexChannel(*it);
+            chan->loaded = now;
+            chan->from   = from;
+            loaded[*it]  = chan;
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+
+    if (generation != m_generation)
+    {
+        LOG(VB_SCHEDULE, LOG_INFO, LOC +
+            "Listings changed while loading, discarding them");
+        qDeleteAll(loaded);
+        return false;
+    }
+
+    if (chanids.empty())
+    {
+        qDeleteAll(m_channels);
+        m_channels = loaded;
+        m_allLoaded = true;
+        m_allLoadedTime = now;
+    }
+    else
+    {
+        QHash<uint, GuideIndexChannel*>::iterator lit = loaded.begin();
+        for (; lit != loaded.end(); ++lit)
+        {
+            delete m_channels.value(lit.key());
+            m_channels[lit.key()] = *lit;
+        }
+    }
+
+    LOG(VB_SCHEDULE, LOG_INFO, LOC +
+        QString("Loaded %1 listings on %2 channels in %3 ms")
+        .arg(programs).arg(loaded.size()).arg(t.elapsed()));
+
+    return true;
+}
+
+ProgramInfo *GuideIndex::NewProgramInfo(const GuideIndexChannel &chan,
+                                        const GuideIndexEntry &e,
+                                        const ProgramList &schedList)
+{
+    return new ProgramInfo(
+        e.title, e.subtitle, e.description, e.syndicatedepisode, e.category,
+
+        chan.chanid, chan.channum, chan.callsign, chan.name,
+        chan.playbackfilters,
+
+        e.starttime, e.endtime, e.starttime, e.endtime,
+
+        e.seriesid, e.programid, e.catType,
+
+        e.stars, e.year, e.partnumber, e.parttotal, e.originalairdate,
+        e.recstatus, e.recordid, e.rectype, e.findid,
+
+        chan.commfree, e.repeat,
+
+        e.videoprops, e.audioprops, e.subtitletypes,
+
+        e.season, e.episode, e.totalepisodes,
+
+        schedList);
+}
+
+void GuideIndex::RecordRequest(bool indexed, bool cacheHit, qint64 latencyUS)
+{
+    QMutexLocker locker(&m_statsLock);
+    m_stats.requests++;
+    if (!indexed)
+        m_stats.fallbacks++;
+    else if (cacheHit)
+        m_stats.hits++;
+    else
+        m_stats.misses++;
+    m_stats.totalLatencyUS += latencyUS;
+    m_stats.maxLatencyUS    = max(m_stats.maxLatencyUS, latencyUS);
+}
+
+GuideIndexStats GuideIndex::GetStats(void) const
+{
+    GuideIndexStats stats;
+    {
+        QMutexLocker locker(&m_statsLock);
+        stats = m_stats;
+    }
+
+    QReadLocker locker(&m_lock);
+    stats.channels = m_channels.size();
+    QHash<uint, GuideIndexChannel*>::const_iterator it = m_channels.begin();
+    for (; it != m_channels.end(); ++it)
+        stats.programs += (*it)->count;
+
+    return stats;
+}
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
@@ -0,0 +1,181 @@
+#ifndef _GUIDEINDEX_H_
+#define _GUIDEINDEX_H_
+
+// Qt headers
+#include <QReadWriteLock>
+#include <QDateTime>
+#include <QVector>
+#include <QString>
+#include <QMutex>
+#include <QList>
+#include <QHash>
+#include <QMap>
+
+// MythTV headers
+#include "programinfo.h"
+
+/// One row of the program table, the channel columns live in the channel
+class GuideIndexEntry
+{
+  public:
+    GuideIndexEntry() :
+        catType(ProgramInfo::kCategoryNone), stars(0.0f), year(0),
+        partnumber(0), parttotal(0), recstatus(RecStatus::Unknown),
+        recordid(0), rectype(kNotRecording), findid(0), repeat(false),
+        videoprops(0), audioprops(0), subtitletypes(0),
+        season(0), episode(0), totalepisodes(0) {}
+
+    QString   title;
+    QString   subtitle;
+    QString   description;
+    QString   syndicatedepisode;
+    QString   category;
+    QString   seriesid;
+    QString   programid;
+    QDateTime starttime;
+    QDateTime endtime;
+    QDate     originalairdate;
+    ProgramInfo::CategoryType catType;
+    float     stars;
+    uint      year;
+    uint      partnumber;
+    uint      parttotal;
+    RecStatus::Type recstatus;
+    uint      recordid;
+    RecordingType rectype;
+    uint      findid;
+    bool      repeat;
+    uint      videoprops;
+    uint      audioprops;
+    uint      subtitletypes;
+    uint      season;
+    uint      episode;
+    uint      totalepisodes;
+};
+
+/// All the indexed listings of one channel, bucketed by time slice
+class GuideIndexChannel
+{
+  public:
+    GuideIndexChannel(uint id) :
+        chanid(id), commfree(false), visible(true),
+        sourceid(0), mplexid(0), count(0) {}
+
+    uint      chanid;
+    QString   channum;
+    QString   callsign;
+    QString   name;
+    QString   playbackfilters;
+    bool      commfree;
+    bool      visible;
+    uint      sourceid;
+    uint      mplexid;
+
+    QDateTime loaded;   ///< when the listings were read from the database
+    QDateTime from;     ///< listings ending before this were not loaded
+    int       count;
+
+    /// Listings keyed by the slice their start time falls in
+    QMap<uint, QVector<GuideIndexEntry> > slices;
+};
+
+class GuideIndexFilter
+{
+  public:
+    GuideIndexFilter() : chanid(0), descending(false) {}
+
+    uint      chanid;       ///< 0 for all visible channels
+    QDateTime startTime;    ///< listings ending at or after this
+    QDateTime endTime;      ///< listings starting at or before this, if valid
+    QString   title;        ///< substring of the title
+    QString   category;     ///< the whole category
+    QString   keyword;      ///< substring of the title, subtitle or description
+    QString   sort;         ///< "starttime", "title", "channel" or "duration"
+    bool      descending;
+};
+
+class GuideIndexStats
+{
+  public:
+    GuideIndexStats() :
+        requests(0), hits(0), misses(0), fallbacks(0), invalidations(0),
+        channels(0), programs(0), totalLatencyUS(0), maxLatencyUS(0) {}
+
+    double HitRate(void) const
+        { return requests ? (double)hits / requests : 0.0; }
+    double AverageLatencyMS(void) const
+        { return requests ? totalLatencyUS / (requests * 1000.0) : 0.0; }
+
+    quint64 requests;
+    quint64 hits;           ///< served without touching the database
+    quint64 misses;         ///< served after loading some channels
+    quint64 fallbacks;      ///< handed back to the SQL queries
+    quint64 invalidations;
+    int     channels;
+    int     programs;
+    qint64  totalLatencyUS;
+    qint64  maxLatencyUS;
+};
+
+/** \brief In memory copy of the program listings for the guide services.
+ *
+ *  Channels are loaded from the database the first time they are asked
+ *  for, several at once where possible, and then kept until the
+ *  scheduler is told the listings of their video source changed, or
+ *  until they are kMaxAgeSecs old. Within a channel the listings are
+ *  bucketed by kSliceSecs of start time so a guide window only looks at
+ *  the slices it overlaps.
+ *
+ *  Recording status is applied from the pending schedule list each time
+ *  listings are handed out, as LoadFromProgram() does.
+ */
+class GuideIndex
+{
+  public:
+    static GuideIndex *GetIndex(void);
+
+    bool Prefetch(const QList<uint> &chanids, const QDateTime &start,
+                  bool &cacheHit);
+    bool GetPrograms(uint chanid, const QDateTime &start,
+                     const QDateTime &end, const ProgramList &schedList,
+                     ProgramList &destination);
+    bool Search(const GuideIndexFilter &filter, const ProgramList &schedList,
+                uint start, uint limit, ProgramList &destination,
+                uint &totalAvailable, bool &cacheHit);
+
+    void Invalidate(uint sourceid, uint mplexid);
+
+    void RecordRequest(bool indexed, bool cacheHit, qint64 latencyUS);
+    GuideIndexStats GetStats(void) const;
+
+    static const uint kSliceSecs   = 4 * 60 * 60;
+    static const int  kHistorySecs = 24 * 60 * 60;
+    static const int  kMaxAgeSecs  = 30 * 60;
+
+  private:
+    GuideIndex() : m_generation(0), m_allLoaded(false) {}
+   ~GuideIndex();
+
+    bool IsFresh(const GuideIndexChannel *chan, const QDateTime &now) const;
+    bool Load(const QList<uint> &chanids);
+    static uint SliceOf(const QDateTime &dt);
+    static ProgramInfo *NewProgramInfo(const GuideIndexChannel &chan,
+                                       const GuideIndexEntry &entry,
+                                       const ProgramList &schedList);
+
+    mutable QReadWriteLock           m_lock;
+    QHash<uint, GuideIndexChannel*>  m_channels;
+    uint                             m_generation;
+    bool                             m_allLoaded;
+    QDateTime                        m_allLoadedTime;
+
+    mutable QMutex                   m_statsLock;
+    GuideIndexStats                  m_stats;
+
+    static QMutex                    s_lock;
+    static GuideIndex               *s_index;
+};
+
+#endif
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
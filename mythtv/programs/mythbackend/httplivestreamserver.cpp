@@ -0,0 +1,143 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: httplivestreamserver.cpp
+//
+// Purpose - Serves remuxed HTTP Live Stream segments on demand
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "httplivestreamserver.h"
+
+#include "mythlogging.h"
+#include "HLS/httplivestream.h"
+#include "HLS/httplivestreamremuxer.h"
+
+const int HTTPLiveStreamServer::kMaxRemuxers = 16;
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+HTTPLiveStreamServer::HTTPLiveStreamServer( const QString &sSharePath )
+        : HttpServerExtension( "HTTPLiveStreamServer", sSharePath )
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+HTTPLiveStreamServer::~HTTPLiveStreamServer()
+{
+    QMutexLocker locker(&m_lock);
+
+    m_remuxers.clear();
+    m_remuxerOrder.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+QStringList HTTPLiveStreamServer::GetBasePaths()
+{
+    return QStringList( "/HLSRemux" );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool HTTPLiveStreamServer::ProcessRequest( HTTPRequest *pRequest )
+{
+    try
+    {
+        if (pRequest)
+        {
+            if (pRequest->m_sBaseUrl != "/HLSRemux")
+                return false;
+
+            LOG(VB_HTTP, LOG_DEBUG,
+                QString("HTTPLiveStreamServer::ProcessRequest: %1 : %2")
+                    .arg(pRequest->m_sMethod)
+                    .arg(pRequest->m_sRawRequest));
+
+            if (pRequest->m_sMethod == "GetSegment")
+            {
+                GetSegment( pRequest );
+                return true;
+            }
+        }
+    }
+    catch( ... )
+    {
+        LOG(VB_GENERAL, LOG_ERR,
+            "HTTPLiveStreamServer::ProcessRequest() - Unexpected Exception" );
+    }
+
+    return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+RemuxerPtr HTTPLiveStreamServer::GetRemuxer( int nStreamId )
+{
+    QMutexLocker locker(&m_lock);
+
+    if (m_remuxers.contains(nStreamId))
+    {
+        m_remuxerOrder.removeOne(nStreamId);
+        m_remuxerOrder.append(nStreamId);
+        return m_remuxers[nStreamId];
+    }
+
+    HTTPLiveStream hls(nStreamId);
+    if (hls.GetSourceFile().isEmpty())
+        return RemuxerPtr();
+
+    RemuxerPtr remuxer(
+        new HTTPLiveStreamRemuxer(hls.GetSourceFile(), hls.GetSegmentSize()));
+
+    if (!remuxer->Init())
+        return RemuxerPtr();
+
+    // Drop the least recently used, the segment map is cheap to rebuild
+    while (m_remuxers.size() >= kMaxRemuxers && !m_remuxerOrder.isEmpty())
+        m_remuxers.remove(m_remuxerOrder.takeFirst());
+
+    m_remuxers[nStreamId] = remuxer;
+    m_remuxerOrder.append(nStreamId);
+
+    return remuxer;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void HTTPLiveStreamServer::GetSegment( HTTPRequest *pRequest )
+{
+    int nStreamId = pRequest->m_mapParams[ "StreamId" ].toInt();
+    int nSegment  = pRequest->m_mapParams[ "Segment"  ].toInt();
+
+    RemuxerPtr remuxer = GetRemuxer( nStreamId );
+    QByteArray data;
+
+    if (!remuxer || (nSegment < 1) || !remuxer->GetSegment(nSegment, data))
+    {
+        LOG(VB_HTTP, LOG_WARNING,
+            QString("HTTPLiveStreamServer: No segment %1 for stream %2")
+                .arg(nSegment).arg(nStreamId));
+
+        pRequest->m_eResponseType   = ResponseTypeHTML;
+        pRequest->m_nResponseStatus = 404;
+        pRequest->m_response.write( pRequest->GetResponsePage() );
+        return;
+    }
+
+    pRequest->m_eResponseType     = ResponseTypeOther;
+    pRequest->m_sResponseTypeText = "video/mp2t";
+    pRequest->m_mapRespHeaders[ "Cache-Control" ] = "max-age=3600";
+    pRequest->m_response.write( data );
+}
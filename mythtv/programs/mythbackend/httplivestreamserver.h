@@ -0,0 +1,57 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: httplivestreamserver.h
+//
+// Purpose - Serves remuxed HTTP Live Stream segments on demand
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef HTTPLIVESTREAMSERVER_H_
+#define HTTPLIVESTREAMSERVER_H_
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+
+#include "httpserver.h"
+
+class HTTPLiveStreamRemuxer;
+typedef QSharedPointer<HTTPLiveStreamRemuxer> RemuxerPtr;
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+//
+// Segments of live streams that did not need transcoding are cut from the
+// recording when a client asks for them, see HTTPLiveStream::StartRemux()
+//
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+class HTTPLiveStreamServer : public HttpServerExtension
+{
+    private:
+
+        // Requests in progress hold a reference, so evicting a remuxer
+        // from here never frees it under them.
+        QMutex                             m_lock;
+        QHash<int, RemuxerPtr>             m_remuxers;
+        QList<int>                         m_remuxerOrder; ///< LRU first
+
+        static const int                   kMaxRemuxers;
+
+    private:
+
+        RemuxerPtr GetRemuxer( int nStreamId );
+
+        void    GetSegment( HTTPRequest *pRequest );
+
+    public:
+                 HTTPLiveStreamServer( const QString &sSharePath );
+        virtual ~HTTPLiveStreamServer();
+
+        virtual QStringList GetBasePaths();
+
+        bool     ProcessRequest( HTTPRequest *pRequest );
+};
+
+#endif
@@ -0,0 +1,77 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: httpmetrics.cpp
+//
+// Purpose - Prometheus metrics HttpServerExtension
+//
+//////////////////////////////////////////////////////////////////////////////
+
+// Qt headers
+#include <QTextStream>
+
+// MythTV headers
+#include "httpmetrics.h"
+#include "recorders/recordermetrics.h"
+#include "mythlogging.h"
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+HttpMetrics::HttpMetrics()
+          : HttpServerExtension( "HttpMetrics" , QString())
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+HttpMetrics::~HttpMetrics()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+QStringList HttpMetrics::GetBasePaths()
+{
+    return QStringList( "/metrics" );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool HttpMetrics::ProcessRequest( HTTPRequest *pRequest )
+{
+    try
+    {
+        if (!pRequest)
+            return( false );
+
+        if ((pRequest->m_sBaseUrl     != "/metrics" ) &&
+            (pRequest->m_sResourceUrl != "/metrics" ))
+        {
+            return( false );
+        }
+
+        pRequest->m_eResponseType     = ResponseTypeOther;
+        pRequest->m_sResponseTypeText = "text/plain; version=0.0.4";
+        pRequest->m_mapRespHeaders[ "Cache-Control" ] = "no-cache";
+        pRequest->m_nResponseStatus   = 200;
+
+        QTextStream stream( &pRequest->m_response );
+        stream.setCodec("UTF-8");
+        stream << RecorderMetricsRegistry::ToPrometheusText();
+
+        return( true );
+    }
+    catch( ... )
+    {
+        LOG(VB_GENERAL, LOG_ERR,
+            "HttpMetrics::ProcessRequest() - Unexpected Exception");
+    }
+
+    return( false );
+}
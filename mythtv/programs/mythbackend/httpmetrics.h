@@ -0,0 +1,34 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: httpmetrics.h
+//
+// Purpose - Prometheus metrics HttpServerExtension
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef HTTPMETRICS_H_
+#define HTTPMETRICS_H_
+
+#include "httpserver.h"
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+//
+// Serves the recorder metrics of this backend at /metrics in the
+// Prometheus text exposition format.
+//
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+class HttpMetrics : public HttpServerExtension
+{
+    public:
+
+                 HttpMetrics();
+        virtual ~HttpMetrics();
+
+        virtual QStringList GetBasePaths();
+
+        bool     ProcessRequest( HTTPRequest *pRequest );
+};
+
+#endif
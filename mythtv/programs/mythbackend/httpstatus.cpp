@@ -40,6 +40,8 @@
 #include "jobqueue.h"
 #include "upnp.h"
 #include "mythdate.h"
+#include "mthreadpool.h"
+#include "guideindex.h"
 
 /////////////////////////////////////////////////////////////////////////////
 //
@@ -564,6 +566,51 @@ void HttpStatus::FillStatusXML( QDomDocument *pDoc )
         pDoc->createTextNode(gCoreContext->GetSetting("DataDirectMessage"));
     guide.appendChild(dataDirectMessage);
 
+    GuideIndexStats indexStats = GuideIndex::GetIndex()->GetStats();
+
+    QDomElement index = pDoc->createElement("Index");
+    guide.appendChild(index);
+
+    index.setAttribute("channels",  indexStats.channels);
+    index.setAttribute("programs",  indexStats.programs);
+    index.setAttribute("requests",  indexStats.requests);
+    index.setAttribute("hits",      indexStats.hits);
+    index.setAttribute("misses",    indexStats.misses);
+    index.setAttribute("fallbacks", indexStats.fallbacks);
+    index.setAttribute("hitRate",
+                       QString::number(indexStats.HitRate() * 100.0, 'f', 1));
+    index.setAttribute("avgLatencyMS",
+                       QString::number(indexStats.AverageLatencyMS(), 'f', 1));
+    index.setAttribute("maxLatencyMS", indexStats.maxLatencyUS / 1000);
+
+    // Add Thread Pool information
+
+    QDomElement pools = pDoc->createElement("ThreadPools");
+    root.appendChild(pools);
+
+    QList<MThreadPoolStats> poolStats = MThreadPool::GetAllStats();
+    QList<MThreadPoolStats>::const_iterator pit = poolStats.begin();
+    for (; pit != poolStats.end(); ++pit)
+    {
+        QDomElement pool = pDoc->createElement("ThreadPool");
+        pools.appendChild(pool);
+
+        pool.setAttribute("name",         (*pit).name);
+        pool.setAttribute("workStealing", (*pit).workStealing);
+        pool.setAttribute("threads",      (*pit).threads);
+        pool.setAttribute("active",       (*pit).active);
+        pool.setAttribute("queued",       (*pit).queued);
+        pool.setAttribute("completed",    (*pit).completed);
+        pool.setAttribute("cancelled",    (*pit).cancelled);
+        pool.setAttribute("steals",       (*pit).steals);
+        pool.setAttribute("avgWaitMS",
+                          QString::number((*pit).AverageWaitMS(), 'f', 1));
+        pool.setAttribute("maxWaitMS",    (*pit).maxWaitMS);
+        pool.setAttribute("avgRunMS",
+                          QString::number((*pit).AverageRunMS(), 'f', 1));
+        pool.setAttribute("maxRunMS",     (*pit).maxRunMS);
+    }
+
     // Add Miscellaneous information
 
     QString info_script = gCoreContext->GetSetting("MiscStatusScript");
@@ -691,6 +738,13 @@ void HttpStatus::PrintStatus( QTextStream &os, QDomDocument *pDoc )
     if (!node.isNull())
         PrintMachineInfo( os, node.toElement());
 
+    // Thread pools ----------------------------
+
+    node = docElem.namedItem( "ThreadPools" );
+
+    if (!node.isNull())
+        PrintThreadPools( os, node.toElement());
+
     // Miscellaneous information ---------------
 
     node = docElem.namedItem( "Miscellaneous" );
@@ -1437,6 +1491,19 @@ int HttpStatus::PrintMachineInfo( QTextStream &os, QDomElement info )
 
             if (!sMsg.isEmpty())
                 os << "<br />\r\n    DataDirect Status: " << sMsg;
+
+            QDomElement index = e.namedItem( "Index" ).toElement();
+
+            if (!index.isNull() && index.attribute( "requests", "0" ) != "0")
+            {
+                os << "<br />\r\n    Guide index: "
+                   << index.attribute( "programs", "0" ) << " listings on "
+                   << index.attribute( "channels", "0" ) << " channels, "
+                   << index.attribute( "hitRate", "0" ) << "% of "
+                   << index.attribute( "requests", "0" )
+                   << " requests served from memory, "
+                   << index.attribute( "avgLatencyMS", "0" ) << " ms average.";
+            }
         }
     }
     os << "\r\n  </div>\r\n";
@@ -1444,6 +1511,52 @@ int HttpStatus::PrintMachineInfo( QTextStream &os, QDomElement info )
     return( 1 );
 }
 
+int HttpStatus::PrintThreadPools( QTextStream &os, QDomElement pools )
+{
+    if (pools.isNull())
+        return( 0 );
+
+    QDomNodeList nodes = pools.elementsByTagName("ThreadPool");
+    uint count = nodes.count();
+    if (count == 0)
+        return( 0 );
+
+    os << "  <div class=\"content\">\r\n"
+       << "    <h2 class=\"status\">Thread Pools</h2>\r\n"
+       << "    <table summary=\"Thread Pools\">\r\n"
+       << "      <tr><th>Pool</th><th>Threads</th><th>Active</th>"
+       << "<th>Queued</th><th>Completed</th><th>Cancelled</th>"
+       << "<th>Steals</th><th>Wait (avg/max ms)</th>"
+       << "<th>Run (avg/max ms)</th></tr>\r\n";
+
+    for (uint i = 0; i < count; i++)
+    {
+        QDomElement e = nodes.item(i).toElement();
+        if (e.isNull())
+            continue;
+
+        bool stealing = e.attribute("workStealing", "0").toInt();
+
+        os << "      <tr><td>" << e.attribute("name", "")
+           << (stealing ? " (work stealing)" : "") << "</td>"
+           << "<td>" << e.attribute("threads", "0")   << "</td>"
+           << "<td>" << e.attribute("active", "0")    << "</td>"
+           << "<td>" << e.attribute("queued", "0")    << "</td>"
+           << "<td>" << e.attribute("completed", "0") << "</td>"
+           << "<td>" << e.attribute("cancelled", "0") << "</td>"
+           << "<td>" << e.attribute("steals", "0")    << "</td>"
+           << "<td>" << e.attribute("avgWaitMS", "0") << " / "
+                     << e.attribute("maxWaitMS", "0") << "</td>"
+           << "<td>" << e.attribute("avgRunMS", "0")  << " / "
+                     << e.attribute("maxRunMS", "0")  << "</td></tr>\r\n";
+    }
+
+    os << "    </table>\r\n"
+       << "  </div>\r\n\r\n";
+
+    return count;
+}
+
 int HttpStatus::PrintMiscellaneousInfo( QTextStream &os, QDomElement info )
 {
     if (info.isNull())
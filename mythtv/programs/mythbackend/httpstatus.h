@@ -67,6 +67,7 @@ class HttpStatus : public HttpServerExtension
         int     PrintBackends     ( QTextStream &os, QDomElement backends );
         int     PrintJobQueue     ( QTextStream &os, QDomElement jobs );
         int     PrintMachineInfo  ( QTextStream &os, QDomElement info );
+        int     PrintThreadPools  ( QTextStream &os, QDomElement pools );
         int     PrintMiscellaneousInfo ( QTextStream &os, QDomElement info );
 
         void    FillProgramInfo   ( QDomDocument *pDoc,
@@ -4,6 +4,7 @@
 #include "imagemetadata.h"
 #include "imagescanner.h"
 #include "imagethumbs.h"
+#include "storagegroup.h"
 
 
 /*!
@@ -62,6 +63,9 @@ QStringList ImageHandler::HandleRename(QString id, QString newBase)
     LOG(VB_FILE, LOG_DEBUG, QString("Image: Renamed %1 -> %2")
         .arg(im->m_fileName, newName));
 
+    StorageGroup::RenameFileInIndex(absFilename,
+                                    dir.absoluteFilePath(newName));
+
     ImageList dummy;
 
     if (im->IsDirectory())
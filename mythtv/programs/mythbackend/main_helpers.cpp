@@ -54,6 +54,7 @@
 
 #include "mediaserver.h"
 #include "httpstatus.h"
+#include "httpmetrics.h"
 #include "mythlogging.h"
 
 #define LOC      QString("MythBackend: ")
@@ -681,6 +682,10 @@ int run_backend(MythBackendCommandLineParser &cmdline)
 
         httpStatus = new HttpStatus( &tvList, sched, expirer, ismaster );
         pHS->RegisterExtension( httpStatus );
+
+        LOG(VB_GENERAL, LOG_INFO, "Main::Registering HttpMetrics Extension");
+
+        pHS->RegisterExtension( new HttpMetrics() );
     }
 
     mainServer = new MainServer(
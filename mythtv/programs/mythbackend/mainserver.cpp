@@ -38,6 +38,7 @@ using namespace std;
 #include <QNetworkInterface>
 #include <QNetworkProxy>
 #include <QHostAddress>
+#include <QSet>
 
 #include "previewgeneratorqueue.h"
 #include "mythmiscutil.h"
@@ -51,6 +52,7 @@ using namespace std;
 #include "mthread.h"
 #include "scheduler.h"
 #include "backendutil.h"
+#include "guideindex.h"
 #include "programinfo.h"
 #include "mythtimezone.h"
 #include "recordinginfo.h"
@@ -104,6 +106,7 @@ int delete_file_immediately(const QString &filename,
 
     LOG(VB_FILE, LOG_INFO, LOC +
         QString("About to delete file: %1").arg(filename));
+    StorageGroup::RemoveFileFromIndex(filename);
     success1 = true;
     success2 = true;
     if (followLinks)
@@ -535,6 +538,13 @@ void MainServer::ProcessRequestWork(MythSocket *sock)
         else
             HandleQueryRecordings(tokens[1], pbs);
     }
+    else if (command == "QUERY_RECORDINGS_SINCE")
+    {
+        if (tokens.size() != 3)
+            SendErrorResponse(pbs, "Bad QUERY_RECORDINGS_SINCE query");
+        else
+            HandleQueryRecordingsSince(tokens, pbs);
+    }
     else if (command == "QUERY_RECORDING")
     {
         HandleQueryRecording(tokens, pbs);
@@ -1070,6 +1080,33 @@ void MainServer::ProcessRequestWork(MythSocket *sock)
     pbs->DecrRef();
 }
 
+/** \brief Returns the key of the events superseded by this event.
+ *
+ *  Only the last of the events with the same key still waiting to be
+ *  sent to a client is sent, see MythSocket::QueueStringList().
+ */
+static QString get_coalesce_key(const QStringList &broadcast)
+{
+    if (broadcast.size() < 2)
+        return QString();
+
+    const QString &message = broadcast[1];
+
+    // Events which only tell the client to reload something
+    if (message == "RECORDING_LIST_CHANGE" ||
+        message == "SCHEDULE_CHANGE" ||
+        message == "CLEAR_SETTINGS_CACHE")
+    {
+        return message;
+    }
+
+    // UPDATE_FILE_SIZE <recordedid> <filesize>
+    if (message.startsWith("UPDATE_FILE_SIZE "))
+        return message.section(' ', 0, 1);
+
+    return QString();
+}
+
 void MainServer::customEvent(QEvent *e)
 {
     if (!e)
@@ -1077,6 +1114,7 @@ void MainServer::customEvent(QEvent *e)
 
     QStringList broadcast;
     QSet<QString> receivers;
+    QString coalesceKey;
 
     // delete stale sockets in the UI thread
     sockListLock.lockForRead();
@@ -1098,6 +1136,21 @@ void MainServer::customEvent(QEvent *e)
 
         QString message = me->Message();
         QString error;
+
+        // The listings may have been replaced wholesale, this also reaches
+        // slave backends which never see the reschedule request.
+        if (message.startsWith("SYSTEM_EVENT MYTHFILLDATABASE_RAN"))
+            GuideIndex::GetIndex()->Invalidate(0, 0);
+
+        // Keep track of what QUERY_RECORDINGS_SINCE has to send
+        if (message == "RECORDING_LIST_CHANGE")
+            m_recJournal.Reset();
+        else if (message.startsWith("RECORDING_LIST_CHANGE ADD ") ||
+                 message.startsWith("RECORDING_LIST_CHANGE DELETE "))
+            m_recJournal.Changed(message.section(' ', 2, 2).toUInt());
+        else if (message.startsWith("MASTER_UPDATE_REC_INFO "))
+            m_recJournal.Changed(message.section(' ', 1, 1).toUInt());
+
         if ((message == "PREVIEW_SUCCESS" || message == "PREVIEW_QUEUED") &&
             me->ExtraDataCount() >= 5)
         {
@@ -1371,7 +1424,10 @@ void MainServer::customEvent(QEvent *e)
         }
 
         if (me->Message() == "CLEAR_SETTINGS_CACHE")
+        {
             gCoreContext->ClearSettingsCache();
+            StorageGroup::ClearFileIndex();
+        }
 
         if (me->Message().startsWith("RESET_IDLETIME") && m_sched)
             m_sched->ResetIdleTime();
@@ -1409,6 +1465,8 @@ void MainServer::customEvent(QEvent *e)
                 evinfo.ToStringList(list);
                 mod_me = MythEvent("RECORDING_LIST_CHANGE UPDATE", list);
                 me = &mod_me;
+                coalesceKey = QString("RECORDING_LIST_CHANGE UPDATE %1")
+                    .arg(recordedid);
             }
             else
             {
@@ -1467,6 +1525,10 @@ void MainServer::customEvent(QEvent *e)
             sendGlobal = true;
         }
 
+        if (coalesceKey.isEmpty())
+            coalesceKey = get_coalesce_key(broadcast);
+        QByteArray payload;
+
         QSet<PlaybackSock*> sentSet;
 
         bool isSystemEvent = broadcast[1].startsWith("SYSTEM_EVENT ");
@@ -1523,9 +1585,15 @@ void MainServer::customEvent(QEvent *e)
                     continue;
             }
 
+            // Queue the event instead of waiting for each client in turn,
+            // so that a client which is slow to read only delays itself.
             MythSocket *sock = pbs->getSocket();
             if (reallysendit && sock->IsConnected())
-                sock->WriteStringList(broadcast);
+            {
+                if (payload.isEmpty())
+                    payload = MythSocket::EncodeStringList(broadcast);
+                sock->QueueStringList(payload, coalesceKey);
+            }
         }
 
         // Done with the pbs list, so decrement all the instances..
@@ -2018,7 +2086,6 @@ void MainServer::SendResponse(MythSocket *socket, QStringList &commands)
 void MainServer::HandleQueryRecordings(QString type, PlaybackSock *pbs)
 {
     MythSocket *pbssock = pbs->getSocket();
-    QString playbackhost = pbs->getHostname();
 
     QMap<QString,ProgramInfo*> recMap;
     if (m_sched)
@@ -2045,7 +2112,20 @@ void MainServer::HandleQueryRecordings(QString type, PlaybackSock *pbs)
     for (; mit != recMap.end(); mit = recMap.erase(mit))
         delete *mit;
 
-    QStringList outputlist(QString::number(destination.size()));
+    QStringList outputlist;
+    FillRecordingList(destination, pbs, outputlist);
+
+    SendResponse(pbssock, outputlist);
+}
+
+/// Appends the count and the programinfo of each recording for the client
+void MainServer::FillRecordingList(ProgramList &destination, PlaybackSock *pbs,
+                                   QStringList &outputlist)
+{
+    QString playbackhost = pbs->getHostname();
+
+    outputlist << QString::number(destination.size());
+
     QMap<QString, QString> backendPortMap;
     QString ip   = gCoreContext->GetBackendServerIP();
     int port = gCoreContext->GetBackendServerPort();
@@ -2135,10 +2215,119 @@ void MainServer::HandleQueryRecordings(QString type, PlaybackSock *pbs)
 
         proginfo->ToStringList(outputlist);
     }
+}
+
+/// Looks up the recordedid of a ProgramInfo::MakeUniqueKey() key
+static uint get_recordedid(const QString &key)
+{
+    uint chanid;
+    QDateTime recstartts;
+    if (!ProgramInfo::ExtractKey(key, chanid, recstartts))
+        return 0;
+
+    MSqlQuery query(MSqlQuery::InitCon());
+    query.prepare("SELECT recordedid FROM recorded "
+                  "WHERE chanid = :CHANID AND starttime = :STARTTIME");
+    query.bindValue(":CHANID", chanid);
+    query.bindValue(":STARTTIME", recstartts);
+
+    if (!query.exec() || !query.next())
+        return 0;
+
+    return query.value(0).toUInt();
+}
+
+/**
+ * \addtogroup myth_network_protocol
+ * \par        QUERY_RECORDINGS_SINCE \e epoch \e generation
+ * Returns only the recordings added, changed or removed since the client's
+ * last load: "DELTA", epoch, generation, the number of removed recordings
+ * followed by their recordedid, then the number of added or changed
+ * recordings followed by their programinfo. If the journal doesn't reach
+ * back to \e generation, or the backend restarted since, "FULL" is
+ * returned with no removed recordings and every recording instead.
+ * The client passes the returned epoch and generation on its next call.
+ * Backends older than this command answer "UNKNOWN_COMMAND", so it needs
+ * no protocol version of its own: the client falls back to
+ * QUERY_RECORDINGS whenever the reply doesn't start with "FULL" or "DELTA".
+ */
+void MainServer::HandleQueryRecordingsSince(QStringList &slist,
+                                            PlaybackSock *pbs)
+{
+    MythSocket *pbssock = pbs->getSocket();
+
+    uint epoch      = slist[1].toUInt();
+    uint generation = slist[2].toUInt();
+    uint current    = 0;
+
+    QMap<QString,uint32_t> inUseMap = ProgramInfo::QueryInUseMap();
+    QMap<QString,bool> isJobRunning =
+        ProgramInfo::QueryJobsRunning(JOB_COMMFLAG);
+
+    // Recordings start and stop being played, recorded or flagged without
+    // a RECORDING_LIST_CHANGE, so journal those whose flags moved on.
+    QMap<QString,uint32_t> flags = inUseMap;
+    QMap<QString,bool>::const_iterator jit = isJobRunning.begin();
+    for (; jit != isJobRunning.end(); ++jit)
+        flags[jit.key()] |= FL_COMMPROCESSING;
+
+    QStringList flagged = m_recJournal.FlagsChanged(flags);
+    QStringList::const_iterator fit = flagged.begin();
+    for (; fit != flagged.end(); ++fit)
+        m_recJournal.Changed(get_recordedid(*fit));
+
+    QList<uint> changed;
+    bool delta = m_recJournal.GetChangesSince(epoch, generation,
+                                              current, changed);
+
+    ProgramList destination;
+
+    // Nothing to load when nothing changed, LoadFromRecorded would load all
+    if (!delta || !changed.empty())
+    {
+        QMap<QString,ProgramInfo*> recMap;
+        if (m_sched)
+            recMap = m_sched->GetRecording();
+
+        LoadFromRecorded(destination, false, inUseMap, isJobRunning,
+                         recMap, 0, changed);
+
+        QMap<QString,ProgramInfo*>::iterator mit = recMap.begin();
+        for (; mit != recMap.end(); mit = recMap.erase(mit))
+            delete *mit;
+    }
+
+    // Whatever changed and is no longer in the recorded table was removed
+    QSet<uint> removed;
+    if (delta)
+    {
+        removed = changed.toSet();
+        ProgramList::const_iterator it = destination.begin();
+        for (; it != destination.end(); ++it)
+            removed.remove((*it)->GetRecordingID());
+    }
+
+    LOG(VB_GENERAL, LOG_DEBUG, LOC +
+        QString("QUERY_RECORDINGS_SINCE %1: %2 changed, %3 removed")
+            .arg(generation).arg(delta ? QString::number(destination.size())
+                                       : QString("all"))
+            .arg(removed.size()));
+
+    QStringList outputlist(QString(delta ? "DELTA" : "FULL"));
+    outputlist << QString::number(m_recJournal.GetEpoch())
+               << QString::number(current)
+               << QString::number(removed.size());
+
+    QSet<uint>::const_iterator rit = removed.begin();
+    for (; rit != removed.end(); ++rit)
+        outputlist << QString::number(*rit);
+
+    FillRecordingList(destination, pbs, outputlist);
 
     SendResponse(pbssock, outputlist);
 }
 
+
 /**
  * \addtogroup myth_network_protocol
  * \par        QUERY_RECORDING BASENAME \e basename
@@ -2528,6 +2717,8 @@ int MainServer::DeleteFile(const QString &filename, bool followLinks,
         QString("About to unlink/delete file: '%1'")
             .arg(fname.constData()));
 
+    StorageGroup::RemoveFileFromIndex(filename);
+
     QString errmsg = QString("Delete Error '%1'").arg(fname.constData());
     if (finfo.isSymLink())
     {
@@ -6730,6 +6921,26 @@ void MainServer::HandleMusicSaveLyrics(const QStringList& slist, PlaybackSock* p
         SendResponse(pbssock, strlist);
 }
 
+/**
+ * \addtogroup myth_network_protocol
+ * \par        QUERY_FILETRANSFER \e id REQUEST_STREAM \e limit
+ * Starts writing the file to the data socket without waiting for
+ * REQUEST_BLOCK, until \e limit bytes in total have been sent.
+ * Returns "1" if the file is streamed. Older backends and mythmediaserver
+ * return "ERROR", in which case the client should keep to REQUEST_BLOCK.
+ * \par        QUERY_FILETRANSFER \e id STREAM_CREDIT \e limit
+ * Raises the total number of bytes the stream may send to \e limit.
+ * Returns "OK". The client has to read that before its next request,
+ * a control socket is only ever read one request at a time.
+ * \par        QUERY_FILETRANSFER \e id STREAM_STATUS
+ * Returns the bytes streamed so far and whether the stream is at the end
+ * of the file.
+ * \par        QUERY_FILETRANSFER \e id STOP_STREAM
+ * Stops the stream, returns the bytes streamed.
+ * \par        QUERY_FILETRANSFER \e id SEEK \e pos \e whence \e curpos
+ * Returns the new position, followed while streaming by the number of
+ * bytes streamed before the seek took effect.
+ */
 void MainServer::HandleFileTransferQuery(QStringList &slist,
                                          QStringList &commands,
                                          PlaybackSock *pbs)
@@ -6785,8 +6996,32 @@ void MainServer::HandleFileTransferQuery(QStringList &slist,
         int whence = slist[3].toInt();
         long long curpos = slist[4].toLongLong();
 
-        long long ret = ft->Seek(curpos, pos, whence);
+        long long streamed = 0;
+        long long ret = ft->Seek(curpos, pos, whence, &streamed);
         retlist << QString::number(ret);
+        if (ft->IsStreaming())
+            retlist << QString::number(streamed);
+    }
+    else if (command == "REQUEST_STREAM")
+    {
+        long long limit = slist[2].toLongLong();
+
+        retlist << QString::number(ft->RequestStream(limit));
+    }
+    else if (command == "STREAM_CREDIT")
+    {
+        ft->AddStreamCredit(slist[2].toLongLong());
+        retlist << "OK";
+    }
+    else if (command == "STREAM_STATUS")
+    {
+        bool ateof = false;
+        retlist << QString::number(ft->GetStreamStatus(ateof));
+        retlist << QString::number(ateof);
+    }
+    else if (command == "STOP_STREAM")
+    {
+        retlist << QString::number(ft->StopStream());
     }
     else if (command == "IS_OPEN")
     {
@@ -23,6 +23,7 @@ using namespace std;
 #include "mythsocket.h"
 #include "mythdeque.h"
 #include "mythdownloadmanager.h"
+#include "recordingjournal.h"
 
 #ifdef DeleteFile
 #undef DeleteFile
@@ -151,6 +152,9 @@ class MainServer : public QObject, public MythSocketCBs
     bool HandleDeleteFile(QString filename, QString storagegroup,
                           PlaybackSock *pbs = NULL);
     void HandleQueryRecordings(QString type, PlaybackSock *pbs);
+    void HandleQueryRecordingsSince(QStringList &slist, PlaybackSock *pbs);
+    void FillRecordingList(ProgramList &destination, PlaybackSock *pbs,
+                           QStringList &outputlist);
     void HandleQueryRecording(QStringList &slist, PlaybackSock *pbs);
     void HandleStopRecording(QStringList &slist, PlaybackSock *pbs);
     void DoHandleStopRecording(RecordingInfo &recinfo, PlaybackSock *pbs);
@@ -313,6 +317,9 @@ class MainServer : public QObject, public MythSocketCBs
     Scheduler *m_sched;
     AutoExpire *m_expirer;
 
+    /// Recording list changes for QUERY_RECORDINGS_SINCE
+    RecordingJournal m_recJournal;
+
     struct DeferredDeleteStruct
     {
         PlaybackSock *sock;
@@ -11,7 +11,10 @@
 #include "mediaserver.h"
 #include "httpconfig.h"
 #include "internetContent.h"
+#include "httplivestreamserver.h"
 #include "mythdirs.h"
+#include "mythcorecontext.h"
+#include "mythevent.h"
 #include "htmlserver.h"
 #include <websocket.h>
 
@@ -138,6 +141,7 @@ void MediaServer::Init(bool bIsMaster, bool bDisableUPnp /* = false */)
     pHttpServer->RegisterExtension( pHtmlServer );
     pHttpServer->RegisterExtension( new HttpConfig() );
     pHttpServer->RegisterExtension( new InternetContent   ( m_sSharePath ));
+    pHttpServer->RegisterExtension( new HTTPLiveStreamServer( m_sSharePath ));
 
     pHttpServer->RegisterExtension( new MythServiceHost   ( m_sSharePath ));
     pHttpServer->RegisterExtension( new GuideServiceHost  ( m_sSharePath ));
@@ -247,11 +251,13 @@ void MediaServer::Init(bool bIsMaster, bool bDisableUPnp /* = false */)
             RegisterExtension(new UPnpCDSVideo());
         }
 
-#if 0
-        LOG(VB_UPNP, LOG_INFO, "MediaServer::Adding Context Listener");
+        // Recording, video and music changes invalidate the cached CDS trees
+        if (m_pUPnpCDS)
+        {
+            LOG(VB_UPNP, LOG_INFO, "MediaServer::Adding Context Listener");
 
-        gCoreContext->addListener( this );
-#endif
+            gCoreContext->addListener( this );
+        }
 
         Start();
 
@@ -282,9 +288,8 @@ MediaServer::~MediaServer()
 {
     // -=>TODO: Need to check to see if calling this more than once is ok.
 
-#if 0
-    gCoreContext->removeListener(this);
-#endif
+    if (gCoreContext)
+        gCoreContext->removeListener(this);
 
     delete m_pHttpServer;
 
@@ -296,7 +301,7 @@ MediaServer::~MediaServer()
 //////////////////////////////////////////////////////////////////////////////
 //
 //////////////////////////////////////////////////////////////////////////////
-#if 0
+
 void MediaServer::customEvent( QEvent *e )
 {
     if (MythEvent::Type(e->type()) == MythEvent::MythEventMessage)
@@ -304,10 +309,11 @@ void MediaServer::customEvent( QEvent *e )
         MythEvent *me = (MythEvent *)e;
         QString message = me->Message();
 
-        //-=>TODO: Need to handle events to notify clients of changes
+        if (m_pUPnpCDS)
+            m_pUPnpCDS->ProcessEvent( message );
     }
 }
-#endif
+
 //////////////////////////////////////////////////////////////////////////////
 //
 //////////////////////////////////////////////////////////////////////////////
@@ -11,6 +11,7 @@
 #ifndef __MEDIASERVER_H__
 #define __MEDIASERVER_H__
 
+#include <QObject>
 #include <QString>
 
 #include "upnp.h"
@@ -28,7 +29,7 @@ class BonjourRegister;
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 
-class MediaServer : public UPnp
+class MediaServer : public QObject, public UPnp
 {
     private:
 
@@ -43,6 +44,8 @@ class MediaServer : public UPnp
 
         QString          m_sSharePath;
 
+        virtual void customEvent( QEvent *e );
+
     public:
         explicit MediaServer();
         void Init(bool bMaster, bool bDisableUPnp = false);
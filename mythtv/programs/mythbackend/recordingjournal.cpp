@@ -0,0 +1,107 @@
+// MythTV headers
+#include "recordingjournal.h"
+#include "mythdate.h"
+#include "mythlogging.h"
+
+#define LOC QString("RecJournal: ")
+
+const int RecordingJournal::kMaxEntries = 10000;
+
+RecordingJournal::RecordingJournal() :
+    m_epoch(MythDate::current().toTime_t()), m_generation(0), m_start(0)
+{
+}
+
+/// Records a change to, addition or removal of a recording
+void RecordingJournal::Changed(uint recordedid)
+{
+    if (!recordedid)
+        return;
+
+    QMutexLocker locker(&m_lock);
+
+    QHash<uint,uint>::iterator it = m_byRecording.find(recordedid);
+    if (it != m_byRecording.end())
+        m_byGeneration.remove(*it);
+
+    m_generation++;
+    m_byRecording[recordedid] = m_generation;
+    m_byGeneration[m_generation] = recordedid;
+
+    // Forget the oldest changes, clients older than that reload everything
+    while (m_byGeneration.size() > kMaxEntries)
+    {
+        QMap<uint,uint>::iterator oldest = m_byGeneration.begin();
+        m_start = oldest.key();
+        m_byRecording.remove(*oldest);
+        m_byGeneration.erase(oldest);
+    }
+}
+
+/// Every client has to reload the full recording list
+void RecordingJournal::Reset(void)
+{
+    QMutexLocker locker(&m_lock);
+
+    m_generation++;
+    m_start = m_generation;
+    m_byRecording.clear();
+    m_byGeneration.clear();
+
+    LOG(VB_GENERAL, LOG_DEBUG, LOC +
+        QString("Reset at generation %1").arg(m_generation));
+}
+
+/** \fn RecordingJournal::FlagsChanged(const QMap<QString,uint32_t>&)
+ *  \brief Remembers the in-use and commflag flags of recordings.
+ *  \param flags Flags by ProgramInfo::MakeUniqueKey(), recordings
+ *               without any may be left out
+ *  \return Keys of the recordings whose flags differ from the last call,
+ *          the caller passes their recordedid to Changed()
+ */
+QStringList RecordingJournal::FlagsChanged(
+    const QMap<QString,uint32_t> &flags)
+{
+    QMutexLocker locker(&m_lock);
+
+    QStringList changed;
+
+    QMap<QString,uint32_t>::const_iterator it = flags.begin();
+    for (; it != flags.end(); ++it)
+    {
+        if (*it != m_flags.value(it.key(), 0))
+            changed << it.key();
+    }
+
+    for (it = m_flags.begin(); it != m_flags.end(); ++it)
+    {
+        if (*it && !flags.contains(it.key()))
+            changed << it.key();
+    }
+
+    m_flags = flags;
+
+    return changed;
+}
+
+/** \fn RecordingJournal::GetChangesSince(uint,uint,uint&,QList<uint>&) const
+ *  \brief Fills in the recordings changed after the given generation.
+ *  \param current Set to the generation the changes bring the client up to
+ *  \return false if the client needs the full list instead
+ */
+bool RecordingJournal::GetChangesSince(
+    uint epoch, uint generation, uint &current, QList<uint> &changed) const
+{
+    QMutexLocker locker(&m_lock);
+
+    current = m_generation;
+
+    if (epoch != m_epoch || generation < m_start || generation > m_generation)
+        return false;
+
+    QMap<uint,uint>::const_iterator it = m_byGeneration.upperBound(generation);
+    for (; it != m_byGeneration.end(); ++it)
+        changed.push_back(*it);
+
+    return true;
+}
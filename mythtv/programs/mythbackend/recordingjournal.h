@@ -0,0 +1,54 @@
+#ifndef _RECORDINGJOURNAL_H_
+#define _RECORDINGJOURNAL_H_
+
+// C headers
+#include <stdint.h>
+
+// Qt headers
+#include <QMutex>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QMap>
+
+/** \class RecordingJournal
+ *  \brief Remembers which recordings changed at which generation, so that
+ *         QUERY_RECORDINGS_SINCE can send a frontend only what changed
+ *         since its last load instead of the whole recording list.
+ *
+ *   Only the latest change of each recording is kept. The epoch changes
+ *   every time the backend starts, a client which presents a different
+ *   epoch or a generation older than the journal reaches back to must
+ *   load the full list. In-use and commflag flags change without any
+ *   RECORDING_LIST_CHANGE, so they are compared on every query instead.
+ */
+class RecordingJournal
+{
+  public:
+    RecordingJournal();
+
+    void Changed(uint recordedid);
+    void Reset(void);
+    QStringList FlagsChanged(const QMap<QString,uint32_t> &flags);
+
+    uint GetEpoch(void) const { return m_epoch; }
+    bool GetChangesSince(uint epoch, uint generation,
+                         uint &current, QList<uint> &changed) const;
+
+  private:
+    mutable QMutex   m_lock;
+    uint             m_epoch;
+    uint             m_generation;
+    /// Oldest generation the journal can answer for
+    uint             m_start;
+    QHash<uint,uint> m_byRecording;   ///< recordedid -> generation
+    QMap<uint,uint>  m_byGeneration;  ///< generation -> recordedid
+    /// In-use and commflag flags by unique key as of the last query
+    QMap<QString,uint32_t> m_flags;
+
+    static const int kMaxEntries;
+
+    friend class TestRecordingJournal;
+};
+
+#endif // _RECORDINGJOURNAL_H_
@@ -33,6 +33,7 @@ using namespace std;
 #include "mainserver.h"
 #include "remoteutil.h"
 #include "backendutil.h"
+#include "guideindex.h"
 #include "mythdate.h"
 #include "exitcodes.h"
 #include "mythcontext.h"
@@ -2281,6 +2282,9 @@ bool Scheduler::HandleReschedule(void)
             uint sourceid = tokens[2].toUInt();
             uint mplexid = tokens[3].toUInt();
             QDateTime maxstarttime = MythDate::fromString(tokens[4]);
+            // Listings changed, rather than a recording rule
+            if (!recordid)
+                GuideIndex::GetIndex()->Invalidate(sourceid, mplexid);
             deleteFuture = true;
             runCheck = true;
             schedLock.unlock();
@@ -41,6 +41,7 @@
 #include "recordinginfo.h"
 #include "cardutil.h"
 #include "inputinfo.h"
+#include "recorders/recordermetrics.h"
 #include "programtypes.h"
 #include "recordingtypes.h"
 
@@ -471,6 +472,63 @@ DTC::InputList* Dvr::GetInputList()
 //
 /////////////////////////////////////////////////////////////////////////////
 
+DTC::RecorderMetricsList* Dvr::GetRecorderMetricsList( int nInputId )
+{
+    DTC::RecorderMetricsList *pList = new DTC::RecorderMetricsList();
+
+    QList<RecorderMetricsSnapshot> recs =
+        RecorderMetricsRegistry::GetSnapshots(nInputId > 0 ? nInputId : 0);
+    QList<ReadBufferSnapshot> drbs =
+        RecorderMetricsRegistry::GetReadBufferSnapshots();
+
+    QList<RecorderMetricsSnapshot>::const_iterator it = recs.begin();
+    for (; it != recs.end(); ++it)
+    {
+        DTC::RecorderMetrics *pMetrics = pList->AddNewRecorderMetrics();
+
+        pMetrics->setInputId         ( it->inputid                    );
+        pMetrics->setDevice          ( it->device                     );
+        pMetrics->setChanId          ( it->chanid                     );
+        pMetrics->setStartTs         ( it->recstartts                 );
+        pMetrics->setUpdated         ( it->updated                    );
+        pMetrics->setBytesIn         ( it->counters.bytesIn           );
+        pMetrics->setBytesOut        ( it->counters.bytesOut          );
+        pMetrics->setPackets         ( it->counters.packets           );
+        pMetrics->setContinuityErrors( it->counters.continuityErrors  );
+        pMetrics->setKeyframes       ( it->counters.keyframes         );
+        pMetrics->setFramesWritten   ( it->counters.frames            );
+        pMetrics->setWriteBufferUse  ( it->writeBufferUse             );
+        pMetrics->setWriteBufferSize ( it->writeBufferSize            );
+        pMetrics->setWriteLatency    ( it->writeLatency               );
+        pMetrics->setMaxWriteLatency ( it->maxWriteLatency            );
+
+        QList<ReadBufferSnapshot>::const_iterator dit = drbs.begin();
+        for (; dit != drbs.end(); ++dit)
+        {
+            if (dit->device == it->device)
+            {
+                pMetrics->setReadBufferUse ( dit->used );
+                pMetrics->setReadBufferSize( dit->size );
+                break;
+            }
+        }
+
+        QMap<uint, quint64>::const_iterator pit = it->pidPackets.begin();
+        for (; pit != it->pidPackets.end(); ++pit)
+        {
+            DTC::PIDCount *pCount = pMetrics->AddNewPIDCount();
+            pCount->setPID    ( pit.key() );
+            pCount->setPackets( *pit      );
+        }
+    }
+
+    return pList;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
 QStringList Dvr::GetRecGroupList()
 {
     MSqlQuery query(MSqlQuery::InitCon());
@@ -99,6 +99,8 @@ class Dvr : public DvrServices
 
         DTC::InputList*   GetInputList        ( );
 
+        DTC::RecorderMetricsList* GetRecorderMetricsList ( int InputId );
+
         QStringList       GetRecGroupList     ( );
 
         QStringList       GetRecStorageGroupList ( );
@@ -363,6 +365,13 @@ class ScriptableDvr : public QObject
             )
         }
 
+        QObject*    GetRecorderMetricsList( int InputId )
+        {
+            SCRIPT_CATCH_EXCEPTION( NULL,
+                return m_obj.GetRecorderMetricsList( InputId );
+            )
+        }
+
         QStringList GetRecGroupList()
         {
             SCRIPT_CATCH_EXCEPTION( QStringList(),
@@ -25,6 +25,8 @@
 
 #include <math.h>
 
+#include <QElapsedTimer>
+
 #include "guide.h"
 
 #include "compat.h"
@@ -35,6 +37,7 @@
 #include "channelutil.h"
 #include "channelgroup.h"
 #include "storagegroup.h"
+#include "guideindex.h"
 
 #include "mythlogging.h"
 
@@ -112,13 +115,28 @@ DTC::ProgramGuide *Guide::GetProgramGuide( const QDateTime &rawStartTime ,
     if (scheduler)
         scheduler->GetAllPending(schedList);
 
+    // ----------------------------------------------------------------------
+    // Make sure the listings are in the guide index
+    // ----------------------------------------------------------------------
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<uint> chanIds;
+    ChannelInfoList::iterator chan_it;
+    for (chan_it = chanList.begin(); chan_it != chanList.end(); ++chan_it)
+        chanIds.push_back((*chan_it).chanid);
+
+    GuideIndex *pIndex    = GuideIndex::GetIndex();
+    bool        bCacheHit = false;
+    bool        bIndexed  = pIndex->Prefetch( chanIds, dtStartTime, bCacheHit );
+
     // ----------------------------------------------------------------------
     // Build Response
     // ----------------------------------------------------------------------
 
     DTC::ProgramGuide *pGuide = new DTC::ProgramGuide();
 
-    ChannelInfoList::iterator chan_it;
     for (chan_it = chanList.begin(); chan_it != chanList.end(); ++chan_it)
     {
         // Create ChannelInfo Object
@@ -128,8 +146,13 @@ DTC::ProgramGuide *Guide::GetProgramGuide( const QDateTime &rawStartTime ,
 
         // Load the list of programmes for this channel
         ProgramList  progList;
-        bindings[":CHANID"] = (*chan_it).chanid;
-        LoadFromProgram( progList, sSQL, bindings, schedList );
+        if (!bIndexed ||
+            !pIndex->GetPrograms( (*chan_it).chanid, dtStartTime, dtEndTime,
+                                  schedList, progList ))
+        {
+            bindings[":CHANID"] = (*chan_it).chanid;
+            LoadFromProgram( progList, sSQL, bindings, schedList );
+        }
 
         // Create Program objects and add them to the channel object
         ProgramList::iterator progIt;
@@ -140,6 +163,8 @@ DTC::ProgramGuide *Guide::GetProgramGuide( const QDateTime &rawStartTime ,
         }
     }
 
+    pIndex->RecordRequest( bIndexed, bCacheHit, timer.nsecsElapsed() / 1000 );
+
     // ----------------------------------------------------------------------
 
     pGuide->setStartTime    ( dtStartTime   );
@@ -286,10 +311,42 @@ DTC::ProgramList* Guide::GetProgramList(int              nStartIndex,
         scheduler->GetAllPending(schedList);
 
     // ----------------------------------------------------------------------
+    // Searches without a person filter can be served by the guide index
+    // ----------------------------------------------------------------------
+
+    QElapsedTimer timer;
+    timer.start();
 
     uint nTotalAvailable = 0;
-    LoadFromProgram( progList, sSQL, bindings, schedList,
-                     (uint)nStartIndex, (uint)nCount, nTotalAvailable);
+    bool bIndexed        = false;
+    bool bCacheHit       = false;
+
+    GuideIndex *pIndex = GuideIndex::GetIndex();
+
+    if (sPersonFilter.isEmpty())
+    {
+        GuideIndexFilter filter;
+        filter.chanid     = nChanId;
+        filter.startTime  = dtStartTime;
+        filter.endTime    = dtEndTime;
+        filter.title      = sTitleFilter;
+        filter.category   = sCategoryFilter;
+        filter.keyword    = sKeywordFilter;
+        filter.sort       = sSort;
+        filter.descending = bDescending;
+
+        bIndexed = pIndex->Search( filter, schedList,
+                                   (uint)nStartIndex, (uint)nCount,
+                                   progList, nTotalAvailable, bCacheHit );
+    }
+
+    if (!bIndexed)
+    {
+        LoadFromProgram( progList, sSQL, bindings, schedList,
+                         (uint)nStartIndex, (uint)nCount, nTotalAvailable);
+    }
+
+    pIndex->RecordRequest( bIndexed, bCacheHit, timer.nsecsElapsed() / 1000 );
 
     // ----------------------------------------------------------------------
     // Build Response
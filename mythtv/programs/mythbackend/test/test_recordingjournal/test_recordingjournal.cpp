@@ -0,0 +1,3 @@
+#include "test_recordingjournal.h"
+
+QTEST_APPLESS_MAIN(TestRecordingJournal)
@@ -0,0 +1,163 @@
+/*
+ *  Class TestRecordingJournal
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+
+#include "recordingjournal.h"
+
+class TestRecordingJournal: public QObject
+{
+    Q_OBJECT
+
+    /// The recordedids changed since \p generation, or false for a full load
+    static bool Since(const RecordingJournal &journal, uint generation,
+                      QList<uint> &changed)
+    {
+        uint current;
+        changed.clear();
+        return journal.GetChangesSince(journal.GetEpoch(), generation,
+                                       current, changed);
+    }
+
+  private slots:
+
+    void changes_in_order(void)
+    {
+        RecordingJournal journal;
+        journal.Changed(5);
+        journal.Changed(7);
+
+        uint current = 0;
+        QList<uint> changed;
+        QVERIFY(journal.GetChangesSince(journal.GetEpoch(), 0,
+                                        current, changed));
+        QCOMPARE(current, 2U);
+        QCOMPARE(changed, QList<uint>() << 5 << 7);
+
+        QVERIFY(Since(journal, 1, changed));
+        QCOMPARE(changed, QList<uint>() << 7);
+
+        QVERIFY(Since(journal, 2, changed));
+        QVERIFY(changed.isEmpty());
+    }
+
+    void only_latest_change_is_kept(void)
+    {
+        RecordingJournal journal;
+        journal.Changed(5);
+        journal.Changed(7);
+        journal.Changed(5);
+
+        QList<uint> changed;
+        QVERIFY(Since(journal, 0, changed));
+        QCOMPARE(changed, QList<uint>() << 7 << 5);
+
+        QVERIFY(Since(journal, 2, changed));
+        QCOMPARE(changed, QList<uint>() << 5);
+    }
+
+    void no_recording_is_no_change(void)
+    {
+        RecordingJournal journal;
+        journal.Changed(0);
+
+        uint current = 1;
+        QList<uint> changed;
+        QVERIFY(journal.GetChangesSince(journal.GetEpoch(), 0,
+                                        current, changed));
+        QCOMPARE(current, 0U);
+        QVERIFY(changed.isEmpty());
+    }
+
+    void other_epoch_needs_full_list(void)
+    {
+        RecordingJournal journal;
+        journal.Changed(5);
+
+        uint current = 0;
+        QList<uint> changed;
+        QVERIFY(!journal.GetChangesSince(journal.GetEpoch() + 1, 0,
+                                         current, changed));
+        QCOMPARE(current, 1U);
+        QVERIFY(changed.isEmpty());
+    }
+
+    void future_generation_needs_full_list(void)
+    {
+        RecordingJournal journal;
+        journal.Changed(5);
+
+        QList<uint> changed;
+        QVERIFY(!Since(journal, 2, changed));
+    }
+
+    void reset_needs_full_list(void)
+    {
+        RecordingJournal journal;
+        journal.Changed(5);
+        journal.Reset();
+        journal.Changed(7);
+
+        QList<uint> changed;
+        QVERIFY(!Since(journal, 0, changed));
+        QVERIFY(!Since(journal, 1, changed));
+
+        QVERIFY(Since(journal, 2, changed));
+        QCOMPARE(changed, QList<uint>() << 7);
+    }
+
+    void oldest_changes_are_forgotten(void)
+    {
+        RecordingJournal journal;
+        uint entries = RecordingJournal::kMaxEntries;
+        for (uint i = 1; i <= entries + 1; i++)
+            journal.Changed(i);
+
+        QList<uint> changed;
+        QVERIFY(!Since(journal, 0, changed));
+
+        QVERIFY(Since(journal, 1, changed));
+        QCOMPARE((uint)changed.size(), entries);
+        QCOMPARE(changed.first(), 2U);
+        QCOMPARE(changed.last(), entries + 1);
+    }
+
+    void flags_changes_are_reported(void)
+    {
+        RecordingJournal journal;
+        QMap<QString,uint32_t> flags;
+
+        flags["1001_20150101000000"] = 0x1;
+        QCOMPARE(journal.FlagsChanged(flags),
+                 QStringList("1001_20150101000000"));
+
+        // Nothing moved on
+        QVERIFY(journal.FlagsChanged(flags).isEmpty());
+
+        // A recording without flags is the same as one left out
+        flags["1001_20150101000000"] = 0x2;
+        flags["1002_20150101000000"] = 0;
+        QCOMPARE(journal.FlagsChanged(flags),
+                 QStringList("1001_20150101000000"));
+
+        // Recordings no longer in use are reported once
+        QCOMPARE(journal.FlagsChanged(QMap<QString,uint32_t>()),
+                 QStringList("1001_20150101000000"));
+        QVERIFY(journal.FlagsChanged(QMap<QString,uint32_t>()).isEmpty());
+    }
+};
@@ -180,6 +180,20 @@ void UPnpCDSMusic::CreateRoot()
 //
 /////////////////////////////////////////////////////////////////////////////
 
+bool UPnpCDSMusic::IsCacheStale( const QString &sEvent )
+{
+    QString sMessage = sEvent.section(' ', 0, 0);
+
+    return (sMessage == "MUSIC_SCANNER_FINISHED" ||
+            sMessage == "MUSIC_RESYNC_FINISHED"  ||
+            sMessage == "MUSIC_METADATA_CHANGED" ||
+            sMessage == "MUSIC_ALBUMART_CHANGED");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
 bool UPnpCDSMusic::IsBrowseRequestForUs( UPnpCDSRequest *pRequest )
 {
     // ----------------------------------------------------------------------
@@ -26,6 +26,8 @@ class UPnpCDSMusic : public UPnpCDSExtension
         UPnpCDSMusic();
         virtual ~UPnpCDSMusic() { };
 
+        virtual bool             IsCacheStale( const QString &sEvent );
+
     protected:
 
         virtual bool             IsBrowseRequestForUs( UPnpCDSRequest *pRequest );
@@ -416,6 +416,17 @@ bool UPnpCDSTv::LoadChildren(const UPnpCDSRequest* pRequest,
 //
 /////////////////////////////////////////////////////////////////////////////
 
+bool UPnpCDSTv::IsCacheStale( const QString &sEvent )
+{
+    // Adds, deletes and changes to recording metadata, file size updates
+    // during a recording aren't worth rebuilding the tree for
+    return sEvent.section(' ', 0, 0) == "RECORDING_LIST_CHANGE";
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
 bool UPnpCDSTv::IsBrowseRequestForUs( UPnpCDSRequest *pRequest )
 {
     // ----------------------------------------------------------------------
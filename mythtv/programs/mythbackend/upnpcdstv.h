@@ -24,6 +24,8 @@ class UPnpCDSTv : public UPnpCDSExtension
         UPnpCDSTv();
         virtual ~UPnpCDSTv() {}
 
+        virtual bool             IsCacheStale( const QString &sEvent );
+
     protected:
 
         virtual bool             IsBrowseRequestForUs( UPnpCDSRequest *pRequest );
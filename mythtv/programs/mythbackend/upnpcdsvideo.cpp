@@ -145,6 +145,15 @@ void UPnpCDSVideo::CreateRoot()
 //
 /////////////////////////////////////////////////////////////////////////////
 
+bool UPnpCDSVideo::IsCacheStale( const QString &sEvent )
+{
+    return sEvent.section(' ', 0, 0) == "VIDEO_LIST_CHANGE";
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
 bool UPnpCDSVideo::IsBrowseRequestForUs( UPnpCDSRequest *pRequest )
 {
     // ----------------------------------------------------------------------
@@ -27,6 +27,8 @@ class UPnpCDSVideo : public UPnpCDSExtension
         UPnpCDSVideo( );
         virtual ~UPnpCDSVideo() {}
 
+        virtual bool             IsCacheStale( const QString &sEvent );
+
     protected:
 
         virtual bool             IsBrowseRequestForUs( UPnpCDSRequest *pRequest );
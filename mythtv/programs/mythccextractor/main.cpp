@@ -73,6 +73,7 @@ static int RunCCExtract(const ProgramInfo &program_info, const QString & destdir
                            .arg(filename)) << endl;
         return GENERIC_EXIT_PERMISSIONS_ERROR;
     }
+    tmprbuf->SetReadAheadPolicy(kReadAheadBatch);
 
     if (program_info.GetRecordingEndTime() > MythDate::current())
     {
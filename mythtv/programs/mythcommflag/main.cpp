@@ -872,6 +872,7 @@ static int FlagCommercials(ProgramInfo *program_info, int jobid,
         global_program_info = NULL;
         return GENERIC_EXIT_PERMISSIONS_ERROR;
     }
+    tmprbuf->SetReadAheadPolicy(kReadAheadBatch);
 
     if (useDB)
     {
@@ -1041,6 +1042,7 @@ static int RebuildSeekTable(ProgramInfo *pginfo, int jobid)
             QString("Unable to create RingBuffer for %1").arg(filename));
         return GENERIC_EXIT_PERMISSIONS_ERROR;
     }
+    tmprbuf->SetReadAheadPolicy(kReadAheadBatch);
 
     MythCommFlagPlayer *cfp = new MythCommFlagPlayer(
                                     (PlayerFlags)(kAudioMuted | kVideoIsNull |
@@ -32,6 +32,7 @@ using namespace std;
 
 // filldata headers
 #include "filldata.h"
+#include "xmltvinserter.h"
 
 #define LOC QString("FillData: ")
 #define LOC_WARN QString("FillData, Warning: ")
@@ -308,22 +309,18 @@ bool FillData::GrabDDData(Source source, int poffset,
 // XMLTV stuff
 bool FillData::GrabDataFromFile(int id, QString &filename)
 {
-    ChannelInfoList chanlist;
-    QMap<QString, QList<ProgInfo> > proglist;
+    XMLTVInserter inserter(&chan_data, id);
 
-    if (!xmltv_parser.parseFile(filename, &chanlist, &proglist))
+    bool ok = xmltv_parser.parseFile(filename, &inserter);
+    inserter.Finish();
+    if (!ok)
         return false;
 
-    chan_data.handleChannels(id, &chanlist);
-    if (proglist.count() == 0)
+    if (inserter.GetProgramCount() == 0)
     {
         LOG(VB_GENERAL, LOG_INFO, "No programs found in data.");
         endofdata = true;
     }
-    else
-    {
-        prog_data.HandlePrograms(id, proglist);
-    }
     return true;
 }
 
@@ -21,8 +21,8 @@ DEPENDPATH  += ../../libs/libmythtv/mpeg
 
 # Input
 HEADERS += filldata.h   channeldata.h
-HEADERS += xmltvparser.h
+HEADERS += xmltvparser.h xmltvinserter.h
 HEADERS += fillutil.h   commandlineparser.h
 SOURCES += filldata.cpp channeldata.cpp
-SOURCES += xmltvparser.cpp fillutil.cpp
+SOURCES += xmltvparser.cpp xmltvinserter.cpp fillutil.cpp
 SOURCES += main.cpp     commandlineparser.cpp
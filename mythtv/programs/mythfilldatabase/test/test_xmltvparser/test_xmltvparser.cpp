@@ -0,0 +1,3 @@
+#include "test_xmltvparser.h"
+
+QTEST_APPLESS_MAIN(TestXMLTVParser)
@@ -0,0 +1,184 @@
+/*
+ *  Class TestXMLTVParser
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <QtTest/QtTest>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QDateTime>
+
+#include "programdata.h"
+#include "xmltvparser.h"
+
+#define BENCHMARK_CHANNELS  200
+#define BENCHMARK_DAYS       14
+#define BENCHMARK_SLOTS      48  // half hour programmes
+
+// Streaming must not hold the whole guide in memory, the peak memory use
+// may only grow by this fraction of the file size while parsing it
+#define MAX_RSS_GROWTH_DIVISOR 4
+
+/// Counts what the parser hands over instead of inserting it
+class CountingListener : public XMLTVListener
+{
+  public:
+    CountingListener() :
+        channels(0), channelCalls(0), programs(0), batches(0), largestBatch(0)
+    {
+    }
+
+    void HandleChannels(ChannelInfoList &chanlist)
+    {
+        channels += chanlist.size();
+        channelCalls++;
+    }
+
+    void HandlePrograms(QMap<QString, QList<ProgInfo> > &proglist)
+    {
+        uint count = 0;
+        QMap<QString, QList<ProgInfo> >::const_iterator it = proglist.begin();
+        for (; it != proglist.end(); ++it)
+            count += (*it).size();
+        programs += count;
+        batches++;
+        largestBatch = std::max(largestBatch, count);
+        proglist.clear();
+    }
+
+    uint channels;
+    uint channelCalls;
+    uint programs;
+    uint batches;
+    uint largestBatch;
+};
+
+static long max_rss_kb(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+class TestXMLTVParser: public QObject
+{
+    Q_OBJECT
+
+  private:
+    QTemporaryFile m_file;
+
+  private slots:
+    // Writes a synthetic XMLTV file with all the elements the parser
+    // looks at, the programmes of each channel are kept together the
+    // way tv_sort and most grabbers write them.
+    void initTestCase(void)
+    {
+        QVERIFY(m_file.open());
+
+        QTextStream out(&m_file);
+        out.setCodec("UTF-8");
+        out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<!DOCTYPE tv SYSTEM \"xmltv.dtd\">\n"
+            << "<tv source-data-url=\"http://example.com/\" "
+               "generator-info-name=\"test_xmltvparser\">\n";
+
+        for (int c = 0; c < BENCHMARK_CHANNELS; c++)
+        {
+            out << QString("  <channel id=\"%1.example.com\">\n"
+                           "    <display-name>Channel %1</display-name>\n"
+                           "    <display-name>CH%1</display-name>\n"
+                           "    <display-name>%1</display-name>\n"
+                           "    <icon src=\"/icons/%1.png\" />\n"
+                           "  </channel>\n").arg(c + 1);
+        }
+
+        QDateTime start(QDate(2015, 6, 1), QTime(0, 0), Qt::UTC);
+        for (int c = 0; c < BENCHMARK_CHANNELS; c++)
+        {
+            for (int p = 0; p < BENCHMARK_DAYS * BENCHMARK_SLOTS; p++)
+            {
+                QDateTime begin = start.addSecs(p * 1800);
+                QDateTime end = begin.addSecs(1800);
+                out << QString(
+                    "  <programme start=\"%1 +0000\" stop=\"%2 +0000\" "
+                    "channel=\"%3.example.com\">\n"
+                    "    <title lang=\"en\">Programme %4</title>\n"
+                    "    <sub-title lang=\"en\">Episode %5</sub-title>\n"
+                    "    <desc lang=\"en\">A synthetic programme description "
+                    "that is about as long as the ones real grabbers produce, "
+                    "it mentions the plot, the guests and the weather.</desc>\n"
+                    "    <credits>\n"
+                    "      <director>Some Director</director>\n"
+                    "      <actor>First Actor</actor>\n"
+                    "      <actor>Second Actor</actor>\n"
+                    "    </credits>\n"
+                    "    <date>2014</date>\n"
+                    "    <category lang=\"en\">Drama</category>\n"
+                    "    <episode-num system=\"xmltv_ns\">%6.%5.0/1</episode-num>\n"
+                    "    <video><aspect>16:9</aspect><quality>HDTV</quality></video>\n"
+                    "    <audio><stereo>stereo</stereo></audio>\n"
+                    "    <subtitles type=\"teletext\" />\n"
+                    "    <rating system=\"BBFC\"><value>PG</value></rating>\n"
+                    "    <star-rating><value>3/4</value></star-rating>\n"
+                    "  </programme>\n")
+                    .arg(begin.toString("yyyyMMddHHmmss"))
+                    .arg(end.toString("yyyyMMddHHmmss"))
+                    .arg(c + 1).arg(p % 37).arg(p % 13).arg(p % 5);
+            }
+        }
+
+        out << "</tv>\n";
+        out.flush();
+        m_file.close();
+    }
+
+    // Parses the synthetic file, reports the time it took and checks
+    // that the peak memory use stays well below the size of the file
+    // and that no batch handed over is larger than kBatchSize.
+    void StreamingParse(void)
+    {
+        XMLTVParser parser;
+        CountingListener listener;
+
+        long rss_before = max_rss_kb();
+
+        QBENCHMARK_ONCE
+        {
+            QVERIFY(parser.parseFile(m_file.fileName(), &listener));
+        }
+
+        long rss_growth = max_rss_kb() - rss_before;
+        long file_kb = m_file.size() / 1024;
+
+        QVERIFY2(rss_growth <= file_kb / MAX_RSS_GROWTH_DIVISOR,
+                 qPrintable(QString("peak memory grew by %1 MB parsing "
+                                    "%2 MB of XMLTV")
+                            .arg(rss_growth / 1024).arg(file_kb / 1024)));
+
+        QCOMPARE(listener.channelCalls, 1U);
+        QCOMPARE(listener.channels, (uint)BENCHMARK_CHANNELS);
+        QCOMPARE(listener.programs,
+                 (uint)(BENCHMARK_CHANNELS * BENCHMARK_DAYS * BENCHMARK_SLOTS));
+        QVERIFY(listener.largestBatch <= XMLTVParser::kBatchSize);
+    }
+
+    void cleanupTestCase(void)
+    {
+    }
+};
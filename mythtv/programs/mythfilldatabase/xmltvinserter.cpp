@@ -0,0 +1,100 @@
+// libmyth headers
+#include "mythlogging.h"
+
+// libmythtv headers
+#include "programdata.h"
+
+// filldata headers
+#include "xmltvinserter.h"
+#include "channeldata.h"
+
+XMLTVInserter::XMLTVInserter(ChannelData *chan_data, uint sourceid) :
+    MThread("XMLTVInserter"),
+    m_chan_data(chan_data), m_sourceid(sourceid),
+    m_inserting(false), m_finishing(false),
+    m_programs(0), m_unchanged(0), m_updated(0)
+{
+    start();
+}
+
+XMLTVInserter::~XMLTVInserter()
+{
+    Finish();
+}
+
+/// Channels are needed before any of their programmes can be inserted,
+/// so they are handled right away on the parser's thread.
+void XMLTVInserter::HandleChannels(ChannelInfoList &chanlist)
+{
+    m_chan_data->handleChannels(m_sourceid, &chanlist);
+}
+
+void XMLTVInserter::HandlePrograms(QMap<QString, QList<ProgInfo> > &proglist)
+{
+    uint count = 0;
+    QMap<QString, QList<ProgInfo> >::const_iterator it = proglist.begin();
+    for (; it != proglist.end(); ++it)
+        count += (*it).size();
+
+    QMutexLocker locker(&m_lock);
+    while (m_queue.size() + (m_inserting ? 1 : 0) >= kMaxQueuedBatches)
+        m_wait.wait(&m_lock);
+    // Swap rather than copy, so the queued batch isn't shared with the
+    // parser and HandlePrograms() never has to detach it.
+    m_queue.enqueue(QMap<QString, QList<ProgInfo> >());
+    m_queue.last().swap(proglist);
+    m_programs += count;
+    m_wait.wakeAll();
+}
+
+void XMLTVInserter::Finish(void)
+{
+    m_lock.lock();
+    m_finishing = true;
+    m_wait.wakeAll();
+    m_lock.unlock();
+
+    if (!isFinished())
+        wait();
+}
+
+uint XMLTVInserter::GetProgramCount(void) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_programs;
+}
+
+void XMLTVInserter::run(void)
+{
+    RunProlog();
+
+    QMutexLocker locker(&m_lock);
+    while (true)
+    {
+        while (m_queue.isEmpty() && !m_finishing)
+            m_wait.wait(&m_lock);
+        if (m_queue.isEmpty())
+            break;
+
+        QMap<QString, QList<ProgInfo> > proglist = m_queue.dequeue();
+        uint unchanged = m_unchanged, updated = m_updated;
+        m_inserting = true;
+
+        locker.unlock();
+        ProgramData::HandlePrograms(m_sourceid, proglist, unchanged, updated);
+        proglist.clear();
+        locker.relock();
+
+        m_inserting = false;
+        m_unchanged = unchanged;
+        m_updated = updated;
+        m_wait.wakeAll();
+    }
+
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("Updated programs: %1 Unchanged programs: %2")
+                .arg(m_updated) .arg(m_unchanged));
+
+    locker.unlock();
+    RunEpilog();
+}
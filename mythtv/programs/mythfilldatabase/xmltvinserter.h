@@ -0,0 +1,63 @@
+#ifndef _XMLTVINSERTER_H_
+#define _XMLTVINSERTER_H_
+
+// Qt headers
+#include <QMap>
+#include <QList>
+#include <QQueue>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+// libmythbase headers
+#include "mthread.h"
+
+// filldata headers
+#include "xmltvparser.h"
+
+class ChannelData;
+class ProgInfo;
+
+/** \class XMLTVInserter
+ *  \brief Inserts the programmes XMLTVParser finds into the database on
+ *         a thread of its own, so parsing and inserting overlap.
+ *
+ *  At most kMaxQueuedBatches batches wait to be inserted, after that
+ *  the parser blocks until the database catches up.
+ */
+class XMLTVInserter : public XMLTVListener, public MThread
+{
+  public:
+    XMLTVInserter(ChannelData *chan_data, uint sourceid);
+    ~XMLTVInserter();
+
+    // XMLTVListener
+    void HandleChannels(ChannelInfoList &chanlist);
+    void HandlePrograms(QMap<QString, QList<ProgInfo> > &proglist);
+
+    /// Waits for all queued programmes to be inserted.
+    void Finish(void);
+
+    /// Number of programmes handed to the inserter so far
+    uint GetProgramCount(void) const;
+
+    static const int kMaxQueuedBatches = 2;
+
+  protected:
+    void run(void);
+
+  private:
+    ChannelData     *m_chan_data;
+    uint             m_sourceid;
+
+    mutable QMutex   m_lock;
+    QWaitCondition   m_wait;
+    QQueue<QMap<QString, QList<ProgInfo> > > m_queue;
+    bool             m_inserting;
+    bool             m_finishing;
+    uint             m_programs;
+    uint             m_unchanged;
+    uint             m_updated;
+};
+
+#endif // _XMLTVINSERTER_H_
@@ -4,7 +4,7 @@
 #include <QFile>
 #include <QStringList>
 #include <QDateTime>
-#include <QDomDocument>
+#include <QXmlStreamReader>
 #include <QUrl>
 
 // C++ headers
@@ -54,64 +54,60 @@ static uint ELFHash(const QByteArray &ba)
     return h;
 }
 
-static QString getFirstText(QDomElement element)
+/// Returns the text of the current element, ignoring any child elements
+static QString getFirstText(QXmlStreamReader &xml)
 {
-    for (QDomNode dname = element.firstChild(); !dname.isNull();
-         dname = dname.nextSibling())
-    {
-        QDomText t = dname.toText();
-        if (!t.isNull())
-            return t.data();
-    }
-    return QString();
+    return xml.readElementText(QXmlStreamReader::SkipChildElements);
 }
 
-ChannelInfo *XMLTVParser::parseChannel(QDomElement &element, QUrl &baseUrl)
+ChannelInfo *XMLTVParser::parseChannel(QXmlStreamReader &xml, QUrl &baseUrl)
 {
     ChannelInfo *chaninfo = new ChannelInfo;
 
-    QString xmltvid = element.attribute("id", "");
+    QString xmltvid = xml.attributes().value("id").toString();
 
     chaninfo->xmltvid = xmltvid;
     chaninfo->tvformat = "Default";
 
-    for (QDomNode child = element.firstChild(); !child.isNull();
-         child = child.nextSibling())
+    while (xml.readNextStartElement())
     {
-        QDomElement info = child.toElement();
-        if (!info.isNull())
+        if (xml.name() == QLatin1String("icon"))
         {
-            if (info.tagName() == "icon")
+            QString path = xml.attributes().value("src").toString();
+            if (!path.isEmpty() && !path.contains("://"))
             {
-                QString path = info.attribute("src", "");
-                if (!path.isEmpty() && !path.contains("://"))
-                {
-                    QString base = baseUrl.toString(QUrl::StripTrailingSlash);
-                    chaninfo->icon = base +
-                        ((path.startsWith("/")) ? path : QString("/") + path);
-                }
-                else if (!path.isEmpty())
-                {
-                    QUrl url(path);
-                    if (url.isValid())
-                        chaninfo->icon = url.toString();
-                }
+                QString base = baseUrl.toString(QUrl::StripTrailingSlash);
+                chaninfo->icon = base +
+                    ((path.startsWith("/")) ? path : QString("/") + path);
             }
-            else if (info.tagName() == "display-name")
+            else if (!path.isEmpty())
             {
-                if (chaninfo->name.isEmpty())
-                {
-                    chaninfo->name = info.text();
-                }
-                else if (chaninfo->callsign.isEmpty())
-                {
-                    chaninfo->callsign = info.text();
-                }
-                else if (chaninfo->channum.isEmpty())
-                {
-                    chaninfo->channum = info.text();
-                }
+                QUrl url(path);
+                if (url.isValid())
+                    chaninfo->icon = url.toString();
             }
+            xml.skipCurrentElement();
+        }
+        else if (xml.name() == QLatin1String("display-name"))
+        {
+            QString text = xml.readElementText(
+                QXmlStreamReader::IncludeChildElements);
+            if (chaninfo->name.isEmpty())
+            {
+                chaninfo->name = text;
+            }
+            else if (chaninfo->callsign.isEmpty())
+            {
+                chaninfo->callsign = text;
+            }
+            else if (chaninfo->channum.isEmpty())
+            {
+                chaninfo->channum = text;
+            }
+        }
+        else
+        {
+            xml.skipCurrentElement();
         }
     }
 
@@ -210,91 +206,108 @@ static void fromXMLTVDate(QString &timestr, QDateTime &dt)
     timestr = MythDate::toString(dt, MythDate::kFilename);
 }
 
-static void parseCredits(QDomElement &element, ProgInfo *pginfo)
+static void parseCredits(QXmlStreamReader &xml, ProgInfo *pginfo)
+{
+    while (xml.readNextStartElement())
+    {
+        QString role = xml.name().toString();
+        pginfo->AddPerson(role, getFirstText(xml));
+    }
+}
+
+static void parseVideo(QXmlStreamReader &xml, ProgInfo *pginfo)
 {
-    for (QDomNode child = element.firstChild(); !child.isNull();
-         child = child.nextSibling())
+    while (xml.readNextStartElement())
     {
-        QDomElement info = child.toElement();
-        if (!info.isNull())
-            pginfo->AddPerson(info.tagName(), getFirstText(info));
+        if (xml.name() == QLatin1String("quality"))
+        {
+            if (getFirstText(xml) == "HDTV")
+                pginfo->videoProps |= VID_HDTV;
+        }
+        else if (xml.name() == QLatin1String("aspect"))
+        {
+            if (getFirstText(xml) == "16:9")
+                pginfo->videoProps |= VID_WIDESCREEN;
+        }
+        else
+        {
+            xml.skipCurrentElement();
+        }
     }
 }
 
-static void parseVideo(QDomElement &element, ProgInfo *pginfo)
+static void parseAudio(QXmlStreamReader &xml, ProgInfo *pginfo)
 {
-    for (QDomNode child = element.firstChild(); !child.isNull();
-         child = child.nextSibling())
+    while (xml.readNextStartElement())
     {
-        QDomElement info = child.toElement();
-        if (!info.isNull())
+        if (xml.name() == QLatin1String("stereo"))
         {
-            if (info.tagName() == "quality")
+            QString text = getFirstText(xml);
+            if (text == "mono")
+            {
+                pginfo->audioProps |= AUD_MONO;
+            }
+            else if (text == "stereo")
+            {
+                pginfo->audioProps |= AUD_STEREO;
+            }
+            else if (text == "dolby" || text == "dolby digital")
             {
-                if (getFirstText(info) == "HDTV")
-                    pginfo->videoProps |= VID_HDTV;
+                pginfo->audioProps |= AUD_DOLBY;
             }
-            else if (info.tagName() == "aspect")
+            else if (text == "surround")
             {
-                if (getFirstText(info) == "16:9")
-                    pginfo->videoProps |= VID_WIDESCREEN;
+                pginfo->audioProps |= AUD_SURROUND;
             }
         }
+        else
+        {
+            xml.skipCurrentElement();
+        }
     }
 }
 
-static void parseAudio(QDomElement &element, ProgInfo *pginfo)
+/// Reads the text of the first \<value\> child of the current element
+static bool getFirstValue(QXmlStreamReader &xml, QString &value)
 {
-    for (QDomNode child = element.firstChild(); !child.isNull();
-         child = child.nextSibling())
+    bool found = false;
+    while (xml.readNextStartElement())
     {
-        QDomElement info = child.toElement();
-        if (!info.isNull())
+        if (!found && xml.name() == QLatin1String("value"))
         {
-            if (info.tagName() == "stereo")
-            {
-                if (getFirstText(info) == "mono")
-                {
-                    pginfo->audioProps |= AUD_MONO;
-                }
-                else if (getFirstText(info) == "stereo")
-                {
-                    pginfo->audioProps |= AUD_STEREO;
-                }
-                else if (getFirstText(info) == "dolby" ||
-                        getFirstText(info) == "dolby digital")
-                {
-                    pginfo->audioProps |= AUD_DOLBY;
-                }
-                else if (getFirstText(info) == "surround")
-                {
-                    pginfo->audioProps |= AUD_SURROUND;
-                }
-            }
+            value = getFirstText(xml);
+            found = true;
+        }
+        else
+        {
+            xml.skipCurrentElement();
         }
     }
+    return found;
 }
 
-ProgInfo *XMLTVParser::parseProgram(QDomElement &element)
+ProgInfo *XMLTVParser::parseProgram(QXmlStreamReader &xml)
 {
     QString uniqueid, season, episode, totalepisodes;
     int dd_progid_done = 0;
     ProgInfo *pginfo = new ProgInfo();
 
-    QString text = element.attribute("start", "");
+    QXmlStreamAttributes attributes = xml.attributes();
+
+    QString text = attributes.value("start").toString();
     fromXMLTVDate(text, pginfo->starttime);
     pginfo->startts = text;
 
-    text = element.attribute("stop", "");
+    text = attributes.value("stop").toString();
     fromXMLTVDate(text, pginfo->endtime);
     pginfo->endts = text;
 
-    text = element.attribute("channel", "");
+    text = attributes.value("channel").toString();
     QStringList split = text.split(" ");
 
     pginfo->channel = split[0];
 
-    text = element.attribute("clumpidx", "");
+    text = attributes.value("clumpidx").toString();
     if (!text.isEmpty())
     {
         split = text.split('/');
@@ -302,241 +315,248 @@ ProgInfo *XMLTVParser::parseProgram(QDomElement &element)
         pginfo->clumpmax = split[1];
     }
 
-    for (QDomNode child = element.firstChild(); !child.isNull();
-         child = child.nextSibling())
+    while (xml.readNextStartElement())
     {
-        QDomElement info = child.toElement();
-        if (!info.isNull())
+        const QStringRef tag = xml.name();
+        attributes = xml.attributes();
+
+        if (tag == QLatin1String("title"))
         {
-            if (info.tagName() == "title")
+            if (attributes.value("lang") == QLatin1String("ja_JP"))
             {
-                if (info.attribute("lang") == "ja_JP")
-                {
-                    pginfo->title = getFirstText(info);
-                }
-                else if (info.attribute("lang") == "ja_JP@kana")
-                {
-                    pginfo->title_pronounce = getFirstText(info);
-                }
-                else if (pginfo->title.isEmpty())
-                {
-                    pginfo->title = getFirstText(info);
-                }
+                pginfo->title = getFirstText(xml);
             }
-            else if (info.tagName() == "sub-title" &&
-                     pginfo->subtitle.isEmpty())
+            else if (attributes.value("lang") == QLatin1String("ja_JP@kana"))
             {
-                pginfo->subtitle = getFirstText(info);
+                pginfo->title_pronounce = getFirstText(xml);
             }
-            else if (info.tagName() == "desc" && pginfo->description.isEmpty())
+            else if (pginfo->title.isEmpty())
             {
-                pginfo->description = getFirstText(info);
+                pginfo->title = getFirstText(xml);
             }
-            else if (info.tagName() == "category")
-            {
-                const QString cat = getFirstText(info).toLower();
-
-                if (ProgramInfo::kCategoryNone == pginfo->categoryType &&
-                    string_to_myth_category_type(cat) != ProgramInfo::kCategoryNone)
-                {
-                    pginfo->categoryType = string_to_myth_category_type(cat);
-                }
-                else if (pginfo->category.isEmpty())
-                {
-                    pginfo->category = cat;
-                }
-
-                if (cat == QObject::tr("movie") || cat == QObject::tr("film"))
-                {
-                    // Hack for tv_grab_uk_rt
-                    pginfo->categoryType = ProgramInfo::kCategoryMovie;
-                }
-            }
-            else if (info.tagName() == "date" && !pginfo->airdate)
+            else
             {
-                // Movie production year
-                QString date = getFirstText(info);
-                pginfo->airdate = date.left(4).toUInt();
+                xml.skipCurrentElement();
             }
-            else if (info.tagName() == "star-rating" && pginfo->stars == 0.0)
-            {
-                QDomNodeList values = info.elementsByTagName("value");
-                QDomElement item;
-                QString stars;
-                float num, den;
-                float rating = 0.0;
-
-                // Use the first rating to appear in the xml, this should be
-                // the most important one.
-                //
-                // Averaging is not a good idea here, any subsequent ratings
-                // are likely to represent that days recommended programmes
-                // which on a bad night could given to an average programme.
-                // In the case of uk_rt it's not unknown for a recommendation
-                // to be given to programmes which are 'so bad, you have to
-                // watch!'
-                //
-                // XMLTV uses zero based ratings and signals no rating by absence.
-                // A rating from 1 to 5 is encoded as 0/4 to 4/4.
-                // MythTV uses zero to signal no rating!
-                // The same rating is encoded as 0.2 to 1.0 with steps of 0.2, it
-                // is not encoded as 0.0 to 1.0 with steps of 0.25 because
-                // 0 signals no rating!
-                // See http://xmltv.cvs.sourceforge.net/viewvc/xmltv/xmltv/xmltv.dtd?revision=1.47&view=markup#l539
-                item = values.item(0).toElement();
-                if (!item.isNull())
-                {
-                    stars = getFirstText(item);
-                    num = stars.section('/', 0, 0).toFloat() + 1;
-                    den = stars.section('/', 1, 1).toFloat() + 1;
-                    if (0.0 < den)
-                        rating = num/den;
-                }
+        }
+        else if (tag == QLatin1String("sub-title") &&
+                 pginfo->subtitle.isEmpty())
+        {
+            pginfo->subtitle = getFirstText(xml);
+        }
+        else if (tag == QLatin1String("desc") && pginfo->description.isEmpty())
+        {
+            pginfo->description = getFirstText(xml);
+        }
+        else if (tag == QLatin1String("category"))
+        {
+            const QString cat = getFirstText(xml).toLower();
 
-                pginfo->stars = rating;
-            }
-            else if (info.tagName() == "rating")
+            if (ProgramInfo::kCategoryNone == pginfo->categoryType &&
+                string_to_myth_category_type(cat) != ProgramInfo::kCategoryNone)
             {
-                // again, the structure of ratings seems poorly represented
-                // in the XML.  no idea what we'd do with multiple values.
-                QDomNodeList values = info.elementsByTagName("value");
-                QDomElement item = values.item(0).toElement();
-                if (item.isNull())
-                    continue;
-                EventRating rating;
-                rating.system = info.attribute("system", "");
-                rating.rating = getFirstText(item);
-                pginfo->ratings.append(rating);
+                pginfo->categoryType = string_to_myth_category_type(cat);
             }
-            else if (info.tagName() == "previously-shown")
+            else if (pginfo->category.isEmpty())
             {
-                pginfo->previouslyshown = true;
-
-                QString prevdate = info.attribute("start");
-                if (!prevdate.isEmpty())
-                {
-                    QDateTime date;
-                    fromXMLTVDate(prevdate, date);
-                    pginfo->originalairdate = date.date();
-                }
+                pginfo->category = cat;
             }
-            else if (info.tagName() == "credits")
+
+            if (cat == QObject::tr("movie") || cat == QObject::tr("film"))
             {
-                parseCredits(info, pginfo);
+                // Hack for tv_grab_uk_rt
+                pginfo->categoryType = ProgramInfo::kCategoryMovie;
             }
-            else if (info.tagName() == "subtitles")
+        }
+        else if (tag == QLatin1String("date") && !pginfo->airdate)
+        {
+            // Movie production year
+            QString date = getFirstText(xml);
+            pginfo->airdate = date.left(4).toUInt();
+        }
+        else if (tag == QLatin1String("star-rating") && pginfo->stars == 0.0)
+        {
+            QString stars;
+            float num, den;
+            float rating = 0.0;
+
+            // Use the first rating to appear in the xml, this should be
+            // the most important one.
+            //
+            // Averaging is not a good idea here, any subsequent ratings
+            // are likely to represent that days recommended programmes
+            // which on a bad night could given to an average programme.
+            // In the case of uk_rt it's not unknown for a recommendation
+            // to be given to programmes which are 'so bad, you have to
+            // watch!'
+            //
+            // XMLTV uses zero based ratings and signals no rating by absence.
+            // A rating from 1 to 5 is encoded as 0/4 to 4/4.
+            // MythTV uses zero to signal no rating!
+            // The same rating is encoded as 0.2 to 1.0 with steps of 0.2, it
+            // is not encoded as 0.0 to 1.0 with steps of 0.25 because
+            // 0 signals no rating!
+            // See http://xmltv.cvs.sourceforge.net/viewvc/xmltv/xmltv/xmltv.dtd?revision=1.47&view=markup#l539
+            if (getFirstValue(xml, stars))
             {
-                if (info.attribute("type") == "teletext")
-                    pginfo->subtitleType |= SUB_NORMAL;
-                else if (info.attribute("type") == "onscreen")
-                    pginfo->subtitleType |= SUB_ONSCREEN;
-                else if (info.attribute("type") == "deaf-signed")
-                    pginfo->subtitleType |= SUB_SIGNED;
+                num = stars.section('/', 0, 0).toFloat() + 1;
+                den = stars.section('/', 1, 1).toFloat() + 1;
+                if (0.0 < den)
+                    rating = num/den;
             }
-            else if (info.tagName() == "audio")
+
+            pginfo->stars = rating;
+        }
+        else if (tag == QLatin1String("rating"))
+        {
+            // again, the structure of ratings seems poorly represented
+            // in the XML.  no idea what we'd do with multiple values.
+            EventRating rating;
+            rating.system = attributes.value("system").toString();
+            if (!getFirstValue(xml, rating.rating))
+                continue;
+            pginfo->ratings.append(rating);
+        }
+        else if (tag == QLatin1String("previously-shown"))
+        {
+            pginfo->previouslyshown = true;
+
+            QString prevdate = attributes.value("start").toString();
+            if (!prevdate.isEmpty())
             {
-                parseAudio(info, pginfo);
+                QDateTime date;
+                fromXMLTVDate(prevdate, date);
+                pginfo->originalairdate = date.date();
             }
-            else if (info.tagName() == "video")
+            xml.skipCurrentElement();
+        }
+        else if (tag == QLatin1String("credits"))
+        {
+            parseCredits(xml, pginfo);
+        }
+        else if (tag == QLatin1String("subtitles"))
+        {
+            if (attributes.value("type") == QLatin1String("teletext"))
+                pginfo->subtitleType |= SUB_NORMAL;
+            else if (attributes.value("type") == QLatin1String("onscreen"))
+                pginfo->subtitleType |= SUB_ONSCREEN;
+            else if (attributes.value("type") == QLatin1String("deaf-signed"))
+                pginfo->subtitleType |= SUB_SIGNED;
+            xml.skipCurrentElement();
+        }
+        else if (tag == QLatin1String("audio"))
+        {
+            parseAudio(xml, pginfo);
+        }
+        else if (tag == QLatin1String("video"))
+        {
+            parseVideo(xml, pginfo);
+        }
+        else if (tag == QLatin1String("episode-num"))
+        {
+            const QString system = attributes.value("system").toString();
+            if (system == "dd_progid")
             {
-                parseVideo(info, pginfo);
+                QString episodenum(getFirstText(xml));
+                // if this field includes a dot, strip it out
+                int idx = episodenum.indexOf('.');
+                if (idx != -1)
+                    episodenum.remove(idx, 1);
+                pginfo->programId = episodenum;
+                dd_progid_done = 1;
             }
-            else if (info.tagName() == "episode-num")
+            else if (system == "xmltv_ns")
             {
-                if (info.attribute("system") == "dd_progid")
+                int tmp;
+                QString episodenum(getFirstText(xml));
+                episode = episodenum.section('.',1,1);
+                totalepisodes = episode.section('/',1,1).trimmed();
+                episode = episode.section('/',0,0).trimmed();
+                season = episodenum.section('.',0,0).trimmed();
+                QString part(episodenum.section('.',2,2));
+                QString partnumber(part.section('/',0,0).trimmed());
+                QString parttotal(part.section('/',1,1).trimmed());
+
+                pginfo->categoryType = ProgramInfo::kCategorySeries;
+
+                if (!season.isEmpty())
                 {
-                    QString episodenum(getFirstText(info));
-                    // if this field includes a dot, strip it out
-                    int idx = episodenum.indexOf('.');
-                    if (idx != -1)
-                        episodenum.remove(idx, 1);
-                    pginfo->programId = episodenum;
-                    dd_progid_done = 1;
+                    tmp = season.toUInt() + 1;
+                    pginfo->season = tmp;
+                    season = QString::number(tmp);
+                    pginfo->syndicatedepisodenumber = QString('S' + season);
                 }
-                else if (info.attribute("system") == "xmltv_ns")
-                {
-                    int tmp;
-                    QString episodenum(getFirstText(info));
-                    episode = episodenum.section('.',1,1);
-                    totalepisodes = episode.section('/',1,1).trimmed();
-                    episode = episode.section('/',0,0).trimmed();
-                    season = episodenum.section('.',0,0).trimmed();
-                    QString part(episodenum.section('.',2,2));
-                    QString partnumber(part.section('/',0,0).trimmed());
-                    QString parttotal(part.section('/',1,1).trimmed());
-
-                    pginfo->categoryType = ProgramInfo::kCategorySeries;
-
-                    if (!season.isEmpty())
-                    {
-                        tmp = season.toUInt() + 1;
-                        pginfo->season = tmp;
-                        season = QString::number(tmp);
-                        pginfo->syndicatedepisodenumber = QString('S' + season);
-                    }
-
-                    if (!episode.isEmpty())
-                    {
-                        tmp = episode.toUInt() + 1;
-                        pginfo->episode = tmp;
-                        episode = QString::number(tmp);
-                        pginfo->syndicatedepisodenumber.append(QString('E' + episode));
-                    }
 
-                    if (!totalepisodes.isEmpty())
-                    {
-                        pginfo->totalepisodes = totalepisodes.toUInt();
-                    }
+                if (!episode.isEmpty())
+                {
+                    tmp = episode.toUInt() + 1;
+                    pginfo->episode = tmp;
+                    episode = QString::number(tmp);
+                    pginfo->syndicatedepisodenumber.append(QString('E' + episode));
+                }
 
-                    uint partno = 0;
-                    if (!partnumber.isEmpty())
-                    {
-                        bool ok;
-                        partno = partnumber.toUInt(&ok) + 1;
-                        partno = (ok) ? partno : 0;
-                    }
+                if (!totalepisodes.isEmpty())
+                {
+                    pginfo->totalepisodes = totalepisodes.toUInt();
+                }
 
-                    if (!parttotal.isEmpty() && partno > 0)
-                    {
-                        bool ok;
-                        uint partto = parttotal.toUInt(&ok);
-                        if (ok && partnumber <= parttotal)
-                        {
-                            pginfo->parttotal  = partto;
-                            pginfo->partnumber = partno;
-                        }
-                    }
+                uint partno = 0;
+                if (!partnumber.isEmpty())
+                {
+                    bool ok;
+                    partno = partnumber.toUInt(&ok) + 1;
+                    partno = (ok) ? partno : 0;
                 }
-                else if (info.attribute("system") == "onscreen")
+
+                if (!parttotal.isEmpty() && partno > 0)
                 {
-                    pginfo->categoryType = ProgramInfo::kCategorySeries;
-                    if (pginfo->subtitle.isEmpty())
+                    bool ok;
+                    uint partto = parttotal.toUInt(&ok);
+                    if (ok && partnumber <= parttotal)
                     {
-                        pginfo->subtitle = getFirstText(info);
+                        pginfo->parttotal  = partto;
+                        pginfo->partnumber = partno;
                     }
                 }
-                else if ((info.attribute("system") == "themoviedb.org") &&
-                    (MetadataDownload::GetMovieGrabber().endsWith(QString("/tmdb3.py"))))
+            }
+            else if (system == "onscreen")
+            {
+                pginfo->categoryType = ProgramInfo::kCategorySeries;
+                QString onscreen(getFirstText(xml));
+                if (pginfo->subtitle.isEmpty())
                 {
-                    /* text is movie/<inetref> */
-                    QString inetrefRaw(getFirstText(info));
-                    if (inetrefRaw.startsWith(QString("movie/"))) {
-                        QString inetref(QString ("tmdb3.py_") + inetrefRaw.section('/',1,1).trimmed());
-                        pginfo->inetref = inetref;
-                    }
+                    pginfo->subtitle = onscreen;
                 }
-                else if ((info.attribute("system") == "thetvdb.com") &&
-                    (MetadataDownload::GetTelevisionGrabber().endsWith(QString("/ttvdb.py"))))
-                {
-                    /* text is series/<inetref> */
-                    QString inetrefRaw(getFirstText(info));
-                    if (inetrefRaw.startsWith(QString("series/"))) {
-                        QString inetref(QString ("ttvdb.py_") + inetrefRaw.section('/',1,1).trimmed());
-                        pginfo->inetref = inetref;
-                        /* ProgInfo does not have a collectionref, so we don't set any */
-                    }
+            }
+            else if ((system == "themoviedb.org") &&
+                (MetadataDownload::GetMovieGrabber().endsWith(QString("/tmdb3.py"))))
+            {
+                /* text is movie/<inetref> */
+                QString inetrefRaw(getFirstText(xml));
+                if (inetrefRaw.startsWith(QString("movie/"))) {
+                    QString inetref(QString ("tmdb3.py_") + inetrefRaw.section('/',1,1).trimmed());
+                    pginfo->inetref = inetref;
+                }
+            }
+            else if ((system == "thetvdb.com") &&
+                (MetadataDownload::GetTelevisionGrabber().endsWith(QString("/ttvdb.py"))))
+            {
+                /* text is series/<inetref> */
+                QString inetrefRaw(getFirstText(xml));
+                if (inetrefRaw.startsWith(QString("series/"))) {
+                    QString inetref(QString ("ttvdb.py_") + inetrefRaw.section('/',1,1).trimmed());
+                    pginfo->inetref = inetref;
+                    /* ProgInfo does not have a collectionref, so we don't set any */
                 }
             }
+            else
+            {
+                xml.skipCurrentElement();
+            }
+        }
+        else
+        {
+            xml.skipCurrentElement();
         }
     }
 
@@ -606,11 +626,17 @@ ProgInfo *XMLTVParser::parseProgram(QDomElement &element)
     return pginfo;
 }
 
-bool XMLTVParser::parseFile(
-    QString filename, ChannelInfoList *chanlist,
-    QMap<QString, QList<ProgInfo> > *proglist)
+/** \brief Streams through an XMLTV file, handing its channels and then
+ *         batches of its programmes to the listener.
+ *
+ *  Programmes are handed over about kBatchSize at a time, so memory use
+ *  doesn't grow with the size of the file. Grabbers normally write all
+ *  programmes of a channel together, so the channel currently being read
+ *  is held back until the next batch where possible, this keeps
+ *  ProgramData::FixProgramList() working on whole channels.
+ */
+bool XMLTVParser::parseFile(QString filename, XMLTVListener *listener)
 {
-    QDomDocument doc;
     QFile f;
 
     if (!dash_open(f, filename, QIODevice::ReadOnly))
@@ -620,94 +646,137 @@ bool XMLTVParser::parseFile(
         return false;
     }
 
-    QString errorMsg = "unknown";
-    int errorLine = 0;
-    int errorColumn = 0;
+    QXmlStreamReader xml(&f);
 
-    if (!doc.setContent(&f, &errorMsg, &errorLine, &errorColumn))
-    {
-        LOG(VB_GENERAL, LOG_ERR, QString("Error in %1:%2: %3")
-            .arg(errorLine).arg(errorColumn).arg(errorMsg));
-
-        f.close();
-        return true;
-    }
-
-    f.close();
+    QUrl baseUrl;
+    //QUrl sourceUrl;
 
-    QDomElement docElem = doc.documentElement();
+    ChannelInfoList chanlist;
+    bool channels_handled = false;
 
-    QUrl baseUrl(docElem.attribute("source-data-url", ""));
-    //QUrl sourceUrl(docElem.attribute("source-info-url", ""));
+    QMap<QString, QList<ProgInfo> > proglist;
+    uint pending = 0;
 
     QString aggregatedTitle;
     QString aggregatedDesc;
 
-    QDomNode n = docElem.firstChild();
-    while (!n.isNull())
+    while (!xml.atEnd() && !xml.hasError())
     {
-        QDomElement e = n.toElement();
-        if (!e.isNull())
+        if (!xml.readNextStartElement())
+            continue;
+
+        if (xml.name() == QLatin1String("tv"))
+        {
+            baseUrl = QUrl(
+                xml.attributes().value("source-data-url").toString());
+            // descend into the channels and programmes
+        }
+        else if (xml.name() == QLatin1String("channel"))
         {
-            if (e.tagName() == "channel")
+            ChannelInfo *chinfo = parseChannel(xml, baseUrl);
+            if (!chinfo->xmltvid.isEmpty())
+                chanlist.push_back(*chinfo);
+            delete chinfo;
+        }
+        else if (xml.name() == QLatin1String("programme"))
+        {
+            if (!channels_handled)
+            {
+                listener->HandleChannels(chanlist);
+                chanlist.clear();
+                channels_handled = true;
+            }
+
+            ProgInfo *pginfo = parseProgram(xml);
+
+            if (pginfo->startts == pginfo->endts)
             {
-                ChannelInfo *chinfo = parseChannel(e, baseUrl);
-                if (!chinfo->xmltvid.isEmpty())
-                    chanlist->push_back(*chinfo);
-                delete chinfo;
+                LOG(VB_GENERAL, LOG_WARNING, QString("Invalid programme (%1), "
+                                                    "identical start and end "
+                                                    "times, skipping")
+                                                    .arg(pginfo->title));
+                delete pginfo;
+                continue;
             }
-            else if (e.tagName() == "programme")
+
+            bool add = true;
+            if (!pginfo->clumpidx.isEmpty())
             {
-                ProgInfo *pginfo = parseProgram(e);
+                /* append all titles/descriptions from one clump */
+                if (pginfo->clumpidx.toInt() == 0)
+                {
+                    aggregatedTitle.clear();
+                    aggregatedDesc.clear();
+                }
 
-                if (pginfo->startts == pginfo->endts)
+                if (!pginfo->title.isEmpty())
                 {
-                    LOG(VB_GENERAL, LOG_WARNING, QString("Invalid programme (%1), "
-                                                        "identical start and end "
-                                                        "times, skipping")
-                                                        .arg(pginfo->title));
+                    if (!aggregatedTitle.isEmpty())
+                        aggregatedTitle.append(" | ");
+                    aggregatedTitle.append(pginfo->title);
                 }
-                else
+
+                if (!pginfo->description.isEmpty())
                 {
-                    if (pginfo->clumpidx.isEmpty())
-                        (*proglist)[pginfo->channel].push_back(*pginfo);
-                    else
-                    {
-                        /* append all titles/descriptions from one clump */
-                        if (pginfo->clumpidx.toInt() == 0)
-                        {
-                            aggregatedTitle.clear();
-                            aggregatedDesc.clear();
-                        }
-
-                        if (!pginfo->title.isEmpty())
-                        {
-                            if (!aggregatedTitle.isEmpty())
-                                aggregatedTitle.append(" | ");
-                            aggregatedTitle.append(pginfo->title);
-                        }
-
-                        if (!pginfo->description.isEmpty())
-                        {
-                            if (!aggregatedDesc.isEmpty())
-                                aggregatedDesc.append(" | ");
-                            aggregatedDesc.append(pginfo->description);
-                        }
-                        if (pginfo->clumpidx.toInt() ==
-                            pginfo->clumpmax.toInt() - 1)
-                        {
-                            pginfo->title = aggregatedTitle;
-                            pginfo->description = aggregatedDesc;
-                            (*proglist)[pginfo->channel].push_back(*pginfo);
-                        }
-                    }
+                    if (!aggregatedDesc.isEmpty())
+                        aggregatedDesc.append(" | ");
+                    aggregatedDesc.append(pginfo->description);
                 }
-                delete pginfo;
+
+                add = (pginfo->clumpidx.toInt() ==
+                       pginfo->clumpmax.toInt() - 1);
+                if (add)
+                {
+                    pginfo->title = aggregatedTitle;
+                    pginfo->description = aggregatedDesc;
+                }
+            }
+
+            if (add)
+            {
+                proglist[pginfo->channel].push_back(*pginfo);
+                pending++;
+            }
+
+            if (pending >= kBatchSize)
+            {
+                // Hold back the channel we are in the middle of, unless
+                // it is the only one we have.
+                QList<ProgInfo> current = proglist.take(pginfo->channel);
+                if (proglist.isEmpty())
+                {
+                    proglist[pginfo->channel] = current;
+                    current.clear();
+                }
+
+                listener->HandlePrograms(proglist);
+                proglist.clear();
+                pending = current.size();
+                if (pending)
+                    proglist[pginfo->channel] = current;
             }
+
+            delete pginfo;
+        }
+        else
+        {
+            xml.skipCurrentElement();
         }
-        n = n.nextSibling();
     }
 
+    if (xml.hasError())
+    {
+        LOG(VB_GENERAL, LOG_ERR, QString("Error in %1:%2: %3")
+            .arg(xml.lineNumber()).arg(xml.columnNumber())
+            .arg(xml.errorString()));
+    }
+
+    f.close();
+
+    if (!channels_handled)
+        listener->HandleChannels(chanlist);
+    if (!proglist.isEmpty())
+        listener->HandlePrograms(proglist);
+
     return true;
 }
-
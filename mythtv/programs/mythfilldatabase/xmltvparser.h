@@ -11,17 +11,36 @@
 
 class ProgInfo;
 class QUrl;
-class QDomElement;
+class QXmlStreamReader;
+
+/** \class XMLTVListener
+ *  \brief Receives the channels and programmes XMLTVParser finds
+ *         while it streams through an XMLTV file.
+ */
+class XMLTVListener
+{
+  public:
+    /// Called once with all the channels, before any programmes
+    virtual void HandleChannels(ChannelInfoList &chanlist) = 0;
+    /// Called with batches of programmes, keyed by XMLTV channel id,
+    /// the listener may take over the contents of proglist
+    virtual void HandlePrograms(QMap<QString, QList<ProgInfo> > &proglist) = 0;
+
+  protected:
+    virtual ~XMLTVListener() {}
+};
 
 class XMLTVParser
 {
   public:
     XMLTVParser();
 
-    ChannelInfo *parseChannel(QDomElement &element, QUrl &baseUrl);
-    ProgInfo *parseProgram(QDomElement &element);
-    bool parseFile(QString filename, ChannelInfoList *chanlist,
-                   QMap<QString, QList<ProgInfo> > *proglist);
+    ChannelInfo *parseChannel(QXmlStreamReader &xml, QUrl &baseUrl);
+    ProgInfo *parseProgram(QXmlStreamReader &xml);
+    bool parseFile(QString filename, XMLTVListener *listener);
+
+    /// Number of programmes handed to the listener at a time
+    static const uint kBatchSize = 5000;
 
   private:
     unsigned int current_year;
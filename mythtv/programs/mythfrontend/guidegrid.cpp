@@ -11,6 +11,8 @@ using namespace std;
 #include <QCoreApplication>
 #include <QKeyEvent>
 #include <QDateTime>
+#include <QCache>
+#include <QSet>
 
 // libmythbase
 #include "mythdate.h"
@@ -186,6 +188,214 @@ bool JumpToChannel::Update(void)
     }
 }
 
+/** \class GuideProgramCache
+ *  \brief Listings of the channels around the visible part of the guide.
+ *
+ *   Listings are loaded with one query per set of channels, and kept
+ *   in blocks of one channel by kBlockSecs of time. The prefetcher fills
+ *   the blocks next to the visible part of the guide so that a page
+ *   up/down/left/right can be served without waiting for the database.
+ */
+class GuideProgramCache
+{
+  public:
+    GuideProgramCache() : m_blocks(kMaxPrograms), m_generation(0) {}
+
+    static const uint kBlockSecs   = 3 * 60 * 60;
+    static const uint kMaxAgeSecs  = 15 * 60;
+    static const int  kMaxPrograms = 20000;
+
+    static uint BlockOf(const QDateTime &t)
+        { return t.toTime_t() / kBlockSecs; }
+    static QDateTime BlockStart(uint block)
+        { return MythDate::fromTime_t(block * kBlockSecs); }
+
+    void Load(const QVector<uint> &chanids, const QDateTime &start,
+              const QDateTime &end, const ProgramList &schedList);
+    ProgramList *Get(uint chanid, const QDateTime &start,
+                     const QDateTime &end);
+    void Clear(void);
+
+  private:
+    class Block
+    {
+      public:
+        Block() : m_loaded(MythDate::current()) {}
+        ProgramList m_programs;
+        QDateTime   m_loaded;
+    };
+
+    static quint64 Key(uint chanid, uint block)
+        { return ((quint64)chanid << 32) | block; }
+    Block *GetBlock(uint chanid, uint block);
+
+    QMutex                 m_lock;
+    QCache<quint64, Block> m_blocks;
+    uint                   m_generation;
+};
+
+/// Returns the block if it is loaded and fresh, m_lock must be held
+GuideProgramCache::Block *GuideProgramCache::GetBlock(uint chanid, uint block)
+{
+    Block *b = m_blocks.object(Key(chanid, block));
+    if (b && b->m_loaded.secsTo(MythDate::current()) > (int)kMaxAgeSecs)
+    {
+        m_blocks.remove(Key(chanid, block));
+        b = NULL;
+    }
+    return b;
+}
+
+/** \fn GuideProgramCache::Load(const QVector<uint>&,const QDateTime&,const QDateTime&,const ProgramList&)
+ *  \brief Loads the blocks covering start to end for each channel which
+ *         doesn't have all of them yet, using a single query.
+ */
+void GuideProgramCache::Load(const QVector<uint> &chanids,
+                             const QDateTime &start, const QDateTime &end,
+                             const ProgramList &schedList)
+{
+    uint first = BlockOf(start);
+    uint last  = BlockOf(end);
+    uint generation;
+    QStringList missing;
+
+    {
+        QMutexLocker locker(&m_lock);
+        generation = m_generation;
+        for (int i = 0; i < chanids.size(); ++i)
+        {
+            for (uint block = first; block <= last; ++block)
+            {
+                if (!GetBlock(chanids[i], block))
+                {
+                    missing << QString::number(chanids[i]);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (missing.empty())
+        return;
+
+    QDateTime blockstart = BlockStart(first);
+    QDateTime blockend   = BlockStart(last + 1);
+
+    MSqlBindings bindings;
+    QString querystr = QString(
+        "WHERE program.chanid IN (%1) "
+        "  AND program.endtime >= :STARTTS "
+        "  AND program.starttime <= :ENDTS "
+        "  AND program.starttime >= :STARTLIMITTS "
+        "  AND program.manualid = 0 "
+        "GROUP BY program.chanid, program.starttime, program.title "
+        "ORDER BY program.starttime ").arg(missing.join(","));
+    bindings[":STARTTS"]      = blockstart;
+    bindings[":STARTLIMITTS"] = blockstart.addDays(-1);
+    bindings[":ENDTS"]        = blockend;
+
+    ProgramList proglist;
+    if (!LoadFromProgram(proglist, querystr, bindings, schedList))
+        return;
+
+    // Split the listings into blocks, a program which spans a block
+    // boundary goes into each block it overlaps.
+    QMap<quint64, Block*> blocks;
+    for (int i = 0; i < missing.size(); ++i)
+    {
+        uint chanid = missing[i].toUInt();
+        for (uint block = first; block <= last; ++block)
+            blocks[Key(chanid, block)] = new Block();
+    }
+
+    ProgramList::const_iterator it = proglist.begin();
+    for (; it != proglist.end(); ++it)
+    {
+        const ProgramInfo *pginfo = *it;
+        for (uint block = first; block <= last; ++block)
+        {
+            QDateTime bstart = BlockStart(block);
+            QDateTime bend   = BlockStart(block + 1);
+            if (pginfo->GetScheduledEndTime() < bstart ||
+                pginfo->GetScheduledStartTime() > bend ||
+                pginfo->GetScheduledStartTime() < bstart.addDays(-1))
+            {
+                continue;
+            }
+            QMap<quint64, Block*>::iterator bit =
+                blocks.find(Key(pginfo->GetChanID(), block));
+            if (bit != blocks.end())
+                (*bit)->m_programs.push_back(new ProgramInfo(*pginfo));
+        }
+    }
+
+    QMutexLocker locker(&m_lock);
+    QMap<quint64, Block*>::iterator bit = blocks.begin();
+    for (; bit != blocks.end(); ++bit)
+    {
+        // Listings loaded before a Clear() may carry stale recording
+        // status, so they are dropped rather than cached.
+        if (generation != m_generation)
+            delete *bit;
+        else
+            m_blocks.insert(bit.key(), *bit, (*bit)->m_programs.size() + 1);
+    }
+}
+
+/** \fn GuideProgramCache::Get(uint,const QDateTime&,const QDateTime&)
+ *  \brief Returns a copy of the listings for the channel between start
+ *         and end, or NULL if they are not all cached.
+ */
+ProgramList *GuideProgramCache::Get(uint chanid, const QDateTime &start,
+                                    const QDateTime &end)
+{
+    uint first = BlockOf(start);
+    uint last  = BlockOf(end);
+
+    QMutexLocker locker(&m_lock);
+
+    QVector<Block*> blocks;
+    for (uint block = first; block <= last; ++block)
+    {
+        Block *b = GetBlock(chanid, block);
+        if (!b)
+            return NULL;
+        blocks.push_back(b);
+    }
+
+    ProgramList *proglist = new ProgramList();
+    QSet<uint> seen;
+    QDateTime startlimit = start.addDays(-1);
+    for (int i = 0; i < blocks.size(); ++i)
+    {
+        ProgramList::const_iterator it = blocks[i]->m_programs.begin();
+        for (; it != blocks[i]->m_programs.end(); ++it)
+        {
+            const ProgramInfo *pginfo = *it;
+            if (pginfo->GetScheduledEndTime() < start ||
+                pginfo->GetScheduledStartTime() > end ||
+                pginfo->GetScheduledStartTime() < startlimit)
+            {
+                continue;
+            }
+            uint key = pginfo->GetScheduledStartTime().toTime_t();
+            if (seen.contains(key))
+                continue;
+            seen.insert(key);
+            proglist->push_back(new ProgramInfo(*pginfo));
+        }
+    }
+
+    return proglist;
+}
+
+void GuideProgramCache::Clear(void)
+{
+    QMutexLocker locker(&m_lock);
+    m_blocks.clear();
+    ++m_generation;
+}
+
 // GuideStatus is used for transferring the relevant read-only data
 // from GuideGrid to the GuideUpdateProgramRow constructor.
 class GuideStatus
@@ -285,6 +495,17 @@ public:
             return false;
         }
 
+        // Load the listings of all the rows that need them at once
+        QVector<int> missing;
+        for (unsigned int i = 0; i < m_numRows; ++i)
+        {
+            if (!m_proglists[i])
+                missing.push_back(m_channums[i]);
+        }
+        if (!missing.empty())
+            m_guide->loadProgramBlocks(missing, m_currentStartTime,
+                                       m_currentEndTime);
+
         for (unsigned int i = 0; i < m_numRows; ++i)
         {
             unsigned int row = i + m_firstRow;
@@ -353,6 +574,26 @@ public:
     QVector<bool> m_unavailables;
 };
 
+// Fills the program cache around the visible part of the guide,
+// there is nothing to do in the UI thread.
+class GuidePrefetchPrograms : public GuideUpdaterBase
+{
+public:
+    GuidePrefetchPrograms(GuideGrid *guide, const QVector<int> &channums,
+                          const QDateTime &start, const QDateTime &end)
+        : GuideUpdaterBase(guide), m_channums(channums),
+          m_start(start), m_end(end) {}
+    virtual bool ExecuteNonUI(void)
+    {
+        m_guide->loadProgramBlocks(m_channums, m_start, m_end);
+        return false;
+    }
+    virtual void ExecuteUI(void) {}
+
+    const QVector<int> m_channums;
+    const QDateTime m_start, m_end;
+};
+
 class UpdateGuideEvent : public QEvent
 {
 public:
@@ -517,6 +758,8 @@ GuideGrid::GuideGrid(MythScreenStack *parent,
            m_channelOrdering(gCoreContext->GetSetting("ChannelOrdering", "channum")),
            m_updateTimer(NULL),
            m_threadPool("GuideGridHelperPool"),
+           m_programCache(new GuideProgramCache()),
+           m_prefetchChannel(0),
            m_changrpid(changrpid),
            m_changrplist(ChannelGroup::GetChannelGroups(false)),
            m_jumpToChannelLock(QMutex::Recursive),
@@ -654,6 +897,9 @@ GuideGrid::~GuideGrid()
 
     gCoreContext->removeListener(this);
 
+    delete m_programCache;
+    m_programCache = NULL;
+
     while (!m_programs.empty())
     {
         if (m_programs.back())
@@ -1354,7 +1600,15 @@ void GuideGrid::fillProgramInfos(bool useExistingData)
 
 ProgramList *GuideGrid::getProgramListFromProgram(int chanNum)
 {
-    ProgramList *proglist = new ProgramList();
+    uint chanid = GetChannelInfo(chanNum)->chanid;
+    QDateTime starttime = m_currentStartTime.addSecs(0 - m_currentStartTime.time().second());
+    QDateTime endtime = m_currentEndTime.addSecs(0 - m_currentEndTime.time().second());
+
+    ProgramList *proglist = m_programCache->Get(chanid, starttime, endtime);
+    if (proglist)
+        return proglist;
+
+    proglist = new ProgramList();
 
     if (proglist)
     {
@@ -1364,11 +1618,10 @@ ProgramList *GuideGrid::getProgramListFromProgram(int chanNum)
                            "  AND program.starttime <= :ENDTS "
                            "  AND program.starttime >= :STARTLIMITTS "
                            "  AND program.manualid = 0 ";
-        QDateTime starttime = m_currentStartTime.addSecs(0 - m_currentStartTime.time().second());
-        bindings[":CHANID"]  = GetChannelInfo(chanNum)->chanid;
+        bindings[":CHANID"]  = chanid;
         bindings[":STARTTS"] = starttime;
         bindings[":STARTLIMITTS"] = starttime.addDays(-1);
-        bindings[":ENDTS"] = m_currentEndTime.addSecs(0 - m_currentEndTime.time().second());
+        bindings[":ENDTS"] = endtime;
 
         LoadFromProgram(*proglist, querystr, bindings, m_recList);
     }
@@ -1376,6 +1629,79 @@ ProgramList *GuideGrid::getProgramListFromProgram(int chanNum)
     return proglist;
 }
 
+/** \fn GuideGrid::loadProgramBlocks(const QVector<int>&,const QDateTime&,const QDateTime&)
+ *  \brief Loads the listings of the given channel indexes between start
+ *         and end into the program cache, with a single query.
+ */
+void GuideGrid::loadProgramBlocks(const QVector<int> &chanNums,
+                                  const QDateTime &start,
+                                  const QDateTime &end)
+{
+    QVector<uint> chanids;
+    for (int i = 0; i < chanNums.size(); ++i)
+    {
+        const ChannelInfo *chinfo = GetChannelInfo(chanNums[i]);
+        if (chinfo && !chanids.contains(chinfo->chanid))
+            chanids.push_back(chinfo->chanid);
+    }
+
+    if (chanids.empty())
+        return;
+
+    m_programCache->Load(chanids,
+                         start.addSecs(0 - start.time().second()),
+                         end.addSecs(0 - end.time().second()), m_recList);
+}
+
+/** \fn GuideGrid::prefetchPrograms(void)
+ *  \brief Queues loading of the listings around the visible part of the
+ *         guide.
+ *
+ *   One page is loaded in each direction, and two pages in the direction
+ *   the guide last moved in, as that is most likely where it goes next.
+ */
+void GuideGrid::prefetchPrograms(void)
+{
+    int chancount = m_channelInfos.size();
+    if (!chancount || !m_channelCount)
+        return;
+
+    int dchan = (int)m_currentStartChannel - (int)m_prefetchChannel;
+    if (dchan > chancount / 2)
+        dchan -= chancount;
+    else if (dchan < -(chancount / 2))
+        dchan += chancount;
+    int dtime = m_prefetchTime.isValid() ?
+        m_prefetchTime.secsTo(m_currentStartTime) : 0;
+
+    m_prefetchChannel = m_currentStartChannel;
+    m_prefetchTime    = m_currentStartTime;
+
+    int chansBefore = m_channelCount, chansAfter = m_channelCount;
+    if (dchan > 0)
+        chansAfter *= 2;
+    else if (dchan < 0)
+        chansBefore *= 2;
+
+    int span = m_currentStartTime.secsTo(m_currentEndTime);
+    int timeBefore = span, timeAfter = span;
+    if (dtime > 0)
+        timeAfter *= 2;
+    else if (dtime < 0)
+        timeBefore *= 2;
+
+    QVector<int> chanNums;
+    int first = (int)m_currentStartChannel - chansBefore;
+    int count = min(chansBefore + m_channelCount + chansAfter, chancount);
+    for (int i = 0; i < count; ++i)
+        chanNums.push_back(((first + i) % chancount + chancount) % chancount);
+
+    GuidePrefetchPrograms *updater = new GuidePrefetchPrograms(
+        this, chanNums, m_currentStartTime.addSecs(-timeBefore),
+        m_currentEndTime.addSecs(timeAfter));
+    m_threadPool.start(new GuideHelper(this, updater), "GuideHelper");
+}
+
 void GuideGrid::fillProgramRowInfos(int firstRow, bool useExistingData)
 {
     bool allRows = false;
@@ -1438,6 +1764,9 @@ void GuideGrid::fillProgramRowInfos(int firstRow, bool useExistingData)
     GuideUpdateProgramRow *updater =
         new GuideUpdateProgramRow(this, gs, proglists);
     m_threadPool.start(new GuideHelper(this, updater), "GuideHelper");
+
+    if (allRows)
+        prefetchPrograms();
 }
 
 void GuideUpdateProgramRow::fillProgramRowInfosWith(int row, int chanNum,
@@ -1684,6 +2013,7 @@ void GuideGrid::customEvent(QEvent *event)
         if (message == "SCHEDULE_CHANGE")
         {
             LoadFromScheduler(m_recList);
+            m_programCache->Clear();
             fillProgramInfos();
         }
         else if (message == "STOP_VIDEO_REFRESH_TIMER")
@@ -2075,6 +2405,7 @@ void GuideGrid::generateListings()
     m_channelCount = min(m_guideGrid->getChannelCount(), maxchannel + 1);
 
     LoadFromScheduler(m_recList);
+    m_programCache->Clear();
     fillProgramInfos();
 }
 
@@ -30,6 +30,7 @@ class ProgramInfo;
 class QTimer;
 class MythUIButtonList;
 class MythUIGuideGrid;
+class GuideProgramCache;
 
 #define MAX_DISPLAY_TIMES 36
 
@@ -210,6 +211,8 @@ class GuideGrid : public ScheduleCommon, public JumpToChannelListener
 public:
     // These need to be public so that the helper classes can operate.
     ProgramList *getProgramListFromProgram(int chanNum);
+    void loadProgramBlocks(const QVector<int> &chanNums,
+                           const QDateTime &start, const QDateTime &end);
     void updateProgramsUI(unsigned int firstRow, unsigned int numRows,
                           int progPast,
                           const QVector<ProgramList*> &proglists,
@@ -231,6 +234,7 @@ private:
     ProgramList GetProgramList(uint chanid) const;
     uint GetAlternateChannelIndex(uint chan_idx, bool with_same_channum) const;
     void updateDateText(void);
+    void prefetchPrograms(void);
 
   private:
     int   m_selectRecThreshold;
@@ -276,6 +280,11 @@ private:
 
     MThreadPool       m_threadPool;
 
+    GuideProgramCache *m_programCache;
+    /// Start of the guide when the last prefetch was queued
+    uint              m_prefetchChannel;
+    QDateTime         m_prefetchTime;
+
     int               m_changrpid;
     ChannelGroupList  m_changrplist;
 
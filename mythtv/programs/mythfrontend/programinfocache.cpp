@@ -16,19 +16,6 @@
 
 #include <algorithm>
 
-typedef vector<ProgramInfo*> *VPI_ptr;
-static void free_vec(VPI_ptr &v)
-{
-    if (v)
-    {
-        vector<ProgramInfo*>::iterator it = v->begin();
-        for (; it != v->end(); ++it)
-            delete *it;
-        delete v;
-        v = NULL;
-    }
-}
-
 class ProgramInfoLoader : public QRunnable
 {
   public:
@@ -45,8 +32,8 @@ class ProgramInfoLoader : public QRunnable
 };
 
 ProgramInfoCache::ProgramInfoCache(QObject *o) :
-    m_next_cache(NULL), m_listener(o),
-    m_load_is_queued(false), m_loads_in_progress(0)
+    m_next_is_full(false), m_epoch(0), m_generation(0),
+    m_listener(o), m_load_is_queued(false), m_loads_in_progress(0)
 {
 }
 
@@ -58,7 +45,7 @@ ProgramInfoCache::~ProgramInfoCache()
         m_load_wait.wait(&m_lock);
 
     Clear();
-    free_vec(m_next_cache);
+    ClearNext();
 }
 
 void ProgramInfoCache::ScheduleLoad(const bool updateUI)
@@ -75,19 +62,64 @@ void ProgramInfoCache::ScheduleLoad(const bool updateUI)
 
 void ProgramInfoCache::Load(const bool updateUI)
 {
+    QMutexLocker serial(&m_load_serial);
     QMutexLocker locker(&m_lock);
     m_load_is_queued = false;
 
+    uint epoch      = m_epoch;
+    uint generation = m_generation;
+    bool full       = true;
+    vector<uint> removed;
+
     locker.unlock();
     /**/
-    // Get an unsorted list (sort = 0) from RemoteGetRecordedList
-    // we sort the list later anyway.
-    vector<ProgramInfo*> *tmp = RemoteGetRecordedList(0);
+    // Only fetch what changed since the last load, the backend sends
+    // everything if it can't tell.
+    vector<ProgramInfo*> *tmp =
+        RemoteGetRecordedListSince(epoch, generation, full, removed);
+
+    if (!tmp)
+    {
+        // Get an unsorted list (sort = 0) from RemoteGetRecordedList
+        // we sort the list later anyway.
+        tmp        = RemoteGetRecordedList(0);
+        full       = true;
+        epoch      = 0;
+        generation = 0;
+    }
     /**/
     locker.relock();
 
-    free_vec(m_next_cache);
-    m_next_cache = tmp;
+    if (tmp)
+    {
+        // Merge into whatever earlier loads left for Refresh()
+        if (full)
+        {
+            ClearNext();
+            m_next_is_full = true;
+        }
+
+        vector<uint>::const_iterator rit = removed.begin();
+        for (; rit != removed.end(); ++rit)
+        {
+            delete m_next_cache.take(*rit);
+            if (!m_next_is_full)
+                m_next_removed.insert(*rit);
+        }
+
+        vector<ProgramInfo*>::iterator it = tmp->begin();
+        for (; it != tmp->end(); ++it)
+        {
+            uint recordingID = (*it)->GetRecordingID();
+            delete m_next_cache.take(recordingID);
+            m_next_cache[recordingID] = *it;
+            m_next_removed.remove(recordingID);
+        }
+        delete tmp;
+
+        m_epoch      = epoch;
+        m_generation = generation;
+    }
 
     if (updateUI)
         QCoreApplication::postEvent(
@@ -112,9 +144,9 @@ void ProgramInfoCache::WaitForLoadToComplete(void) const
 
 /** \brief Refreshed the cache.
  *
- *  If a new list has been loaded this fills the cache with that list
- *  if not, this simply removes list items marked for deletion from the
- *  the list.
+ *  If a new list has been loaded this fills the cache with that list,
+ *  if only changes have been loaded they are applied to the cache in
+ *  place. Then this removes list items marked for deletion from the list.
  *
  *  \note This must only be called from the UI thread.
  *  \note All references to the ProgramInfo pointers should be cleared
@@ -123,20 +155,26 @@ void ProgramInfoCache::WaitForLoadToComplete(void) const
 void ProgramInfoCache::Refresh(void)
 {
     QMutexLocker locker(&m_lock);
-    if (m_next_cache)
+    if (m_next_is_full)
     {
         Clear();
-        vector<ProgramInfo*>::iterator it = m_next_cache->begin();
-        for (; it != m_next_cache->end(); ++it)
-        {
-            if (!(*it)->GetChanID())
-                continue;
+        m_cache.swap(m_next_cache);
+        m_next_is_full = false;
+    }
+    else
+    {
+        QSet<uint>::const_iterator rit = m_next_removed.begin();
+        for (; rit != m_next_removed.end(); ++rit)
+            delete m_cache.take(*rit);
+        m_next_removed.clear();
 
-            m_cache[(*it)->GetRecordingID()] = *it;
+        Cache::iterator it = m_next_cache.begin();
+        for (; it != m_next_cache.end(); ++it)
+        {
+            delete m_cache.take(it.key());
+            m_cache[it.key()] = *it;
         }
-        delete m_next_cache;
-        m_next_cache = NULL;
-        return;
+        m_next_cache.clear();
     }
     locker.unlock();
 
@@ -147,7 +185,8 @@ void ProgramInfoCache::Refresh(void)
         nit = it;
         ++nit;
 
-        if ((*it)->GetAvailableStatus() == asDeleted)
+        if (!(*it)->GetChanID() ||
+            (*it)->GetAvailableStatus() == asDeleted)
         {
             delete (*it);
             m_cache.erase(it);
@@ -280,3 +319,14 @@ void ProgramInfoCache::Clear(void)
         delete (*it);
     m_cache.clear();
 }
+
+/// Drops loaded changes not yet applied, m_lock must be held.
+void ProgramInfoCache::ClearNext(void)
+{
+    Cache::iterator it = m_next_cache.begin();
+    for (; it != m_next_cache.end(); ++it)
+        delete (*it);
+    m_next_cache.clear();
+    m_next_removed.clear();
+    m_next_is_full = false;
+}
@@ -15,6 +15,7 @@ using namespace std;
 #include <QDateTime>
 #include <QMutex>
 #include <QHash>
+#include <QSet>
 
 class ProgramInfoLoader;
 class ProgramInfo;
@@ -46,6 +47,7 @@ class ProgramInfoCache
   private:
     void Load(const bool updateUI = true);
     void Clear(void);
+    void ClearNext(void);
 
   private:
     // NOTE: Hash would be faster for lookups and updates, but we need a sorted
@@ -57,7 +59,17 @@ class ProgramInfoCache
 
     mutable QMutex          m_lock;
     Cache                   m_cache;
-    vector<ProgramInfo*>   *m_next_cache;
+    /// Loaded recordings not yet moved into m_cache by Refresh()
+    Cache                   m_next_cache;
+    /// Recordings removed since the last Refresh(), unless m_next_is_full
+    QSet<uint>              m_next_removed;
+    /// m_next_cache holds every recording, not just the changed ones
+    bool                    m_next_is_full;
+    /// Our position in the backend's recording journal
+    uint                    m_epoch;
+    uint                    m_generation;
+    /// Each load continues from where the previous one left off
+    QMutex                  m_load_serial;
     QObject                *m_listener;
     bool                    m_load_is_queued;
     uint                    m_loads_in_progress;
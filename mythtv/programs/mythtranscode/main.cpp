@@ -22,6 +22,7 @@ using namespace std;
 #include "mythdate.h"
 #include "transcode.h"
 #include "mpeg2fix.h"
+#include "smartcut.h"
 #include "remotefile.h"
 #include "mythtranslation.h"
 #include "mythlogging.h"
@@ -68,7 +69,8 @@ static void UpdatePositionMap(frm_pos_map_t &posMap, frm_pos_map_t &durMap, QStr
     }
 }
 
-static int BuildKeyframeIndex(MPEG2fixup *m2f, QString &infile,
+template <class T>
+static int BuildKeyframeIndex(T *m2f, QString &infile,
                        frm_pos_map_t &posMap, frm_pos_map_t &durMap, int jobID)
 {
     if (!m2f)
@@ -106,6 +108,45 @@ static int CheckJobQueue()
     return 0;
 }
 
+static int SmartCut(QString infile, QString outfile,
+                    frm_dir_map_t &deleteMap, ProgramInfo *pginfo,
+                    int jobID, bool showprogress, bool update_index)
+{
+    void (*update_func)(float) = NULL;
+    int (*check_func)() = NULL;
+    if (jobID >= 0)
+    {
+       glbl_jobID = jobID;
+       update_func = &UpdateJobQueue;
+       check_func = &CheckJobQueue;
+    }
+
+    SmartCutter cutter(infile, outfile, &deleteMap, showprogress,
+                       update_func, check_func);
+
+    int result = cutter.Start();
+    if (result != REENCODE_OK)
+        return result;
+
+    frm_pos_map_t posMap;
+    frm_pos_map_t durMap;
+    result = BuildKeyframeIndex(&cutter, outfile, posMap, durMap, jobID);
+    if (result != REENCODE_OK)
+        return result;
+
+    if (update_index)
+        UpdatePositionMap(posMap, durMap, NULL, pginfo);
+    else
+        UpdatePositionMap(posMap, durMap, outfile + QString(".map"), pginfo);
+
+    RecordingInfo recInfo(*pginfo);
+    RecordingFile *recFile = recInfo.GetRecordingFile();
+    recFile->m_containerFormat = formatMPEG2_TS;
+    recFile->Save();
+
+    return REENCODE_OK;
+}
+
 static int QueueTranscodeJob(ProgramInfo *pginfo, QString profile,
                             QString hostname, bool usecutlist)
 {
@@ -623,7 +664,27 @@ int main(int argc, char *argv[])
                                           fifodir, fifo_info, cleanCut, deleteMap,
                                           AudioTrackNo, passthru);
 
-        if ((result == REENCODE_OK) && (jobID >= 0))
+        bool smartcut = false;
+        if (result == REENCODE_SMARTCUT)
+        {
+            result = SmartCut(infile, outfile, deleteMap, pginfo, jobID,
+                              showprogress, update_index);
+            if (result == REENCODE_NOSMARTCUT)
+            {
+                LOG(VB_GENERAL, LOG_NOTICE,
+                    "Smart cutting failed, transcoding the whole recording");
+                transcode->DisableSmartCut();
+                result = transcode->TranscodeFile(infile, outfile,
+                                          profilename, useCutlist,
+                                          (fifosync || keyframesonly), jobID,
+                                          fifodir, fifo_info, cleanCut, deleteMap,
+                                          AudioTrackNo, passthru);
+            }
+            else
+                smartcut = true;
+        }
+
+        if ((result == REENCODE_OK) && (jobID >= 0) && !smartcut)
         {
             JobQueue::ChangeJobArgs(jobID, "RENAME_TO_NUV");
             RecordingInfo recInfo(pginfo->GetRecordingID());
@@ -0,0 +1,1133 @@
+// C headers
+#include <cstring>
+
+// Qt headers
+#include <QtAlgorithms>
+#include <QFileInfo>
+
+// MythTV headers
+#include "smartcut.h"
+#include "mythlogging.h"
+#include "mythdate.h"
+#include "exitcodes.h"
+
+#define LOC QString("SmartCut: ")
+
+SmartCutter::SmartCutter(const QString &inf, const QString &outf,
+                         frm_dir_map_t *deleteMap, bool showprog,
+                         void (*update_func)(float), int (*check_func)()) :
+    m_infile(inf), m_outfile(outf),
+    m_inputFC(NULL), m_outputFC(NULL),
+    m_decoder(NULL), m_encoder(NULL), m_frame(NULL),
+    m_videoStream(-1), m_reorderDelay(0),
+    m_planPos(0), m_encoderGroup(-1),
+    m_encodedFrames(0), m_copiedPackets(0), m_failed(false),
+    m_checkAbort(check_func), m_updateStatus(update_func),
+    m_showProgress(showprog), m_statusUpdateTime(5),
+    m_progressCount(0), m_fileSize(0)
+{
+    if (deleteMap)
+        m_deleteMap = *deleteMap;
+
+    m_videoTimeBase.num = 1;
+    m_videoTimeBase.den = 90000;
+
+    av_register_all();
+
+    if (m_showProgress || m_updateStatus)
+    {
+        if (m_updateStatus)
+        {
+            m_statusUpdateTime = 20;
+            m_updateStatus(0);
+        }
+        m_statusTime = MythDate::current().addSecs(m_statusUpdateTime);
+    }
+
+    m_fileSize = QFileInfo(inf).size();
+}
+
+SmartCutter::~SmartCutter()
+{
+    if (m_encoder)
+    {
+        avcodec_close(m_encoder);
+        av_freep(&m_encoder);
+    }
+
+    CloseOutput();
+    CloseInput();
+
+    QMap<int, AVPacket>::iterator it = m_readyPackets.begin();
+    for (; it != m_readyPackets.end(); ++it)
+        av_free_packet(&(*it));
+
+    QMap<int, QList<AVPacket> >::iterator git = m_groupPackets.begin();
+    for (; git != m_groupPackets.end(); ++git)
+    {
+        for (int i = 0; i < (*git).size(); i++)
+            av_free_packet(&(*git)[i]);
+    }
+
+    if (m_frame)
+        av_frame_free(&m_frame);
+}
+
+/** \fn SmartCutter::IsSupported(const QString&)
+ *  \brief Returns true if file is a transport stream with H.264 or HEVC
+ *         video, which we can decode and also encode again.
+ */
+bool SmartCutter::IsSupported(const QString &file)
+{
+    av_register_all();
+
+    AVFormatContext *fc = NULL;
+    QByteArray fname = file.toLocal8Bit();
+    if (avformat_open_input(&fc, fname.constData(), NULL, NULL))
+        return false;
+
+    bool ok = false;
+    if (fc->iformat && !strcmp(fc->iformat->name, "mpegts") &&
+        avformat_find_stream_info(fc, NULL) >= 0)
+    {
+        for (uint i = 0; i < fc->nb_streams; i++)
+        {
+            AVCodecContext *codec = fc->streams[i]->codec;
+            if (codec->codec_type != AVMEDIA_TYPE_VIDEO)
+                continue;
+
+            if (codec->codec_id != AV_CODEC_ID_H264 &&
+                codec->codec_id != AV_CODEC_ID_HEVC)
+                break;
+
+            if (!avcodec_find_decoder(codec->codec_id) ||
+                !avcodec_find_encoder(codec->codec_id))
+            {
+                LOG(VB_GENERAL, LOG_INFO, LOC +
+                    QString("No %1 encoder available, can not cut smartly")
+                        .arg(avcodec_get_name(codec->codec_id)));
+                break;
+            }
+
+            ok = true;
+            break;
+        }
+    }
+
+    avformat_close_input(&fc);
+
+    return ok;
+}
+
+int SmartCutter::Start(void)
+{
+    int result = ScanInput();
+    if (result != REENCODE_OK)
+        return result;
+
+    result = BuildRanges();
+    if (result != REENCODE_OK)
+        return result;
+
+    PlanCut();
+
+    return WriteOutput();
+}
+
+bool SmartCutter::OpenInput(const QString &file)
+{
+    QByteArray fname = file.toLocal8Bit();
+
+    int ret = avformat_open_input(&m_inputFC, fname.constData(), NULL, NULL);
+    if (ret)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Couldn't open input file, error #%1").arg(ret));
+        return false;
+    }
+
+    ret = avformat_find_stream_info(m_inputFC, NULL);
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Couldn't get stream info, error #%1").arg(ret));
+        CloseInput();
+        return false;
+    }
+
+    m_videoStream = -1;
+    for (uint i = 0; i < m_inputFC->nb_streams; i++)
+    {
+        AVCodecContext *codec = m_inputFC->streams[i]->codec;
+        if (codec->codec_type == AVMEDIA_TYPE_VIDEO &&
+            (codec->codec_id == AV_CODEC_ID_H264 ||
+             codec->codec_id == AV_CODEC_ID_HEVC))
+        {
+            m_videoStream = i;
+            break;
+        }
+    }
+
+    if (m_videoStream < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "No H.264 or HEVC video stream found");
+        CloseInput();
+        return false;
+    }
+
+    m_videoTimeBase = m_inputFC->streams[m_videoStream]->time_base;
+
+    return true;
+}
+
+void SmartCutter::CloseInput(void)
+{
+    if (m_decoder)
+    {
+        avcodec_close(m_decoder);
+        m_decoder = NULL;
+    }
+
+    if (m_inputFC)
+    {
+        avformat_close_input(&m_inputFC);
+        m_inputFC = NULL;
+    }
+}
+
+bool SmartCutter::OpenOutput(void)
+{
+    QByteArray fname = m_outfile.toLocal8Bit();
+
+    int ret = avformat_alloc_output_context2(&m_outputFC, NULL, "mpegts",
+                                             fname.constData());
+    if (ret < 0 || !m_outputFC)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Couldn't create the output, error #%1").arg(ret));
+        m_outputFC = NULL;
+        return false;
+    }
+
+    m_streamMap.clear();
+    for (uint i = 0; i < m_inputFC->nb_streams; i++)
+    {
+        AVStream *ist = m_inputFC->streams[i];
+        if ((int)i != m_videoStream &&
+            (ist->codec->codec_type != AVMEDIA_TYPE_AUDIO ||
+             ist->codec->codec_id == AV_CODEC_ID_NONE))
+            continue;
+
+        AVStream *ost = avformat_new_stream(m_outputFC, NULL);
+        if (!ost || avcodec_copy_context(ost->codec, ist->codec) < 0)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC +
+                QString("Couldn't copy stream #%1").arg(i));
+            avformat_free_context(m_outputFC);
+            m_outputFC = NULL;
+            return false;
+        }
+
+        ost->codec->codec_tag = 0;
+        ost->time_base = ist->time_base;
+        av_dict_copy(&ost->metadata, ist->metadata, 0);
+
+        m_streamMap[i] = ost->index;
+    }
+
+    ret = avio_open(&m_outputFC->pb, fname.constData(), AVIO_FLAG_WRITE);
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Couldn't open '%1', error #%2").arg(m_outfile).arg(ret));
+        avformat_free_context(m_outputFC);
+        m_outputFC = NULL;
+        return false;
+    }
+
+    ret = avformat_write_header(m_outputFC, NULL);
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Couldn't write the header, error #%1").arg(ret));
+        avio_closep(&m_outputFC->pb);
+        avformat_free_context(m_outputFC);
+        m_outputFC = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+void SmartCutter::CloseOutput(void)
+{
+    if (!m_outputFC)
+        return;
+
+    av_write_trailer(m_outputFC);
+    avio_closep(&m_outputFC->pb);
+    avformat_free_context(m_outputFC);
+    m_outputFC = NULL;
+}
+
+/// Returns false if the job was stopped
+bool SmartCutter::UpdateProgress(int64_t pos, float base, float scale)
+{
+    if (!(m_showProgress || m_updateStatus) || (++m_progressCount & 0xff))
+        return true;
+
+    if (MythDate::current() <= m_statusTime)
+        return true;
+
+    float percent_done = 100.0 * base;
+    if (pos >= 0 && m_fileSize > 0)
+        percent_done += 100.0 * scale * pos / m_fileSize;
+
+    if (m_updateStatus)
+        m_updateStatus(percent_done);
+    if (m_showProgress)
+        LOG(VB_GENERAL, LOG_INFO, QString("%1% complete")
+                .arg(percent_done, 0, 'f', 1));
+    if (m_checkAbort && m_checkAbort())
+        return false;
+
+    m_statusTime = MythDate::current().addSecs(m_statusUpdateTime);
+
+    return true;
+}
+
+/** \fn SmartCutter::ScanInput(void)
+ *  \brief Reads the timestamps and keyframes of all the video packets.
+ */
+int SmartCutter::ScanInput(void)
+{
+    LOG(VB_GENERAL, LOG_INFO, LOC + "Scanning the keyframes of " + m_infile);
+
+    if (!OpenInput(m_infile))
+        return REENCODE_ERROR;
+
+    AVPacket pkt;
+    av_init_packet(&pkt);
+
+    int gop = -1;
+    while (av_read_frame(m_inputFC, &pkt) >= 0)
+    {
+        int64_t pos = pkt.pos;
+
+        if (pkt.stream_index == m_videoStream)
+        {
+            if (pkt.pts == AV_NOPTS_VALUE)
+            {
+                LOG(VB_GENERAL, LOG_WARNING, LOC +
+                    QString("Video packet %1 has no timestamp")
+                        .arg(m_packets.size()));
+                av_free_packet(&pkt);
+                CloseInput();
+                return REENCODE_NOSMARTCUT;
+            }
+
+            SmartCutPacket packet;
+            packet.pts = pkt.pts;
+            packet.dts = (pkt.dts != AV_NOPTS_VALUE) ? pkt.dts : pkt.pts;
+            packet.key = pkt.flags & AV_PKT_FLAG_KEY;
+
+            if (packet.key)
+            {
+                SmartCutGOP g;
+                g.first = g.last = m_packets.size();
+                m_gops.push_back(g);
+                gop++;
+            }
+            else if (gop >= 0)
+            {
+                m_gops[gop].last = m_packets.size();
+            }
+            packet.gop = gop;
+
+            m_packets.push_back(packet);
+        }
+
+        av_free_packet(&pkt);
+
+        if (!UpdateProgress(pos, 0.0, 0.5))
+        {
+            CloseInput();
+            return REENCODE_STOPPED;
+        }
+    }
+
+    CloseInput();
+
+    if (m_gops.empty())
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC + "No keyframes found");
+        return REENCODE_NOSMARTCUT;
+    }
+
+    return REENCODE_OK;
+}
+
+int SmartCutter::FindDisplay(int64_t pts) const
+{
+    QVector<int64_t>::const_iterator it =
+        qLowerBound(m_displayPTS.begin(), m_displayPTS.end(), pts);
+    if (it == m_displayPTS.end() || *it != pts)
+        return -1;
+    return it - m_displayPTS.begin();
+}
+
+int SmartCutter::FindRange(int64_t pts) const
+{
+    for (int i = 0; i < m_ranges.size(); i++)
+    {
+        if (pts >= m_ranges[i].startPTS && pts < m_ranges[i].endPTS)
+            return i;
+    }
+    return -1;
+}
+
+/** \fn SmartCutter::BuildRanges(void)
+ *  \brief Numbers the frames in display order and turns the cutlist
+ *         into the sections to keep.
+ */
+int SmartCutter::BuildRanges(void)
+{
+    const int frames = m_packets.size();
+
+    m_displayPTS.resize(frames);
+    for (int i = 0; i < frames; i++)
+        m_displayPTS[i] = m_packets[i].pts;
+    qSort(m_displayPTS.begin(), m_displayPTS.end());
+
+    for (int i = 1; i < frames; i++)
+    {
+        if (m_displayPTS[i] == m_displayPTS[i - 1])
+        {
+            LOG(VB_GENERAL, LOG_WARNING, LOC +
+                QString("Two frames share the timestamp %1")
+                    .arg(m_displayPTS[i]));
+            return REENCODE_NOSMARTCUT;
+        }
+    }
+
+    for (int i = 0; i < frames; i++)
+    {
+        SmartCutPacket &packet = m_packets[i];
+        packet.display = FindDisplay(packet.pts);
+        m_reorderDelay = qMax(m_reorderDelay, packet.pts - packet.dts);
+    }
+
+    // A cut runs from its start mark to its end mark inclusive,
+    // a leading end mark cuts from the first frame.
+    int64_t keepStart = 0;
+    bool cutting = false;
+    frm_dir_map_t::const_iterator it = m_deleteMap.begin();
+    if (it != m_deleteMap.end() && *it == MARK_CUT_END)
+        cutting = true;
+    for (; it != m_deleteMap.end(); ++it)
+    {
+        if (*it == MARK_CUT_START && !cutting)
+        {
+            if ((int64_t)it.key() > keepStart && keepStart < frames)
+            {
+                SmartCutRange range;
+                range.first = keepStart;
+                range.last  = qMin((int64_t)it.key(), (int64_t)frames);
+                m_ranges.push_back(range);
+            }
+            cutting = true;
+        }
+        else if (*it == MARK_CUT_END && cutting)
+        {
+            keepStart = it.key() + 1;
+            cutting = false;
+        }
+    }
+    if (!cutting && keepStart < frames)
+    {
+        SmartCutRange range;
+        range.first = keepStart;
+        range.last  = frames;
+        m_ranges.push_back(range);
+    }
+
+    if (m_ranges.empty())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "The cutlist removes every frame");
+        return REENCODE_ERROR;
+    }
+
+    m_rangeOf.fill(-1, frames);
+
+    int64_t outPTS = m_displayPTS[0];
+    for (int i = 0; i < m_ranges.size(); i++)
+    {
+        SmartCutRange &range = m_ranges[i];
+        range.startPTS = m_displayPTS[range.first];
+        range.endPTS   = (range.last < frames) ?
+            m_displayPTS[range.last] : INT64_MAX;
+        range.shift    = range.startPTS - outPTS;
+        if (range.last < frames)
+            outPTS += range.endPTS - range.startPTS;
+
+        for (int d = range.first; d < range.last; d++)
+            m_rangeOf[d] = i;
+    }
+
+    return REENCODE_OK;
+}
+
+/** \fn SmartCutter::PlanCut(void)
+ *  \brief Decides which packets are copied and which frames are encoded.
+ *
+ *   The trailing frames of a GOP, from the keyframe on in display
+ *   order, only refer to the GOP itself. They are copied when all of
+ *   them are kept and encoded when some of them are.
+ *
+ *   The leading frames, displayed before the keyframe of an open GOP,
+ *   also refer to the previous GOP. They are only copied along with
+ *   both GOPs, otherwise they are encoded after decoding the previous
+ *   GOP too.
+ *
+ *   The frames encoded between two copied packets are encoded as one
+ *   group starting with an I frame, unless a GOP which is not decoded
+ *   comes between them.
+ */
+void SmartCutter::PlanCut(void)
+{
+    for (int g = 0; g < m_gops.size(); g++)
+    {
+        SmartCutGOP &gop = m_gops[g];
+        gop.keyDisplay = m_packets[gop.first].display;
+
+        bool trailingAll = true, trailingNone = true;
+        bool leadingAll = true, leadingNone = true;
+        for (int i = gop.first; i <= gop.last; i++)
+        {
+            const SmartCutPacket &packet = m_packets[i];
+            bool kept = IsKept(packet.display);
+            if (packet.display < gop.keyDisplay)
+            {
+                gop.lastLeading = i;
+                leadingAll  &= kept;
+                leadingNone &= !kept;
+            }
+            else
+            {
+                trailingAll  &= kept;
+                trailingNone &= !kept;
+            }
+        }
+
+        gop.copyTrailing   = trailingAll;
+        gop.encodeTrailing = !trailingAll && !trailingNone;
+
+        // The leading frames of the first GOP can not be decoded
+        if (gop.lastLeading >= 0 && !leadingNone && g > 0)
+        {
+            if (leadingAll && gop.copyTrailing && m_gops[g - 1].copyTrailing)
+                gop.copyLeading = true;
+            else
+                gop.encodeLeading = true;
+        }
+    }
+
+    int lastDecode = -1;
+    for (int g = 0; g < m_gops.size(); g++)
+    {
+        const SmartCutGOP &gop = m_gops[g];
+
+        if (gop.encodeLeading)
+        {
+            for (int i = m_gops[g - 1].first; i <= m_gops[g - 1].last; i++)
+                m_packets[i].decode = true;
+        }
+
+        if (gop.encodeTrailing)
+            lastDecode = gop.last;
+        else if (gop.encodeLeading)
+            lastDecode = gop.lastLeading;
+
+        for (int i = gop.first; i <= gop.last; i++)
+        {
+            SmartCutPacket &packet = m_packets[i];
+            bool leading = packet.display < gop.keyDisplay;
+            packet.copy   = leading ? gop.copyLeading : gop.copyTrailing;
+            packet.decode = packet.decode || (i <= lastDecode);
+        }
+    }
+
+    m_groupOf.fill(-1, m_displayPTS.size());
+
+    int copyGOPs = 0;
+    for (int g = 0; g < m_gops.size(); g++)
+    {
+        const SmartCutGOP &gop = m_gops[g];
+
+        QList<int> encode;
+        for (int i = gop.first; i <= gop.last; i++)
+        {
+            const SmartCutPacket &packet = m_packets[i];
+            if (!IsKept(packet.display))
+                continue;
+
+            bool leading = packet.display < gop.keyDisplay;
+            if ((leading && gop.encodeLeading) ||
+                (!leading && gop.encodeTrailing))
+                encode.push_back(packet.display);
+        }
+
+        if (!encode.empty())
+        {
+            qSort(encode);
+
+            // The decoder is drained at any packet it is not fed, such
+            // as those of the GOPs cut whole, and that ends the group.
+            bool newGroup = m_plan.empty() || m_plan.back() >= 0;
+            if (!newGroup)
+            {
+                int from = gop.encodeLeading ? m_gops[g - 1].first : gop.first;
+                for (int i = m_groupLastPacket.back() + 1; i < from; i++)
+                    newGroup = newGroup || !m_packets[i].decode;
+            }
+
+            if (newGroup)
+            {
+                m_plan.push_back(-1 - m_groupFrames.size());
+                m_groupFrames.push_back(0);
+                m_groupLastPacket.push_back(0);
+            }
+
+            int group = m_groupFrames.size() - 1;
+            for (int i = 0; i < encode.size(); i++)
+                m_groupOf[encode[i]] = group;
+            m_groupFrames[group] += encode.size();
+            m_groupLastPacket[group] = gop.encodeTrailing ?
+                gop.last : gop.lastLeading;
+        }
+
+        for (int i = gop.first; i <= gop.last; i++)
+        {
+            if (m_packets[i].copy)
+                m_plan.push_back(i);
+        }
+
+        if (gop.copyTrailing)
+            copyGOPs++;
+    }
+
+    m_groupEncoded.fill(0, m_groupFrames.size());
+    m_groupReady.fill(false, m_groupFrames.size());
+
+    int encodeFrames = 0;
+    for (int i = 0; i < m_groupFrames.size(); i++)
+        encodeFrames += m_groupFrames[i];
+
+    LOG(VB_GENERAL, LOG_INFO, LOC +
+        QString("Keeping %1 sections, copying %2 of %3 GOPs "
+                "and encoding %4 frames")
+            .arg(m_ranges.size()).arg(copyGOPs).arg(m_gops.size())
+            .arg(encodeFrames));
+}
+
+int SmartCutter::WriteOutput(void)
+{
+    LOG(VB_GENERAL, LOG_INFO, LOC + QString("Cutting %1 to %2")
+            .arg(m_infile).arg(m_outfile));
+
+    if (!OpenInput(m_infile))
+        return REENCODE_ERROR;
+
+    if (!OpenOutput())
+    {
+        CloseInput();
+        return REENCODE_ERROR;
+    }
+
+    if (!m_groupFrames.empty())
+    {
+        m_decoder = m_inputFC->streams[m_videoStream]->codec;
+        AVCodec *codec = avcodec_find_decoder(m_decoder->codec_id);
+        if (!codec || avcodec_open2(m_decoder, codec, NULL) < 0)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC + "Couldn't open the video decoder");
+            m_decoder = NULL;
+            CloseOutput();
+            CloseInput();
+            return REENCODE_NOSMARTCUT;
+        }
+        m_frame = av_frame_alloc();
+    }
+
+    AVPacket pkt;
+    av_init_packet(&pkt);
+
+    int result = REENCODE_OK;
+    int index = 0;
+    bool decoding = false;
+    while (av_read_frame(m_inputFC, &pkt) >= 0)
+    {
+        int64_t pos = pkt.pos;
+
+        if (pkt.stream_index == m_videoStream)
+        {
+            if (index >= m_packets.size() || m_packets[index].pts != pkt.pts)
+            {
+                LOG(VB_GENERAL, LOG_ERR, LOC +
+                    "The recording changed since it was scanned");
+                av_free_packet(&pkt);
+                result = REENCODE_ERROR;
+                break;
+            }
+
+            const SmartCutPacket &packet = m_packets[index];
+
+            if (packet.decode)
+            {
+                DecodePacket(&pkt);
+                decoding = true;
+            }
+            else if (decoding)
+            {
+                DrainDecoder(index);
+                decoding = false;
+            }
+
+            if (packet.copy)
+            {
+                av_dup_packet(&pkt);
+                m_readyPackets[index] = pkt;
+            }
+            else
+            {
+                av_free_packet(&pkt);
+            }
+
+            index++;
+            EmitReady();
+        }
+        else if (m_streamMap.contains(pkt.stream_index))
+        {
+            WriteAudio(&pkt);
+        }
+        else
+        {
+            av_free_packet(&pkt);
+        }
+
+        if (m_failed)
+        {
+            result = REENCODE_NOSMARTCUT;
+            break;
+        }
+
+        if (!UpdateProgress(pos, 0.5, 0.5))
+        {
+            result = REENCODE_STOPPED;
+            break;
+        }
+    }
+
+    if (result == REENCODE_OK)
+    {
+        if (decoding)
+            DrainDecoder(m_packets.size());
+        EmitReady();
+
+        if (m_failed)
+            result = REENCODE_NOSMARTCUT;
+        else if (m_planPos < m_plan.size())
+        {
+            // A truncated file must not replace the recording
+            LOG(VB_GENERAL, LOG_ERR, LOC +
+                QString("Only %1 of %2 parts of the output were written")
+                    .arg(m_planPos).arg(m_plan.size()));
+            result = REENCODE_NOSMARTCUT;
+        }
+    }
+
+    CloseOutput();
+    CloseInput();
+
+    LOG(VB_GENERAL, LOG_INFO, LOC +
+        QString("Copied %1 video packets and encoded %2 frames")
+            .arg(m_copiedPackets).arg(m_encodedFrames));
+
+    return result;
+}
+
+bool SmartCutter::DecodePacket(AVPacket *pkt)
+{
+    int got_frame = 0;
+    int ret = avcodec_decode_video2(m_decoder, m_frame, &got_frame, pkt);
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC +
+            QString("Decoding error #%1").arg(ret));
+        return false;
+    }
+
+    if (!got_frame)
+        return false;
+
+    int display = FindDisplay(av_frame_get_best_effort_timestamp(m_frame));
+    if (display >= 0 && m_groupOf[display] >= 0)
+        EncodeFrame(m_frame, display);
+
+    return true;
+}
+
+/** \fn SmartCutter::DrainDecoder(int)
+ *  \brief Gets the last frames out of the decoder and completes the
+ *         groups which can not receive any more frames.
+ *  \param next index of the first packet not decoded
+ */
+bool SmartCutter::DrainDecoder(int next)
+{
+    AVPacket pkt;
+    av_init_packet(&pkt);
+    pkt.data = NULL;
+    pkt.size = 0;
+
+    while (DecodePacket(&pkt))
+        ;
+
+    avcodec_flush_buffers(m_decoder);
+
+    FinishGroup();
+
+    for (int i = 0; i < m_groupReady.size(); i++)
+    {
+        if (m_groupReady[i] || m_groupLastPacket[i] >= next)
+            continue;
+
+        // Writing what there is would lose frames silently
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Could only decode %1 of the %2 frames around a cut")
+                .arg(m_groupEncoded[i]).arg(m_groupFrames[i]));
+        m_groupReady[i] = true;
+        m_failed = true;
+    }
+
+    EmitReady();
+
+    return true;
+}
+
+bool SmartCutter::OpenEncoder(const AVFrame *frame)
+{
+    AVStream *st = m_inputFC->streams[m_videoStream];
+    AVCodec *codec = avcodec_find_encoder(st->codec->codec_id);
+    if (!codec)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "No video encoder found");
+        return false;
+    }
+
+    AVRational rate = st->avg_frame_rate;
+    if (!rate.num || !rate.den)
+        rate = st->r_frame_rate;
+    if (!rate.num || !rate.den)
+    {
+        rate.num = 25;
+        rate.den = 1;
+    }
+
+    m_encoder = avcodec_alloc_context3(codec);
+    m_encoder->width      = frame->width;
+    m_encoder->height     = frame->height;
+    m_encoder->pix_fmt    = (AVPixelFormat)frame->format;
+    m_encoder->time_base  = av_inv_q(rate);
+    m_encoder->sample_aspect_ratio = st->codec->sample_aspect_ratio;
+    m_encoder->color_primaries = st->codec->color_primaries;
+    m_encoder->color_trc       = st->codec->color_trc;
+    m_encoder->colorspace      = st->codec->colorspace;
+    m_encoder->color_range     = st->codec->color_range;
+    // No B frames, so the encoded frames are in display order
+    m_encoder->max_b_frames = 0;
+    m_encoder->gop_size = m_groupFrames[m_encoderGroup] + 1;
+    if (frame->interlaced_frame)
+        m_encoder->flags |= CODEC_FLAG_INTERLACED_DCT |
+                            CODEC_FLAG_INTERLACED_ME;
+
+    AVDictionary *opts = NULL;
+    av_dict_set(&opts, "preset", "fast", 0);
+    av_dict_set(&opts, "crf", "16", 0);
+    av_dict_set(&opts, "x265-params", "bframes=0", 0);
+
+    int ret = avcodec_open2(m_encoder, codec, &opts);
+    av_dict_free(&opts);
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Couldn't open the %1 encoder, error #%2")
+                .arg(codec->name).arg(ret));
+        av_freep(&m_encoder);
+        return false;
+    }
+
+    return true;
+}
+
+void SmartCutter::EncodeFrame(AVFrame *frame, int display)
+{
+    int group = m_groupOf[display];
+
+    if (group != m_encoderGroup)
+    {
+        FinishGroup();
+        m_encoderGroup = group;
+        if (!OpenEncoder(frame))
+        {
+            m_failed = true;
+            m_encoderGroup = -1;
+            return;
+        }
+    }
+
+    frame->pts = display;
+    frame->pict_type = (m_groupEncoded[group] == 0) ?
+        AV_PICTURE_TYPE_I : AV_PICTURE_TYPE_NONE;
+
+    WriteEncoderOutput(frame);
+    m_groupEncoded[group]++;
+
+    if (m_groupEncoded[group] >= m_groupFrames[group])
+        FinishGroup();
+}
+
+/// Returns true if the encoder returned a packet
+bool SmartCutter::WriteEncoderOutput(AVFrame *frame)
+{
+    AVPacket pkt;
+    av_init_packet(&pkt);
+    pkt.data = NULL;
+    pkt.size = 0;
+
+    int got_packet = 0;
+    int ret = avcodec_encode_video2(m_encoder, &pkt, frame, &got_packet);
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Encoding error #%1").arg(ret));
+        m_failed = true;
+        return false;
+    }
+
+    if (!got_packet)
+        return false;
+
+    QList<AVPacket> &packets = m_groupPackets[m_encoderGroup];
+    int display = pkt.pts;
+    if (pkt.pts < 0 || display >= m_displayPTS.size() ||
+        m_rangeOf[display] < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Encoder returned unknown frame %1").arg(pkt.pts));
+        av_free_packet(&pkt);
+        m_failed = true;
+        return false;
+    }
+
+    pkt.pts = m_displayPTS[display] - m_ranges[m_rangeOf[display]].shift;
+    pkt.dts = AV_NOPTS_VALUE;
+    pkt.duration = 0;
+
+    if (!packets.empty() && pkt.pts <= packets.back().pts)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Encoder reordered the frames");
+        av_free_packet(&pkt);
+        m_failed = true;
+        return false;
+    }
+
+    packets.push_back(pkt);
+    m_encodedFrames++;
+
+    return true;
+}
+
+void SmartCutter::FinishGroup(void)
+{
+    if (m_encoderGroup < 0)
+        return;
+
+    if (m_encoder)
+    {
+        while (WriteEncoderOutput(NULL))
+            ;
+        avcodec_close(m_encoder);
+        av_freep(&m_encoder);
+    }
+
+    m_groupReady[m_encoderGroup] = true;
+    m_encoderGroup = -1;
+
+    EmitReady();
+}
+
+/** \fn SmartCutter::EmitReady(void)
+ *  \brief Writes the video in the planned order, as far as it is
+ *         available.
+ */
+void SmartCutter::EmitReady(void)
+{
+    while (m_planPos < m_plan.size())
+    {
+        int item = m_plan[m_planPos];
+        if (item >= 0)
+        {
+            QMap<int, AVPacket>::iterator it = m_readyPackets.find(item);
+            if (it == m_readyPackets.end())
+                return;
+
+            AVPacket pkt = *it;
+            m_readyPackets.erase(it);
+
+            const SmartCutPacket &packet = m_packets[item];
+            int64_t shift = m_ranges[m_rangeOf[packet.display]].shift;
+            WriteVideo(&pkt, packet.pts - shift, packet.dts - shift);
+            m_copiedPackets++;
+        }
+        else
+        {
+            int group = -1 - item;
+            if (!m_groupReady[group])
+                return;
+
+            // The encoded frames are not reordered, any decode time up
+            // to the display time works as long as it keeps increasing.
+            QList<AVPacket> packets = m_groupPackets.take(group);
+            int out = m_streamMap[m_videoStream];
+            for (int i = 0; i < packets.size(); i++)
+            {
+                int64_t dts = packets[i].pts - m_reorderDelay;
+                if (m_lastDTS.contains(out))
+                    dts = qMax(dts, m_lastDTS[out] + 1);
+                WriteVideo(&packets[i], packets[i].pts, dts);
+            }
+        }
+        m_planPos++;
+    }
+}
+
+void SmartCutter::WriteVideo(AVPacket *pkt, int64_t pts, int64_t dts)
+{
+    int out = m_streamMap[m_videoStream];
+
+    QMap<int, int64_t>::iterator last = m_lastDTS.find(out);
+    if (last != m_lastDTS.end() && dts <= *last)
+        dts = *last + 1;
+
+    // Dropping the frame would leave a hole in the output
+    if (dts > pts)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Video frame at %1 is out of order").arg(pts));
+        av_free_packet(pkt);
+        m_failed = true;
+        return;
+    }
+    m_lastDTS[out] = dts;
+
+    AVStream *ost = m_outputFC->streams[out];
+    pkt->pts = av_rescale_q(pts, m_videoTimeBase, ost->time_base);
+    pkt->dts = av_rescale_q(dts, m_videoTimeBase, ost->time_base);
+    pkt->duration = av_rescale_q(pkt->duration, m_videoTimeBase,
+                                 ost->time_base);
+    pkt->stream_index = out;
+    pkt->pos = -1;
+
+    int ret = av_interleaved_write_frame(m_outputFC, pkt);
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Couldn't write video, error #%1").arg(ret));
+        m_failed = true;
+    }
+}
+
+/** \fn SmartCutter::WriteAudio(AVPacket*)
+ *  \brief Copies the audio frames starting in a kept section.
+ */
+void SmartCutter::WriteAudio(AVPacket *pkt)
+{
+    AVStream *ist = m_inputFC->streams[pkt->stream_index];
+    int range = -1;
+    if (pkt->pts != AV_NOPTS_VALUE)
+        range = FindRange(av_rescale_q(pkt->pts, ist->time_base,
+                                       m_videoTimeBase));
+    if (range < 0)
+    {
+        av_free_packet(pkt);
+        return;
+    }
+
+    int64_t shift = av_rescale_q(m_ranges[range].shift, m_videoTimeBase,
+                                 ist->time_base);
+    int64_t pts = pkt->pts - shift;
+    int64_t dts = ((pkt->dts != AV_NOPTS_VALUE) ? pkt->dts : pkt->pts) - shift;
+
+    int out = m_streamMap[pkt->stream_index];
+    QMap<int, int64_t>::iterator last = m_lastDTS.find(out);
+    if (last != m_lastDTS.end() && dts <= *last)
+    {
+        av_free_packet(pkt);
+        return;
+    }
+    m_lastDTS[out] = dts;
+
+    AVStream *ost = m_outputFC->streams[out];
+    pkt->pts = av_rescale_q(pts, ist->time_base, ost->time_base);
+    pkt->dts = av_rescale_q(dts, ist->time_base, ost->time_base);
+    pkt->duration = av_rescale_q(pkt->duration, ist->time_base,
+                                 ost->time_base);
+    pkt->stream_index = out;
+    pkt->pos = -1;
+
+    int ret = av_interleaved_write_frame(m_outputFC, pkt);
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Couldn't write audio, error #%1").arg(ret));
+        m_failed = true;
+    }
+}
+
+int SmartCutter::BuildKeyframeIndex(QString &file,
+                                    frm_pos_map_t &posMap,
+                                    frm_pos_map_t &durMap)
+{
+    LOG(VB_GENERAL, LOG_INFO, "Generating Keyframe Index");
+
+    if (!OpenInput(file))
+        return GENERIC_EXIT_NOT_OK;
+
+    AVPacket pkt;
+    av_init_packet(&pkt);
+
+    int count = 0;
+    uint64_t totalDuration = 0;
+    while (av_read_frame(m_inputFC, &pkt) >= 0)
+    {
+        if (pkt.stream_index == m_videoStream)
+        {
+            if (pkt.flags & AV_PKT_FLAG_KEY)
+            {
+                posMap[count] = pkt.pos;
+                durMap[count] = totalDuration;
+            }
+
+            totalDuration +=
+                av_q2d(m_videoTimeBase) * pkt.duration * 1000; // msec
+            count++;
+        }
+        av_free_packet(&pkt);
+    }
+
+    CloseInput();
+
+    return REENCODE_OK;
+}
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
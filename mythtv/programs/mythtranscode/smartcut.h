@@ -0,0 +1,167 @@
+#ifndef SMARTCUT_H
+#define SMARTCUT_H
+
+#include <stdint.h>
+
+extern "C"
+{
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+}
+
+// Qt
+#include <QVector>
+#include <QList>
+#include <QMap>
+#include <QDateTime>
+#include <QString>
+
+// MythTV
+#include "transcodedefs.h"
+#include "programtypes.h"
+
+/// A video packet of the input, in decode order
+class SmartCutPacket
+{
+  public:
+    SmartCutPacket() :
+        pts(AV_NOPTS_VALUE), dts(AV_NOPTS_VALUE), display(-1), gop(-1),
+        key(false), copy(false), decode(false) {}
+
+    int64_t pts;
+    int64_t dts;
+    int     display;  ///< frame number in display order
+    int     gop;      ///< -1 before the first keyframe
+    bool    key;
+    bool    copy;     ///< written to the output as it is
+    bool    decode;   ///< fed to the decoder
+};
+
+/// The packets from one keyframe to the next, in decode order
+class SmartCutGOP
+{
+  public:
+    SmartCutGOP() :
+        first(0), last(0), keyDisplay(0), lastLeading(-1),
+        copyTrailing(false), encodeTrailing(false),
+        copyLeading(false), encodeLeading(false) {}
+
+    int  first;         ///< index of the keyframe packet
+    int  last;
+    int  keyDisplay;
+    int  lastLeading;   ///< last packet displayed before the keyframe
+    bool copyTrailing;
+    bool encodeTrailing;
+    bool copyLeading;
+    bool encodeLeading;
+};
+
+/// A kept section of the input, in display order
+class SmartCutRange
+{
+  public:
+    SmartCutRange() :
+        first(0), last(0), startPTS(0), endPTS(0), shift(0) {}
+
+    int     first;      ///< first frame kept
+    int     last;       ///< first frame cut after the section
+    int64_t startPTS;
+    int64_t endPTS;
+    int64_t shift;      ///< subtracted from the timestamps of the section
+};
+
+// SmartCutter applies a cutlist to an H.264 or HEVC transport stream
+// without transcoding the whole recording. The GOPs kept whole are
+// copied untouched, only the frames kept from the GOPs at each cut
+// point are decoded and encoded again, so the job is bound by I/O.
+class SmartCutter
+{
+  public:
+    SmartCutter(const QString &inf, const QString &outf,
+                frm_dir_map_t *deleteMap, bool showprog,
+                void (*update_func)(float) = NULL, int (*check_func)() = NULL);
+    ~SmartCutter();
+
+    static bool IsSupported(const QString &file);
+
+    int Start(void);
+    int BuildKeyframeIndex(QString &file, frm_pos_map_t &posMap,
+                           frm_pos_map_t &durMap);
+
+  private:
+    bool OpenInput(const QString &file);
+    void CloseInput(void);
+    bool OpenOutput(void);
+    void CloseOutput(void);
+    int  ScanInput(void);
+    int  BuildRanges(void);
+    void PlanCut(void);
+    int  WriteOutput(void);
+    bool UpdateProgress(int64_t pos, float base, float scale);
+
+    int  FindDisplay(int64_t pts) const;
+    int  FindRange(int64_t pts) const;
+    bool IsKept(int display) const { return m_rangeOf[display] >= 0; }
+
+    bool DecodePacket(AVPacket *pkt);
+    bool DrainDecoder(int next);
+    void EncodeFrame(AVFrame *frame, int display);
+    bool OpenEncoder(const AVFrame *frame);
+    void FinishGroup(void);
+    bool WriteEncoderOutput(AVFrame *frame);
+    void EmitReady(void);
+    void WriteVideo(AVPacket *pkt, int64_t pts, int64_t dts);
+    void WriteAudio(AVPacket *pkt);
+
+    QString                 m_infile;
+    QString                 m_outfile;
+    frm_dir_map_t           m_deleteMap;
+
+    AVFormatContext        *m_inputFC;
+    AVFormatContext        *m_outputFC;
+    AVCodecContext         *m_decoder;
+    AVCodecContext         *m_encoder;
+    AVFrame                *m_frame;
+    int                     m_videoStream;
+    AVRational              m_videoTimeBase;
+    QMap<int, int>          m_streamMap;     ///< input to output stream
+    QMap<int, int64_t>      m_lastDTS;       ///< by output stream
+
+    QVector<SmartCutPacket> m_packets;
+    QVector<SmartCutGOP>    m_gops;
+    QVector<int64_t>        m_displayPTS;    ///< sorted pts of the frames
+    QVector<int>            m_rangeOf;       ///< by display, -1 if cut
+    QVector<int>            m_groupOf;       ///< by display, -1 if copied
+    QList<SmartCutRange>    m_ranges;
+    int64_t                 m_reorderDelay;
+
+    /// What to write, in order. A packet index, or -1 - n for
+    /// the frames of encoder group n.
+    QVector<int>            m_plan;
+    int                     m_planPos;
+    QVector<int>            m_groupFrames;
+    QVector<int>            m_groupEncoded;
+    QVector<int>            m_groupLastPacket; ///< last packet decoded for it
+    QVector<bool>           m_groupReady;
+    QMap<int, AVPacket>     m_readyPackets;
+    QMap<int, QList<AVPacket> > m_groupPackets;
+    int                     m_encoderGroup;
+    int                     m_encodedFrames;
+    int                     m_copiedPackets;
+    bool                    m_failed;        ///< fall back to transcoding
+
+    // progress indicators
+    int                   (*m_checkAbort)();
+    void                  (*m_updateStatus)(float percent_done);
+    bool                    m_showProgress;
+    QDateTime               m_statusTime;
+    int                     m_statusUpdateTime;
+    uint                    m_progressCount;
+    int64_t                 m_fileSize;
+
+    // for testing the plan without an input file
+    friend class TestSmartCut;
+};
+
+#endif
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
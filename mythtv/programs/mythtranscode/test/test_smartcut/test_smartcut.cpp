@@ -0,0 +1,3 @@
+#include "test_smartcut.h"
+
+QTEST_APPLESS_MAIN(TestSmartCut)
@@ -0,0 +1,199 @@
+/*
+ *  Class TestSmartCut
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+
+#include "smartcut.h"
+
+static const int kGOPs      = 6;
+static const int kGOPLength = 12;
+
+/// Display order of the packets of an open GOP, I B B P B B P B B P B B,
+/// the first two B frames are displayed before the keyframe.
+static const int kOpenDisplay[kGOPLength] =
+    { 2, 0, 1, 5, 3, 4, 8, 6, 7, 11, 9, 10 };
+
+class TestSmartCut: public QObject
+{
+    Q_OBJECT
+
+    /// Closed GOPs without B frames, or open GOPs with them, as
+    /// ScanInput() would find them
+    void AddGOPs(SmartCutter &cutter, bool open)
+    {
+        for (int g = 0; g < kGOPs; g++)
+        {
+            SmartCutGOP gop;
+            gop.first = g * kGOPLength;
+            gop.last  = gop.first + kGOPLength - 1;
+            cutter.m_gops.push_back(gop);
+
+            for (int i = gop.first; i <= gop.last; i++)
+            {
+                SmartCutPacket packet;
+                int display = open ?
+                    gop.first + kOpenDisplay[i - gop.first] : i;
+                packet.pts = 90000 + display * 3600;
+                packet.dts = 90000 + (open ? i - 2 : i) * 3600;
+                packet.key = (i == gop.first);
+                packet.gop = g;
+                cutter.m_packets.push_back(packet);
+            }
+        }
+    }
+
+    /// The plan for a cut of the frames [start, end]
+    void Plan(SmartCutter &cutter, int start, int end, bool open = false)
+    {
+        cutter.m_deleteMap[start] = MARK_CUT_START;
+        cutter.m_deleteMap[end]   = MARK_CUT_END;
+        AddGOPs(cutter, open);
+        QCOMPARE(cutter.BuildRanges(), (int)REENCODE_OK);
+        cutter.PlanCut();
+    }
+
+    /// The expected plan, the packets of the GOPs given and then groups
+    QVector<int> Expected(int firstGOPs, int groups, int lastGOPs)
+    {
+        QVector<int> plan;
+        for (int i = 0; i < firstGOPs * kGOPLength; i++)
+            plan.push_back(i);
+        for (int n = 0; n < groups; n++)
+            plan.push_back(-1 - n);
+        for (int i = (kGOPs - lastGOPs) * kGOPLength; i < kGOPs * kGOPLength;
+             i++)
+        {
+            plan.push_back(i);
+        }
+        return plan;
+    }
+
+    /// The packets [first, last]
+    static QVector<int> Packets(int first, int last)
+    {
+        QVector<int> packets;
+        for (int i = first; i <= last; i++)
+            packets.push_back(i);
+        return packets;
+    }
+
+  private slots:
+    void cut_between_keyframes_copies_gops(void)
+    {
+        SmartCutter cutter("", "", NULL, false);
+        Plan(cutter, 2 * kGOPLength, 4 * kGOPLength - 1);
+
+        QCOMPARE(cutter.m_plan, Expected(2, 0, 2));
+        QVERIFY(cutter.m_groupFrames.empty());
+    }
+
+    void cut_within_adjacent_gops_is_one_group(void)
+    {
+        SmartCutter cutter("", "", NULL, false);
+        Plan(cutter, kGOPLength + 6, 2 * kGOPLength + 5);
+
+        QCOMPARE(cutter.m_plan, Expected(1, 1, 3));
+        QCOMPARE(cutter.m_groupFrames.size(), 1);
+        QCOMPARE(cutter.m_groupFrames[0], kGOPLength);
+        QCOMPARE(cutter.m_groupOf[kGOPLength], 0);
+        QCOMPARE(cutter.m_groupOf[2 * kGOPLength + 6], 0);
+    }
+
+    /// The GOPs cut whole in between drain the decoder, so the frames
+    /// on either side of the cut have to be encoded as two groups.
+    void cut_spanning_gops_starts_new_group(void)
+    {
+        SmartCutter cutter("", "", NULL, false);
+        Plan(cutter, kGOPLength + 6, 4 * kGOPLength + 5);
+
+        QCOMPARE(cutter.m_plan, Expected(1, 2, 1));
+        QCOMPARE(cutter.m_groupFrames.size(), 2);
+        QCOMPARE(cutter.m_groupFrames[0], 6);
+        QCOMPARE(cutter.m_groupFrames[1], 6);
+        QCOMPARE(cutter.m_groupOf[kGOPLength], 0);
+        QCOMPARE(cutter.m_groupOf[4 * kGOPLength + 6], 1);
+        QCOMPARE(cutter.m_groupLastPacket[0], 2 * kGOPLength - 1);
+
+        // The GOPs cut whole are not decoded
+        for (int i = 2 * kGOPLength; i < 4 * kGOPLength; i++)
+            QVERIFY(!cutter.m_packets[i].decode);
+    }
+
+    /// The leading B frames of the GOP after a cut refer to the cut GOP,
+    /// so they are dropped while the rest of that GOP is copied.
+    void open_gop_cut_drops_leading_frames(void)
+    {
+        SmartCutter cutter("", "", NULL, false);
+        Plan(cutter, 2 * kGOPLength + 2, 4 * kGOPLength + 1, true);
+
+        // The leading frames before the cut are encoded from the
+        // previous GOP, which is copied and decoded too.
+        QCOMPARE(cutter.m_plan, QVector<int>() << 0 << Packets(3, 23) << -1
+                 << 4 * kGOPLength << Packets(4 * kGOPLength + 3, 71));
+        QCOMPARE(cutter.m_groupFrames.size(), 1);
+        QCOMPARE(cutter.m_groupFrames[0], 2);
+        QCOMPARE(cutter.m_groupOf[2 * kGOPLength], 0);
+        QCOMPARE(cutter.m_groupOf[2 * kGOPLength + 1], 0);
+        for (int i = kGOPLength; i <= 2 * kGOPLength + 2; i++)
+            QVERIFY(cutter.m_packets[i].decode);
+
+        // Copied again from the GOP after that
+        QVERIFY(cutter.m_gops[5].copyLeading);
+    }
+
+    /// A cut within the trailing frames of an open GOP encodes its
+    /// leading frames along with the kept trailing ones.
+    void open_gop_cut_encodes_leading_frames(void)
+    {
+        SmartCutter cutter("", "", NULL, false);
+        Plan(cutter, 3 * kGOPLength + 4, 4 * kGOPLength + 1, true);
+
+        QCOMPARE(cutter.m_plan, QVector<int>() << 0 << Packets(3, 35) << -1
+                 << 4 * kGOPLength << Packets(4 * kGOPLength + 3, 71));
+        QCOMPARE(cutter.m_groupFrames.size(), 1);
+        QCOMPARE(cutter.m_groupFrames[0], 4);
+        QVERIFY(cutter.m_gops[3].encodeLeading);
+        QVERIFY(cutter.m_gops[3].encodeTrailing);
+        for (int i = 2 * kGOPLength; i < 4 * kGOPLength; i++)
+            QVERIFY(cutter.m_packets[i].decode);
+    }
+
+    /// The leading frames kept after a cut refer to the GOP cut whole
+    /// before them. That GOP is decoded, so the frames on either side of
+    /// the cut are one group.
+    void open_gop_cut_decodes_cut_gop(void)
+    {
+        SmartCutter cutter("", "", NULL, false);
+        Plan(cutter, 2 * kGOPLength + 6, 4 * kGOPLength - 1, true);
+
+        QCOMPARE(cutter.m_plan, QVector<int>() << 0 << Packets(3, 23) << -1
+                 << 4 * kGOPLength << Packets(4 * kGOPLength + 3, 71));
+        QCOMPARE(cutter.m_groupFrames.size(), 1);
+        QCOMPARE(cutter.m_groupFrames[0], 8);
+        QCOMPARE(cutter.m_groupOf[2 * kGOPLength], 0);
+        QCOMPARE(cutter.m_groupOf[4 * kGOPLength], 0);
+        QCOMPARE(cutter.m_groupLastPacket[0], 4 * kGOPLength + 2);
+        for (int i = 3 * kGOPLength; i < 4 * kGOPLength; i++)
+        {
+            QVERIFY(cutter.m_packets[i].decode);
+            QVERIFY(!cutter.m_packets[i].copy);
+        }
+        QVERIFY(cutter.m_gops[4].encodeLeading);
+        QVERIFY(cutter.m_gops[4].copyTrailing);
+    }
+};
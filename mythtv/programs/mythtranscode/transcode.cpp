@@ -32,6 +32,7 @@
 
 #include "videodecodebuffer.h"
 #include "cutter.h"
+#include "smartcut.h"
 #include "audioreencodebuffer.h"
 
 extern "C" {
@@ -55,6 +56,7 @@ Transcode::Transcode(ProgramInfo *pginfo) :
     fifow(NULL),
     kfa_table(NULL),
     showprogress(false),
+    smartCut(true),
     recorderOptions(""),
     avfMode(false),
     hlsMode(false),                 hlsStreamID(-1),
@@ -268,6 +270,7 @@ int Transcode::TranscodeFile(const QString &inputname,
             delete hls;
         return REENCODE_ERROR;
     }
+    rb->SetReadAheadPolicy(kReadAheadBatch);
     player_ctx->SetRingBuffer(rb);
     player_ctx->SetPlayer(new MythPlayer((PlayerFlags)(kVideoIsNull | kNoITV)));
     SetPlayerContext(player_ctx);
@@ -684,6 +687,16 @@ int Transcode::TranscodeFile(const QString &inputname,
             return REENCODE_MPEG2TRANS;
         }
 
+        // SmartCutter checks the video is H.264 or HEVC itself
+        if (get_int_option(m_recProfile, "transcodelossless") &&
+            honorCutList && !deleteMap.empty() && smartCut &&
+            SmartCutter::IsSupported(inputname))
+        {
+            LOG(VB_GENERAL, LOG_NOTICE, "Switching to smart-render cutter.");
+            SetPlayerContext(NULL);
+            return REENCODE_SMARTCUT;
+        }
+
         // Recorder setup
         if (get_int_option(m_recProfile, "transcodelossless"))
         {
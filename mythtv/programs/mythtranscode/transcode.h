@@ -37,6 +37,7 @@ class Transcode : public QObject
     void SetCMDBitrate(int bitrate) { cmdBitrate = bitrate; }
     void SetCMDAudioBitrate(int bitrate) { cmdAudioBitrate = bitrate; }
     void DisableAudioOnlyHLS(void) { hlsDisableAudioOnly = true; }
+    void DisableSmartCut(void) { smartCut = false; }
 
   private:
     bool GetProfile(QString profileName, QString encodingType, int height,
@@ -56,6 +57,7 @@ class Transcode : public QObject
     FIFOWriter             *fifow;
     KFATable               *kfa_table;
     bool                    showprogress;
+    bool                    smartCut;
     QString                 recorderOptions;
     bool                    avfMode;
     bool                    hlsMode;
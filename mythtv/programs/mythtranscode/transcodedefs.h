@@ -1,6 +1,8 @@
 #ifndef TRANSCODEDEFS_H_
 #define TRANSCODEDEFS_H_
 
+#define REENCODE_NOSMARTCUT      4
+#define REENCODE_SMARTCUT        3
 #define REENCODE_MPEG2TRANS      2
 #define REENCODE_CUTLIST_CHANGE  1
 #define REENCODE_OK              0
@@ -513,6 +513,42 @@ static HostSpinBox *JobQueueCheckFrequency()
     return gc;
 };
 
+static HostSpinBox *JobQueueMaxLoad()
+{
+    HostSpinBox *gc = new HostSpinBox("JobQueueMaxLoad", 0, 800, 25);
+    gc->setLabel(QObject::tr("Maximum CPU load for new jobs (%)"));
+    gc->setHelpText(QObject::tr("New jobs will not be started on this "
+                    "backend while its load average is above this "
+                    "percentage of its CPU cores, leaving them for another "
+                    "backend. Set to 0 to start jobs regardless of the "
+                    "load."));
+    gc->setValue(0);
+    return gc;
+};
+
+static HostSpinBox *JobQueueMaxIOWait()
+{
+    HostSpinBox *gc = new HostSpinBox("JobQueueMaxIOWait", 0, 100, 5);
+    gc->setLabel(QObject::tr("Maximum I/O wait for new jobs (%)"));
+    gc->setHelpText(QObject::tr("New jobs will not be started on this "
+                    "backend while its CPUs spend more than this percentage "
+                    "of their time waiting on disk I/O. Set to 0 to start "
+                    "jobs regardless of the I/O load."));
+    gc->setValue(0);
+    return gc;
+};
+
+static HostCheckBox *JobQueuePauseWhileRecording()
+{
+    HostCheckBox *gc = new HostCheckBox("JobQueuePauseWhileRecording");
+    gc->setLabel(QObject::tr("Pause transcode and user jobs while recording"));
+    gc->setValue(false);
+    gc->setHelpText(QObject::tr("If enabled, transcoding and user jobs "
+                    "running on this backend are paused while it is "
+                    "recording, and resumed when the recordings finish."));
+    return gc;
+};
+
 static HostComboBox *JobQueueCPU()
 {
     HostComboBox *gc = new HostComboBox("JobQueueCPU");
@@ -914,6 +950,9 @@ BackendSettings::BackendSettings() {
     group5->setLabel(QObject::tr("Job Queue (Backend-Specific)"));
     group5->addChild(JobQueueMaxSimultaneousJobs());
     group5->addChild(JobQueueCheckFrequency());
+    group5->addChild(JobQueueMaxLoad());
+    group5->addChild(JobQueueMaxIOWait());
+    group5->addChild(JobQueuePauseWhileRecording());
 
     HorizontalConfigurationGroup* group5a =
               new HorizontalConfigurationGroup(false, false);
@@ -24,3 +24,27 @@ using_backend {
 }
 
 using_mythtranscode: SUBDIRS += mythtranscode
+
+# unit tests mythbackend
+using_backend {
+    mythbackend-test.depends = sub-mythbackend
+    mythbackend-test.target = buildtestmythbackend
+    mythbackend-test.commands = cd mythbackend/test && $(QMAKE) && $(MAKE)
+    unix:QMAKE_EXTRA_TARGETS += mythbackend-test
+}
+
+# unit tests and benchmarks mythfilldatabase
+using_backend {
+    mythfilldatabase-test.depends = sub-mythfilldatabase
+    mythfilldatabase-test.target = buildtestmythfilldatabase
+    mythfilldatabase-test.commands = cd mythfilldatabase/test && $(QMAKE) && $(MAKE)
+    unix:QMAKE_EXTRA_TARGETS += mythfilldatabase-test
+}
+
+# unit tests mythtranscode
+using_mythtranscode {
+    mythtranscode-test.depends = sub-mythtranscode
+    mythtranscode-test.target = buildtestmythtranscode
+    mythtranscode-test.commands = cd mythtranscode/test && $(QMAKE) && $(MAKE)
+    unix:QMAKE_EXTRA_TARGETS += mythtranscode-test
+}